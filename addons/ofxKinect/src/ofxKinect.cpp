@@ -217,6 +217,8 @@ bool ofxKinect::open(int deviceIndex) {
 		bHasMotorControl = true;
 	}
 
+	pointCloud.setup(getZeroPlanePixelSize(), getZeroPlaneDistance(), width, height);
+
 	lastDeviceIndex = deviceIndex;
 	timeSinceOpen = ofGetElapsedTimef();
 	bGotDataVideo = false;
@@ -259,6 +261,8 @@ bool ofxKinect::open(string serial) {
 		bHasMotorControl = true;
 	}
     
+	pointCloud.setup(getZeroPlanePixelSize(), getZeroPlaneDistance(), width, height);
+
 	lastDeviceIndex = kinectContext.getDeviceIndex(serial);
 	timeSinceOpen = ofGetElapsedTimef();
 	bGotDataVideo = false;
@@ -440,6 +444,16 @@ ofVec3f ofxKinect::getWorldCoordinateAt(float cx, float cy, float wz)  const{
 	return ofVec3f(wx, wy, wz);
 }
 
+//------------------------------------
+void ofxKinect::getPointCloud(ofMesh & mesh, int step, bool bClip, bool bColors) const{
+	pointCloud.update(depthPixelsRaw, mesh, step, bClip, nearClipping, farClipping, (bColors && bGrabVideo) ? &videoPixels : nullptr);
+}
+
+//------------------------------------
+size_t ofxKinect::getPointCloud(float * points, int step, bool bClip) const{
+	return pointCloud.update(depthPixelsRaw, points, step, bClip, nearClipping, farClipping);
+}
+
 //------------------------------------
 float ofxKinect::getSensorEmitterDistance()  const{
 	return kinectDevice->registration.zero_plane_info.dcmos_emitter_dist;
@@ -44,6 +44,7 @@
 
 
 #include "ofxBase3DVideo.h"
+#include "ofxKinectPointCloud.h"
 
 class ofxKinectContext;
 
@@ -129,6 +130,25 @@ public:
 	ofVec3f getWorldCoordinateAt(int cx, int cy) const;
 	ofVec3f getWorldCoordinateAt(float cx, float cy, float wz) const;
 
+	/// calculates the world coordinates of the whole depth image at once
+	///
+	/// same as calling getWorldCoordinateAt() for every pixel but with
+	/// precomputed rays, see ofxKinectPointCloud
+	///
+	/// step skips pixels in both directions for a decimated cloud, bClip
+	/// drops the points outside of the setDepthClipping() range and pixels
+	/// without depth are always dropped
+	///
+	/// bColors sets the color of every point from the video image, see
+	/// setRegistration() for calibrated colors
+	void getPointCloud(ofMesh & mesh, int step=1, bool bClip=true, bool bColors=false) const;
+
+	/// same as above but writes xyz triples, points has to hold
+	/// 3 * width * height floats when step is 1
+	///
+	/// returns the number of points written
+	size_t getPointCloud(float * points, int step=1, bool bClip=true) const;
+
 /// \section Intrinsic IR Sensor Parameters
 
 	/// these values are used when depth registration is enabled to align the
@@ -387,6 +407,7 @@ private:
 	ofPixels videoPixelsBack;			///< rgb back
 
 	vector<unsigned char> depthLookupTable;
+	ofxKinectPointCloud pointCloud; ///< rays for the current device
 	void updateDepthLookupTable();
 	void updateDepthPixels();
 
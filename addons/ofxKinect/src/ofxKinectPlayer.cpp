@@ -0,0 +1,483 @@
+/*==============================================================================
+
+    Copyright (c) 2010, 2011 ofxKinect Team
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+    
+==============================================================================*/
+#include "ofxKinectPlayer.h"
+
+//--------------------------------------------------------------------
+ofxKinectPlayer::ofxKinectPlayer() {
+	header = {};
+	frameSize = 0;
+	totalNumFrames = 0;
+	currentFrame = -1;
+	nextFrame = 0;
+
+	bRealtime = false;
+	bLoop = true;
+	bDone = false;
+	bIsFrameNew = false;
+	firstTimestamp = 0;
+	frameTimestamp = 0;
+	playStartTime = 0;
+
+	bUseTexture = true;
+	bNearWhite = true;
+
+	setDepthClipping();
+}
+
+//--------------------------------------------------------------------
+ofxKinectPlayer::~ofxKinectPlayer() {
+	close();
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::load(const of::filesystem::path & filename) {
+	close();
+
+	file.open(ofToDataPath(filename), std::ios::binary);
+	if(!file.is_open()) {
+		ofLogError("ofxKinectPlayer") << "load(): couldn't open " << filename;
+		return false;
+	}
+
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if(!file.good() || !std::equal(header.magic, header.magic + sizeof(header.magic), ofxKinectRecorder::magic)
+	   || header.width <= 0 || header.height <= 0 || header.videoChannels < 0) {
+		ofLogError("ofxKinectPlayer") << "load(): " << filename << " is not a kinect recording";
+		close();
+		return false;
+	}
+
+	frameSize = sizeof(uint64_t) + std::streamoff(header.width) * header.height * (sizeof(unsigned short) + header.videoChannels);
+	file.seekg(0, std::ios::end);
+	totalNumFrames = (file.tellg() - std::streamoff(sizeof(header))) / frameSize;
+	if(totalNumFrames <= 0) {
+		ofLogError("ofxKinectPlayer") << "load(): " << filename << " has no frames";
+		close();
+		return false;
+	}
+
+	depthPixelsRaw.allocate(header.width, header.height, 1);
+	depthPixels.allocate(header.width, header.height, 1);
+	distancePixels.allocate(header.width, header.height, 1);
+	depthPixelsRaw.set(0);
+	depthPixels.set(0);
+	distancePixels.set(0);
+	if(header.videoChannels > 0) {
+		videoPixels.allocate(header.width, header.height, header.videoChannels);
+		videoPixels.set(0);
+	}
+
+	if(bUseTexture) {
+		depthTex.allocate(depthPixels);
+		if(videoPixels.isAllocated()) {
+			videoTex.allocate(videoPixels);
+		}
+	}
+
+	pointCloud.setup(header.zeroPlanePixelSize, header.zeroPlaneDistance, header.width, header.height);
+
+	firstTimestamp = readTimestamp(0);
+	currentFrame = -1;
+	nextFrame = 0;
+	bDone = false;
+	return true;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPlayer::close() {
+	if(file.is_open()) {
+		file.close();
+	}
+	file.clear();
+	totalNumFrames = 0;
+	currentFrame = -1;
+	nextFrame = 0;
+	bIsFrameNew = false;
+
+	videoPixels.clear();
+	depthPixels.clear();
+	depthPixelsRaw.clear();
+	distancePixels.clear();
+	depthTex.clear();
+	videoTex.clear();
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isLoaded() const {
+	return totalNumFrames > 0;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isInitialized() const {
+	return isLoaded();
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPlayer::update() {
+	bIsFrameNew = false;
+	if(!isLoaded() || bDone) {
+		return;
+	}
+
+	if(nextFrame >= totalNumFrames) {
+		if(!bLoop) {
+			bDone = true;
+			return;
+		}
+		nextFrame = 0;
+		currentFrame = -1;
+	}
+
+	int frame = nextFrame;
+	if(bRealtime) {
+		uint64_t now = ofGetElapsedTimeMicros();
+		if(currentFrame < 0) {
+			playStartTime = now - (readTimestamp(frame) - firstTimestamp);
+		}
+		uint64_t elapsed = now - playStartTime;
+		if(readTimestamp(frame) - firstTimestamp > elapsed) {
+			return;
+		}
+		// skip the frames that are already late
+		while(frame + 1 < totalNumFrames && readTimestamp(frame + 1) - firstTimestamp <= elapsed) {
+			frame++;
+		}
+	}
+
+	if(!readFrame(frame)) {
+		bDone = true;
+		return;
+	}
+	currentFrame = frame;
+	nextFrame = frame + 1;
+	bIsFrameNew = true;
+
+	updateDepthPixels();
+	if(bUseTexture) {
+		depthTex.loadData(depthPixels);
+		if(videoPixels.isAllocated()) {
+			videoTex.loadData(videoPixels);
+		}
+	}
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isFrameNew() const {
+	return bIsFrameNew;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isFrameNewVideo() const {
+	return bIsFrameNew && videoPixels.isAllocated();
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isFrameNewDepth() const {
+	return bIsFrameNew;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::setPixelFormat(ofPixelFormat pixelFormat) {
+	return pixelFormat == getPixelFormat();
+}
+
+//--------------------------------------------------------------------
+ofPixelFormat ofxKinectPlayer::getPixelFormat() const {
+	return header.videoChannels == 1 ? OF_PIXELS_GRAY : OF_PIXELS_RGB;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPlayer::setRealtime(bool bRealtime) {
+	this->bRealtime = bRealtime;
+	if(bRealtime && currentFrame >= 0) {
+		playStartTime = ofGetElapsedTimeMicros() - (frameTimestamp - firstTimestamp);
+	}
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isRealtime() const {
+	return bRealtime;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPlayer::setLoop(bool bLoop) {
+	this->bLoop = bLoop;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::isLooping() const {
+	return bLoop;
+}
+
+//--------------------------------------------------------------------
+int ofxKinectPlayer::getCurrentFrame() const {
+	return currentFrame;
+}
+
+//--------------------------------------------------------------------
+int ofxKinectPlayer::getTotalNumFrames() const {
+	return totalNumFrames;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPlayer::setFrame(int frame) {
+	if(!isLoaded()) {
+		return;
+	}
+	nextFrame = ofClamp(frame, 0, totalNumFrames - 1);
+	currentFrame = -1;
+	bDone = false;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPlayer::getIsMovieDone() const {
+	return bDone;
+}
+
+//------------------------------------
+float ofxKinectPlayer::getDistanceAt(int x, int y) const {
+	return depthPixelsRaw[y * header.width + x];
+}
+
+//------------------------------------
+float ofxKinectPlayer::getDistanceAt(const ofPoint & p) const {
+	return getDistanceAt(p.x, p.y);
+}
+
+//------------------------------------
+ofVec3f ofxKinectPlayer::getWorldCoordinateAt(int x, int y) const {
+	return getWorldCoordinateAt(x, y, getDistanceAt(x, y));
+}
+
+//------------------------------------
+ofVec3f ofxKinectPlayer::getWorldCoordinateAt(float cx, float cy, float wz) const {
+	// same as freenect_camera_to_world, including the truncation to int pixels
+	double factor = 2.0 * header.zeroPlanePixelSize * wz / header.zeroPlaneDistance;
+	double wx = (int(cx) - header.width / 2) * factor;
+	double wy = (int(cy) - header.height / 2) * factor;
+	return ofVec3f(wx, wy, wz);
+}
+
+//------------------------------------
+void ofxKinectPlayer::getPointCloud(ofMesh & mesh, int step, bool bClip, bool bColors) const {
+	pointCloud.update(depthPixelsRaw, mesh, step, bClip, nearClipping, farClipping, (bColors && videoPixels.isAllocated()) ? &videoPixels : nullptr);
+}
+
+//------------------------------------
+size_t ofxKinectPlayer::getPointCloud(float * points, int step, bool bClip) const {
+	return pointCloud.update(depthPixelsRaw, points, step, bClip, nearClipping, farClipping);
+}
+
+//------------------------------------
+float ofxKinectPlayer::getZeroPlanePixelSize() const {
+	return header.zeroPlanePixelSize;
+}
+
+//------------------------------------
+float ofxKinectPlayer::getZeroPlaneDistance() const {
+	return header.zeroPlaneDistance;
+}
+
+//------------------------------------
+ofPixels & ofxKinectPlayer::getPixels() {
+	return videoPixels;
+}
+
+//------------------------------------
+const ofPixels & ofxKinectPlayer::getPixels() const {
+	return videoPixels;
+}
+
+//------------------------------------
+ofPixels & ofxKinectPlayer::getDepthPixels() {
+	return depthPixels;
+}
+
+//------------------------------------
+const ofPixels & ofxKinectPlayer::getDepthPixels() const {
+	return depthPixels;
+}
+
+//------------------------------------
+ofShortPixels & ofxKinectPlayer::getRawDepthPixels() {
+	return depthPixelsRaw;
+}
+
+//------------------------------------
+const ofShortPixels & ofxKinectPlayer::getRawDepthPixels() const {
+	return depthPixelsRaw;
+}
+
+//------------------------------------
+ofFloatPixels & ofxKinectPlayer::getDistancePixels() {
+	return distancePixels;
+}
+
+//------------------------------------
+const ofFloatPixels & ofxKinectPlayer::getDistancePixels() const {
+	return distancePixels;
+}
+
+//------------------------------------
+ofTexture & ofxKinectPlayer::getTexture() {
+	return videoTex;
+}
+
+//------------------------------------
+const ofTexture & ofxKinectPlayer::getTexture() const {
+	return videoTex;
+}
+
+//------------------------------------
+ofTexture & ofxKinectPlayer::getDepthTexture() {
+	return depthTex;
+}
+
+//------------------------------------
+const ofTexture & ofxKinectPlayer::getDepthTexture() const {
+	return depthTex;
+}
+
+//---------------------------------------------------------------------------
+void ofxKinectPlayer::enableDepthNearValueWhite(bool bEnabled) {
+	bNearWhite = bEnabled;
+	updateDepthLookupTable();
+}
+
+//---------------------------------------------------------------------------
+bool ofxKinectPlayer::isDepthNearValueWhite() const {
+	return bNearWhite;
+}
+
+//---------------------------------------------------------------------------
+void ofxKinectPlayer::setDepthClipping(float nearClip, float farClip) {
+	nearClipping = nearClip;
+	farClipping = farClip;
+	updateDepthLookupTable();
+}
+
+//---------------------------------------------------------------------------
+float ofxKinectPlayer::getNearClipping() const {
+	return nearClipping;
+}
+
+//---------------------------------------------------------------------------
+float ofxKinectPlayer::getFarClipping() const {
+	return farClipping;
+}
+
+//------------------------------------
+void ofxKinectPlayer::setUseTexture(bool bUse) {
+	bUseTexture = bUse;
+}
+
+//------------------------------------
+bool ofxKinectPlayer::isUsingTexture() const {
+	return bUseTexture;
+}
+
+//----------------------------------------------------------
+void ofxKinectPlayer::draw(float x, float y, float w, float h) const {
+	if(bUseTexture && videoTex.isAllocated()) {
+		videoTex.draw(x, y, w, h);
+	}
+}
+
+//----------------------------------------------------------
+void ofxKinectPlayer::draw(float x, float y) const {
+	draw(x, y, getWidth(), getHeight());
+}
+
+//----------------------------------------------------------
+void ofxKinectPlayer::drawDepth(float x, float y, float w, float h) const {
+	if(bUseTexture && depthTex.isAllocated()) {
+		depthTex.draw(x, y, w, h);
+	}
+}
+
+//----------------------------------------------------------
+void ofxKinectPlayer::drawDepth(float x, float y) const {
+	drawDepth(x, y, getWidth(), getHeight());
+}
+
+//----------------------------------------------------------
+float ofxKinectPlayer::getWidth() const {
+	return header.width;
+}
+
+//----------------------------------------------------------
+float ofxKinectPlayer::getHeight() const {
+	return header.height;
+}
+
+/* ***** PRIVATE ***** */
+
+//---------------------------------------------------------------------------
+bool ofxKinectPlayer::readFrame(int frame) {
+	file.clear();
+	file.seekg(std::streamoff(sizeof(header)) + frame * frameSize);
+	file.read(reinterpret_cast<char*>(&frameTimestamp), sizeof(frameTimestamp));
+	file.read(reinterpret_cast<char*>(depthPixelsRaw.getData()), depthPixelsRaw.getTotalBytes());
+	if(header.videoChannels > 0) {
+		file.read(reinterpret_cast<char*>(videoPixels.getData()), videoPixels.getTotalBytes());
+	}
+	if(!file.good()) {
+		ofLogError("ofxKinectPlayer") << "readFrame(): couldn't read frame " << frame;
+		return false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+uint64_t ofxKinectPlayer::readTimestamp(int frame) {
+	uint64_t timestamp = 0;
+	file.clear();
+	file.seekg(std::streamoff(sizeof(header)) + frame * frameSize);
+	file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+	return timestamp;
+}
+
+//---------------------------------------------------------------------------
+void ofxKinectPlayer::updateDepthLookupTable() {
+	unsigned char nearColor = bNearWhite ? 255 : 0;
+	unsigned char farColor = bNearWhite ? 0 : 255;
+	unsigned int maxDepthLevels = 10001;
+	depthLookupTable.resize(maxDepthLevels);
+	depthLookupTable[0] = 0;
+	for(unsigned int i = 1; i < maxDepthLevels; i++) {
+		depthLookupTable[i] = ofMap(i, nearClipping, farClipping, nearColor, farColor, true);
+	}
+}
+
+//----------------------------------------------------------
+void ofxKinectPlayer::updateDepthPixels() {
+	size_t n = depthPixelsRaw.size();
+	size_t maxDepth = depthLookupTable.size() - 1;
+	for(size_t i = 0; i < n; i++) {
+		distancePixels[i] = depthPixelsRaw[i];
+	}
+	for(size_t i = 0; i < n; i++) {
+		depthPixels[i] = depthLookupTable[std::min<size_t>(depthPixelsRaw[i], maxDepth)];
+	}
+}
@@ -0,0 +1,182 @@
+/*==============================================================================
+
+    Copyright (c) 2010, 2011 ofxKinect Team
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+    
+==============================================================================*/
+#pragma once
+
+#include "ofMain.h"
+
+#include "ofxBase3DVideo.h"
+#include "ofxKinectPointCloud.h"
+#include "ofxKinectRecorder.h"
+
+/// \class ofxKinectPlayer
+///
+/// plays back a file recorded with ofxKinectRecorder with the same
+/// interface as ofxKinect, so apps and tests can run without hardware
+///
+class ofxKinectPlayer : public ofxBase3DVideo {
+
+public:
+
+	ofxKinectPlayer();
+	virtual ~ofxKinectPlayer();
+
+/// \section Main
+
+	/// open a recording, the first frame is available after the next update()
+	bool load(const of::filesystem::path & filename);
+	void close();
+
+	bool isLoaded() const;
+	bool isInitialized() const;
+
+	/// read the next frame
+	///
+	/// by default a new frame is read on every call, with realtime enabled
+	/// frames are read following the recorded timestamps instead
+	void update();
+
+	bool isFrameNew() const;
+	bool isFrameNewVideo() const;
+	bool isFrameNewDepth() const;
+
+	bool setPixelFormat(ofPixelFormat pixelFormat);
+	ofPixelFormat getPixelFormat() const;
+
+/// \section Playback
+
+	/// play at the recorded frame rate instead of a frame per update()
+	void setRealtime(bool bRealtime=true);
+	bool isRealtime() const;
+
+	/// start again from the first frame when the end is reached, enabled by default
+	void setLoop(bool bLoop=true);
+	bool isLooping() const;
+
+	/// index of the last frame read, -1 before the first update()
+	int getCurrentFrame() const;
+	int getTotalNumFrames() const;
+
+	/// the next update() reads this frame
+	void setFrame(int frame);
+
+	/// true when the last frame was read and looping is disabled
+	bool getIsMovieDone() const;
+
+/// \section Depth Data
+
+	float getDistanceAt(int x, int y) const;
+	float getDistanceAt(const ofPoint & p) const;
+
+	ofVec3f getWorldCoordinateAt(int cx, int cy) const;
+	ofVec3f getWorldCoordinateAt(float cx, float cy, float wz) const;
+
+	/// see ofxKinect::getPointCloud()
+	void getPointCloud(ofMesh & mesh, int step=1, bool bClip=true, bool bColors=false) const;
+	size_t getPointCloud(float * points, int step=1, bool bClip=true) const;
+
+	/// recorded IR sensor parameters
+	float getZeroPlanePixelSize() const;
+	float getZeroPlaneDistance() const;
+
+/// \section Pixel Data
+
+	ofPixels & getPixels();
+	const ofPixels & getPixels() const;
+
+	ofPixels & getDepthPixels();
+	const ofPixels & getDepthPixels() const;
+	ofShortPixels & getRawDepthPixels();
+	const ofShortPixels & getRawDepthPixels() const;
+
+	ofFloatPixels & getDistancePixels();
+	const ofFloatPixels & getDistancePixels() const;
+
+	ofTexture & getTexture();
+	const ofTexture & getTexture() const;
+
+	ofTexture & getDepthTexture();
+	const ofTexture & getDepthTexture() const;
+
+/// \section Grayscale Depth Value
+
+	/// see ofxKinect::enableDepthNearValueWhite()
+	void enableDepthNearValueWhite(bool bEnabled=true);
+	bool isDepthNearValueWhite() const;
+
+	/// see ofxKinect::setDepthClipping()
+	void setDepthClipping(float nearClip=500, float farClip=4000);
+	float getNearClipping() const;
+	float getFarClipping() const;
+
+/// \section Draw
+
+	void setUseTexture(bool bUse);
+	bool isUsingTexture() const;
+
+	void draw(float x, float y, float w, float h) const;
+	void draw(float x, float y) const;
+
+	void drawDepth(float x, float y, float w, float h) const;
+	void drawDepth(float x, float y) const;
+
+	float getWidth() const;
+	float getHeight() const;
+
+private:
+
+	bool readFrame(int frame);
+	uint64_t readTimestamp(int frame);
+	void updateDepthLookupTable();
+	void updateDepthPixels();
+
+	std::ifstream file;
+	ofxKinectRecorder::Header header;
+	std::streamoff frameSize;
+	int totalNumFrames;
+	int currentFrame;
+	int nextFrame;
+
+	bool bRealtime;
+	bool bLoop;
+	bool bDone;
+	bool bIsFrameNew;
+	uint64_t firstTimestamp;
+	uint64_t frameTimestamp;
+	uint64_t playStartTime;
+
+	ofPixels videoPixels;
+	ofPixels depthPixels;
+	ofShortPixels depthPixelsRaw;
+	ofFloatPixels distancePixels;
+
+	bool bUseTexture;
+	ofTexture depthTex;
+	ofTexture videoTex;
+
+	vector<unsigned char> depthLookupTable;
+	bool bNearWhite;
+	float nearClipping, farClipping;
+
+	ofxKinectPointCloud pointCloud;
+};
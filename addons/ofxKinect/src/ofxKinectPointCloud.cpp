@@ -0,0 +1,222 @@
+/*==============================================================================
+
+    Copyright (c) 2010, 2011 ofxKinect Team
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+    
+==============================================================================*/
+#include "ofxKinectPointCloud.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFX_KINECT_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OFX_KINECT_NEON
+#endif
+
+namespace {
+	// every point is written and the output only advances when it's
+	// inside the range, the buffer is sized for all the points so the
+	// last write never overflows
+	inline size_t convertPoint(float * points, size_t n, float rx, float ry, float z, float minZ, float maxZ) {
+		float * p = points + n * 3;
+		p[0] = rx * z;
+		p[1] = ry * z;
+		p[2] = z;
+		return n + ((z >= minZ) & (z <= maxZ));
+	}
+
+	// Converts 4 consecutive depth pixels at once. The compaction has a
+	// loop carried output index so the compiler can't vectorize it, but
+	// most groups are either all inside the range or all outside, those
+	// are written with 3 vector stores or skipped. Mixed groups fall
+	// back to one point at a time. Returns the number of points written.
+#if defined(OFX_KINECT_SSE2)
+	inline size_t convertPoints4(float * points, size_t n, const float * rx, float ry, const unsigned short * depth, float minZ, float maxZ) {
+		__m128 z = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(depth)), _mm_setzero_si128()));
+		int inside = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(z, _mm_set1_ps(minZ)), _mm_cmple_ps(z, _mm_set1_ps(maxZ))));
+		if(inside == 0) {
+			return n;
+		}
+		if(inside != 0xF) {
+			for(int i = 0; i < 4; i++) {
+				n = convertPoint(points, n, rx[i], ry, depth[i], minZ, maxZ);
+			}
+			return n;
+		}
+		__m128 x = _mm_mul_ps(_mm_loadu_ps(rx), z);
+		__m128 y = _mm_mul_ps(_mm_set1_ps(ry), z);
+		// interleave to x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3
+		__m128 xyLo = _mm_unpacklo_ps(x, y);
+		__m128 xyHi = _mm_unpackhi_ps(x, y);
+		__m128 xzLo = _mm_unpacklo_ps(x, z);
+		__m128 yzLo = _mm_unpacklo_ps(y, z);
+		__m128 yzHi = _mm_unpackhi_ps(y, z);
+		__m128 zxHi = _mm_unpackhi_ps(z, x);
+		float * p = points + n * 3;
+		_mm_storeu_ps(p, _mm_shuffle_ps(xyLo, xzLo, _MM_SHUFFLE(2, 1, 1, 0)));
+		_mm_storeu_ps(p + 4, _mm_shuffle_ps(yzLo, xyHi, _MM_SHUFFLE(1, 0, 3, 2)));
+		_mm_storeu_ps(p + 8, _mm_shuffle_ps(zxHi, yzHi, _MM_SHUFFLE(3, 2, 3, 0)));
+		return n + 4;
+	}
+#elif defined(OFX_KINECT_NEON)
+	inline size_t convertPoints4(float * points, size_t n, const float * rx, float ry, const unsigned short * depth, float minZ, float maxZ) {
+		float32x4_t z = vcvtq_f32_u32(vmovl_u16(vld1_u16(depth)));
+		uint32x4_t inRange = vandq_u32(vcgeq_f32(z, vdupq_n_f32(minZ)), vcleq_f32(z, vdupq_n_f32(maxZ)));
+		uint32x2_t folded = vpmin_u32(vget_low_u32(inRange), vget_high_u32(inRange));
+		bool all = vget_lane_u32(vpmin_u32(folded, folded), 0) != 0;
+		folded = vpmax_u32(vget_low_u32(inRange), vget_high_u32(inRange));
+		bool any = vget_lane_u32(vpmax_u32(folded, folded), 0) != 0;
+		if(!any) {
+			return n;
+		}
+		if(!all) {
+			for(int i = 0; i < 4; i++) {
+				n = convertPoint(points, n, rx[i], ry, depth[i], minZ, maxZ);
+			}
+			return n;
+		}
+		float32x4x3_t xyz;
+		xyz.val[0] = vmulq_f32(vld1q_f32(rx), z);
+		xyz.val[1] = vmulq_n_f32(z, ry);
+		xyz.val[2] = z;
+		vst3q_f32(points + n * 3, xyz);
+		return n + 4;
+	}
+#endif
+}
+
+//--------------------------------------------------------------------
+ofxKinectPointCloud::ofxKinectPointCloud() {
+	width = 0;
+	height = 0;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::setup(float zeroPlanePixelSize, float zeroPlaneDistance, int width, int height) {
+	this->width = width;
+	this->height = height;
+
+	// same as freenect_camera_to_world: the zero plane pixel size is for
+	// a 1280x1024 image that is cropped and scaled by .5 to 640x480
+	double factor = 2.0 * zeroPlanePixelSize / zeroPlaneDistance;
+	rayX.resize(width);
+	for(int x = 0; x < width; x++) {
+		rayX[x] = (x - width / 2) * factor;
+	}
+	rayY.resize(height);
+	for(int y = 0; y < height; y++) {
+		rayY[y] = (y - height / 2) * factor;
+	}
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectPointCloud::isSetup() const {
+	return !rayX.empty();
+}
+
+//--------------------------------------------------------------------
+int ofxKinectPointCloud::getWidth() const {
+	return width;
+}
+
+//--------------------------------------------------------------------
+int ofxKinectPointCloud::getHeight() const {
+	return height;
+}
+
+//--------------------------------------------------------------------
+size_t ofxKinectPointCloud::getMaxNumPoints(int step) const {
+	step = std::max(step, 1);
+	return size_t((width + step - 1) / step) * size_t((height + step - 1) / step);
+}
+
+//--------------------------------------------------------------------
+size_t ofxKinectPointCloud::update(const ofShortPixels & depth, float * points, int step, bool bClip, float nearClip, float farClip) const {
+	if(!isSetup() || depth.getWidth() != width || depth.getHeight() != height || depth.getNumChannels() != 1) {
+		ofLogError("ofxKinectPointCloud") << "update(): depth pixels don't match the " << width << "x" << height << " rays";
+		return 0;
+	}
+	step = std::max(step, 1);
+
+	// 0 means no depth, so it's always outside of the range
+	float minZ = bClip ? std::max(nearClip, 1.f) : 1.f;
+	float maxZ = bClip ? farClip : std::numeric_limits<float>::max();
+
+	const float * rx = rayX.data();
+	size_t n = 0;
+	for(int y = 0; y < height; y += step) {
+		const unsigned short * row = depth.getData() + size_t(y) * width;
+		float ry = rayY[y];
+		int x = 0;
+#if defined(OFX_KINECT_SSE2) || defined(OFX_KINECT_NEON)
+		if(step == 1) {
+			for(; x + 4 <= width; x += 4) {
+				n = convertPoints4(points, n, rx + x, ry, row + x, minZ, maxZ);
+			}
+		}
+#endif
+		for(; x < width; x += step) {
+			n = convertPoint(points, n, rx[x], ry, row[x], minZ, maxZ);
+		}
+	}
+	return n;
+}
+
+//--------------------------------------------------------------------
+void ofxKinectPointCloud::update(const ofShortPixels & depth, ofMesh & mesh, int step, bool bClip, float nearClip, float farClip, const ofPixels * colors) const {
+	mesh.setMode(OF_PRIMITIVE_POINTS);
+	auto & vertices = mesh.getVertices();
+	vertices.resize(getMaxNumPoints(step));
+	size_t n = update(depth, reinterpret_cast<float*>(vertices.data()), step, bClip, nearClip, farClip);
+	vertices.resize(n);
+
+	if(colors == nullptr) {
+		mesh.clearColors();
+		return;
+	}
+	if(colors->getWidth() != width || colors->getHeight() != height) {
+		ofLogError("ofxKinectPointCloud") << "update(): color pixels don't match the depth pixels";
+		mesh.clearColors();
+		return;
+	}
+
+	// second pass with the same test as the points so they stay in sync
+	step = std::max(step, 1);
+	float minZ = bClip ? std::max(nearClip, 1.f) : 1.f;
+	float maxZ = bClip ? farClip : std::numeric_limits<float>::max();
+	size_t channels = colors->getNumChannels();
+	size_t green = (channels - 1) / 2;
+	size_t blue = channels - 1;
+	auto & meshColors = mesh.getColors();
+	meshColors.resize(n);
+	size_t i = 0;
+	for(int y = 0; y < height; y += step) {
+		const unsigned short * row = depth.getData() + size_t(y) * width;
+		const unsigned char * colorRow = colors->getData() + size_t(y) * width * channels;
+		for(int x = 0; x < width; x += step) {
+			float z = row[x];
+			if(z >= minZ && z <= maxZ) {
+				const unsigned char * c = colorRow + x * channels;
+				meshColors[i++].set(c[0] / 255.f, c[green] / 255.f, c[blue] / 255.f, 1.f);
+			}
+		}
+	}
+}
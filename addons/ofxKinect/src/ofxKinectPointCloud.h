@@ -0,0 +1,77 @@
+/*==============================================================================
+
+    Copyright (c) 2010, 2011 ofxKinect Team
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+    
+==============================================================================*/
+#pragma once
+
+#include "ofMain.h"
+
+/// \class ofxKinectPointCloud
+///
+/// converts whole depth frames to world coordinates
+///
+/// the kinect projection is separable so the ray through every depth pixel
+/// is precomputed once as a per column and a per row factor, converting a
+/// frame is then 2 multiplies per point written straight into a float
+/// buffer or mesh instead of a freenect_camera_to_world call per pixel,
+/// without decimation 4 pixels are converted at a time with SSE2 or NEON
+///
+/// the results are the same as ofxKinect::getWorldCoordinateAt()
+///
+class ofxKinectPointCloud {
+
+public:
+
+	ofxKinectPointCloud();
+
+	/// precompute the rays for a depth image of the given size from the
+	/// IR sensor parameters, see ofxKinect::getZeroPlanePixelSize() and
+	/// ofxKinect::getZeroPlaneDistance()
+	void setup(float zeroPlanePixelSize, float zeroPlaneDistance, int width=640, int height=480);
+	bool isSetup() const;
+
+	int getWidth() const;
+	int getHeight() const;
+
+	/// max number of points a frame can produce when skipping step pixels
+	size_t getMaxNumPoints(int step=1) const;
+
+	/// convert a depth frame in millimeters into xyz triples
+	///
+	/// every step pixels in x and y are converted, pixels without depth are
+	/// always dropped and if bClip is true so are the ones outside of
+	/// nearClip - farClip, points has to hold 3 * getMaxNumPoints(step) floats
+	///
+	/// returns the number of points written
+	size_t update(const ofShortPixels & depth, float * points, int step=1, bool bClip=false, float nearClip=0, float farClip=0) const;
+
+	/// same as above but replaces the vertices of the mesh, if colors is
+	/// not null the color of every point is taken from the same pixel
+	void update(const ofShortPixels & depth, ofMesh & mesh, int step=1, bool bClip=false, float nearClip=0, float farClip=0, const ofPixels * colors=nullptr) const;
+
+private:
+
+	int width;
+	int height;
+	std::vector<float> rayX; ///< world x for each column at 1mm depth
+	std::vector<float> rayY; ///< world y for each row at 1mm depth
+};
@@ -0,0 +1,124 @@
+/*==============================================================================
+
+    Copyright (c) 2010, 2011 ofxKinect Team
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+    
+==============================================================================*/
+#include "ofxKinectRecorder.h"
+#include "ofxKinect.h"
+
+const char ofxKinectRecorder::magic[8] = {'O','F','X','K','N','C','T','1'};
+
+//--------------------------------------------------------------------
+ofxKinectRecorder::ofxKinectRecorder() {
+	header = {};
+	numFrames = 0;
+}
+
+//--------------------------------------------------------------------
+ofxKinectRecorder::~ofxKinectRecorder() {
+	close();
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectRecorder::open(const of::filesystem::path & filename, int width, int height, int videoChannels, float zeroPlanePixelSize, float zeroPlaneDistance) {
+	close();
+
+	if(width <= 0 || height <= 0 || (videoChannels != 0 && videoChannels != 1 && videoChannels != 3)) {
+		ofLogError("ofxKinectRecorder") << "open(): unsupported size " << width << "x" << height << " or " << videoChannels << " video channels";
+		return false;
+	}
+
+	file.open(ofToDataPath(filename), std::ios::binary | std::ios::trunc);
+	if(!file.is_open()) {
+		ofLogError("ofxKinectRecorder") << "open(): couldn't open " << filename;
+		return false;
+	}
+
+	std::copy(magic, magic + sizeof(magic), header.magic);
+	header.width = width;
+	header.height = height;
+	header.videoChannels = videoChannels;
+	header.zeroPlanePixelSize = zeroPlanePixelSize;
+	header.zeroPlaneDistance = zeroPlaneDistance;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	numFrames = 0;
+	return file.good();
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectRecorder::open(const of::filesystem::path & filename, const ofxKinect & kinect, bool bVideo) {
+	if(!kinect.isConnected()) {
+		ofLogError("ofxKinectRecorder") << "open(): the kinect has to be connected to read its sensor parameters";
+		return false;
+	}
+	int videoChannels = bVideo ? kinect.getPixels().getNumChannels() : 0;
+	return open(filename, kinect.getWidth(), kinect.getHeight(), videoChannels, kinect.getZeroPlanePixelSize(), kinect.getZeroPlaneDistance());
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectRecorder::addFrame(const ofShortPixels & depth, const ofPixels & video, uint64_t timestamp) {
+	if(!isOpen()) {
+		ofLogError("ofxKinectRecorder") << "addFrame(): recording not open";
+		return false;
+	}
+	if(depth.getWidth() != size_t(header.width) || depth.getHeight() != size_t(header.height) || depth.getNumChannels() != 1) {
+		ofLogError("ofxKinectRecorder") << "addFrame(): depth pixels don't match the recording size";
+		return false;
+	}
+	if(header.videoChannels > 0 && (video.getWidth() != size_t(header.width) || video.getHeight() != size_t(header.height) || video.getNumChannels() != size_t(header.videoChannels))) {
+		ofLogError("ofxKinectRecorder") << "addFrame(): video pixels don't match the recording format";
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+	file.write(reinterpret_cast<const char*>(depth.getData()), depth.getTotalBytes());
+	if(header.videoChannels > 0) {
+		file.write(reinterpret_cast<const char*>(video.getData()), video.getTotalBytes());
+	}
+	if(!file.good()) {
+		ofLogError("ofxKinectRecorder") << "addFrame(): couldn't write frame " << numFrames;
+		return false;
+	}
+	numFrames++;
+	return true;
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectRecorder::addFrame(const ofxKinect & kinect) {
+	return addFrame(kinect.getRawDepthPixels(), kinect.getPixels(), ofGetElapsedTimeMicros());
+}
+
+//--------------------------------------------------------------------
+void ofxKinectRecorder::close() {
+	if(file.is_open()) {
+		file.close();
+	}
+}
+
+//--------------------------------------------------------------------
+bool ofxKinectRecorder::isOpen() const {
+	return file.is_open();
+}
+
+//--------------------------------------------------------------------
+int ofxKinectRecorder::getNumFrames() const {
+	return numFrames;
+}
@@ -0,0 +1,85 @@
+/*==============================================================================
+
+    Copyright (c) 2010, 2011 ofxKinect Team
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+    
+==============================================================================*/
+#pragma once
+
+#include "ofMain.h"
+
+class ofxKinect;
+
+/// \class ofxKinectRecorder
+///
+/// records raw depth and video frames to a file that can be played back
+/// with ofxKinectPlayer, useful to work, test and benchmark without a
+/// kinect plugged in
+///
+/// the file has a small header with the image size and the IR sensor
+/// parameters followed by fixed size frames: a timestamp in microseconds,
+/// the raw depth in millimeters and optionally the video pixels
+///
+class ofxKinectRecorder {
+
+public:
+
+	ofxKinectRecorder();
+	~ofxKinectRecorder();
+
+	/// start a new recording, videoChannels is 0 to only record depth,
+	/// 1 for infrared or 3 for rgb video
+	bool open(const of::filesystem::path & filename, int width, int height, int videoChannels, float zeroPlanePixelSize, float zeroPlaneDistance);
+
+	/// start a new recording with the size and parameters of a connected kinect
+	bool open(const of::filesystem::path & filename, const ofxKinect & kinect, bool bVideo=true);
+
+	/// add a frame, video is ignored when only recording depth
+	///
+	/// the timestamp is only used to play back at the recorded speed
+	bool addFrame(const ofShortPixels & depth, const ofPixels & video, uint64_t timestamp);
+
+	/// add the current frame of a kinect stamped with ofGetElapsedTimeMicros()
+	bool addFrame(const ofxKinect & kinect);
+
+	void close();
+	bool isOpen() const;
+
+	/// number of frames added since open()
+	int getNumFrames() const;
+
+	/// format identifier at the start of every recording
+	static const char magic[8];
+
+	struct Header {
+		char magic[8];
+		int32_t width;
+		int32_t height;
+		int32_t videoChannels;
+		float zeroPlanePixelSize;
+		float zeroPlaneDistance;
+	};
+
+private:
+
+	std::ofstream file;
+	Header header;
+	int numFrames;
+};
@@ -0,0 +1,355 @@
+
+#include "ofxCvBlobFinder.h"
+
+
+
+// 8 neighbours clockwise starting east, y grows downwards
+static const int dirX[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+static const int dirY[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+
+// stripes thinner than this aren't worth a thread
+static const int minStripeHeight = 32;
+
+
+//--------------------------------------------------------------------------------
+static uint32_t findRoot( std::vector<uint32_t>& parent, uint32_t label ) {
+	while( parent[label] != label ) {
+		parent[label] = parent[parent[label]];
+		label = parent[label];
+	}
+	return label;
+}
+
+//--------------------------------------------------------------------------------
+// the smallest label is always kept as the root so it's also the one whose
+// first pixel comes first in raster order
+static uint32_t unite( std::vector<uint32_t>& parent, uint32_t a, uint32_t b ) {
+	a = findRoot(parent, a);
+	b = findRoot(parent, b);
+	if( a < b ) {
+		parent[b] = a;
+		return a;
+	} else {
+		parent[a] = b;
+		return b;
+	}
+}
+
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvBlobFinder::ofxCvBlobFinder() {
+	threshold = 0;
+	numThreads = 1;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::setThreshold( unsigned char _threshold ) {
+	threshold = _threshold;
+}
+
+//--------------------------------------------------------------------------------
+unsigned char ofxCvBlobFinder::getThreshold() const {
+	return threshold;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::setNumThreads( int _numThreads ) {
+	numThreads = std::max(1, _numThreads);
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::getNumThreads() const {
+	return numThreads;
+}
+
+//--------------------------------------------------------------------------------
+const std::vector<uint32_t>& ofxCvBlobFinder::getLabels() const {
+	return labels;
+}
+
+//--------------------------------------------------------------------------------
+uint32_t ofxCvBlobFinder::getLabel( size_t blob ) const {
+	return blob < blobLabels.size() ? blobLabels[blob] : 0;
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::findBlobs( const ofPixels& input,
+								int minArea,
+								int maxArea,
+								int nConsidered,
+								bool bFindContours,
+								bool bUseApproximation ) {
+	if( input.getNumChannels() != 1 ) {
+		ofLogError("ofxCvBlobFinder") << "findBlobs(): expected single channel pixels, got "
+			<< input.getNumChannels() << " channels";
+		reset();
+		return 0;
+	}
+	return findBlobs( input.getData(), input.getWidth(), input.getHeight(), input.getWidth(),
+					  minArea, maxArea, nConsidered, bFindContours, bUseApproximation );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::findContours( ofxCvGrayscaleImage& input,
+								   int minArea,
+								   int maxArea,
+								   int nConsidered,
+								   bool bFindHoles,
+								   bool bUseApproximation ) {
+	// read straight from the IplImage, honoring the ROI like cvFindContours
+	// does, instead of syncing the ofPixels copy
+	IplImage* img = input.getCvImage();
+	ofRectangle roi = input.getIntersectionROI( input.getROI(), ofRectangle(0, 0, img->width, img->height) );
+	const unsigned char* data = (const unsigned char*)img->imageData
+		+ (size_t)roi.y * img->widthStep + (size_t)roi.x;
+	int found = findBlobs( data, roi.width, roi.height, img->widthStep,
+						   minArea, maxArea, nConsidered, true, bUseApproximation );
+	// the points are relative to the ROI but draw() scales by the whole
+	// image, like the contour finder
+	_width = img->width;
+	_height = img->height;
+	return found;
+}
+
+//--------------------------------------------------------------------------------
+template<typename F>
+void ofxCvBlobFinder::forEachStripe( F && f ) {
+	workers.run( stripes.size(), [&]( size_t i ){ f( stripes[i] ); } );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::findBlobs( const unsigned char* data,
+								int width,
+								int height,
+								size_t stride,
+								int minArea,
+								int maxArea,
+								int nConsidered,
+								bool bFindContours,
+								bool bUseApproximation ) {
+	_width = width;
+	_height = height;
+	reset();
+	blobLabels.clear();
+	labels.resize( (size_t)width * height );
+	if( width <= 0 || height <= 0 ) {
+		return 0;
+	}
+
+	// label every stripe independently, each one with its own union find
+	int nStripes = std::max( 1, std::min( numThreads, height / minStripeHeight ) );
+	stripes.resize( nStripes );
+	for( int i = 0; i < nStripes; i++ ) {
+		stripes[i].y0 = height * i / nStripes;
+		stripes[i].y1 = height * (i + 1) / nStripes;
+	}
+	forEachStripe( [&]( Stripe& stripe ){ labelStripe( stripe, data, stride ); } );
+
+	// concatenate the union finds and join components across stripe borders
+	uint32_t total = 0;
+	for( auto & stripe : stripes ) {
+		stripe.offset = total;
+		total += stripe.parent.size();
+	}
+	parent.resize( total );
+	for( auto & stripe : stripes ) {
+		for( size_t i = 0; i < stripe.parent.size(); i++ ) {
+			parent[stripe.offset + i] = stripe.offset + stripe.parent[i];
+		}
+	}
+	for( int i = 1; i < nStripes; i++ ) {
+		const uint32_t* row = labels.data() + (size_t)stripes[i].y0 * width;
+		const uint32_t* above = row - width;
+		for( int x = 0; x < width; x++ ) {
+			if( !row[x] ) continue;
+			for( int nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); nx++ ) {
+				if( above[nx] ) {
+					unite( parent, stripes[i].offset + row[x], stripes[i - 1].offset + above[nx] );
+				}
+			}
+		}
+	}
+
+	// roots always come before their children so a single pass in label
+	// order can number the components and sum their accumulators
+	components.clear();
+	finalLabels.assign( total, 0 );
+	for( auto & stripe : stripes ) {
+		for( uint32_t i = 1; i < stripe.parent.size(); i++ ) {
+			uint32_t label = stripe.offset + i;
+			uint32_t root = findRoot( parent, label );
+			const Accumulator& acc = stripe.accumulators[i];
+			if( root == label ) {
+				components.push_back( acc );
+				finalLabels[label] = components.size();
+			} else {
+				finalLabels[label] = finalLabels[root];
+				Accumulator& component = components[finalLabels[root] - 1];
+				component.area += acc.area;
+				component.sumX += acc.sumX;
+				component.sumY += acc.sumY;
+				component.minX = std::min( component.minX, acc.minX );
+				component.minY = std::min( component.minY, acc.minY );
+				component.maxX = std::max( component.maxX, acc.maxX );
+				component.maxY = std::max( component.maxY, acc.maxY );
+			}
+		}
+	}
+	forEachStripe( [&]( Stripe& stripe ){ relabelStripe( stripe ); } );
+
+	// keep the nConsidered biggest blobs in the area range
+	candidates.clear();
+	for( uint32_t i = 0; i < components.size(); i++ ) {
+		float area = components[i].area;
+		if( area > minArea && area < maxArea ) {
+			candidates.push_back( i );
+		}
+	}
+	size_t nBlobsFound = std::min( (size_t)std::max(0, nConsidered), candidates.size() );
+	std::partial_sort( candidates.begin(), candidates.begin() + nBlobsFound, candidates.end(),
+		[this]( uint32_t a, uint32_t b ){ return components[a].area > components[b].area; } );
+
+	blobs.resize( nBlobsFound );
+	blobLabels.resize( nBlobsFound );
+	for( size_t i = 0; i < nBlobsFound; i++ ) {
+		const Accumulator& component = components[candidates[i]];
+		ofxCvBlob& blob = blobs[i];
+		blob.area                = component.area;
+		blob.boundingRect.x      = component.minX;
+		blob.boundingRect.y      = component.minY;
+		blob.boundingRect.width  = component.maxX - component.minX + 1;
+		blob.boundingRect.height = component.maxY - component.minY + 1;
+		blob.centroid.x          = double(component.sumX) / component.area;
+		blob.centroid.y          = double(component.sumY) / component.area;
+		blob.hole                = false;
+		blob.length              = 0;
+		blob.pts.clear();
+		blobLabels[i] = candidates[i] + 1;
+		if( bFindContours ) {
+			traceContour( blob, blobLabels[i], component.firstX, component.firstY, bUseApproximation );
+		}
+		blob.nPts = blob.pts.size();
+	}
+
+	nBlobs = blobs.size();
+	return nBlobs;
+}
+
+//--------------------------------------------------------------------------------
+// Labels whole runs of foreground pixels at once against the runs of the
+// previous row, 8-connected runs overlap or touch diagonally.
+void ofxCvBlobFinder::labelStripe( Stripe& stripe, const unsigned char* data, size_t stride ) {
+	stripe.parent.assign( 1, 0 );
+	stripe.accumulators.resize( 1 );
+	stripe.previousRuns.clear();
+
+	for( int y = stripe.y0; y < stripe.y1; y++ ) {
+		const unsigned char* row = data + (size_t)y * stride;
+		uint32_t* labelRow = labels.data() + (size_t)y * _width;
+		stripe.runs.clear();
+		auto previous = stripe.previousRuns.begin();
+
+		int x = 0;
+		while( x < _width ) {
+			int gap = x;
+			while( x < _width && row[x] <= threshold ) {
+				x++;
+			}
+			std::fill( labelRow + gap, labelRow + x, 0 );
+			if( x == _width ) break;
+			int start = x;
+			while( x < _width && row[x] > threshold ) {
+				x++;
+			}
+			int end = x;
+
+			uint32_t label = 0;
+			while( previous != stripe.previousRuns.end() && previous->end < start ) {
+				++previous;
+			}
+			for( auto run = previous; run != stripe.previousRuns.end() && run->start <= end; ++run ) {
+				label = label ? unite( stripe.parent, label, run->label ) : findRoot( stripe.parent, run->label );
+			}
+
+			if( !label ) {
+				label = stripe.parent.size();
+				stripe.parent.push_back( label );
+				stripe.accumulators.push_back( { 0, 0, 0, start, y, end - 1, y, start, y } );
+			}
+
+			Accumulator& acc = stripe.accumulators[label];
+			uint64_t n = end - start;
+			acc.area += n;
+			acc.sumX += n * (uint64_t)(start + end - 1) / 2;
+			acc.sumY += n * (uint64_t)y;
+			acc.minX = std::min( acc.minX, start );
+			acc.maxX = std::max( acc.maxX, end - 1 );
+			acc.maxY = y;
+
+			std::fill( labelRow + start, labelRow + end, label );
+			stripe.runs.push_back( { start, end, label } );
+		}
+		std::swap( stripe.previousRuns, stripe.runs );
+	}
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::relabelStripe( const Stripe& stripe ) {
+	uint32_t* label = labels.data() + (size_t)stripe.y0 * _width;
+	uint32_t* end = labels.data() + (size_t)stripe.y1 * _width;
+	const uint32_t* finals = finalLabels.data() + stripe.offset;
+	for( ; label != end; ++label ) {
+		if( *label ) {
+			*label = finals[*label];
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------
+// Moore neighbour tracing of the outer boundary, clockwise from the first
+// pixel in raster order, stopping when the first move repeats (Jacob's
+// criterion). With approximation only the pixels where the direction
+// changes are kept, like CV_CHAIN_APPROX_SIMPLE.
+void ofxCvBlobFinder::traceContour( ofxCvBlob& blob, uint32_t label, int firstX, int firstY, bool bUseApproximation ) {
+	auto inside = [&]( int x, int y ) {
+		return x >= 0 && y >= 0 && x < _width && y < _height && labels[(size_t)y * _width + x] == label;
+	};
+
+	int x = firstX;
+	int y = firstY;
+	int search = 0; // west, north west, north and north east can't be set
+	int firstDir = -1;
+	int previousDir = -1;
+	size_t maxSteps = 4 * (size_t)blob.area + 8;
+	for( size_t step = 0; step < maxSteps; step++ ) {
+		int dir = -1;
+		for( int i = 0; i < 8; i++ ) {
+			int d = (search + i) % 8;
+			if( inside( x + dirX[d], y + dirY[d] ) ) {
+				dir = d;
+				break;
+			}
+		}
+		if( dir == -1 ) {
+			blob.pts.push_back( ofDefaultVec3( x, y, 0 ) );
+			break;
+		}
+		if( x == firstX && y == firstY && dir == firstDir ) {
+			break;
+		}
+		if( firstDir == -1 ) {
+			firstDir = dir;
+		}
+		if( !bUseApproximation || dir != previousDir ) {
+			blob.pts.push_back( ofDefaultVec3( x, y, 0 ) );
+		}
+		blob.length += (dir & 1) ? 1.41421356f : 1.f;
+		previousDir = dir;
+		x += dirX[dir];
+		y += dirY[dir];
+		// restart the search at the last background pixel checked
+		search = (dir & 1) ? (dir + 5) % 8 : (dir + 6) % 8;
+	}
+}
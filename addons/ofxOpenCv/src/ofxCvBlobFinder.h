@@ -0,0 +1,117 @@
+/*
+* ofxCvBlobFinder.h
+*
+* Finds white blobs in 8 bit single channel images using a single pass,
+* run based connected component labeling. Area, centroid and bounding box
+* are accumulated while labeling and only the blobs that end up in the
+* result get their outer contour traced, so there's no copy of the input,
+* no CvMemStorage and no per blob moments pass.
+*
+* The image can be split in horizontal stripes that are labeled in
+* parallel. The threads and every buffer are kept from one frame to the
+* next.
+*
+* It can be used anywhere an ofxCvContourFinder is used, with these
+* differences:
+* - holes are never reported
+* - area is the number of pixels of the blob, the contour finder reports
+*   the area of the contour polygon, which goes through the centers of the
+*   border pixels so it's smaller, roughly by half the perimeter. minArea,
+*   maxArea and the sorting use the pixel count too
+* - the centroid is the mean of the blob pixels instead of the centroid of
+*   the contour polygon
+* Positions are relative to the ROI and findContours() reports the size of
+* the whole image for drawing, like the contour finder does.
+*
+*/
+
+#pragma once
+
+#include "ofxCvContourFinder.h"
+#include "ofxCvStripeWorkers.h"
+
+class ofxCvBlobFinder : public ofxCvContourFinder {
+
+  public:
+
+    ofxCvBlobFinder();
+
+    // pixels brighter than the threshold belong to a blob, 0 by default
+    void setThreshold( unsigned char threshold );
+    unsigned char getThreshold() const;
+
+    // number of stripes labeled in parallel, 1 labels on the calling thread
+    void setNumThreads( int numThreads );
+    int getNumThreads() const;
+
+    virtual int  findBlobs( const ofPixels& input,
+                            int minArea, int maxArea,
+                            int nConsidered,
+                            bool bFindContours = true,
+                            bool bUseApproximation = true );
+
+    // bFindHoles is ignored, only outer contours are traced
+    virtual int  findContours( ofxCvGrayscaleImage& input,
+                               int minArea, int maxArea,
+                               int nConsidered, bool bFindHoles,
+                               bool bUseApproximation = true );
+
+    // label of every pixel of the last image, or of its ROI, 0 is the
+    // background
+    const std::vector<uint32_t>& getLabels() const;
+
+    // value of blobs[i] in the label image
+    uint32_t getLabel( size_t blob ) const;
+
+
+  protected:
+
+    // raster order accumulators, the first pixel is where tracing starts
+    struct Accumulator {
+        uint64_t area;
+        uint64_t sumX;
+        uint64_t sumY;
+        int minX, minY, maxX, maxY;
+        int firstX, firstY;
+    };
+
+    struct Run {
+        int start;
+        int end;
+        uint32_t label;
+    };
+
+    struct Stripe {
+        int y0;
+        int y1;
+        uint32_t offset;
+        std::vector<uint32_t> parent;
+        std::vector<Accumulator> accumulators;
+        std::vector<Run> previousRuns;
+        std::vector<Run> runs;
+    };
+
+    int findBlobs( const unsigned char* data, int width, int height, size_t stride,
+                   int minArea, int maxArea, int nConsidered,
+                   bool bFindContours, bool bUseApproximation );
+
+    void labelStripe( Stripe& stripe, const unsigned char* data, size_t stride );
+    void relabelStripe( const Stripe& stripe );
+    void traceContour( ofxCvBlob& blob, uint32_t label, int firstX, int firstY, bool bUseApproximation );
+
+    template<typename F>
+    void forEachStripe( F && f );
+
+    unsigned char threshold;
+    int numThreads;
+
+    std::vector<Stripe> stripes;
+    std::vector<uint32_t> labels;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> finalLabels;
+    std::vector<Accumulator> components;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> blobLabels;
+    ofxCvStripeWorkers workers;
+
+};
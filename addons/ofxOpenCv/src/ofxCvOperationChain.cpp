@@ -0,0 +1,337 @@
+
+#include "ofxCvOperationChain.h"
+
+
+
+// row segments are processed in chunks of this many values so the scratch
+// buffer and the operand rows stay in L1 while every operation runs on them
+static const int tileSize = 1024;
+
+// stripes thinner than this aren't worth a thread
+static const int minStripeHeight = 16;
+
+
+//--------------------------------------------------------------------------------
+static inline float saturate( float v ) {
+	return v < 0.f ? 0.f : (v > 255.f ? 255.f : v);
+}
+
+//--------------------------------------------------------------------------------
+// like cvRound + saturate_cast<uchar>, adding and removing 1.5 * 2^23 rounds
+// half to even the same way without a libm call so the loops vectorize.
+// Don't build this file with -ffast-math.
+static inline float roundSaturate( float v ) {
+	return (saturate(v) + 12582912.f) - 12582912.f;
+}
+
+
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain::ofxCvOperationChain() {
+	bCompiled = false;
+	numThreads = 1;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::push( Type type, float value, ofxCvImage* image ) {
+	operations.push_back( { type, value, image } );
+	bCompiled = false;
+	return *this;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::add( float value ) {
+	return push( ADD_SCALAR, value, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::subtract( float value ) {
+	return push( SUBTRACT_SCALAR, value, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::multiply( float value ) {
+	return push( MULTIPLY_SCALAR, value, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::add( ofxCvImage& mom ) {
+	return push( ADD_IMAGE, 0, &mom );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::subtract( ofxCvImage& mom ) {
+	return push( SUBTRACT_IMAGE, 0, &mom );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::multiply( ofxCvImage& mom ) {
+	return push( MULTIPLY_IMAGE, 0, &mom );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::bitwiseAnd( ofxCvImage& mom ) {
+	return push( AND_IMAGE, 0, &mom );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::absDiff( ofxCvImage& mom ) {
+	return push( ABS_DIFF_IMAGE, 0, &mom );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::threshold( int value, bool invert ) {
+	return push( invert ? THRESHOLD_INVERTED : THRESHOLD, value, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::invert() {
+	return push( INVERT, 0, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::erode() {
+	return push( ERODE, 0, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::dilate() {
+	return push( DILATE, 0, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::blur( int value ) {
+	return push( BLUR, value, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+ofxCvOperationChain& ofxCvOperationChain::blurGaussian( int value ) {
+	return push( BLUR_GAUSSIAN, value, nullptr );
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvOperationChain::clear() {
+	operations.clear();
+	segments.clear();
+	bCompiled = false;
+}
+
+//--------------------------------------------------------------------------------
+size_t ofxCvOperationChain::size() const {
+	return operations.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvOperationChain::setNumThreads( int _numThreads ) {
+	numThreads = std::max( 1, _numThreads );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvOperationChain::getNumThreads() const {
+	return numThreads;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvOperationChain::isPixelOperation( Type type ) {
+	return type != ERODE && type != DILATE && type != BLUR && type != BLUR_GAUSSIAN;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvOperationChain::compile() {
+	segments.clear();
+	size_t i = 0;
+	while( i < operations.size() ) {
+		Segment segment;
+		segment.begin = i;
+		segment.fused = isPixelOperation( operations[i].type );
+		segment.usesImages = false;
+		if( segment.fused ) {
+			while( i < operations.size() && isPixelOperation( operations[i].type ) ) {
+				segment.usesImages |= operations[i].image != nullptr;
+				i++;
+			}
+		} else {
+			i++;
+		}
+		segment.end = i;
+
+		// without other images every operation only depends on the
+		// value of the pixel so the whole segment folds into a table
+		if( segment.fused && !segment.usesImages ) {
+			float values[256];
+			for( int v = 0; v < 256; v++ ) {
+				values[v] = v;
+			}
+			applyPixelOperations( values, 256, segment.begin, segment.end, nullptr );
+			for( int v = 0; v < 256; v++ ) {
+				segment.lut[v] = (unsigned char)values[v];
+			}
+		}
+		segments.push_back( segment );
+	}
+	bCompiled = true;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvOperationChain::checkOperand( const ofxCvImage& image, const ofxCvImage& mom ) const {
+	if( !mom.bAllocated ) {
+		ofLogError("ofxCvOperationChain") << "apply(): operand image not allocated";
+		return false;
+	}
+	const IplImage* img = image.getCvImage();
+	const IplImage* momImg = mom.getCvImage();
+	if( momImg->nChannels != img->nChannels || momImg->depth != img->depth ) {
+		ofLogError("ofxCvOperationChain") << "apply(): operand image type mismatch";
+		return false;
+	}
+	ofRectangle roi = image.getROI();
+	ofRectangle momRoi = mom.getROI();
+	if( roi.width != momRoi.width || roi.height != momRoi.height ) {
+		ofLogError("ofxCvOperationChain") << "apply(): operand region of interest mismatch";
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+// Every operation runs over the whole tile before the next one so the
+// loops are simple enough for the compiler to vectorize, __restrict tells
+// it the operand rows never alias the scratch buffer. Values are
+// saturated after each step so results match running them one by one.
+void ofxCvOperationChain::applyPixelOperations( float* __restrict values, size_t n, size_t begin, size_t end,
+												const unsigned char* const* operands ) const {
+	for( size_t op = begin; op < end; op++ ) {
+		const Operation& operation = operations[op];
+		const unsigned char* __restrict mom = operands ? operands[op - begin] : nullptr;
+		const float value = operation.value;
+		switch( operation.type ) {
+			case ADD_SCALAR:
+				for( size_t i = 0; i < n; i++ ) values[i] = roundSaturate( values[i] + value );
+				break;
+			case SUBTRACT_SCALAR:
+				for( size_t i = 0; i < n; i++ ) values[i] = roundSaturate( values[i] - value );
+				break;
+			case MULTIPLY_SCALAR:
+				for( size_t i = 0; i < n; i++ ) values[i] = roundSaturate( values[i] * value );
+				break;
+			case ADD_IMAGE:
+				for( size_t i = 0; i < n; i++ ) values[i] = saturate( values[i] + mom[i] );
+				break;
+			case SUBTRACT_IMAGE:
+				for( size_t i = 0; i < n; i++ ) values[i] = saturate( values[i] - mom[i] );
+				break;
+			case MULTIPLY_IMAGE:
+				for( size_t i = 0; i < n; i++ ) values[i] = roundSaturate( values[i] * mom[i] * (1.f / 255.f) );
+				break;
+			case AND_IMAGE:
+				for( size_t i = 0; i < n; i++ ) values[i] = float( (unsigned char)values[i] & mom[i] );
+				break;
+			case ABS_DIFF_IMAGE:
+				for( size_t i = 0; i < n; i++ ) values[i] = std::abs( values[i] - mom[i] );
+				break;
+			case THRESHOLD:
+				for( size_t i = 0; i < n; i++ ) values[i] = values[i] > value ? 255.f : 0.f;
+				break;
+			case THRESHOLD_INVERTED:
+				for( size_t i = 0; i < n; i++ ) values[i] = values[i] > value ? 0.f : 255.f;
+				break;
+			case INVERT:
+				for( size_t i = 0; i < n; i++ ) values[i] = 255.f - values[i];
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvOperationChain::runStripe( const Segment& segment, ofxCvImage& image, int y0, int y1 ) {
+	IplImage* img = image.getCvImage();
+	ofRectangle roi = image.getROI();
+	const size_t rowLength = (size_t)roi.width * img->nChannels;
+
+	if( !segment.usesImages ) {
+		for( int y = y0; y < y1; y++ ) {
+			unsigned char* row = (unsigned char*)img->imageData
+				+ (size_t)(roi.y + y) * img->widthStep + (size_t)roi.x * img->nChannels;
+			for( size_t i = 0; i < rowLength; i++ ) {
+				row[i] = segment.lut[row[i]];
+			}
+		}
+		return;
+	}
+
+	float values[tileSize];
+	std::vector<const unsigned char*> operands( segment.end - segment.begin, nullptr );
+	for( int y = y0; y < y1; y++ ) {
+		unsigned char* row = (unsigned char*)img->imageData
+			+ (size_t)(roi.y + y) * img->widthStep + (size_t)roi.x * img->nChannels;
+		for( size_t x = 0; x < rowLength; x += tileSize ) {
+			size_t n = std::min( (size_t)tileSize, rowLength - x );
+			for( size_t op = segment.begin; op < segment.end; op++ ) {
+				ofxCvImage* mom = operations[op].image;
+				if( mom ) {
+					const IplImage* momImg = mom->getCvImage();
+					ofRectangle momRoi = mom->getROI();
+					operands[op - segment.begin] = (const unsigned char*)momImg->imageData
+						+ (size_t)(momRoi.y + y) * momImg->widthStep + (size_t)momRoi.x * momImg->nChannels + x;
+				}
+			}
+			for( size_t i = 0; i < n; i++ ) {
+				values[i] = row[x + i];
+			}
+			applyPixelOperations( values, n, segment.begin, segment.end, operands.data() );
+			for( size_t i = 0; i < n; i++ ) {
+				row[x + i] = (unsigned char)values[i];
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvOperationChain::runSegment( const Segment& segment, ofxCvImage& image ) {
+	if( !segment.fused ) {
+		const Operation& operation = operations[segment.begin];
+		switch( operation.type ) {
+			case ERODE: image.erode(); break;
+			case DILATE: image.dilate(); break;
+			case BLUR: image.blur( operation.value ); break;
+			case BLUR_GAUSSIAN: image.blurGaussian( operation.value ); break;
+			default: break;
+		}
+		return;
+	}
+
+	int height = image.getROI().height;
+	int nStripes = std::max( 1, std::min( numThreads, height / minStripeHeight ) );
+	workers.run( nStripes, [&]( size_t i ){
+		runStripe( segment, image, height * i / nStripes, height * (i + 1) / nStripes );
+	} );
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvOperationChain::apply( ofxCvImage& image ) {
+	if( !image.bAllocated ) {
+		ofLogError("ofxCvOperationChain") << "apply(): image not allocated";
+		return false;
+	}
+	if( image.getCvImage()->depth != IPL_DEPTH_8U ) {
+		ofLogError("ofxCvOperationChain") << "apply(): only 8 bit images are supported";
+		return false;
+	}
+	for( auto & operation : operations ) {
+		if( operation.image && !checkOperand( image, *operation.image ) ) {
+			return false;
+		}
+	}
+	if( !bCompiled ) {
+		compile();
+	}
+	for( auto & segment : segments ) {
+		runSegment( segment, image );
+	}
+	image.flagImageChanged();
+	return true;
+}
@@ -0,0 +1,116 @@
+/*
+* ofxCvOperationChain.h
+*
+* Records a sequence of operations on an 8 bit ofxCvImage and applies them
+* all at once. Consecutive per pixel operations are fused into a single
+* pass over the image instead of one pass plus a temp buffer swap each:
+* chains that only use constants are folded into a lookup table and chains
+* that read other images are run tile by tile so every row segment stays
+* in cache while all the operations are applied to it. Filters that need
+* neighbouring pixels (erode, dilate, blur) split the chain and run as
+* usual. The image is flagged as changed only once at the end so pixels
+* and texture are synced once, and the same chain can be applied every
+* frame.
+*
+* Results are the same as calling the equivalent ofxCvGrayscaleImage or
+* ofxCvColorImage methods one after another. Scalar operations apply to
+* every channel, like ofxCvColorImage's += and -= do. The generic
+* ofxCvImage::operator+= ( float ) and -= only change the first channel,
+* so other multi channel ofxCvImage subclasses can differ. multiply( float )
+* and threshold() have no 8 bit color equivalent and also apply to every
+* channel.
+*
+* Stripes run on threads that are kept by the chain between calls.
+*
+*/
+
+#pragma once
+
+#include "ofxCvImage.h"
+#include "ofxCvStripeWorkers.h"
+
+
+class ofxCvOperationChain {
+
+  public:
+
+    ofxCvOperationChain();
+
+    ofxCvOperationChain&  add( float value );
+    ofxCvOperationChain&  subtract( float value );
+    ofxCvOperationChain&  multiply( float value );
+    ofxCvOperationChain&  add( ofxCvImage& mom );
+    ofxCvOperationChain&  subtract( ofxCvImage& mom );
+    ofxCvOperationChain&  multiply( ofxCvImage& mom );       // scaled by 1/255 like operator*=
+    ofxCvOperationChain&  bitwiseAnd( ofxCvImage& mom );
+    ofxCvOperationChain&  absDiff( ofxCvImage& mom );
+    ofxCvOperationChain&  threshold( int value, bool invert = false );
+    ofxCvOperationChain&  invert();
+    ofxCvOperationChain&  erode();
+    ofxCvOperationChain&  dilate();
+    ofxCvOperationChain&  blur( int value = 3 );
+    ofxCvOperationChain&  blurGaussian( int value = 3 );
+
+    void    clear();
+    size_t  size() const;
+
+    // number of stripes of rows processed in parallel, 1 runs on the calling thread
+    void  setNumThreads( int numThreads );
+    int   getNumThreads() const;
+
+    // images passed as operands have to outlive the chain and match the
+    // target's size, channels and ROI when it's applied
+    bool  apply( ofxCvImage& image );
+
+
+  protected:
+
+    enum Type {
+        ADD_SCALAR,
+        SUBTRACT_SCALAR,
+        MULTIPLY_SCALAR,
+        ADD_IMAGE,
+        SUBTRACT_IMAGE,
+        MULTIPLY_IMAGE,
+        AND_IMAGE,
+        ABS_DIFF_IMAGE,
+        THRESHOLD,
+        THRESHOLD_INVERTED,
+        INVERT,
+        ERODE,
+        DILATE,
+        BLUR,
+        BLUR_GAUSSIAN
+    };
+
+    struct Operation {
+        Type type;
+        float value;
+        ofxCvImage* image;
+    };
+
+    // a run of consecutive per pixel operations, or a single filter
+    struct Segment {
+        size_t begin;
+        size_t end;
+        bool fused;
+        bool usesImages;
+        unsigned char lut[256];
+    };
+
+    static bool  isPixelOperation( Type type );
+    ofxCvOperationChain&  push( Type type, float value, ofxCvImage* image );
+    void  compile();
+    bool  checkOperand( const ofxCvImage& image, const ofxCvImage& mom ) const;
+    void  applyPixelOperations( float* __restrict values, size_t n, size_t begin, size_t end,
+                                const unsigned char* const* operands ) const;
+    void  runSegment( const Segment& segment, ofxCvImage& image );
+    void  runStripe( const Segment& segment, ofxCvImage& image, int y0, int y1 );
+
+    std::vector<Operation> operations;
+    std::vector<Segment> segments;
+    bool bCompiled;
+    int numThreads;
+    ofxCvStripeWorkers workers;
+
+};
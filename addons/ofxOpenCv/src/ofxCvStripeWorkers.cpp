@@ -0,0 +1,91 @@
+#include "ofxCvStripeWorkers.h"
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvStripeWorkers::ofxCvStripeWorkers() {
+	task = nullptr;
+	numTasks = 0;
+	numPending = 0;
+	generation = 0;
+	bExit = false;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvStripeWorkers::ofxCvStripeWorkers( const ofxCvStripeWorkers& )
+:ofxCvStripeWorkers() {
+}
+
+//--------------------------------------------------------------------------------
+ofxCvStripeWorkers& ofxCvStripeWorkers::operator = ( const ofxCvStripeWorkers& ) {
+	return *this;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvStripeWorkers::~ofxCvStripeWorkers() {
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		bExit = true;
+	}
+	startCondition.notify_all();
+	for( auto & thread : threads ) {
+		thread.join();
+	}
+}
+
+//--------------------------------------------------------------------------------
+size_t ofxCvStripeWorkers::getNumThreads() const {
+	std::unique_lock<std::mutex> lock( mutex );
+	return threads.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvStripeWorkers::run( size_t _numTasks, const std::function<void( size_t )>& _task ) {
+	if( _numTasks == 0 ) {
+		return;
+	}
+	if( _numTasks > 1 ) {
+		std::unique_lock<std::mutex> lock( mutex );
+		// thread i - 1 runs task i
+		while( threads.size() < _numTasks - 1 ) {
+			threads.emplace_back( &ofxCvStripeWorkers::threadedFunction, this, threads.size() + 1 );
+		}
+		task = &_task;
+		numTasks = _numTasks;
+		numPending = _numTasks - 1;
+		generation++;
+		startCondition.notify_all();
+	}
+
+	_task( 0 );
+
+	if( _numTasks > 1 ) {
+		std::unique_lock<std::mutex> lock( mutex );
+		doneCondition.wait( lock, [this]{ return numPending == 0; } );
+		task = nullptr;
+	}
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvStripeWorkers::threadedFunction( size_t index ) {
+	std::unique_lock<std::mutex> lock( mutex );
+	// a thread started by run() has to take part in the call that started it
+	uint64_t seen = generation - 1;
+	while( true ) {
+		startCondition.wait( lock, [&]{ return bExit || generation != seen; } );
+		if( bExit ) {
+			return;
+		}
+		seen = generation;
+		if( index >= numTasks ) {
+			continue;
+		}
+		const std::function<void( size_t )>& current = *task;
+		lock.unlock();
+		current( index );
+		lock.lock();
+		if( --numPending == 0 ) {
+			doneCondition.notify_one();
+		}
+	}
+}
@@ -0,0 +1,53 @@
+/*
+* ofxCvStripeWorkers.h
+*
+* A small set of threads that stays alive between calls so the per frame
+* parallel passes of ofxCvBlobFinder and ofxCvOperationChain don't pay for
+* creating and joining threads every frame. The first task runs on the
+* calling thread and the threads are only started the first time more
+* than one task is needed.
+*
+* Copying gives an empty set, the threads belong to a single owner.
+*
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ofxCvStripeWorkers {
+
+  public:
+
+    ofxCvStripeWorkers();
+    ofxCvStripeWorkers( const ofxCvStripeWorkers& mom );
+    ofxCvStripeWorkers& operator = ( const ofxCvStripeWorkers& mom );
+    virtual ~ofxCvStripeWorkers();
+
+    // calls task(i) for every i in [0, numTasks) and returns once all of
+    // them are done, task(0) runs on the calling thread
+    void  run( size_t numTasks, const std::function<void( size_t )>& task );
+
+    // threads started so far
+    size_t  getNumThreads() const;
+
+
+  protected:
+
+    void  threadedFunction( size_t index );
+
+    std::vector<std::thread> threads;
+    mutable std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    const std::function<void( size_t )>* task;
+    size_t numTasks;
+    size_t numPending;
+    uint64_t generation;
+    bool bExit;
+
+};
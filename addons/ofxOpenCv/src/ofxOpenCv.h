@@ -11,9 +11,11 @@
 #include "ofxCvColorImage.h"
 #include "ofxCvFloatImage.h"
 #include "ofxCvShortImage.h"
+#include "ofxCvOperationChain.h"
 
 //--------------------------
 // contours and blobs
 #include "ofxCvContourFinder.h"
+#include "ofxCvBlobFinder.h"
 
 #include "ofxCvHaarFinder.h"
@@ -152,19 +152,11 @@ void ofApp::draw() {
 }
 
 void ofApp::drawPointCloud() {
-	int w = 640;
-	int h = 480;
 	ofMesh mesh;
-	mesh.setMode(OF_PRIMITIVE_POINTS);
-	int step = 2;
-	for(int y = 0; y < h; y += step) {
-		for(int x = 0; x < w; x += step) {
-			if(kinect.getDistanceAt(x, y) > 0) {
-				mesh.addColor(kinect.getColorAt(x,y));
-				mesh.addVertex(kinect.getWorldCoordinateAt(x, y));
-			}
-		}
-	}
+	// every 2nd pixel in x and y with the color of the video image,
+	// pass true as the 3rd argument to only keep the points inside
+	// the depth clipping range
+	kinect.getPointCloud(mesh, 2, false, true);
 	glPointSize(3);
 	ofPushMatrix();
 	// the projected points are 'upside down' and 'backwards' 
@@ -1,5 +1,6 @@
 
 #include "ofNode.h"
+#include "ofNodeHierarchy.h"
 #include "of3dGraphics.h"
 
 //----------------------------------------
@@ -17,6 +18,9 @@ ofNode::ofNode()
 
 //----------------------------------------
 ofNode::~ofNode(){
+	if(hierarchy){
+		hierarchy->remove(*this);
+	}
 	if(parent){
 		parent->removeListener(*this);
 	}
@@ -78,6 +82,10 @@ ofNode & ofNode::operator=(const ofNode & node){
 	if(parent){
 		parent->addListener(*this);
 	}
+	if(hierarchy){
+		hierarchy->structureChanged();
+	}
+	ofNodeHierarchy::nodeChanged();
 	return *this;
 }
 
@@ -95,6 +103,10 @@ ofNode & ofNode::operator=(ofNode && node){
 	if(parent){
 		parent->addListener(*this);
 	}
+	if(hierarchy){
+		hierarchy->structureChanged();
+	}
+	ofNodeHierarchy::nodeChanged();
 	return *this;
 }
 
@@ -142,6 +154,10 @@ void ofNode::setParent(ofNode& parent, bool bMaintainGlobalTransform) {
 		parent.addListener(*this);
 	}
 	this->parent = &parent;
+	if(hierarchy){
+		hierarchy->structureChanged();
+	}
+	ofNodeHierarchy::nodeChanged();
 }
 
 //----------------------------------------
@@ -160,7 +176,10 @@ void ofNode::clearParent(bool bMaintainGlobalTransform) {
 	}else{
 		this->parent = nullptr;
 	}
-
+	if(hierarchy){
+		hierarchy->structureChanged();
+	}
+	ofNodeHierarchy::nodeChanged();
 }
 
 //----------------------------------------
@@ -168,6 +187,11 @@ ofNode* ofNode::getParent() const {
 	return parent;
 }
 
+//----------------------------------------
+ofNodeHierarchy* ofNode::getHierarchy() const {
+	return hierarchy;
+}
+
 //----------------------------------------
 void ofNode::setPosition(float px, float py, float pz) {
 	setPosition({px, py, pz});
@@ -582,6 +606,7 @@ const glm::mat4& ofNode::getLocalTransformMatrix() const {
 
 //----------------------------------------
 glm::mat4 ofNode::getGlobalTransformMatrix() const {
+	if(hierarchy) return hierarchy->getGlobalTransformMatrix(*this);
 	if(parent) return parent->getGlobalTransformMatrix() * getLocalTransformMatrix();
 	else return getLocalTransformMatrix();
 }
@@ -709,6 +734,11 @@ void ofNode::createMatrix() {
 	localTransformMatrix = glm::scale(localTransformMatrix, toGlm(scale));
 
 	updateAxis();
+
+	if(hierarchy){
+		hierarchy->localTransformChanged(*this);
+	}
+	ofNodeHierarchy::nodeChanged();
 }
 
 
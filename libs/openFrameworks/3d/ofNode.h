@@ -8,6 +8,7 @@
 #include <array>
 
 class ofBaseRenderer;
+class ofNodeHierarchy;
 
 /// \brief A generic 3d object in space with transformation (position, rotation, scale).
 
@@ -45,6 +46,12 @@ public:
 	/// \returns Pointer to parent ofNode.
 	ofNode* getParent() const;
 
+	/// \brief Get the hierarchy caching this node's global transform.
+	///
+	/// \returns Pointer to the ofNodeHierarchy or nullptr if the node
+	///          wasn't added to one.
+	ofNodeHierarchy* getHierarchy() const;
+
 	/// \}
 	/// \name Getters
 	/// \{
@@ -152,11 +159,10 @@ public:
 	/// \sa https://open.gl/transformations
 	const glm::mat4& getLocalTransformMatrix() const;
 	
-	// TODO: optimize and cache these
-	// (parent would need to know about its children so it can inform them 
-	// to update their global matrices if it itself transforms)
-	
 	/// \brief Get node's global transformations (position, orientation, scale).
+	///
+	/// This multiplies all the parents' transformations unless the node was
+	/// added to an ofNodeHierarchy, which caches them.
 	/// \returns A refrence to mat4 containing node's global transformations.
 	/// \sa https://open.gl/transformations
 	glm::mat4 getGlobalTransformMatrix() const;
@@ -531,5 +537,9 @@ private:
 
 	void addListener(ofNode & node);
 	void removeListener(ofNode & node);
+
+	friend class ofNodeHierarchy;
+	ofNodeHierarchy * hierarchy = nullptr;
+	size_t hierarchyIndex = 0;
 //	glm::mat4 globalTransformMatrix;
 };
@@ -0,0 +1,334 @@
+#include "ofNodeHierarchy.h"
+#include "ofNode.h"
+#include "ofTaskScheduler.h"
+#include <algorithm>
+
+// levels of the tree with fewer nodes per thread are updated on the
+// calling thread, handing them to the task scheduler costs more than
+// the multiplications
+static const size_t minNodesPerThread = 4096;
+
+// bumped whenever any node's local transform or parent changes while a
+// hierarchy has parents outside of it, those are only read again after it
+std::atomic<size_t> ofNodeHierarchy::numHierarchiesWithExternal(0);
+std::atomic<uint64_t> ofNodeHierarchy::transformGeneration(0);
+
+//----------------------------------------
+ofNodeHierarchy::ofNodeHierarchy()
+:updateCount(0)
+,externalGeneration(0)
+,bNeedsRebuild(false)
+,bAllDirty(false)
+,bHasExternal(false)
+,bExternalDirty(false)
+,numThreads(1){
+}
+
+//----------------------------------------
+ofNodeHierarchy::~ofNodeHierarchy(){
+	clear();
+}
+
+//----------------------------------------
+void ofNodeHierarchy::add(ofNode & node){
+	// iterative so very deep trees don't overflow the stack
+	std::vector<ofNode*> pending{&node};
+	while(!pending.empty()){
+		ofNode * current = pending.back();
+		pending.pop_back();
+		if(current->hierarchy != this){
+			if(current->hierarchy){
+				current->hierarchy->remove(*current);
+			}
+			current->hierarchy = this;
+			current->hierarchyIndex = nodes.size();
+			nodes.push_back(current);
+		}
+		pending.insert(pending.end(), current->children.begin(), current->children.end());
+	}
+	structureChanged();
+}
+
+//----------------------------------------
+void ofNodeHierarchy::remove(ofNode & node){
+	if(node.hierarchy != this){
+		return;
+	}
+	// nodes are only sorted again on the next update so the order
+	// doesn't need to be kept here
+	size_t index = node.hierarchyIndex;
+	nodes[index] = nodes.back();
+	nodes[index]->hierarchyIndex = index;
+	nodes.pop_back();
+	node.hierarchy = nullptr;
+	structureChanged();
+}
+
+//----------------------------------------
+void ofNodeHierarchy::clear(){
+	for(auto node: nodes){
+		node->hierarchy = nullptr;
+	}
+	nodes.clear();
+	parents.clear();
+	childrenBegin.clear();
+	childrenEnd.clear();
+	external.clear();
+	externalIndices.clear();
+	dirty.clear();
+	dirtyNodes.clear();
+	updatedIn.clear();
+	localTransforms.clear();
+	globalTransforms.clear();
+	levels.clear();
+	bNeedsRebuild = false;
+	bAllDirty = false;
+	bExternalDirty = false;
+	setHasExternal(false);
+}
+
+//----------------------------------------
+size_t ofNodeHierarchy::size() const{
+	return nodes.size();
+}
+
+//----------------------------------------
+void ofNodeHierarchy::setNumThreads(size_t numThreads){
+	this->numThreads = std::max(numThreads, size_t(1));
+}
+
+//----------------------------------------
+size_t ofNodeHierarchy::getNumThreads() const{
+	return numThreads;
+}
+
+//----------------------------------------
+void ofNodeHierarchy::update(){
+	if(bNeedsRebuild){
+		rebuild();
+	}
+
+	// parents outside of the hierarchy are read again whenever any node
+	// changed since the last time, before the levels are updated since it
+	// can trigger an update of another hierarchy
+	if(externalChanged()){
+		externalGeneration = transformGeneration.load(std::memory_order_relaxed);
+		bExternalDirty = false;
+		for(auto i: externalIndices){
+			globalTransforms[i] = nodes[i]->parent->getGlobalTransformMatrix() * localTransforms[i];
+			markDirty(i);
+		}
+	}
+
+	if(bAllDirty){
+		for(size_t level = 0; level + 1 < levels.size(); level++){
+			updateLevel(levels[level], levels[level + 1]);
+		}
+		bAllDirty = false;
+	}else if(!dirtyNodes.empty()){
+		if(++updateCount == 0){
+			std::fill(updatedIn.begin(), updatedIn.end(), 0);
+			updateCount = 1;
+		}
+		// ancestors come first so the subtrees they already recomputed
+		// are skipped
+		std::sort(dirtyNodes.begin(), dirtyNodes.end());
+		for(auto node: dirtyNodes){
+			if(updatedIn[node] == updateCount){
+				continue;
+			}
+			size_t begin = node;
+			size_t end = node + 1;
+			while(begin < end){
+				updateLevel(begin, end);
+				auto childBegin = childrenBegin[begin];
+				end = childrenEnd[end - 1];
+				begin = childBegin;
+			}
+		}
+	}
+
+	for(auto node: dirtyNodes){
+		dirty[node] = 0;
+	}
+	dirtyNodes.clear();
+}
+
+//----------------------------------------
+const glm::mat4 & ofNodeHierarchy::getGlobalTransformMatrix(const ofNode & node){
+	if(bNeedsRebuild || bAllDirty || !dirtyNodes.empty() || externalChanged()){
+		update();
+	}
+	return globalTransforms[node.hierarchyIndex];
+}
+
+//----------------------------------------
+bool ofNodeHierarchy::externalChanged() const{
+	return bHasExternal && (bExternalDirty || externalGeneration != transformGeneration.load(std::memory_order_relaxed));
+}
+
+//----------------------------------------
+void ofNodeHierarchy::setHasExternal(bool hasExternal){
+	if(hasExternal != bHasExternal){
+		if(hasExternal){
+			numHierarchiesWithExternal++;
+		}else{
+			numHierarchiesWithExternal--;
+		}
+		bHasExternal = hasExternal;
+	}
+}
+
+//----------------------------------------
+void ofNodeHierarchy::markDirty(size_t index){
+	if(!dirty[index]){
+		dirty[index] = 1;
+		dirtyNodes.push_back(index);
+	}
+}
+
+//----------------------------------------
+void ofNodeHierarchy::localTransformChanged(const ofNode & node){
+	// a rebuild copies all the local transforms again
+	if(bNeedsRebuild){
+		return;
+	}
+	size_t index = node.hierarchyIndex;
+	localTransforms[index] = node.getLocalTransformMatrix();
+	markDirty(index);
+}
+
+//----------------------------------------
+void ofNodeHierarchy::structureChanged(){
+	bNeedsRebuild = true;
+}
+
+//----------------------------------------
+void ofNodeHierarchy::rebuild(){
+	size_t numNodes = nodes.size();
+
+	// depth of every node, walking up until a node with a known depth
+	// or a root of this hierarchy
+	std::vector<int32_t> depths(numNodes, -1);
+	std::vector<size_t> path;
+	int32_t maxDepth = 0;
+	for(size_t i = 0; i < numNodes; i++){
+		size_t current = i;
+		while(depths[current] < 0){
+			ofNode * parent = nodes[current]->parent;
+			if(parent == nullptr || parent->hierarchy != this){
+				depths[current] = 0;
+				break;
+			}
+			path.push_back(current);
+			current = parent->hierarchyIndex;
+		}
+		int32_t depth = depths[current];
+		while(!path.empty()){
+			depths[path.back()] = ++depth;
+			path.pop_back();
+		}
+		maxDepth = std::max(maxDepth, depth);
+	}
+
+	// counting sort by depth, stable so siblings keep the order they were added in
+	levels.assign(maxDepth + 2, 0);
+	for(auto depth: depths){
+		levels[depth + 1]++;
+	}
+	for(size_t level = 1; level < levels.size(); level++){
+		levels[level] += levels[level - 1];
+	}
+	std::vector<ofNode*> sorted(numNodes);
+	std::vector<size_t> next(levels.begin(), levels.end() - 1);
+	for(size_t i = 0; i < numNodes; i++){
+		sorted[next[depths[i]]++] = nodes[i];
+	}
+	nodes.swap(sorted);
+
+	// then every level by the index of the parents, which are already in
+	// their final place, so children of the same node are together
+	parents.resize(numNodes);
+	for(size_t level = 0; level + 1 < levels.size(); level++){
+		auto begin = nodes.begin() + levels[level];
+		auto end = nodes.begin() + levels[level + 1];
+		if(level > 0){
+			std::stable_sort(begin, end, [](const ofNode * a, const ofNode * b){
+				return a->parent->hierarchyIndex < b->parent->hierarchyIndex;
+			});
+		}
+		for(size_t i = levels[level]; i < levels[level + 1]; i++){
+			nodes[i]->hierarchyIndex = i;
+		}
+	}
+
+	external.resize(numNodes);
+	externalIndices.clear();
+	localTransforms.resize(numNodes);
+	globalTransforms.resize(numNodes);
+	for(size_t i = 0; i < numNodes; i++){
+		ofNode * parent = nodes[i]->parent;
+		bool inHierarchy = parent != nullptr && parent->hierarchy == this;
+		parents[i] = inHierarchy ? int32_t(parent->hierarchyIndex) : -1;
+		external[i] = parent != nullptr && !inHierarchy;
+		if(external[i]){
+			externalIndices.push_back(i);
+		}
+		localTransforms[i] = nodes[i]->getLocalTransformMatrix();
+	}
+
+	// nodes without children get an empty range where theirs would be
+	childrenBegin.resize(numNodes);
+	childrenEnd.resize(numNodes);
+	for(size_t level = 0; level + 1 < levels.size(); level++){
+		size_t child = levels[level + 1];
+		size_t levelEnd = level + 2 < levels.size() ? levels[level + 2] : numNodes;
+		for(size_t i = levels[level]; i < levels[level + 1]; i++){
+			childrenBegin[i] = child;
+			while(child < levelEnd && size_t(parents[child]) == i){
+				child++;
+			}
+			childrenEnd[i] = child;
+		}
+	}
+
+	setHasExternal(!externalIndices.empty());
+	bExternalDirty = true;
+
+	dirty.assign(numNodes, 0);
+	dirtyNodes.clear();
+	updatedIn.assign(numNodes, 0);
+	updateCount = 0;
+	bAllDirty = true;
+	bNeedsRebuild = false;
+}
+
+//----------------------------------------
+void ofNodeHierarchy::updateLevel(size_t begin, size_t end){
+	size_t count = end - begin;
+	size_t threads = std::min(numThreads, count / minNodesPerThread);
+	if(threads <= 1){
+		updateRange(begin, end);
+		return;
+	}
+
+	// nodes in the same level only read their parents from the previous one
+	size_t chunk = (count + threads - 1) / threads;
+	ofGetTaskScheduler().parallelForRange(begin, end, [this](size_t chunkBegin, size_t chunkEnd){
+		updateRange(chunkBegin, chunkEnd);
+	}, chunk);
+}
+
+//----------------------------------------
+void ofNodeHierarchy::updateRange(size_t begin, size_t end){
+	// nodes with an external parent are roots, computed in update()
+	for(size_t i = begin; i < end; i++){
+		int32_t parent = parents[i];
+		if(parent >= 0){
+			globalTransforms[i] = globalTransforms[parent] * localTransforms[i];
+		}else if(!external[i]){
+			globalTransforms[i] = localTransforms[i];
+		}
+		updatedIn[i] = updateCount;
+	}
+}
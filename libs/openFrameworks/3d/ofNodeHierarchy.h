@@ -0,0 +1,117 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "glm/mat4x4.hpp"
+#include <atomic>
+
+class ofNode;
+
+/// \brief Caches the global transforms of a scene of ofNodes.
+///
+/// By default every call to ofNode::getGlobalTransformMatrix() multiplies
+/// all the way up the parent chain. Nodes added to an ofNodeHierarchy keep
+/// their local and global matrices in contiguous arrays sorted by depth in
+/// the tree, so parents always come before their children. Changing a
+/// node's transform only flags it and update() recomputes the global
+/// matrices of the flagged nodes and their descendants, level by level,
+/// optionally splitting the larger levels across the threads of
+/// ofGetTaskScheduler().
+///
+/// ofNode keeps its API: getGlobalTransformMatrix() and the functions that
+/// depend on it read from the hierarchy and bring it up to date first if
+/// needed, so calling update() once per frame is only an optimization.
+///
+/// ~~~~{.cpp}
+/// ofNodeHierarchy hierarchy;
+/// hierarchy.add(root); // also adds all its descendants
+/// ...
+/// // in update, after moving the nodes
+/// hierarchy.update();
+/// ~~~~
+///
+/// Nodes can belong to a single hierarchy and the hierarchy has to be used
+/// from one thread at a time. That includes the const getters of its
+/// nodes, like ofNode::getGlobalPosition(), which update the cached
+/// transforms if the hierarchy has pending changes.
+class ofNodeHierarchy {
+public:
+	ofNodeHierarchy();
+	~ofNodeHierarchy();
+
+	ofNodeHierarchy(const ofNodeHierarchy &) = delete;
+	ofNodeHierarchy & operator=(const ofNodeHierarchy &) = delete;
+
+	/// \brief Add a node and all its descendants.
+	///
+	/// A node whose parent is not in this hierarchy still works but its
+	/// parent's global transform has to be read again after any ofNode
+	/// changes, so it's better to add the root of the tree.
+	void add(ofNode & node);
+
+	/// \brief Remove a node, its descendants stay in the hierarchy.
+	void remove(ofNode & node);
+
+	/// \brief Remove all the nodes.
+	void clear();
+
+	/// \returns Number of nodes in the hierarchy.
+	size_t size() const;
+
+	/// \brief Recompute the global transforms of the nodes that changed.
+	void update();
+
+	/// \brief Set the number of chunks the levels of the tree with many
+	///        nodes are split into. They run on ofGetTaskScheduler(), 1
+	///        updates on the calling thread.
+	void setNumThreads(size_t numThreads);
+	size_t getNumThreads() const;
+
+	/// \brief Get the global transform of a node in this hierarchy.
+	const glm::mat4 & getGlobalTransformMatrix(const ofNode & node);
+
+private:
+	friend class ofNode;
+
+	void localTransformChanged(const ofNode & node);
+	void structureChanged();
+	void rebuild();
+	void updateRange(size_t begin, size_t end);
+	void updateLevel(size_t begin, size_t end);
+	void markDirty(size_t index);
+	void setHasExternal(bool hasExternal);
+	bool externalChanged() const;
+
+	// only counted while some hierarchy has parents outside of it, so apps
+	// that don't use them don't pay for an atomic write per transform change
+	static void nodeChanged(){
+		if(numHierarchiesWithExternal.load(std::memory_order_relaxed) > 0){
+			transformGeneration.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	static std::atomic<size_t> numHierarchiesWithExternal;
+	static std::atomic<uint64_t> transformGeneration;
+
+	// one entry per node sorted by depth and, in every level, by parent, so
+	// the descendants of a node at any depth are a contiguous range.
+	// nodes[i]->hierarchyIndex == i
+	std::vector<ofNode*> nodes;
+	std::vector<int32_t> parents; // index of the parent, -1 for roots
+	std::vector<size_t> childrenBegin;
+	std::vector<size_t> childrenEnd;
+	std::vector<uint8_t> external; // the parent is not in this hierarchy
+	std::vector<size_t> externalIndices;
+	std::vector<uint8_t> dirty; // in dirtyNodes
+	std::vector<size_t> dirtyNodes;
+	std::vector<uint32_t> updatedIn; // last update that recomputed the node
+	std::vector<glm::mat4> localTransforms;
+	std::vector<glm::mat4> globalTransforms;
+	std::vector<size_t> levels; // first index of every depth level plus the end
+
+	uint32_t updateCount;
+	uint64_t externalGeneration; // last time the external parents were read
+	bool bNeedsRebuild;
+	bool bAllDirty;
+	bool bHasExternal;
+	bool bExternalDirty;
+	size_t numThreads;
+};
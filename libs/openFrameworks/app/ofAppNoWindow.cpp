@@ -1,7 +1,10 @@
 #include "ofAppNoWindow.h"
+#include "ofAppRunner.h"
+#include "ofMainLoop.h"
 #include "ofGraphics.h"
 #include "ofPath.h"
 #include "of3dGraphics.h"
+#include <chrono>
 #include <memory>
 
 
@@ -211,15 +214,31 @@ private:
 
 const std::string ofNoopRenderer::TYPE="NOOP";
 
+//----------------------------------------------------------
+// the elapsed time follows the virtual clock, timings need the real one
+static uint64_t getSteadyTimeMicros(){
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
 //----------------------------------------------------------
 ofAppNoWindow::ofAppNoWindow()
-:coreEvents(new ofCoreEvents)
+:runSettingsApplied(false)
+,timingStart(getSteadyTimeMicros())
+,previousFrameEnd(0)
+,outputPending(false)
+,coreEvents(new ofCoreEvents)
 ,currentRenderer(new ofNoopRenderer){
 	ofAppPtr = nullptr;
 	width = 0;
 	height = 0;
 }
 
+//----------------------------------------------------------
+ofAppNoWindow::~ofAppNoWindow(){
+	close();
+}
+
 
 //----------------------------------------------------------
 void ofAppNoWindow::setup(const ofWindowSettings & settings){
@@ -227,8 +246,78 @@ void ofAppNoWindow::setup(const ofWindowSettings & settings){
 	height = settings.getHeight();
 }
 
+//----------------------------------------------------------
+void ofAppNoWindow::close(){
+	waitForOutput();
+	if(outputThread.joinable()){
+		outputFrames.close();
+		outputThread.join();
+	}
+}
+
+//----------------------------------------------------------
+void ofAppNoWindow::setRunSettings(const RunSettings & settings){
+	runSettings = settings;
+	runSettingsApplied = false;
+	timings.clear();
+
+	if(runSettings.pipelineOutput && !outputThread.joinable()){
+		outputThread = std::thread([this]{
+			uint64_t frame;
+			while(outputFrames.receive(frame)){
+				auto start = getTimingMicros();
+				ofNotifyEvent(output, frame, this);
+				outputsDone.send(OutputDone{frame, start, getTimingMicros() - start});
+			}
+		});
+	}
+}
+
+//----------------------------------------------------------
+const ofAppNoWindow::RunSettings & ofAppNoWindow::getRunSettings() const{
+	return runSettings;
+}
+
+//----------------------------------------------------------
+const std::vector<ofAppNoWindow::FrameTiming> & ofAppNoWindow::getFrameTimings() const{
+	return timings;
+}
+
+//----------------------------------------------------------
+void ofAppNoWindow::applyRunSettings(){
+	// the clock can only be changed once the window is in the main loop,
+	// which might not be the case yet when the settings are set
+	runSettingsApplied = true;
+	if(runSettings.fixedStepFps > 0){
+		ofSetTimeModeFixedRate(ofGetFixedStepForFps(runSettings.fixedStepFps));
+		// start at 0 so the time only depends on the number of frames
+		ofResetElapsedTimeCounter();
+	}
+	auto mainLoop = ofGetMainLoop();
+	if(mainLoop){
+		// the output of the last frame has to finish before the app exits
+		exitListener = mainLoop->exitEvent.newListener([this]{
+			waitForOutput();
+		});
+	}
+	timingStart = getSteadyTimeMicros();
+	previousFrameEnd = 0;
+}
+
+//----------------------------------------------------------
+uint64_t ofAppNoWindow::getTimingMicros() const{
+	return getSteadyTimeMicros() - timingStart;
+}
+
 //----------------------------------------------------------
 void ofAppNoWindow::update(){
+	if(!runSettingsApplied){
+		applyRunSettings();
+	}
+	if(runSettings.fixedStepFps > 0){
+		// ofSetFrameRate() would pace the frames to the wall clock
+		events().setFrameRate(0);
+	}
 
     /// listen for escape
     #ifdef TARGET_WIN32
@@ -256,13 +345,134 @@ void ofAppNoWindow::update(){
 	}
 	#endif
 
-
+	auto updateStart = getTimingMicros();
 	events().notifyUpdate();
+	if(runSettings.recordTimings){
+		FrameTiming timing{};
+		timing.frame = events().getFrameNum();
+		timing.startMicros = previousFrameEnd;
+		timing.eventsMicros = updateStart - previousFrameEnd;
+		timing.updateMicros = getTimingMicros() - updateStart;
+		timings.push_back(timing);
+	}
 }
 
 //----------------------------------------------------------
 void ofAppNoWindow::draw(){
+	auto frame = events().getFrameNum();
+	auto drawStart = getTimingMicros();
 	events().notifyDraw();
+	auto drawEnd = getTimingMicros();
+
+	bool recordTiming = runSettings.recordTimings && !timings.empty() && timings.back().frame == frame;
+	if(recordTiming){
+		timings.back().drawMicros = drawEnd - drawStart;
+	}
+
+	if(runSettings.pipelineOutput && outputThread.joinable()){
+		waitForOutput();
+		if(recordTiming){
+			timings.back().waitMicros = getTimingMicros() - drawEnd;
+		}
+		outputPending = true;
+		outputFrames.send(frame);
+	}else{
+		notifyOutput(frame);
+	}
+	previousFrameEnd = getTimingMicros();
+
+	if(runSettings.numFrames > 0 && frame + 1 >= runSettings.numFrames){
+		waitForOutput();
+		ofExit();
+	}
+}
+
+//----------------------------------------------------------
+void ofAppNoWindow::notifyOutput(uint64_t frame){
+	auto start = getTimingMicros();
+	ofNotifyEvent(output, frame, this);
+	outputDone(OutputDone{frame, start, getTimingMicros() - start});
+}
+
+//----------------------------------------------------------
+void ofAppNoWindow::waitForOutput(){
+	if(!outputPending){
+		return;
+	}
+	OutputDone done;
+	if(outputsDone.receive(done)){
+		outputDone(done);
+	}
+	outputPending = false;
+}
+
+//----------------------------------------------------------
+void ofAppNoWindow::outputDone(const OutputDone & done){
+	if(!runSettings.recordTimings){
+		return;
+	}
+	for(auto timing = timings.rbegin(); timing != timings.rend(); ++timing){
+		if(timing->frame == done.frame){
+			timing->outputStartMicros = done.startMicros;
+			timing->outputMicros = done.durationMicros;
+			break;
+		}
+	}
+}
+
+//----------------------------------------------------------
+bool ofAppNoWindow::saveFrameTimings(const of::filesystem::path & path) const{
+	std::string out;
+	if(ofToLower(path.extension().string()) == ".csv"){
+		out = "frame,start,events,update,draw,wait,output start,output\n";
+		for(auto & timing: timings){
+			for(auto value: {timing.frame, timing.startMicros, timing.eventsMicros, timing.updateMicros, timing.drawMicros, timing.waitMicros, timing.outputStartMicros}){
+				ofAppendToString(out, value);
+				out += ',';
+			}
+			ofAppendToString(out, timing.outputMicros);
+			out += '\n';
+		}
+	}else{
+		// complete events in the chrome trace format, the output runs in its
+		// own row when it's pipelined
+		bool first = true;
+		auto addEvent = [&](const char * name, uint64_t frame, uint64_t start, uint64_t duration, int thread){
+			out += first ? "\n" : ",\n";
+			first = false;
+			out += "{\"name\":\"";
+			out += name;
+			out += "\",\"ph\":\"X\",\"pid\":0,\"tid\":";
+			ofAppendToString(out, thread);
+			out += ",\"ts\":";
+			ofAppendToString(out, start);
+			out += ",\"dur\":";
+			ofAppendToString(out, duration);
+			out += ",\"args\":{\"frame\":";
+			ofAppendToString(out, frame);
+			out += "}}";
+		};
+		out = "{\"traceEvents\":[";
+		for(auto & timing: timings){
+			auto start = timing.startMicros;
+			addEvent("events", timing.frame, start, timing.eventsMicros, 0);
+			start += timing.eventsMicros;
+			addEvent("update", timing.frame, start, timing.updateMicros, 0);
+			start += timing.updateMicros;
+			addEvent("draw", timing.frame, start, timing.drawMicros, 0);
+			start += timing.drawMicros;
+			if(timing.waitMicros > 0){
+				addEvent("wait output", timing.frame, start, timing.waitMicros, 0);
+			}
+			addEvent("output", timing.frame, timing.outputStartMicros, timing.outputMicros, runSettings.pipelineOutput ? 1 : 0);
+		}
+		out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+	if(!ofBufferToFile(path, ofBuffer(out.data(), out.size()))){
+		ofLogError("ofAppNoWindow") << "saveFrameTimings(): couldn't save " << path;
+		return false;
+	}
+	return true;
 }
 
 //------------------------------------------------------------
@@ -1,15 +1,66 @@
 #pragma once
 
 #include "ofAppBaseWindow.h"
+#include "ofEvents.h"
+#include "ofThreadChannel.h"
+#include <thread>
 
 class ofBaseApp;
 class ofBaseRenderer;
 
+/// \brief A window that doesn't show anything, to run apps without a display.
+///
+/// By default it runs like any other window, at the frame rate set with
+/// ofSetFrameRate(). For offline rendering setRunSettings() can switch it to
+/// a virtual clock that advances a fixed step every frame, so
+/// ofGetElapsedTimef(), ofGetLastFrameTime() and ofGetFrameNum() only depend
+/// on the number of frames run and frames run as fast as the CPU allows:
+///
+/// ~~~~{.cpp}
+/// auto window = std::make_shared<ofAppNoWindow>();
+/// ofAppNoWindow::RunSettings settings;
+/// settings.fixedStepFps = 30;
+/// settings.numFrames = 30 * 60;
+/// settings.pipelineOutput = true;
+/// window->setRunSettings(settings);
+/// ofRunApp(window, std::make_shared<ofApp>());
+/// ofRunMainLoop();
+/// ~~~~
 class ofAppNoWindow : public ofAppBaseWindow {
 
 public:
+	struct RunSettings{
+		/// \brief Frames per second of the virtual clock, 0 keeps the system
+		/// clock and the frame rate set with ofSetFrameRate().
+		double fixedStepFps = 0;
+		/// \brief Exits after this many frames, 0 runs until ofExit().
+		uint64_t numFrames = 0;
+		/// \brief Notify the output event of a frame in a separate thread
+		/// while the next frame is updated and drawn.
+		bool pipelineOutput = false;
+		/// \brief Keep the time spent in every phase of every frame, see
+		/// getFrameTimings().
+		bool recordTimings = false;
+	};
+
+	/// \brief Wall clock time spent in each phase of a frame, in microseconds.
+	struct FrameTiming{
+		uint64_t frame;
+		/// \brief When the frame started, since the timings started recording.
+		uint64_t startMicros;
+		/// \brief Events notified between the previous frame and this one,
+		/// polling and the listeners of the main loop.
+		uint64_t eventsMicros;
+		uint64_t updateMicros;
+		uint64_t drawMicros;
+		/// \brief Time waiting for the output of the previous frame to finish.
+		uint64_t waitMicros;
+		uint64_t outputStartMicros;
+		uint64_t outputMicros;
+	};
+
 	ofAppNoWindow();
-	~ofAppNoWindow(){}
+	~ofAppNoWindow();
 
 	static bool doesLoop(){ return false; }
 	static bool allowsMultiWindow(){ return false; }
@@ -23,6 +74,40 @@ public:
 	void setup(const ofWindowSettings & settings);
 	void update();
 	void draw();
+	void close();
+
+	/// \brief Sets how frames are run, can be called before ofRunApp().
+	void setRunSettings(const RunSettings & settings);
+	const RunSettings & getRunSettings() const;
+
+	/// \brief Timings of the frames run so far when recordTimings is enabled.
+	///
+	/// When the output is pipelined the output time of the last frame is
+	/// only known once the next frame has been drawn.
+	const std::vector<FrameTiming> & getFrameTimings() const;
+
+	/// \brief Saves the frame timings as a Chrome trace, that can be opened
+	/// in chrome://tracing or Perfetto, or as CSV if the extension is csv.
+	bool saveFrameTimings(const of::filesystem::path & path) const;
+
+	/// \brief Notified after draw with the number of the frame drawn.
+	///
+	/// With pipelineOutput it's notified from another thread at the same time
+	/// the next frame is updated and drawn, so the listeners should only use
+	/// data handed over in draw. The output of a frame always finishes before
+	/// the one after the next is drawn so alternating between two buffers
+	/// using the frame number is enough:
+	///
+	/// ~~~~{.cpp}
+	/// void ofApp::draw(){
+	///     renderer.getPixels(frames[ofGetFrameNum() % 2]);
+	/// }
+	///
+	/// void ofApp::output(const uint64_t & frame){
+	///     ofSaveImage(frames[frame % 2], "frame" + ofToString(frame) + ".png");
+	/// }
+	/// ~~~~
+	ofEvent<const uint64_t> output;
 
 	glm::vec2	getWindowPosition();
 	glm::vec2	getWindowSize();
@@ -35,8 +120,32 @@ public:
 	std::shared_ptr<ofBaseRenderer> & renderer();
 
 private:
+	struct OutputDone{
+		uint64_t frame;
+		uint64_t startMicros;
+		uint64_t durationMicros;
+	};
+
+	void applyRunSettings();
+	void notifyOutput(uint64_t frame);
+	void waitForOutput();
+	void outputDone(const OutputDone & done);
+	uint64_t getTimingMicros() const;
+
 	int width, height;
 
+	RunSettings runSettings;
+	bool runSettingsApplied;
+	uint64_t timingStart;
+	uint64_t previousFrameEnd;
+	std::vector<FrameTiming> timings;
+	ofEventListener exitListener;
+
+	std::thread outputThread;
+	ofThreadChannel<uint64_t> outputFrames;
+	ofThreadChannel<OutputDone> outputsDone;
+	bool outputPending;
+
     ofBaseApp *		ofAppPtr;
 	std::unique_ptr<ofCoreEvents> coreEvents;
     std::shared_ptr<ofBaseRenderer> currentRenderer;
@@ -8,6 +8,7 @@
 #include "ofMainLoop.h"
 #include "ofBaseApp.h"
 #include "ofConstants.h"
+#include "ofProfiler.h"
 
 //========================================================================
 // default windowing
@@ -133,6 +134,7 @@ int ofMainLoop::loop(){
 
 void ofMainLoop::loopOnce(){
 	if(bShouldClose) return;
+	OF_PROFILE_ZONE("ofMainLoop::loopOnce");
 	for(auto i = windowsApps.begin(); !windowsApps.empty() && i != windowsApps.end();){
 		if(i->first->getWindowShouldClose()){
 			const auto & window = i->first;
@@ -55,26 +55,135 @@ using std::string;
 using std::list;
 using std::pair;
 
+// the thread stops queueing messages if update() isn't called for a while
+static const size_t maxPendingMessages = 64 * 1024;
+
+//---------------------------------------------------------------------------
+ofFirmataParser::ofFirmataParser() {
+	reset();
+}
+
+void ofFirmataParser::reset() {
+	waitForData = 0;
+	command = 0x00;
+	channel = 0;
+	storedData[0] = storedData[1] = 0;
+	sysExData.clear();
+	pinState.analog.fill(-1);
+	pinState.analogTimeMicros.fill(0);
+	pinState.digitalPorts.fill(-1);
+	pinState.digitalTimeMicros.fill(0);
+	pinState.timeMicros = 0;
+	pinState.numMessages = 0;
+}
+
+const ofFirmataParser::PinState & ofFirmataParser::getPinState() const {
+	return pinState;
+}
+
+int ofFirmataParser::PinState::getDigital(int pin) const {
+	if (pin < 0 || pin / 8 >= ARD_TOTAL_PORTS || digitalPorts[pin / 8] < 0) {
+		return -1;
+	}
+	return (digitalPorts[pin / 8] >> (pin % 8)) & 0x01 ? ARD_HIGH : ARD_LOW;
+}
+
+void ofFirmataParser::parse(const unsigned char * data, size_t size, uint64_t timeMicros, const Callback & callback) {
+	for (auto end = data + size; data != end; ++data) {
+		unsigned char inputData = *data;
+
+		// we have command data
+		if (waitForData > 0 && inputData < 128) {
+			waitForData--;
+
+			// collect the data, the first byte ends up in storedData[1]
+			storedData[waitForData] = inputData;
+
+			if (waitForData == 0) {
+				Message message{Message::Analog, channel, (storedData[0] << 7) | storedData[1], nullptr, 0};
+				switch (command) {
+				case DIGITAL_MESSAGE:
+					message.type = Message::Digital;
+					if (channel < ARD_TOTAL_PORTS) {
+						pinState.digitalPorts[channel] = message.value;
+						pinState.digitalTimeMicros[channel] = timeMicros;
+					}
+					break;
+
+				case REPORT_VERSION:
+					message.type = Message::Version;
+					message.value = storedData[1];
+					message.channel = storedData[0];
+					break;
+
+				case ANALOG_MESSAGE:
+					pinState.analog[channel] = message.value;
+					pinState.analogTimeMicros[channel] = timeMicros;
+					break;
+				}
+				pinState.timeMicros = timeMicros;
+				pinState.numMessages++;
+				callback(message);
+			}
+		}
+		// we have SysEx command data
+		else if (waitForData < 0) {
+			if (inputData == END_SYSEX) {
+				waitForData = 0;
+				pinState.timeMicros = timeMicros;
+				pinState.numMessages++;
+				callback(Message{Message::SysEx, 0, 0, sysExData.data(), sysExData.size()});
+				sysExData.clear();
+			}
+			else {
+				sysExData.push_back(inputData);
+			}
+		}
+		// we have a command
+		else {
+			// a command byte in the middle of a message discards the rest of it
+			waitForData = 0;
+
+			// extract the command and channel info from a byte if it is less than 0xF0
+			if (inputData < 0xF0) {
+				command = inputData & 0xF0;
+				channel = inputData & 0x0F;
+			}
+			else {
+				// commands in the 0xF* range don't use channel data
+				command = inputData;
+			}
+
+			switch (command) {
+			case REPORT_VERSION:
+			case DIGITAL_MESSAGE:
+			case ANALOG_MESSAGE:
+				waitForData = 2;     // 2 bytes needed
+				break;
+
+			case START_SYSEX:
+				sysExData.clear();
+				waitForData = -1;     // n bytes needed, -1 is used to indicate sysex message
+				break;
+			}
+		}
+	}
+}
 
- // TODO thread it?
  // TODO throw event or exception if the serial port goes down...
  //---------------------------------------------------------------------------
 ofArduino::ofArduino() {
 	_portStatus = -1;
-	_waitForData = 0;
+	_threadRunning = false;
+	_numDroppedMessages = 0;
 	_analogHistoryLength = 2;
 	_digitalHistoryLength = 2;
 	_stringHistoryLength = 1;
 	_sysExHistoryLength = 1;
 	_initialized = false;
 	_totalDigitalPins = 0;
-	_executeMultiByteCommand = 0x00; // 0x00 a pin mode (input), not a command in Firmata -> fail hard
-	_multiByteChannel = 0;
 	_firstAnalogPin = -1;
 
-	for (unsigned char & e : _storedInputData) {
-		e = UCHAR_MAX;
-	}
 	for (int & e : _digitalPinMode) {
 		e = INT_MAX;
 	}
@@ -107,7 +216,7 @@ ofArduino::ofArduino() {
 }
 
 ofArduino::~ofArduino() {
-	_port.close();
+	disconnect();
 }
 
 // initialize pins once we get the Firmata version back from the Arduino board
@@ -156,10 +265,20 @@ void ofArduino::initPins() {
 	ofNotifyEvent(EInitialized, _majorFirmwareVersion, this);
 }
 
-bool ofArduino::connect(const std::string & device, int baud) {
+bool ofArduino::connect(const std::string & device, int baud, bool threaded) {
+	disconnect();
 	connectTime = ofGetElapsedTimef();
 	_initialized = false;
+	_parser.reset();
+	_threadPinState = _parser.getPinState();
+	_pendingMessages.clear();
+	_pendingSysEx.clear();
+	_numDroppedMessages = 0;
 	connected = _port.setup(device.c_str(), baud);
+	if (connected && threaded && _port.startReadThread()) {
+		_threadRunning = true;
+		_thread = std::thread(&ofArduino::threadedFunction, this);
+	}
 	sendFirmwareVersionRequest();
 	return connected;
 }
@@ -205,22 +324,96 @@ void ofArduino::setStringHistoryLength(int length) {
 }
 
 void ofArduino::disconnect() {
+	if (_thread.joinable()) {
+		_threadRunning = false;
+		_thread.join();
+	}
 	_port.close();
 }
 
 void ofArduino::update() {
-	vector <unsigned char> bytesToProcess;
+	if (_thread.joinable()) {
+		{
+			std::unique_lock<std::mutex> lock(_threadMutex);
+			std::swap(_pendingMessages, _processingMessages);
+			std::swap(_pendingSysEx, _processingSysEx);
+			if (_numDroppedMessages > 0) {
+				ofLogWarning("ofArduino") << "update(): dropped " << _numDroppedMessages << " messages, update() isn't called often enough";
+				_numDroppedMessages = 0;
+			}
+		}
+		for (auto & pending : _processingMessages) {
+			if (pending.message.type == ofFirmataParser::Message::SysEx) {
+				pending.message.data = _processingSysEx.data() + pending.sysExStart;
+			}
+			processMessage(pending.message);
+		}
+		_processingMessages.clear();
+		_processingSysEx.clear();
+		return;
+	}
+
 	int bytesToRead = _port.available();
 	if (bytesToRead > 0) {
-		bytesToProcess.resize(bytesToRead);
+		_readBuffer.resize(bytesToRead);
 		//its possible we dont get all the bytes
-		int bytesRead = _port.readBytes(&bytesToProcess[0], bytesToRead);
-		for (int i = 0; i < bytesRead; i++) {
-			processData((char)(bytesToProcess[i]));
+		int bytesRead = _port.readBytes(_readBuffer.data(), bytesToRead);
+		if (bytesRead > 0) {
+			_parser.parse(_readBuffer.data(), bytesRead, ofGetElapsedTimeMicros(), [this](const ofFirmataParser::Message & message) {
+				processMessage(message);
+			});
 		}
 	}
 }
 
+void ofArduino::threadedFunction() {
+	std::vector <unsigned char> block(4096);
+	std::vector <PendingMessage> messages;
+	std::vector <unsigned char> sysEx;
+	while (_threadRunning) {
+		if (!_port.waitForData(50)) {
+			continue;
+		}
+		auto bytesRead = _port.readBytes(block.data(), block.size());
+		if (bytesRead <= 0) {
+			continue;
+		}
+
+		_parser.parse(block.data(), bytesRead, _port.getLastReceiveTimeMicros(), [&](const ofFirmataParser::Message & message) {
+			messages.push_back(PendingMessage{message, sysEx.size()});
+			sysEx.insert(sysEx.end(), message.data, message.data + message.size);
+		});
+
+		std::unique_lock<std::mutex> lock(_threadMutex);
+		auto sysExBase = _pendingSysEx.size();
+		for (auto & pending : messages) {
+			if (_pendingMessages.size() >= maxPendingMessages) {
+				_numDroppedMessages++;
+				continue;
+			}
+			pending.sysExStart += sysExBase;
+			_pendingMessages.push_back(pending);
+		}
+		_pendingSysEx.insert(_pendingSysEx.end(), sysEx.begin(), sysEx.end());
+		_threadPinState = _parser.getPinState();
+		lock.unlock();
+		messages.clear();
+		sysEx.clear();
+	}
+}
+
+ofFirmataParser::PinState ofArduino::getPinState() const {
+	if (_thread.joinable()) {
+		std::unique_lock<std::mutex> lock(_threadMutex);
+		return _threadPinState;
+	}
+	return _parser.getPinState();
+}
+
+bool ofArduino::isThreaded() const {
+	return _thread.joinable();
+}
+
 int ofArduino::getAnalog(int pin) const {
 	if (!isAnalogPin(pin)) {
 		return -1;
@@ -559,100 +752,38 @@ bool ofArduino::isAttached() {
 
 // ------------------------------ private functions
 
-void ofArduino::processData(unsigned char inputData) {
-	ofLog() << "Received Byte: " << inputData;
-
-	// we have command data
-	if (_waitForData > 0 && inputData < 128) {
-		_waitForData--;
-
-		// collect the data
-		_storedInputData[_waitForData] = inputData;
-
-		// we have all data executeMultiByteCommand
-		if (_waitForData == 0) {
-			switch (_executeMultiByteCommand) {
-			case DIGITAL_MESSAGE:
-				processDigitalPort(_multiByteChannel, (_storedInputData[0] << 7) | _storedInputData[1]);
-				break;
+void ofArduino::processMessage(const ofFirmataParser::Message & message) {
+	switch (message.type) {
+	case ofFirmataParser::Message::Digital:
+		processDigitalPort(message.channel, message.value);
+		break;
 
-			case REPORT_VERSION:    // report version
-				_majorFirmwareVersion = _storedInputData[1];
-				_minorFirmwareVersion = _storedInputData[0];
-				ofNotifyEvent(EFirmwareVersionReceived, _majorFirmwareVersion, this);
-				break;
+	case ofFirmataParser::Message::Version:
+		_majorFirmwareVersion = message.value;
+		_minorFirmwareVersion = message.channel;
+		ofNotifyEvent(EFirmwareVersionReceived, _majorFirmwareVersion, this);
+		break;
 
-			case ANALOG_MESSAGE:
-				if (_initialized) {
-					if (_analogHistory[_multiByteChannel].size() > 0) {
-						int previous = _analogHistory[_multiByteChannel].front();
-
-						_analogHistory[_multiByteChannel].push_front((_storedInputData[0] << 7) | _storedInputData[1]);
-						if ((int)_analogHistory[_multiByteChannel].size() > _analogHistoryLength) {
-							_analogHistory[_multiByteChannel].pop_back();
-						}
-
-						// trigger an event if the pin has changed value
-						if (_analogHistory[_multiByteChannel].front() != previous) {
-							ofNotifyEvent(EAnalogPinChanged, _multiByteChannel, this);
-						}
-					}
-					else {
-						_analogHistory[_multiByteChannel].push_front((_storedInputData[0] << 7) | _storedInputData[1]);
-						if ((int)_analogHistory[_multiByteChannel].size() > _analogHistoryLength) {
-							_analogHistory[_multiByteChannel].pop_back();
-						}
-					}
-				}
-				break;
+	case ofFirmataParser::Message::Analog:
+		if (_initialized && message.channel < (int)_analogHistory.size()) {
+			auto & history = _analogHistory[message.channel];
+			bool changed = history.empty() || history.front() != message.value;
+			history.push_front(message.value);
+			if ((int)history.size() > _analogHistoryLength) {
+				history.pop_back();
 			}
 
+			// trigger an event if the pin has changed value
+			if (changed && history.size() > 1) {
+				int pin = message.channel;
+				ofNotifyEvent(EAnalogPinChanged, pin, this);
+			}
 		}
-	}
-	// we have SysEx command data
-	else if (_waitForData < 0) {
-
-		// we have all sysex data
-		if (inputData == END_SYSEX) {
-			_waitForData = 0;
-			processSysExData(_sysExData);
-			_sysExData.clear();
-		}
-		// still have data, collect it
-		else {
-			_sysExData.push_back((unsigned char)inputData);
-		}
-	}
-	// we have a command
-	else {
-
-		int command;
-
-		// extract the command and channel info from a byte if it is less than 0xF0
-		if (inputData < 0xF0) {
-			command = inputData & 0xF0;
-			_multiByteChannel = inputData & 0x0F;
-		}
-		else {
-			// commands in the 0xF* range don't use channel data
-			command = inputData;
-		}
-
-		switch (command) {
-		case REPORT_VERSION:
-		case DIGITAL_MESSAGE:
-		case ANALOG_MESSAGE:
-			_waitForData = 2;     // 2 bytes needed
-			_executeMultiByteCommand = command;
-			break;
-
-		case START_SYSEX:
-			_sysExData.clear();
-			_waitForData = -1;     // n bytes needed, -1 is used to indicate sysex message
-			_executeMultiByteCommand = command;
-			break;
-		}
+		break;
 
+	case ofFirmataParser::Message::SysEx:
+		processSysExData(vector <unsigned char>(message.data, message.data + message.size));
+		break;
 	}
 }
 
@@ -1652,7 +1783,10 @@ void ofArduino::detachEncoder(int encoderID) {
 
 //if the buffer gets out of sync we have to purge everything to get back on track
 void ofArduino::purge() {
-	while (_port.readByte() != -1);
+	// in threaded mode the thread is the only one reading from the port
+	if (!_thread.joinable()) {
+		while (_port.readByte() >= 0);
+	}
 	for (int i = 0; i < 5; i++)
 		sendByte(END_SYSEX);
 }
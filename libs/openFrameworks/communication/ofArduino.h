@@ -27,8 +27,13 @@
 #include "ofEvents.h"
 #include "ofSerial.h"
 #include "ofConstants.h"
+#include <array>
+#include <atomic>
+#include <functional>
 #include <list>
 #include <map>
+#include <mutex>
+#include <thread>
 
  /* Version numbers for the protocol.  The protocol is still changing, so these
  * version numbers are important.  This number can be queried so that host
@@ -251,6 +256,76 @@ struct Firmata_Serial_Data {
 	std::string			data;
 };
 
+/// \brief Splits the bytes received from a Firmata board into messages.
+///
+/// Works on whole blocks of bytes as they come from the port and keeps the
+/// state of a message split across blocks. Besides calling back for every
+/// message it keeps the last analog and digital values received, with the
+/// time they arrived, so they can be read without going through the events.
+///
+/// ofArduino uses it internally, it can also be used on its own to decode
+/// recorded data or data that comes from a different transport.
+class ofFirmataParser {
+public:
+	struct Message {
+		enum Type {
+			Analog,
+			Digital,
+			Version,
+			SysEx,
+		};
+
+		Type type;
+		/// \brief Analog pin for Analog, port for Digital and the minor
+		/// version for Version.
+		int channel;
+		/// \brief Pin value for Analog, the pins of the port for Digital and
+		/// the major version for Version.
+		int value;
+		/// \brief Data between START_SYSEX and END_SYSEX for SysEx, only
+		/// valid during the callback.
+		const unsigned char * data;
+		size_t size;
+	};
+
+	/// \brief Last values received for every pin.
+	struct PinState {
+		/// \brief Last value of every analog pin, -1 until one arrives.
+		std::array<int, 16> analog;
+		std::array<uint64_t, 16> analogTimeMicros;
+		/// \brief Last value of every digital port, -1 until one arrives.
+		std::array<int, ARD_TOTAL_PORTS> digitalPorts;
+		std::array<uint64_t, ARD_TOTAL_PORTS> digitalTimeMicros;
+		/// \brief Time the last message arrived.
+		uint64_t timeMicros;
+		uint64_t numMessages;
+
+		/// \returns ARD_HIGH or ARD_LOW, -1 if the pin's port hasn't been reported yet.
+		int getDigital(int pin) const;
+	};
+
+	typedef std::function<void(const Message &)> Callback;
+
+	ofFirmataParser();
+
+	/// \brief Parses a block of bytes calling callback for every complete message.
+	/// \param timeMicros Time the bytes were received, stored in the PinState.
+	void parse(const unsigned char * data, size_t size, uint64_t timeMicros, const Callback & callback);
+
+	/// \brief Discards a partially received message and the pin state.
+	void reset();
+
+	const PinState & getPinState() const;
+
+private:
+	int waitForData;
+	int command;
+	int channel;
+	unsigned char storedData[2];
+	std::vector<unsigned char> sysExData;
+	PinState pinState;
+};
+
 /// \brief This is a way to control an Arduino that has had the firmata library
 /// loaded onto it, from OF.
 ///
@@ -288,7 +363,10 @@ public:
 	/// \param device The name of the device.
 	/// You can get the name from the Arduino IDE
 	/// \param baud The baud rate the connection uses
-	bool connect(const std::string & device, int baud = 57600);
+	/// \param threaded Read and parse the incoming data in a background
+	/// thread as soon as it arrives. The events are still notified from
+	/// update() on the calling thread but getPinState() is always up to date.
+	bool connect(const std::string & device, int baud = 57600, bool threaded = false);
 
 	/// \brief Returns true if a succesfull connection has been established
 	/// and the Arduino has reported a firmware
@@ -307,6 +385,15 @@ public:
 	/// \brief Polls data from the serial port, this has to be called periodically
 	void update();
 
+	/// \brief Last values received for every pin and when they arrived.
+	///
+	/// When connected in threaded mode this is updated as soon as the data
+	/// arrives, without waiting for update(), and can be called from any
+	/// thread.
+	ofFirmataParser::PinState getPinState() const;
+
+	bool isThreaded() const;
+
 	/// \}
 	/// \name Setup
 	/// \{
@@ -720,7 +807,8 @@ private:
 
 	void purge();
 
-	void processData(unsigned char inputData);
+	void processMessage(const ofFirmataParser::Message & message);
+	void threadedFunction();
 	void processDigitalPort(int port, unsigned char value);
 	virtual void processSysExData(std::vector <unsigned char> data);
 
@@ -734,13 +822,26 @@ private:
 	int _sysExHistoryLength;
 
 	// --- data processing variables
-	int _waitForData;
-	int _executeMultiByteCommand; ///< \brief Indicate Firmata command to execute.
-	int _multiByteChannel; ///< \brief Indicates which pin the data came from.
+	ofFirmataParser _parser;
+	std::vector <unsigned char> _readBuffer;
+
+	// --- threaded reading, the thread parses the data and queues the
+	// messages so update() can notify them
+	struct PendingMessage {
+		ofFirmataParser::Message message;
+		size_t sysExStart;
+	};
+	std::thread _thread;
+	std::atomic<bool> _threadRunning;
+	mutable std::mutex _threadMutex;
+	std::vector <PendingMessage> _pendingMessages;
+	std::vector <unsigned char> _pendingSysEx;
+	std::vector <PendingMessage> _processingMessages;
+	std::vector <unsigned char> _processingSysEx;
+	ofFirmataParser::PinState _threadPinState;
+	uint64_t _numDroppedMessages;
 
 	// --- data holders
-	unsigned char _storedInputData[FIRMATA_MAX_DATA_BYTES];
-	std::vector <unsigned char> _sysExData;
 	int _majorFirmwareVersion;
 	int _minorFirmwareVersion;
 	std::string _firmwareName;
@@ -6,6 +6,7 @@
 	#include <sys/ioctl.h>
 	#include <getopt.h>
 	#include <dirent.h>
+	#include <poll.h>
 #endif
 
 
@@ -13,7 +14,11 @@
 #include <errno.h>
 #include <ctype.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <thread>
 
 #ifdef TARGET_LINUX
 	#include <linux/serial.h>
@@ -94,6 +99,86 @@ void ofSerial::enumerateWin32Ports(){
 
 
 
+//----------------------------------------------------------------
+// single producer, single consumer ring buffer filled by the read thread,
+// the positions only grow so the used space is always write - read.
+// a side that is going to wait sets its flag and then checks the position,
+// the other side moves the position and then checks the flag. the seq_cst
+// fences between each store and load make sure at least one of them sees
+// the other's store, so a notification is never lost
+struct ofSerial::ReadThread{
+	std::vector<char> buffer;
+	size_t mask = 0;
+	std::atomic<uint64_t> writePos{0};
+	std::atomic<uint64_t> readPos{0};
+	std::atomic<uint64_t> lastReceiveTime{0};
+	std::atomic<bool> running{false};
+	std::atomic<bool> readerWaiting{false};
+	std::atomic<bool> writerWaiting{false};
+	std::mutex mutex;
+	std::condition_variable dataAvailable;
+	std::condition_variable spaceAvailable;
+	std::thread thread;
+#ifdef TARGET_WIN32
+	COMMTIMEOUTS timeouts;
+#endif
+
+	size_t size() const{
+		return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_relaxed);
+	}
+
+	size_t read(char * data, size_t length){
+		auto read = readPos.load(std::memory_order_relaxed);
+		auto available = writePos.load(std::memory_order_acquire) - read;
+		length = std::min<size_t>(length, available);
+		auto start = read & mask;
+		auto first = std::min(length, buffer.size() - start);
+		memcpy(data, buffer.data() + start, first);
+		memcpy(data + first, buffer.data(), length - first);
+		readPos.store(read + length, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(length > 0 && writerWaiting.load()){
+			std::unique_lock<std::mutex> lock(mutex);
+			spaceAvailable.notify_one();
+		}
+		return length;
+	}
+
+	void clear(){
+		readPos.store(writePos.load(std::memory_order_acquire), std::memory_order_release);
+		std::unique_lock<std::mutex> lock(mutex);
+		spaceAvailable.notify_one();
+	}
+
+	// returns the free contiguous space after the write position, waits
+	// for the reader when the buffer is full
+	size_t waitForSpace(){
+		auto write = writePos.load(std::memory_order_relaxed);
+		auto free = buffer.size() - (write - readPos.load(std::memory_order_acquire));
+		if(free == 0){
+			std::unique_lock<std::mutex> lock(mutex);
+			writerWaiting = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			spaceAvailable.wait_for(lock, std::chrono::milliseconds(50), [&]{
+				return !running || write - readPos.load(std::memory_order_acquire) < buffer.size();
+			});
+			writerWaiting = false;
+			free = buffer.size() - (write - readPos.load(std::memory_order_acquire));
+		}
+		return std::min(free, buffer.size() - (write & mask));
+	}
+
+	void written(size_t length){
+		writePos.store(writePos.load(std::memory_order_relaxed) + length, std::memory_order_release);
+		lastReceiveTime = ofGetElapsedTimeMicros();
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(readerWaiting.load()){
+			std::unique_lock<std::mutex> lock(mutex);
+			dataAvailable.notify_all();
+		}
+	}
+};
+
 //----------------------------------------------------------------
 ofSerial::ofSerial(){
 
@@ -241,6 +326,7 @@ void ofSerial::enumerateDevices(){
 
 //----------------------------------------------------------------
 void ofSerial::close(){
+	stopReadThread();
 
 	#ifdef TARGET_WIN32
 
@@ -523,6 +609,14 @@ long ofSerial::readBytes(char * buffer, size_t length){
 		return OF_SERIAL_ERROR;
 	}
 
+	if(readThread){
+		auto nRead = readThread->read(buffer, length);
+		if(nRead == 0 && length > 0){
+			return OF_SERIAL_NO_DATA;
+		}
+		return nRead;
+	}
+
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 
 		auto nRead = read(fd, buffer, length);
@@ -580,6 +674,13 @@ int ofSerial::readByte(){
 
 	unsigned char tmpByte = 0;
 
+	if(readThread){
+		if(readThread->read(reinterpret_cast<char*>(&tmpByte), 1) == 0){
+			return OF_SERIAL_NO_DATA;
+		}
+		return tmpByte;
+	}
+
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 
 		int nRead = read(fd, &tmpByte, 1);
@@ -625,6 +726,10 @@ void ofSerial::flush(bool flushIn, bool flushOut){
 		return;
 	}
 
+	if(flushIn && readThread){
+		readThread->clear();
+	}
+
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
 		int flushType = 0;
 		if(flushIn && flushOut) flushType = TCIOFLUSH;
@@ -666,6 +771,10 @@ int ofSerial::available(){
 		return OF_SERIAL_ERROR;
 	}
 
+	if(readThread){
+		return readThread->size();
+	}
+
 	int numBytes = 0;
 
 	#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
@@ -696,3 +805,134 @@ int ofSerial::available(){
 bool ofSerial::isInitialized() const{
 	return bInited;
 }
+
+//----------------------------------------------------------------
+bool ofSerial::startReadThread(size_t bufferSize){
+	if(!bInited){
+		ofLogError("ofSerial") << "startReadThread(): serial not inited";
+		return false;
+	}
+	stopReadThread();
+
+	size_t size = 2;
+	while(size < bufferSize){
+		size *= 2;
+	}
+	readThread.reset(new ReadThread);
+	readThread->buffer.resize(size);
+	readThread->mask = size - 1;
+	readThread->running = true;
+
+	#ifdef TARGET_WIN32
+		// ReadFile returns as soon as there's any data or after 50ms
+		// so the thread can check if it has to stop
+		GetCommTimeouts(hComm, &readThread->timeouts);
+		COMMTIMEOUTS tOut = readThread->timeouts;
+		tOut.ReadIntervalTimeout = MAXDWORD;
+		tOut.ReadTotalTimeoutMultiplier = MAXDWORD;
+		tOut.ReadTotalTimeoutConstant = 50;
+		SetCommTimeouts(hComm, &tOut);
+	#endif
+
+	auto thread = readThread.get();
+	thread->thread = std::thread([this, thread]{
+		bool hangUpReported = false;
+		while(thread->running){
+			auto free = thread->waitForSpace();
+			if(free == 0){
+				continue;
+			}
+			auto data = thread->buffer.data() + (thread->writePos.load(std::memory_order_relaxed) & thread->mask);
+
+		#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
+			pollfd pfd{fd, POLLIN, 0};
+			auto ready = poll(&pfd, 1, 50);
+			if(ready <= 0){
+				continue;
+			}
+			if(!(pfd.revents & POLLIN)){
+				// the other end is gone, keep the port open in case it comes
+				// back but don't spin while it's away
+				if(!hangUpReported){
+					ofLogWarning("ofSerial") << "read thread: the device hung up";
+					hangUpReported = true;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				continue;
+			}
+			hangUpReported = false;
+			auto nRead = read(fd, data, free);
+			if(nRead < 0 && errno != EAGAIN && errno != EINTR){
+				ofLogError("ofSerial") << "read thread: couldn't read from port: " << errno << " " << strerror(errno);
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				continue;
+			}
+		#elif defined( TARGET_WIN32 )
+			DWORD nRead = 0;
+			if(!ReadFile(hComm, data, free, &nRead, 0)){
+				if(!hangUpReported){
+					ofLogError("ofSerial") << "read thread: couldn't read from port";
+					hangUpReported = true;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				continue;
+			}
+			hangUpReported = false;
+		#else
+			long nRead = 0;
+		#endif
+			if(nRead > 0){
+				thread->written(nRead);
+			}
+		}
+	});
+	return true;
+}
+
+//----------------------------------------------------------------
+void ofSerial::stopReadThread(){
+	if(!readThread){
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock(readThread->mutex);
+		readThread->running = false;
+		readThread->spaceAvailable.notify_all();
+		readThread->dataAvailable.notify_all();
+	}
+	if(readThread->thread.joinable()){
+		readThread->thread.join();
+	}
+	#ifdef TARGET_WIN32
+		SetCommTimeouts(hComm, &readThread->timeouts);
+	#endif
+	readThread.reset();
+}
+
+//----------------------------------------------------------------
+bool ofSerial::isReadThreadRunning() const{
+	return readThread != nullptr;
+}
+
+//----------------------------------------------------------------
+bool ofSerial::waitForData(uint64_t timeoutMs){
+	if(!readThread){
+		return false;
+	}
+	if(readThread->size() > 0){
+		return true;
+	}
+	std::unique_lock<std::mutex> lock(readThread->mutex);
+	readThread->readerWaiting = true;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	readThread->dataAvailable.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]{
+		return !readThread->running || readThread->size() > 0;
+	});
+	readThread->readerWaiting = false;
+	return readThread->size() > 0;
+}
+
+//----------------------------------------------------------------
+uint64_t ofSerial::getLastReceiveTimeMicros() const{
+	return readThread ? readThread->lastReceiveTime.load() : 0;
+}
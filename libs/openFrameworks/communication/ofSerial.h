@@ -329,6 +329,52 @@ public:
 	void drain();
 
 	/// \}
+	/// \name Threaded Reading
+	/// \{
+
+	/// \brief Reads from the port in a background thread as soon as data arrives.
+	///
+	/// The thread waits for the port to have data and copies it into a ring
+	/// buffer, so the system buffers don't overflow at high baud rates when
+	/// the application is slow to read them. While the thread runs,
+	/// available(), readBytes() and readByte() read from the ring buffer
+	/// without any system call. Writing still happens from the calling thread.
+	///
+	/// The ring buffer is lock free for a single reader, only one thread should
+	/// read from the port while the read thread is running:
+	///
+	/// ~~~~{.cpp}
+	/// serial.setup("/dev/ttyUSB0", 115200);
+	/// serial.startReadThread();
+	///
+	/// // in another thread
+	/// while(serial.waitForData(100)){
+	///     auto numBytes = serial.readBytes(buffer, sizeof(buffer));
+	/// }
+	/// ~~~~
+	///
+	/// If the ring buffer fills up the thread stops reading until there's space.
+	///
+	/// \param bufferSize Size of the ring buffer in bytes, rounded up to a power of 2.
+	/// \returns false if the port isn't open.
+	bool startReadThread(size_t bufferSize = 64 * 1024);
+
+	/// \brief Stops the read thread, data still in the ring buffer is discarded.
+	void stopReadThread();
+
+	bool isReadThreadRunning() const;
+
+	/// \brief Waits until the read thread has received data.
+	/// \param timeoutMs Maximum time to wait in milliseconds.
+	/// \returns true if there is data to read, always false when the read
+	/// thread isn't running.
+	bool waitForData(uint64_t timeoutMs);
+
+	/// \returns The time, as ofGetElapsedTimeMicros(), when the read thread
+	/// last received data.
+	uint64_t getLastReceiveTimeMicros() const;
+
+	/// \}
 
 protected:
 	/// \brief Enumerate all devices attached to a serial port.
@@ -344,6 +390,9 @@ protected:
 	bool bHaveEnumeratedDevices;  ///\< \brief Indicate having enumerated devices (serial ports) available.
 	bool bInited;  ///\< \brief Indicate the successful initialization of the serial connection.
 
+	struct ReadThread;
+	std::unique_ptr<ReadThread> readThread; ///< \brief The thread and ring buffer used by startReadThread().
+
 #ifdef TARGET_WIN32
 
 	/// \brief Enumerate all serial ports on Microsoft Windows.
@@ -2,6 +2,7 @@
 #include "ofAppRunner.h"
 #include "ofAppBaseWindow.h"
 #include "ofLog.h"
+#include "ofProfiler.h"
 
 static ofEventArgs voidEventArgs;
 
@@ -275,20 +276,27 @@ int ofCoreEvents::getModifiers() const{
 
 //------------------------------------------
 bool ofCoreEvents::notifySetup(){
+	OF_PROFILE_ZONE("setup");
 	return ofNotifyEvent( setup, voidEventArgs );
 }
 
 #include "ofGraphics.h"
 //------------------------------------------
 bool ofCoreEvents::notifyUpdate(){
+	OF_PROFILE_ZONE("update");
 	return ofNotifyEvent( update, voidEventArgs );
 }
 
 //------------------------------------------
 bool ofCoreEvents::notifyDraw(){
-	auto attended = ofNotifyEvent( draw, voidEventArgs );
+	bool attended;
+	{
+		OF_PROFILE_ZONE("draw");
+		attended = ofNotifyEvent( draw, voidEventArgs );
+	}
 
 	if (bFrameRateSet){
+		OF_PROFILE_ZONE("wait for frame rate");
 		timer.waitNext();
 	}
 	
@@ -321,6 +329,7 @@ bool ofCoreEvents::notifyKeyReleased(int key, int keycode, int scancode, uint32_
 
 //------------------------------------------
 bool ofCoreEvents::notifyKeyEvent(ofKeyEventArgs & e){
+	OF_PROFILE_ZONE("key event");
 	bool attended = false;
 	modifiers = e.modifiers;
 	switch(e.type){
@@ -450,6 +459,7 @@ void ofCoreEvents::notifyTouchDoubleTap(int x, int y, int touchID){
 
 //------------------------------------------
 void ofCoreEvents::notifyTouchEvent(ofTouchEventArgs & touchArgs){
+	OF_PROFILE_ZONE("touch event");
 	switch(touchArgs.type){
 		case ofTouchEventArgs::move:
 			ofNotifyEvent( touchMoved, touchArgs );
@@ -472,6 +482,7 @@ void ofCoreEvents::notifyTouchEvent(ofTouchEventArgs & touchArgs){
 
 //------------------------------------------
 bool  ofCoreEvents::notifyMouseEvent(ofMouseEventArgs & e){
+	OF_PROFILE_ZONE("mouse event");
 	modifiers = e.modifiers;
 	switch(e.type){
 		case ofMouseEventArgs::Moved:
@@ -590,6 +601,7 @@ bool ofCoreEvents::notifyMouseExited(int x, int y){
 
 //------------------------------------------
 bool ofCoreEvents::notifyExit(){
+	OF_PROFILE_ZONE("exit");
 	return ofNotifyEvent( exit, voidEventArgs );
 }
 
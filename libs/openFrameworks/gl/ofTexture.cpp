@@ -5,6 +5,7 @@
 #include "ofGLBaseTypes.h"
 #include "ofBufferObject.h"
 #include "ofMesh.h"
+#include "ofProfiler.h"
 #include <unordered_map>
 
 #ifdef TARGET_ANDROID
@@ -651,6 +652,7 @@ void ofTexture::loadData(const ofBufferObject & buffer, int glFormat, int glType
 
 //----------------------------------------------------------
 void ofTexture::loadData(const void * data, int w, int h, int glFormat, int glType){
+	OF_PROFILE_ZONE("ofTexture::loadData");
 
 	if(w > texData.tex_w || h > texData.tex_h) {
 		if(isAllocated()){
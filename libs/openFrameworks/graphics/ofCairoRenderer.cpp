@@ -7,10 +7,161 @@
 #include "ofMesh.h"
 #include "ofTrueTypeFont.h"
 #include "ofVideoBaseTypes.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OF_CAIRO_SSE2
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define OF_CAIRO_SSSE3
+#endif
 
 using std::string;
 using std::vector;
 
+namespace {
+	// cairo pixels are native endian 32 bit words, writing them as uint32_t
+	// keeps the conversion independent of the byte order, the simd versions
+	// are only used on x86 which is always little endian
+	inline uint32_t premultiply(uint32_t c, uint32_t a) {
+		uint32_t t = c * a + 128;
+		return (t + (t >> 8)) >> 8;
+	}
+
+	// R and B are the offsets of red and blue in the source pixel
+	template <int R, int B>
+	void rgbToCairo(const unsigned char * src, uint32_t * dst, size_t width) {
+		size_t i = 0;
+#ifdef OF_CAIRO_SSSE3
+		// 16 bytes are loaded for every 4 pixels so stop 2 pixels early
+		const __m128i shuffle = _mm_setr_epi8(B, 1, R, -1, 3 + B, 4, 3 + R, -1, 6 + B, 7, 6 + R, -1, 9 + B, 10, 9 + R, -1);
+		const __m128i opaque = _mm_set1_epi32(0xff000000);
+		for (; i + 6 <= width; i += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), opaque));
+		}
+#endif
+		for (; i < width; i++) {
+			auto p = src + i * 3;
+			dst[i] = 0xff000000u | (uint32_t(p[R]) << 16) | (uint32_t(p[1]) << 8) | p[B];
+		}
+	}
+
+	template <int R, int B>
+	void rgbaToCairo(const unsigned char * src, uint32_t * dst, size_t width) {
+		size_t i = 0;
+#ifdef OF_CAIRO_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alphaLanes = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+		const __m128i alphaMax = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+		const __m128i half = _mm_set1_epi16(128);
+		auto premultiply2 = [&](__m128i x) {
+			// x holds 2 pixels as 16 bit lanes, the alpha lane is multiplied by
+			// 255 so it comes out unchanged
+			if (R == 0) {
+				x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 0, 1, 2));
+				x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 0, 1, 2));
+			}
+			__m128i a = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+			a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+			a = _mm_or_si128(_mm_andnot_si128(alphaLanes, a), alphaMax);
+			__m128i t = _mm_add_epi16(_mm_mullo_epi16(x, a), half);
+			return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		};
+		for (; i + 4 <= width; i += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+			__m128i lo = premultiply2(_mm_unpacklo_epi8(v, zero));
+			__m128i hi = premultiply2(_mm_unpackhi_epi8(v, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+		}
+#endif
+		for (; i < width; i++) {
+			auto p = src + i * 4;
+			uint32_t a = p[3];
+			dst[i] = (a << 24) | (premultiply(p[R], a) << 16) | (premultiply(p[1], a) << 8) | premultiply(p[B], a);
+		}
+	}
+
+	inline uint32_t unpremultiply(uint32_t c, uint32_t a) {
+		return a == 0 ? 0 : std::min<uint32_t>((c * 255 + a / 2) / a, 255);
+	}
+
+	// writes a row of cairo pixels as rgb or straight, not premultiplied, rgba
+	void cairoToRgb(const uint32_t * src, unsigned char * dst, size_t width, bool alpha) {
+		for (size_t i = 0; i < width; i++) {
+			uint32_t p = src[i];
+			uint32_t a = p >> 24;
+			uint32_t r = (p >> 16) & 0xff;
+			uint32_t g = (p >> 8) & 0xff;
+			uint32_t b = p & 0xff;
+			if (alpha) {
+				dst[0] = unpremultiply(r, a);
+				dst[1] = unpremultiply(g, a);
+				dst[2] = unpremultiply(b, a);
+				dst[3] = a;
+				dst += 4;
+			} else {
+				dst[0] = r;
+				dst[1] = g;
+				dst[2] = b;
+				dst += 3;
+			}
+		}
+	}
+
+	void grayToCairo(const unsigned char * src, uint32_t * dst, size_t width) {
+		size_t i = 0;
+#ifdef OF_CAIRO_SSE2
+		const __m128i opaque = _mm_set1_epi8(-1);
+		for (; i + 16 <= width; i += 16) {
+			__m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+			__m128i gg = _mm_unpacklo_epi8(g, g);
+			__m128i ga = _mm_unpacklo_epi8(g, opaque);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi16(gg, ga));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4), _mm_unpackhi_epi16(gg, ga));
+			gg = _mm_unpackhi_epi8(g, g);
+			ga = _mm_unpackhi_epi8(g, opaque);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_unpacklo_epi16(gg, ga));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 12), _mm_unpackhi_epi16(gg, ga));
+		}
+#endif
+		for (; i < width; i++) {
+			dst[i] = 0xff000000u | (uint32_t(src[i]) * 0x010101u);
+		}
+	}
+
+	void grayAlphaToCairo(const unsigned char * src, uint32_t * dst, size_t width) {
+		for (size_t i = 0; i < width; i++) {
+			uint32_t a = src[i * 2 + 1];
+			dst[i] = (a << 24) | (premultiply(src[i * 2], a) * 0x010101u);
+		}
+	}
+
+	// only used to notice if the pixels of a cached surface changed, four
+	// independent lanes so the multiplications don't wait on each other
+	uint64_t hashPixels(const unsigned char * data, size_t size) {
+		const uint64_t k = 0x9E3779B97F4A7C15ull;
+		uint64_t h[4] = { size, k, k << 1, k << 2 };
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32) {
+			for (int lane = 0; lane < 4; lane++) {
+				uint64_t word;
+				memcpy(&word, data + i + lane * 8, 8);
+				h[lane] = (h[lane] ^ word) * k;
+				h[lane] ^= h[lane] >> 32;
+			}
+		}
+		for (; i < size; i++) {
+			h[0] = (h[0] ^ data[i]) * k;
+		}
+		return (h[0] ^ (h[1] * 3) ^ (h[2] * 5) ^ (h[3] * 7)) * k;
+	}
+}
+
 const string ofCairoRenderer::TYPE = "cairo";
 
 _cairo_status ofCairoRenderer::stream_function(void * closure, const unsigned char * data, unsigned int length) {
@@ -29,6 +180,9 @@ ofCairoRenderer::ofCairoRenderer()
 	page = 0;
 	multiPage = false;
 	b3D = false;
+	bTiled = false;
+	bTilesDirty = false;
+	imageCacheSize = 64 * 1024 * 1024;
 	currentMatrixMode = OF_MATRIX_MODELVIEW;
 }
 
@@ -37,6 +191,178 @@ ofCairoRenderer::~ofCairoRenderer() {
 }
 
 void ofCairoRenderer::setup(const of::filesystem::path & _filename, Type _type, bool multiPage_, bool b3D_, ofRectangle outputsize) {
+	bTiled = false;
+	setupSurface(_filename, _type, multiPage_, b3D_, outputsize);
+}
+
+void ofCairoRenderer::setupTiled(const of::filesystem::path & _filename, const TileSettings & settings, ofRectangle outputsize) {
+	bTiled = true;
+	tileSettings = settings;
+	if (tileSettings.streamToFile) {
+		auto ext = ofToLower(_filename.extension().string());
+		if (ext != ".ppm" && ext != ".pam") {
+			ofLogWarning("ofCairoRenderer") << "setupTiled(): can only stream to .ppm or .pam files, keeping " << _filename << " in memory";
+			tileSettings.streamToFile = false;
+		}
+	}
+	setupSurface(_filename, IMAGE, true, false, outputsize);
+}
+
+bool ofCairoRenderer::isTiled() const {
+	return bTiled;
+}
+
+void ofCairoRenderer::setImageCacheSize(size_t bytes) {
+	imageCacheSize = bytes;
+	evictCachedImages();
+}
+
+void ofCairoRenderer::evictCachedImages() const {
+	while (imageCacheStats.numBytes > imageCacheSize) {
+		auto & oldest = imageCache.back();
+		imageCacheIndex.erase(oldest.data);
+		imageCacheStats.numBytes -= oldest.bytes;
+		imageCacheStats.numSurfaces--;
+		imageCacheStats.numEvicted++;
+		cairo_surface_destroy(oldest.surface);
+		imageCache.pop_back();
+	}
+}
+
+size_t ofCairoRenderer::getImageCacheSize() const {
+	return imageCacheSize;
+}
+
+void ofCairoRenderer::clearImageCache() {
+	for (auto & cached : imageCache) {
+		cairo_surface_destroy(cached.surface);
+	}
+	imageCache.clear();
+	imageCacheIndex.clear();
+	imageCacheStats.numSurfaces = 0;
+	imageCacheStats.numBytes = 0;
+}
+
+ofCairoRenderer::ImageCacheStats ofCairoRenderer::getImageCacheStats() const {
+	return imageCacheStats;
+}
+
+cairo_format_t ofCairoRenderer::getCairoFormat(ofPixelFormat format) {
+	switch (format) {
+	case OF_PIXELS_RGB:
+	case OF_PIXELS_BGR:
+	case OF_PIXELS_GRAY:
+		return CAIRO_FORMAT_RGB24;
+	case OF_PIXELS_RGBA:
+	case OF_PIXELS_BGRA:
+	case OF_PIXELS_GRAY_ALPHA:
+		return CAIRO_FORMAT_ARGB32;
+	default:
+		return CAIRO_FORMAT_INVALID;
+	}
+}
+
+bool ofCairoRenderer::toCairoPixels(const ofPixels & pixels, unsigned char * dst, int dstStride) {
+	void (*convert)(const unsigned char *, uint32_t *, size_t);
+	switch (pixels.getPixelFormat()) {
+	case OF_PIXELS_RGB:
+		convert = rgbToCairo<0, 2>;
+		break;
+	case OF_PIXELS_BGR:
+		convert = rgbToCairo<2, 0>;
+		break;
+	case OF_PIXELS_RGBA:
+		convert = rgbaToCairo<0, 2>;
+		break;
+	case OF_PIXELS_BGRA:
+		convert = rgbaToCairo<2, 0>;
+		break;
+	case OF_PIXELS_GRAY:
+		convert = grayToCairo;
+		break;
+	case OF_PIXELS_GRAY_ALPHA:
+		convert = grayAlphaToCairo;
+		break;
+	default:
+		return false;
+	}
+	auto src = pixels.getData();
+	auto srcStride = pixels.getBytesStride();
+	for (size_t y = 0; y < pixels.getHeight(); y++) {
+		convert(src + y * srcStride, reinterpret_cast<uint32_t *>(dst + y * dstStride), pixels.getWidth());
+	}
+	return true;
+}
+
+cairo_surface_t * ofCairoRenderer::createCairoSurface(const ofPixels & pixels) {
+	auto format = getCairoFormat(pixels.getPixelFormat());
+	if (format == CAIRO_FORMAT_INVALID) {
+		return nullptr;
+	}
+	auto image = cairo_image_surface_create(format, pixels.getWidth(), pixels.getHeight());
+	if (cairo_surface_status(image) != CAIRO_STATUS_SUCCESS) {
+		cairo_surface_destroy(image);
+		return nullptr;
+	}
+	cairo_surface_flush(image);
+	toCairoPixels(pixels, cairo_image_surface_get_data(image), cairo_image_surface_get_stride(image));
+	cairo_surface_mark_dirty(image);
+	return image;
+}
+
+cairo_surface_t * ofCairoRenderer::getCachedSurface(const ofPixels & pixels) const {
+	auto format = getCairoFormat(pixels.getPixelFormat());
+	if (format == CAIRO_FORMAT_INVALID) {
+		return nullptr;
+	}
+	size_t bytes = size_t(cairo_format_stride_for_width(format, pixels.getWidth())) * pixels.getHeight();
+	if (bytes > imageCacheSize) {
+		return nullptr;
+	}
+
+	// hashing is much cheaper than converting and allocating a new surface
+	// and catches pixels that changed or a buffer reused by other pixels
+	auto hash = hashPixels(pixels.getData(), pixels.getTotalBytes());
+	auto found = imageCacheIndex.find(pixels.getData());
+	if (found != imageCacheIndex.end()) {
+		auto cached = found->second;
+		if (cached->width == pixels.getWidth() && cached->height == pixels.getHeight() && cached->format == pixels.getPixelFormat()) {
+			imageCache.splice(imageCache.begin(), imageCache, cached);
+			if (cached->hash != hash) {
+				// same pixels with new contents, like a video frame. marking
+				// the surface dirty detaches the snapshots PDF and recording
+				// surfaces keep of the previous contents
+				imageCacheStats.numMisses++;
+				cairo_surface_flush(cached->surface);
+				toCairoPixels(pixels, cairo_image_surface_get_data(cached->surface), cairo_image_surface_get_stride(cached->surface));
+				cairo_surface_mark_dirty(cached->surface);
+				cached->hash = hash;
+			} else {
+				imageCacheStats.numHits++;
+			}
+			return cached->surface;
+		}
+		imageCacheStats.numBytes -= cached->bytes;
+		imageCacheStats.numSurfaces--;
+		cairo_surface_destroy(cached->surface);
+		imageCache.erase(cached);
+		imageCacheIndex.erase(found);
+	}
+
+	imageCacheStats.numMisses++;
+	auto image = createCairoSurface(pixels);
+	if (!image) {
+		return nullptr;
+	}
+	imageCache.push_front(CachedImage { pixels.getData(), pixels.getWidth(), pixels.getHeight(), pixels.getPixelFormat(), hash, bytes, image });
+	imageCacheIndex[pixels.getData()] = imageCache.begin();
+	imageCacheStats.numBytes += bytes;
+	imageCacheStats.numSurfaces++;
+	evictCachedImages();
+	return image;
+}
+
+void ofCairoRenderer::setupSurface(const of::filesystem::path & _filename, Type _type, bool multiPage_, bool b3D_, ofRectangle outputsize) {
 	if (outputsize.width == 0 || outputsize.height == 0) {
 		outputsize.set(0, 0, ofGetViewportWidth(), ofGetViewportHeight());
 	}
@@ -85,9 +411,17 @@ void ofCairoRenderer::setup(const of::filesystem::path & _filename, Type _type,
 		}
 		break;
 	case IMAGE:
-		imageBuffer.allocate(outputsize.width, outputsize.height, OF_PIXELS_BGRA);
-		imageBuffer.set(0);
-		surface = cairo_image_surface_create_for_data(imageBuffer.getData(), CAIRO_FORMAT_ARGB32, outputsize.width, outputsize.height, outputsize.width * 4);
+		if (bTiled) {
+			// the pixels are only allocated when the recording is rasterized
+			cairo_rectangle_t extents { 0, 0, outputsize.width, outputsize.height };
+			imageBuffer.clear();
+			surface = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+			bTilesDirty = true;
+		} else {
+			imageBuffer.allocate(outputsize.width, outputsize.height, OF_PIXELS_BGRA);
+			imageBuffer.set(0);
+			surface = cairo_image_surface_create_for_data(imageBuffer.getData(), CAIRO_FORMAT_ARGB32, outputsize.width, outputsize.height, outputsize.width * 4);
+		}
 		break;
 	case FROM_FILE_EXTENSION:
 		ofLogFatalError("ofCairoRenderer") << "setup(): couldn't determine type from extension for filename: " << _filename << "!";
@@ -121,7 +455,10 @@ void ofCairoRenderer::flush() {
 void ofCairoRenderer::close() {
 	if (surface) {
 		cairo_surface_flush(surface);
-		if (type == IMAGE && filename != "") {
+		if (bTiled && bTilesDirty) {
+			rasterizeTiles();
+		}
+		if (type == IMAGE && filename != "" && !(bTiled && tileSettings.streamToFile)) {
 			ofSaveImage(imageBuffer, filename);
 		}
 		cairo_surface_finish(surface);
@@ -132,6 +469,7 @@ void ofCairoRenderer::close() {
 		cairo_destroy(cr);
 		cr = nullptr;
 	}
+	clearImageCache();
 }
 
 void ofCairoRenderer::startRender() {
@@ -140,13 +478,141 @@ void ofCairoRenderer::startRender() {
 		page = 1;
 	} else {
 		page++;
-		if (getBackgroundAuto()) {
+		if (bTiled) {
+			// an unclipped clear drops everything recorded so far, otherwise
+			// the recording keeps the previous frames like copy_page
+			if (getBackgroundAuto()) {
+				cairo_save(cr);
+				cairo_reset_clip(cr);
+				cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+				cairo_paint(cr);
+				cairo_restore(cr);
+				clear();
+			}
+		} else if (getBackgroundAuto()) {
 			cairo_show_page(cr);
 			clear();
 		} else {
 			cairo_copy_page(cr);
 		}
 	}
+	bTilesDirty = bTiled;
+}
+
+bool ofCairoRenderer::rasterizeTiles() {
+	bTilesDirty = false;
+	cairo_surface_flush(surface);
+
+	int width = originalViewport.width;
+	int height = originalViewport.height;
+	if (width <= 0 || height <= 0) {
+		return false;
+	}
+	int tileWidth = std::max(1, std::min(tileSettings.tileWidth, width));
+	int tileHeight = std::max(1, std::min(tileSettings.tileHeight, height));
+	int numTilesX = (width + tileWidth - 1) / tileWidth;
+	bool streaming = tileSettings.streamToFile && filename != "";
+
+	// when streaming only a row of tiles is in memory at a time
+	ofPixels band;
+	ofFile file;
+	bool rgba = false;
+	int bandHeight = height;
+	if (streaming) {
+		rgba = ofToLower(filename.extension().string()) == ".pam";
+		if (!file.open(filename, ofFile::WriteOnly, true)) {
+			ofLogError("ofCairoRenderer") << "couldn't open " << filename << " to stream the image";
+			return false;
+		}
+		if (rgba) {
+			file << "P7\nWIDTH " << width << "\nHEIGHT " << height << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+		} else {
+			file << "P6\n" << width << " " << height << "\n255\n";
+		}
+		bandHeight = tileHeight;
+		band.allocate(width, bandHeight, OF_PIXELS_BGRA);
+		imageBuffer.clear();
+	} else if (imageBuffer.getWidth() != (size_t)width || imageBuffer.getHeight() != (size_t)height) {
+		imageBuffer.allocate(width, height, OF_PIXELS_BGRA);
+	}
+
+	size_t numThreads = tileSettings.numThreads;
+	if (numThreads == 0) {
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	size_t tilesPerBand = numTilesX * ((bandHeight + tileHeight - 1) / tileHeight);
+	numThreads = std::min(numThreads, tilesPerBand);
+
+	// cairo objects can't be used from several threads at the same time so
+	// every thread replays its own copy of the recording. Marking the
+	// recording dirty detaches the snapshot the copy holds, otherwise the
+	// next copy would share it
+	cairo_rectangle_t extents { 0, 0, double(width), double(height) };
+	std::vector<cairo_surface_t *> recordings(numThreads);
+	for (auto & recording : recordings) {
+		recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+		cairo_t * copy = cairo_create(recording);
+		cairo_set_source_surface(copy, surface, 0, 0);
+		cairo_paint(copy);
+		cairo_destroy(copy);
+		cairo_surface_mark_dirty(surface);
+	}
+
+	std::vector<unsigned char> row;
+	bool ok = true;
+	for (int bandY = 0; bandY < height && ok; bandY += bandHeight) {
+		int currentBandHeight = std::min(bandHeight, height - bandY);
+		auto & pixels = streaming ? band : imageBuffer;
+		size_t stride = pixels.getBytesStride();
+		size_t numTiles = numTilesX * ((currentBandHeight + tileHeight - 1) / tileHeight);
+		std::atomic<size_t> nextTile(0);
+
+		auto worker = [&](cairo_surface_t * recording) {
+			for (size_t i = nextTile++; i < numTiles; i = nextTile++) {
+				int x = (i % numTilesX) * tileWidth;
+				int y = (i / numTilesX) * tileHeight;
+				int w = std::min(tileWidth, width - x);
+				int h = std::min(tileHeight, currentBandHeight - y);
+				auto data = pixels.getData() + y * stride + x * 4;
+				auto tile = cairo_image_surface_create_for_data(data, CAIRO_FORMAT_ARGB32, w, h, stride);
+				auto tileCr = cairo_create(tile);
+				cairo_set_operator(tileCr, CAIRO_OPERATOR_CLEAR);
+				cairo_paint(tileCr);
+				cairo_set_operator(tileCr, CAIRO_OPERATOR_OVER);
+				cairo_set_source_surface(tileCr, recording, -x, -(bandY + y));
+				cairo_paint(tileCr);
+				cairo_destroy(tileCr);
+				cairo_surface_finish(tile);
+				cairo_surface_destroy(tile);
+			}
+		};
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < numThreads; i++) {
+			threads.emplace_back(worker, recordings[i]);
+		}
+		worker(recordings[0]);
+		for (auto & thread : threads) {
+			thread.join();
+		}
+
+		if (streaming) {
+			int channels = rgba ? 4 : 3;
+			row.resize(width * channels);
+			for (int y = 0; y < currentBandHeight && ok; y++) {
+				auto src = reinterpret_cast<const uint32_t *>(band.getData() + y * stride);
+				cairoToRgb(src, row.data(), width, rgba);
+				ok = bool(file.write((const char *)row.data(), row.size()));
+			}
+		}
+	}
+
+	for (auto & recording : recordings) {
+		cairo_surface_destroy(recording);
+	}
+	if (!ok) {
+		ofLogError("ofCairoRenderer") << "couldn't write " << filename;
+	}
+	return ok;
 }
 
 void ofCairoRenderer::finishRender() {
@@ -506,89 +972,55 @@ void ofCairoRenderer::draw(const ofPath::Command & command) const {
 }
 
 //--------------------------------------------
-void ofCairoRenderer::draw(const ofPixels & raw, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const {
-	bool shouldCrop = sx != 0 || sy != 0 || sw != w || sh != h;
-	ofPixels cropped;
-	if (shouldCrop) {
-		cropped.allocate(sw, sh, raw.getPixelFormat());
-		raw.cropTo(cropped, sx, sy, sw, sh);
-	}
-	const ofPixels & pix = shouldCrop ? cropped : raw;
+void ofCairoRenderer::draw(const ofPixels & pix, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const {
+	drawPixels(pix, imageCacheSize > 0, x, y, z, w, h, sx, sy, sw, sh);
+}
 
-	ofCairoRenderer * mut_this = const_cast<ofCairoRenderer *>(this);
-	mut_this->pushMatrix();
-	mut_this->translate(x, y, z);
-	mut_this->scale(w / pix.getWidth(), h / pix.getHeight());
-	cairo_surface_t * image;
-	int stride = 0;
-	int picsize = pix.getWidth() * pix.getHeight();
-	const unsigned char * imgPix = pix.getData();
-
-	vector<unsigned char> swapPixels;
-
-	switch (pix.getImageType()) {
-	case OF_IMAGE_COLOR:
-#ifdef TARGET_LITTLE_ENDIAN
-		swapPixels.resize(picsize * 4);
-
-		for (int p = 0; p < picsize; p++) {
-			swapPixels[p * 4] = imgPix[p * 3 + 2];
-			swapPixels[p * 4 + 1] = imgPix[p * 3 + 1];
-			swapPixels[p * 4 + 2] = imgPix[p * 3];
+//--------------------------------------------
+void ofCairoRenderer::drawPixels(const ofPixels & pix, bool cached, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const {
+	cairo_surface_t * image = cached ? getCachedSurface(pix) : nullptr;
+	bool ownsImage = false;
+	if (!image) {
+		image = createCairoSurface(pix);
+		if (!image) {
+			ofLogError("ofCairoRenderer") << "draw(): can't draw pixels with format " << ofToString(pix.getPixelFormat());
+			return;
 		}
-#else
-		swapPixels.resize(picsize * 4);
+		ownsImage = true;
+	}
 
-		for (int p = 0; p < picsize; p++) {
-			swapPixels[p * 4] = imgPix[p * 3];
-			swapPixels[p * 4 + 1] = imgPix[p * 3 + 1];
-			swapPixels[p * 4 + 2] = imgPix[p * 3 + 2];
-		}
-#endif
-		stride = cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, pix.getWidth());
-		image = cairo_image_surface_create_for_data(&swapPixels[0], CAIRO_FORMAT_RGB24, pix.getWidth(), pix.getHeight(), stride);
-		break;
-	case OF_IMAGE_COLOR_ALPHA:
-#ifdef TARGET_LITTLE_ENDIAN
-		swapPixels.resize(picsize * 4);
-
-		for (int p = 0; p < picsize; p++) {
-			swapPixels[p * 4] = imgPix[p * 4 + 2];
-			swapPixels[p * 4 + 1] = imgPix[p * 4 + 1];
-			swapPixels[p * 4 + 2] = imgPix[p * 4];
-			swapPixels[p * 4 + 3] = imgPix[p * 4 + 3];
+	// the cropped region is drawn from a subsurface of the whole image so
+	// the cached surface can be used for any region
+	bool shouldCrop = sx != 0 || sy != 0 || sw != w || sh != h;
+	float width = pix.getWidth();
+	float height = pix.getHeight();
+	cairo_surface_t * source = image;
+	if (shouldCrop) {
+		sx = std::min(std::max(int(sx), 0), int(pix.getWidth()));
+		sy = std::min(std::max(int(sy), 0), int(pix.getHeight()));
+		width = std::min(std::max(int(sw), 0), int(pix.getWidth() - sx));
+		height = std::min(std::max(int(sh), 0), int(pix.getHeight() - sy));
+		if (width > 0 && height > 0) {
+			source = cairo_surface_create_for_rectangle(image, sx, sy, width, height);
 		}
-		stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, pix.getWidth());
-		image = cairo_image_surface_create_for_data(&swapPixels[0], CAIRO_FORMAT_ARGB32, pix.getWidth(), pix.getHeight(), stride);
-#else
-		stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, pix.getWidth());
-		image = cairo_image_surface_create_for_data(pix.getData(), CAIRO_FORMAT_ARGB32, pix.getWidth(), pix.getHeight(), stride);
-#endif
-		break;
-	case OF_IMAGE_GRAYSCALE:
-		swapPixels.resize(picsize * 4);
+	}
 
-		for (int p = 0; p < picsize; p++) {
-			swapPixels[p * 4] = imgPix[p];
-			swapPixels[p * 4 + 1] = imgPix[p];
-			swapPixels[p * 4 + 2] = imgPix[p];
-		}
-		stride = cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, pix.getWidth());
-		image = cairo_image_surface_create_for_data(&swapPixels[0], CAIRO_FORMAT_RGB24, pix.getWidth(), pix.getHeight(), stride);
-		break;
-	case OF_IMAGE_UNDEFINED:
-	default:
-		ofLogError("ofCairoRenderer") << "draw(): trying to draw undefined image type "
-									  << ofToString(pix.getImageType());
+	if (width > 0 && height > 0) {
+		ofCairoRenderer * mut_this = const_cast<ofCairoRenderer *>(this);
+		mut_this->pushMatrix();
+		mut_this->translate(x, y, z);
+		mut_this->scale(w / width, h / height);
+		cairo_set_source_surface(cr, source, 0, 0);
+		cairo_paint(cr);
 		mut_this->popMatrix();
-		return;
-		break;
 	}
-	cairo_set_source_surface(cr, image, 0, 0);
-	cairo_paint(cr);
-	cairo_surface_flush(image);
-	cairo_surface_destroy(image);
-	mut_this->popMatrix();
+
+	if (source != image) {
+		cairo_surface_destroy(source);
+	}
+	if (ownsImage) {
+		cairo_surface_destroy(image);
+	}
 }
 
 //--------------------------------------------
@@ -598,14 +1030,16 @@ void ofCairoRenderer::draw(const ofImage & img, float x, float y, float z, float
 
 //--------------------------------------------
 void ofCairoRenderer::draw(const ofFloatImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const {
+	// the converted pixels only live for this call, caching them would only
+	// push out other images
 	ofPixels tmp = image.getPixels();
-	draw(tmp, x, y, z, w, h, sx, sy, sw, sh);
+	drawPixels(tmp, false, x, y, z, w, h, sx, sy, sw, sh);
 }
 
 //--------------------------------------------
 void ofCairoRenderer::draw(const ofShortImage & image, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const {
 	ofPixels tmp = image.getPixels();
-	draw(tmp, x, y, z, w, h, sx, sy, sw, sh);
+	drawPixels(tmp, false, x, y, z, w, h, sx, sy, sw, sh);
 }
 
 //--------------------------------------------
@@ -1371,6 +1805,10 @@ cairo_surface_t * ofCairoRenderer::getCairoSurface() {
 ofPixels & ofCairoRenderer::getImageSurfacePixels() {
 	if (type != IMAGE) {
 		ofLogError("ofCairoRenderer") << "getImageSurfacePixels(): can only get pixels from image surface";
+	} else if (bTiled && tileSettings.streamToFile && filename != "") {
+		ofLogError("ofCairoRenderer") << "getImageSurfacePixels(): the image is streamed to " << filename << " on close, it's not kept in memory";
+	} else if (bTiled && bTilesDirty) {
+		rasterizeTiles();
 	}
 	return imageBuffer;
 }
@@ -7,7 +7,9 @@
 
 #include "ofPixels.h"
 #include <deque>
+#include <list>
 #include <stack>
+#include <unordered_map>
 
 class ofCairoRenderer: public ofBaseRenderer{
 public:
@@ -24,8 +26,74 @@ public:
 		FROM_FILE_EXTENSION
 	};
 
+	struct TileSettings{
+		int tileWidth = 1024;
+		int tileHeight = 1024;
+		/// \brief Threads rasterizing tiles, 0 uses one per core.
+		size_t numThreads = 0;
+		/// \brief Write the image to the file one row of tiles at a time
+		/// instead of keeping the whole image in memory, only for .ppm
+		/// (RGB) and .pam (RGBA) files.
+		bool streamToFile = false;
+	};
+
+	struct ImageCacheStats{
+		/// \brief Draws that reused a cached surface.
+		size_t numHits = 0;
+		/// \brief Draws that had to convert the pixels.
+		size_t numMisses = 0;
+		size_t numEvicted = 0;
+		size_t numSurfaces = 0;
+		size_t numBytes = 0;
+	};
+
 	void setup(const of::filesystem::path & filename, Type type=ofCairoRenderer::FROM_FILE_EXTENSION, bool multiPage=true, bool b3D=false, ofRectangle outputsize = ofRectangle(0,0,0,0));
 	void setupMemoryOnly(Type _type, bool multiPage=true, bool b3D=false, ofRectangle viewport = ofRectangle(0,0,0,0));
+
+	/// \brief Renders an IMAGE in tiles using several threads.
+	///
+	/// The drawing of a frame is recorded and, once the pixels are needed,
+	/// replayed into tiles of the image in parallel. Useful for very big
+	/// images that take long to rasterize on a single thread. The pixels are
+	/// rasterized when calling getImageSurfacePixels() or close(), which also
+	/// saves the file if there's one. getCairoSurface() returns the recording
+	/// surface.
+	///
+	/// \param filename File to save the image to on close(), empty to only
+	/// keep it in memory.
+	void setupTiled(const of::filesystem::path & filename, const TileSettings & settings, ofRectangle outputsize = ofRectangle(0,0,0,0));
+	bool isTiled() const;
+
+	/// \brief Maximum memory used by the surfaces cached for drawn images.
+	///
+	/// Drawing an ofImage or ofPixels converts it to a cairo surface, which
+	/// is kept and reused while the same pixels are drawn again unchanged.
+	/// When the contents of the pixels change they are converted again into
+	/// the same surface. For PDF and SVG this also means an image drawn many
+	/// times is only embedded once. The least recently drawn surfaces are
+	/// released when going over the size, 0 disables the cache. 64MB by
+	/// default.
+	void setImageCacheSize(size_t bytes);
+	size_t getImageCacheSize() const;
+	void clearImageCache();
+	ImageCacheStats getImageCacheStats() const;
+
+	/// \returns The cairo format pixels are converted to, CAIRO_FORMAT_INVALID
+	/// if they can't be drawn with cairo.
+	static cairo_format_t getCairoFormat(ofPixelFormat format);
+
+	/// \brief Converts pixels to the native endian, premultiplied layout of
+	/// getCairoFormat().
+	/// \param dst Memory for pixels.getHeight() rows of dstStride bytes, as
+	/// returned by cairo_format_stride_for_width().
+	/// \returns false if the format of the pixels can't be converted.
+	static bool toCairoPixels(const ofPixels & pixels, unsigned char * dst, int dstStride);
+
+	/// \brief Creates an image surface with a copy of the pixels.
+	/// \returns nullptr if the format of the pixels can't be converted,
+	/// otherwise a surface to release with cairo_surface_destroy().
+	static cairo_surface_t * createCairoSurface(const ofPixels & pixels);
+
 	void close();
 	void flush();
 
@@ -170,6 +238,11 @@ private:
 	glm::vec3 transform(glm::vec3 vec) const;
 	static _cairo_status stream_function(void *closure,const unsigned char *data, unsigned int length);
 	void draw(const ofPixels & img, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	void drawPixels(const ofPixels & pix, bool cached, float x, float y, float z, float w, float h, float sx, float sy, float sw, float sh) const;
+	cairo_surface_t * getCachedSurface(const ofPixels & pixels) const;
+	void evictCachedImages() const;
+	void setupSurface(const of::filesystem::path & filename, Type type, bool multiPage, bool b3D, ofRectangle outputsize);
+	bool rasterizeTiles();
 
 	mutable std::deque<glm::vec3> curvePoints;
 	cairo_t * cr;
@@ -203,6 +276,25 @@ private:
 	ofBuffer streamBuffer;
 	ofPixels imageBuffer;
 
+	bool bTiled;
+	bool bTilesDirty;
+	TileSettings tileSettings;
+
+	struct CachedImage{
+		const unsigned char * data;
+		size_t width;
+		size_t height;
+		ofPixelFormat format;
+		uint64_t hash;
+		size_t bytes;
+		cairo_surface_t * surface;
+	};
+	// most recently drawn first, indexed by the address of the pixels
+	mutable std::list<CachedImage> imageCache;
+	mutable std::unordered_map<const unsigned char *, std::list<CachedImage>::iterator> imageCacheIndex;
+	mutable ImageCacheStats imageCacheStats;
+	size_t imageCacheSize;
+
 	ofStyle currentStyle;
 	std::deque <ofStyle> styleHistory;
 	ofPath path;
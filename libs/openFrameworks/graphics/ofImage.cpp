@@ -1,6 +1,8 @@
 #include "ofImage.h"
 #include "ofAppRunner.h"
 #include "ofPixels.h"
+#include "ofMath.h"
+#include "ofProfiler.h"
 
 #include "FreeImage.h"
 
@@ -96,7 +98,7 @@ FIBITMAP* getBmpFromPixels(const ofPixels_<PixelType> &pix){
 
 //----------------------------------------------------
 template<typename PixelType>
-void putBmpIntoPixels(FIBITMAP * bmp, ofPixels_<PixelType>& pix, bool swapOnLittleEndian = true, bool bUsePassedPixelFormat = false) {
+void putBmpIntoPixels(FIBITMAP * bmp, ofPixels_<PixelType>& pix, bool swapOnLittleEndian = true, bool bUsePassedPixelFormat = false, bool flipVertical = true) {
 	// convert to correct type depending on type of input bmp and PixelType
 	FIBITMAP* bmpConverted = nullptr;
 	FREE_IMAGE_TYPE imgType = FreeImage_GetImageType(bmp);
@@ -166,12 +168,17 @@ void putBmpIntoPixels(FIBITMAP * bmp, ofPixels_<PixelType>& pix, bool swapOnLitt
         }
     }
     
-	// ofPixels are top left, FIBITMAP is bottom left
-	FreeImage_FlipVertical(bmp);
-
 	unsigned char* bmpBits = FreeImage_GetBits(bmp);
 	if(bmpBits != nullptr) {
-		pix.setFromAlignedPixels((PixelType*) bmpBits, width, height, pixFormat, pitch);
+		// ofPixels are top left, FIBITMAP is bottom left, copying the rows
+		// in reverse order flips the image without another pass over it
+		pix.allocate(width, height, pixFormat);
+		size_t rowBytes = size_t(width) * (bpp / 8);
+		unsigned char* dst = (unsigned char*) pix.getData();
+		for(unsigned int y = 0; y < height; y++) {
+			unsigned int srcRow = flipVertical ? height - 1 - y : y;
+			memcpy(dst + y * rowBytes, bmpBits + size_t(srcRow) * pitch, rowBytes);
+		}
 	} else {
 		ofLogError("ofImage") << "putBmpIntoPixels(): unable to set ofPixels from FIBITMAP";
 	}
@@ -195,8 +202,85 @@ static int getJpegOptionFromImageLoadSetting(const ofImageLoadSettings &settings
 	return option;
 }
 
+/// internal, loads a bitmap through load(flags) applying the size and region
+/// settings. load can be called twice, to read the header and the image
+template<typename Load>
+static FIBITMAP* loadBmp(FREE_IMAGE_FORMAT fif, const ofImageLoadSettings &settings, Load load) {
+	int flags = settings.freeImageFlags;
+	if(fif == FIF_JPEG) {
+		flags |= getJpegOptionFromImageLoadSetting(settings);
+	}
+	bool hasRegion = settings.region.width > 0 && settings.region.height > 0;
+
+	// largest side of the full size image, only known if it was decoded
+	// reduced, to scale the region to the size it was decoded at
+	float fullSize = 0;
+	if(fif == FIF_JPEG && settings.maxSize > 0) {
+		// the decoder can scale by 1/2, 1/4 or 1/8 and picks the smallest
+		// scale that keeps a side at least as large as the requested size
+		float requestedSize = settings.maxSize;
+		if(hasRegion) {
+			FIBITMAP * header = load(FIF_LOAD_NOPIXELS);
+			if(header != nullptr) {
+				fullSize = std::max(FreeImage_GetWidth(header), FreeImage_GetHeight(header));
+				FreeImage_Unload(header);
+				requestedSize = ceil(fullSize * settings.maxSize / std::max(settings.region.width, settings.region.height));
+			}
+			if(fullSize == 0) {
+				requestedSize = 0;
+			}
+		}
+		flags |= int(std::min(requestedSize, 65535.f)) << 16;
+	}
+
+	FIBITMAP * bmp = load(flags);
+	if(bmp == nullptr) {
+		return nullptr;
+	}
+
+	if(hasRegion) {
+		float width = FreeImage_GetWidth(bmp);
+		float height = FreeImage_GetHeight(bmp);
+		float scale = fullSize > 0 ? std::max(width, height) / fullSize : 1;
+		auto region = settings.region.getStandardized();
+		int left = ofClamp(round(region.getLeft() * scale), 0, width);
+		int top = ofClamp(round(region.getTop() * scale), 0, height);
+		int right = ofClamp(round(region.getRight() * scale), 0, width);
+		int bottom = ofClamp(round(region.getBottom() * scale), 0, height);
+		if(right <= left || bottom <= top) {
+			ofLogError("ofImage") << "loadImage(): region " << settings.region << " is outside of the image";
+			FreeImage_Unload(bmp);
+			return nullptr;
+		}
+		FIBITMAP * cropped = FreeImage_Copy(bmp, left, top, right, bottom);
+		FreeImage_Unload(bmp);
+		bmp = cropped;
+	}
+
+	if(bmp != nullptr && settings.maxSize > 0) {
+		unsigned int width = FreeImage_GetWidth(bmp);
+		unsigned int height = FreeImage_GetHeight(bmp);
+		unsigned int size = std::max(width, height);
+		if(size > (unsigned int)settings.maxSize) {
+			float scale = float(settings.maxSize) / size;
+			int newWidth = std::max(int(round(width * scale)), 1);
+			int newHeight = std::max(int(round(height * scale)), 1);
+			FIBITMAP * scaled = FreeImage_Rescale(bmp, newWidth, newHeight, FILTER_BILINEAR);
+			if(scaled != nullptr) {
+				FreeImage_Unload(bmp);
+				bmp = scaled;
+			} else {
+				ofLogWarning("ofImage") << "loadImage(): couldn't scale image down to " << settings.maxSize << " pixels";
+			}
+		}
+	}
+
+	return bmp;
+}
+
 template<typename PixelType>
 static bool loadImage(ofPixels_<PixelType> & pix, const of::filesystem::path& _fileName, const ofImageLoadSettings& settings){
+	OF_PROFILE_ZONE("ofLoadImage");
 	ofInitFreeImage();
 
 	auto uriStr = _fileName.string();
@@ -222,7 +306,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const of::filesystem::path& _f
 	uriFreeUriMembersA(&uri);
 
 	if(scheme == "http" || scheme == "https"){
-		return ofLoadImage(pix, ofLoadURL(_fileName.string()).data);
+		return ofLoadImage(pix, ofLoadURL(_fileName.string()).data, settings);
 	}
 
 	auto fileName = ofToDataPath(_fileName, true);
@@ -236,12 +320,9 @@ static bool loadImage(ofPixels_<PixelType> & pix, const of::filesystem::path& _f
 		fif = FreeImage_GetFIFFromFilename(fileName.c_str());
 	}
 	if((fif != FIF_UNKNOWN) && FreeImage_FIFSupportsReading(fif)) {
-		if(fif == FIF_JPEG) {
-			int option = getJpegOptionFromImageLoadSetting(settings);
-			bmp = FreeImage_Load(fif, fileName.c_str(), option | settings.freeImageFlags);
-		} else {
-			bmp = FreeImage_Load(fif, fileName.c_str(), 0 | settings.freeImageFlags);
-		}
+		bmp = loadBmp(fif, settings, [&](int flags){
+			return FreeImage_Load(fif, fileName.c_str(), flags);
+		});
 
 		if (bmp != nullptr){
 			bLoaded = true;
@@ -251,7 +332,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const of::filesystem::path& _f
 	//-----------------------------
 
 	if ( bLoaded ){
-		putBmpIntoPixels(bmp,pix);
+		putBmpIntoPixels(bmp, pix, true, false, settings.flipVertical);
 	}
 
 	if (bmp != nullptr){
@@ -263,6 +344,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const of::filesystem::path& _f
 
 template<typename PixelType>
 static bool loadImage(ofPixels_<PixelType> & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings){
+	OF_PROFILE_ZONE("ofLoadImage buffer");
 	ofInitFreeImage();
 	bool bLoaded = false;
 	FIBITMAP* bmp = nullptr;
@@ -284,12 +366,10 @@ static bool loadImage(ofPixels_<PixelType> & pix, const ofBuffer & buffer, const
 
 
 	//make the image!!
-	if(fif == FIF_JPEG) {
-		int option = getJpegOptionFromImageLoadSetting(settings);
-		bmp = FreeImage_LoadFromMemory(fif, hmem, option | settings.freeImageFlags);
-	} else {
-		bmp = FreeImage_LoadFromMemory(fif, hmem, settings.freeImageFlags);
-	}
+	bmp = loadBmp(fif, settings, [&](int flags){
+		FreeImage_SeekMemory(hmem, 0, SEEK_SET);
+		return FreeImage_LoadFromMemory(fif, hmem, flags);
+	});
 
 	if( bmp != nullptr ){
 		bLoaded = true;
@@ -298,7 +378,7 @@ static bool loadImage(ofPixels_<PixelType> & pix, const ofBuffer & buffer, const
 	//-----------------------------
 
 	if (bLoaded){
-		putBmpIntoPixels(bmp,pix);
+		putBmpIntoPixels(bmp, pix, true, false, settings.flipVertical);
 	}
 
 	if (bmp != nullptr){
@@ -5,6 +5,7 @@
 #include "ofGraphicsConstants.h"
 #include "ofGLUtils.h"
 #include "ofConstants.h"
+#include "ofRectangle.h"
 
 template<typename T>
 class ofPixels_;
@@ -124,13 +125,33 @@ inline std::string ofImageFormatExtension(ofImageFormat format){
 }
 
 
-/// \todo Needs documentation.
+/// \brief Options for ofLoadImage and ofImage::load.
+///
+/// accurate, exifRotate, grayscale and separateCMYK only apply to JPEGs.
 struct ofImageLoadSettings {
 	bool accurate = false;
 	bool exifRotate = false;
 	bool grayscale = false;
 	bool separateCMYK = false;
     int freeImageFlags = 0;
+
+	/// \brief Scale the image down so its largest side is at most this many
+	///        pixels, 0 loads it at full size.
+	///
+	/// JPEGs are decoded directly at 1/2, 1/4 or 1/8 of their size when
+	/// possible, so the full size image is never allocated, which makes
+	/// this much faster than loading and resizing to build thumbnails.
+	int maxSize = 0;
+
+	/// \brief Only load this region, in pixels of the full size image with
+	///        the origin at the top left. An empty rectangle loads everything.
+	///
+	/// Applied before maxSize, which then limits the size of the region.
+	ofRectangle region;
+
+	/// \brief Flip the rows so the first one is the top of the image, false
+	///        leaves them in the bottom up order FreeImage decodes them in.
+	bool flipVertical = true;
 };
 
 //----------------------------------------------------
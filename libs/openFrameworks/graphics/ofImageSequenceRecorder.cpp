@@ -0,0 +1,243 @@
+#include "ofImageSequenceRecorder.h"
+#include "ofUtils.h"
+#include "FreeImage.h"
+
+// defined in ofImage.cpp, initializing FreeImage from several
+// encoding threads at the same time wouldn't be safe
+void ofInitFreeImage(bool deinit);
+
+//----------------------------------------------------------
+ofImageSequenceRecorder::ofImageSequenceRecorder()
+:format(OF_IMAGE_FORMAT_PNG)
+,nextIndex(0)
+,nextToWrite(0)
+,writing(false)
+,running(false)
+,totalEncodeMicros(0)
+,blockedMicros(0)
+,startTime(0){
+}
+
+//----------------------------------------------------------
+ofImageSequenceRecorder::~ofImageSequenceRecorder(){
+	close();
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::setup(const Settings & _settings){
+	close();
+
+	settings = _settings;
+	folder = ofToDataPath(settings.folder, true);
+
+	ofInitFreeImage(false);
+	auto fif = FreeImage_GetFIFFromFilename(("image." + settings.extension).c_str());
+	if(fif == FIF_UNKNOWN || !FreeImage_FIFSupportsWriting(fif)){
+		ofLogError("ofImageSequenceRecorder") << "setup(): can't write images with extension " << settings.extension;
+		return false;
+	}
+	format = ofImageFormat(fif);
+
+	if(!ofDirectory::createDirectory(folder, false, true)){
+		ofLogError("ofImageSequenceRecorder") << "setup(): couldn't create folder " << folder;
+		return false;
+	}
+
+	if(settings.numThreads == 0){
+		settings.numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	if(settings.maxQueuedFrames == 0){
+		settings.maxQueuedFrames = settings.numThreads * 2;
+	}
+
+	nextIndex = 0;
+	nextToWrite = 0;
+	writing = false;
+	stats = Stats();
+	totalEncodeMicros = 0;
+	blockedMicros = 0;
+	startTime = 0;
+
+	running = true;
+	for(size_t i = 0; i < settings.numThreads; i++){
+		threads.emplace_back(&ofImageSequenceRecorder::threadedFunction, this);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::close(){
+	if(threads.empty()){
+		return;
+	}
+	waitForAll();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		running = false;
+	}
+	jobAvailable.notify_all();
+	frameDone.notify_all();
+	for(auto & thread: threads){
+		thread.join();
+	}
+	threads.clear();
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::add(ofPixels && pixels){
+	if(!pixels.isAllocated()){
+		ofLogError("ofImageSequenceRecorder") << "add(): pixels are not allocated";
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	if(!running){
+		ofLogError("ofImageSequenceRecorder") << "add(): recorder is not setup";
+		return false;
+	}
+	if(startTime == 0){
+		startTime = ofGetElapsedTimeMicros();
+	}
+
+	if(nextIndex - nextToWrite >= settings.maxQueuedFrames){
+		if(settings.overflowPolicy == Drop){
+			stats.numFramesDropped++;
+			return false;
+		}
+		auto then = ofGetElapsedTimeMicros();
+		frameDone.wait(lock, [this]{
+			return !running || nextIndex - nextToWrite < settings.maxQueuedFrames;
+		});
+		blockedMicros += ofGetElapsedTimeMicros() - then;
+		if(!running){
+			return false;
+		}
+	}
+
+	jobs.push_back(Job{nextIndex++, std::move(pixels)});
+	// a moved from ofPixels still points to the data it no longer owns
+	pixels.clear();
+	stats.numFramesAdded++;
+	stats.maxQueueDepth = std::max(stats.maxQueueDepth, size_t(nextIndex - nextToWrite));
+	lock.unlock();
+	jobAvailable.notify_one();
+	return true;
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::add(const ofPixels & pixels){
+	ofPixels copy = pixels;
+	return add(std::move(copy));
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::waitForAll(){
+	std::unique_lock<std::mutex> lock(mutex);
+	frameDone.wait(lock, [this]{
+		return threads.empty() || nextToWrite == nextIndex;
+	});
+}
+
+//----------------------------------------------------------
+ofImageSequenceRecorder::Stats ofImageSequenceRecorder::getStats() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	Stats current = stats;
+	current.queueDepth = nextIndex - nextToWrite;
+	current.blockedMillis = blockedMicros / 1000.f;
+	uint64_t encodedFrames = current.numFramesWritten + current.numFramesFailed;
+	if(encodedFrames > 0){
+		current.averageEncodeMillis = totalEncodeMicros / 1000.f / encodedFrames;
+	}
+	if(startTime > 0){
+		float seconds = std::max(ofGetElapsedTimeMicros() - startTime, uint64_t(1)) / 1000000.f;
+		current.framesPerSecond = current.numFramesWritten / seconds;
+		current.megabytesPerSecond = current.numBytesWritten / 1000000.f / seconds;
+	}
+	return current;
+}
+
+//----------------------------------------------------------
+const ofImageSequenceRecorder::Settings & ofImageSequenceRecorder::getSettings() const{
+	return settings;
+}
+
+//----------------------------------------------------------
+bool ofImageSequenceRecorder::isRecording() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return running;
+}
+
+//----------------------------------------------------------
+of::filesystem::path ofImageSequenceRecorder::getFramePath(size_t frameNumber) const{
+	return folder / (settings.prefix + ofToString(frameNumber, int(settings.numDigits), '0') + "." + settings.extension);
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::threadedFunction(){
+	while(true){
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this]{
+				return !running || !jobs.empty();
+			});
+			if(jobs.empty()){
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		// the flip and color conversion FreeImage needs happen here too,
+		// so the thread that called add() only pays for the move
+		auto then = ofGetElapsedTimeMicros();
+		Encoded result;
+		result.ok = ofSaveImage(job.pixels, result.buffer, format, settings.quality);
+		job.pixels.clear();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			totalEncodeMicros += ofGetElapsedTimeMicros() - then;
+		}
+
+		writeEncoded(job.index, std::move(result));
+	}
+}
+
+//----------------------------------------------------------
+void ofImageSequenceRecorder::writeEncoded(uint64_t index, Encoded && result){
+	std::unique_lock<std::mutex> lock(mutex);
+	encoded.emplace(index, std::move(result));
+
+	// only one thread writes at a time so files appear in order, the
+	// others leave their frame for it and go back to encoding
+	if(writing){
+		return;
+	}
+	writing = true;
+	while(true){
+		auto it = encoded.find(nextToWrite);
+		if(it == encoded.end()){
+			break;
+		}
+		Encoded frame = std::move(it->second);
+		encoded.erase(it);
+		auto path = getFramePath(settings.firstFrame + nextToWrite);
+		lock.unlock();
+
+		bool ok = frame.ok && ofBufferToFile(path, frame.buffer, true);
+		if(!ok){
+			ofLogError("ofImageSequenceRecorder") << "couldn't save " << path;
+		}
+
+		lock.lock();
+		if(ok){
+			stats.numFramesWritten++;
+			stats.numBytesWritten += frame.buffer.size();
+		}else{
+			stats.numFramesFailed++;
+		}
+		nextToWrite++;
+		frameDone.notify_all();
+	}
+	writing = false;
+}
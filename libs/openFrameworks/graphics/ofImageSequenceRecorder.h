@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ofImage.h"
+#include "ofFileUtils.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+/// \brief Saves a sequence of frames to numbered image files in the background.
+///
+/// add() only moves the pixels into a queue, a pool of threads compresses
+/// the frames in parallel and the encoded files are written to disk in the
+/// order they were added. The number of frames in flight is bounded, when
+/// the disk or the encoders can't keep up add() either blocks until there's
+/// room or drops the frame, depending on the overflow policy.
+///
+/// ~~~~{.cpp}
+/// // setup
+/// ofImageSequenceRecorder::Settings settings;
+/// settings.folder = "capture";
+/// recorder.setup(settings);
+///
+/// // draw
+/// ofPixels pixels;
+/// fbo.readToPixels(pixels);
+/// recorder.add(std::move(pixels));
+///
+/// // exit
+/// recorder.close(); // waits for every frame to be written
+/// ~~~~
+class ofImageSequenceRecorder{
+public:
+	enum OverflowPolicy{
+		/// \brief add() waits until a frame is written.
+		Block,
+		/// \brief add() discards the new frame, numbering stays contiguous.
+		Drop,
+	};
+
+	struct Settings{
+		/// \brief Folder the files are written to, relative to data, created if needed.
+		of::filesystem::path folder;
+		std::string prefix = "frame_";
+		/// \brief Extension of the files, also selects the image format.
+		std::string extension = "png";
+		/// \brief Minimum number of digits of the frame number, padded with zeros.
+		size_t numDigits = 5;
+		size_t firstFrame = 0;
+		/// \brief Only used by JPEG files.
+		ofImageQualityType quality = OF_IMAGE_QUALITY_BEST;
+		/// \brief Threads that compress frames, 0 uses one per core.
+		size_t numThreads = 0;
+		/// \brief Frames that can be queued or being encoded or written
+		///        before the overflow policy applies, 0 uses twice the threads.
+		size_t maxQueuedFrames = 0;
+		OverflowPolicy overflowPolicy = Block;
+	};
+
+	struct Stats{
+		uint64_t numFramesAdded = 0;
+		uint64_t numFramesWritten = 0;
+		uint64_t numFramesDropped = 0;
+		/// \brief Frames that couldn't be encoded or written.
+		uint64_t numFramesFailed = 0;
+		uint64_t numBytesWritten = 0;
+		/// \brief Frames queued, being encoded or waiting to be written.
+		size_t queueDepth = 0;
+		size_t maxQueueDepth = 0;
+		/// \brief Time add() spent blocked waiting for room in the queue.
+		float blockedMillis = 0;
+		float averageEncodeMillis = 0;
+		/// \brief Frames and megabytes written per second since the first frame was added.
+		float framesPerSecond = 0;
+		float megabytesPerSecond = 0;
+	};
+
+	ofImageSequenceRecorder();
+	~ofImageSequenceRecorder();
+
+	ofImageSequenceRecorder(const ofImageSequenceRecorder &) = delete;
+	ofImageSequenceRecorder & operator=(const ofImageSequenceRecorder &) = delete;
+
+	/// \brief Starts the encoding threads, closes a previous sequence first.
+	bool setup(const Settings & settings);
+
+	/// \brief Waits for every queued frame to be written and stops the threads.
+	void close();
+
+	/// \brief Queue a frame, the pixels are moved and left unallocated.
+	/// \returns false if the frame was dropped or the recorder isn't setup.
+	bool add(ofPixels && pixels);
+
+	/// \brief Queue a copy of a frame.
+	bool add(const ofPixels & pixels);
+
+	/// \brief Blocks until every frame added so far is written.
+	void waitForAll();
+
+	Stats getStats() const;
+	const Settings & getSettings() const;
+	bool isRecording() const;
+
+	/// \returns Absolute path of the file for a frame number.
+	of::filesystem::path getFramePath(size_t frameNumber) const;
+
+private:
+	struct Job{
+		uint64_t index;
+		ofPixels pixels;
+	};
+
+	struct Encoded{
+		ofBuffer buffer;
+		bool ok;
+	};
+
+	void threadedFunction();
+	void writeEncoded(uint64_t index, Encoded && encoded);
+
+	Settings settings;
+	of::filesystem::path folder;
+	ofImageFormat format;
+	std::vector<std::thread> threads;
+
+	mutable std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable frameDone;
+	std::deque<Job> jobs;
+	std::map<uint64_t, Encoded> encoded;
+	uint64_t nextIndex;
+	uint64_t nextToWrite;
+	bool writing;
+	bool running;
+
+	Stats stats;
+	uint64_t totalEncodeMicros;
+	uint64_t blockedMicros;
+	uint64_t startTime;
+};
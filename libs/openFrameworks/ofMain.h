@@ -5,6 +5,8 @@
 // utils
 #include "ofConstants.h"
 #include "ofFileUtils.h"
+#include "ofDirectoryScanner.h"
+#include "ofDirectoryWatcher.h"
 #include "ofLog.h"
 #include "ofSystemUtils.h"
 
@@ -16,6 +18,8 @@
 #include "ofThreadChannel.h"
 
 #include "ofFpsCounter.h"
+#include "ofProfiler.h"
+#include "ofTaskScheduler.h"
 #include "ofJson.h"
 #include "ofXml.h"
 
@@ -65,6 +69,7 @@
 #endif
 #include "ofGraphics.h"
 #include "ofImage.h"
+#include "ofImageSequenceRecorder.h"
 #include "ofPath.h"
 #include "ofPixels.h"
 #include "ofPolyline.h"
@@ -92,6 +97,7 @@
     #include "ofSoundStream.h"
     #include "ofSoundPlayer.h"
     #include "ofSoundBuffer.h"
+    #include "ofSoundAnalyzer.h"
 #endif
 
 //--------------------------
@@ -110,6 +116,7 @@
 #include "ofEasyCam.h"
 #include "ofMesh.h"
 #include "ofNode.h"
+#include "ofNodeHierarchy.h"
 
 //--------------------------
 #ifdef OF_LEGACY_INCLUDE_STD
@@ -7,6 +7,9 @@
 #include "glm/common.hpp"
 #include "ofLog.h"
 #include "ofEvents.h"
+#include "ofThreadChannel.h"
+#include <map>
+#include <thread>
 
 #if defined (TARGET_OF_IOS) || defined (TARGET_OSX)
 #include <OpenAL/al.h>
@@ -131,6 +134,114 @@ static std::string getMpg123EncodingString(int encoding) {
 
 #define BUFFER_STREAM_SIZE 4096
 
+// ----------------------------------------------------------------------------
+// float copy of interleaved 16 bit samples with one vector per channel, for the fft
+static void deinterleave(const std::vector<short> & samples, int channels, std::vector<std::vector<float> > & out){
+	out.resize(channels);
+	int numFrames = samples.size()/channels;
+	for(int i=0;i<channels;i++){
+		out[i].resize(numFrames);
+		for(int j=0;j<numFrames;j++){
+			out[i][j] = float(samples[j*channels+i])/32768.f;
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+// decoded samples of a file, shared by all the players that load it
+struct ofOpenALSoundData{
+	std::vector<short> samples; // interleaved
+	int channels = 0;
+	int samplerate = 0;
+	float duration = 0;
+	std::vector<ALuint> buffers; // one mono buffer per channel
+
+	~ofOpenALSoundData(){
+		if(!buffers.empty() && alContext){
+			alDeleteBuffers(buffers.size(), buffers.data());
+		}
+	}
+
+	// creates the OpenAL buffers the first time a player needs them
+	bool upload(){
+		std::unique_lock<std::mutex> lock(mutex);
+		if(!buffers.empty()){
+			return true;
+		}
+		buffers.resize(channels);
+		alGetError(); // Clear error.
+		alGenBuffers(channels, buffers.data());
+		std::vector<short> channelBuffer;
+		int numFrames = samples.size()/channels;
+		for(int i=0;i<channels;i++){
+			const short * data = samples.data();
+			if(channels>1){
+				channelBuffer.resize(numFrames);
+				for(int j=0;j<numFrames;j++){
+					channelBuffer[j] = samples[j*channels+i];
+				}
+				data = channelBuffer.data();
+			}
+			alBufferData(buffers[i],AL_FORMAT_MONO16,data,numFrames*2,samplerate);
+		}
+		ALenum err = alGetError();
+		if(err != AL_NO_ERROR){
+			ofLogError("ofOpenALSoundPlayer") << "upload(): " << (int) err << " " << getALErrorString(err);
+			alDeleteBuffers(buffers.size(), buffers.data());
+			buffers.clear();
+			return false;
+		}
+		return true;
+	}
+
+	const std::vector<std::vector<float> > & getSpectrumBuffers(){
+		std::unique_lock<std::mutex> lock(mutex);
+		if(spectrumBuffers.empty()){
+			deinterleave(samples, channels, spectrumBuffers);
+		}
+		return spectrumBuffers;
+	}
+
+private:
+	std::mutex mutex;
+	std::vector<std::vector<float> > spectrumBuffers;
+};
+
+namespace{
+	struct ofOpenALSoundCacheEntry{
+		std::weak_ptr<ofOpenALSoundData> data;
+		std::shared_future<std::shared_ptr<ofOpenALSoundData>> decoding;
+	};
+}
+
+static std::mutex & soundCacheMutex(){
+	static std::mutex * mutex = new std::mutex;
+	return *mutex;
+}
+
+static std::map<std::string, ofOpenALSoundCacheEntry> & soundCache(){
+	static std::map<std::string, ofOpenALSoundCacheEntry> * cache = new std::map<std::string, ofOpenALSoundCacheEntry>;
+	return *cache;
+}
+
+// files loaded with loadAsync are decoded by a few threads shared by all the players
+static ofThreadChannel<std::function<void()>> & decodeQueue(){
+	static ofThreadChannel<std::function<void()>> * queue = []{
+		auto queue = new ofThreadChannel<std::function<void()>>;
+		unsigned numThreads = std::max(std::thread::hardware_concurrency() / 2, 1u);
+		for(unsigned i=0;i<numThreads;i++){
+			std::thread([queue]{
+				std::function<void()> task;
+				while(queue->receive(task)){
+					task();
+				}
+			}).detach();
+		}
+		return queue;
+	}();
+	return *queue;
+}
+
 // now, the individual sound player:
 //------------------------------------------------------------
 ofOpenALSoundPlayer::ofOpenALSoundPlayer(){
@@ -146,6 +257,8 @@ ofOpenALSoundPlayer::ofOpenALSoundPlayer(){
 	duration		= 0;
 	fftCfg			= 0;
 	streamf			= 0;
+	bPlayWhenLoaded	= false;
+	bSpectrum		= false;
 #ifdef OF_USING_MPG123
 	mp3streamf		= 0;
 #endif
@@ -230,79 +343,59 @@ void ofOpenALSoundPlayer::close(){
 }
 
 // ----------------------------------------------------------------------------
-bool ofOpenALSoundPlayer::sfReadFile(const of::filesystem::path& path, std::vector<short> & buffer, std::vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::sfReadFile(const of::filesystem::path& path, ofOpenALSoundData & data){
 	SF_INFO sfInfo;
 	SNDFILE* f = sf_open(path.string().c_str(),SFM_READ,&sfInfo);
 	if(!f){
 		ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): couldn't read " << path;
 		return false;
 	}
-	duration = 0.0f;
-	buffer.resize(sfInfo.frames*sfInfo.channels);
-	fftAuxBuffer.resize(sfInfo.frames*sfInfo.channels);
 
+	// float files are normalized to their peak by libsndfile when converting to 16 bits
 	int subformat = sfInfo.format & SF_FORMAT_SUBMASK ;
 	if (subformat == SF_FORMAT_FLOAT || subformat == SF_FORMAT_DOUBLE){
-		double	scale ;
-		sf_command (f, SFC_CALC_SIGNAL_MAX, &scale, sizeof (scale)) ;
-		if (scale < 1e-10)
-			scale = 1.0 ;
-		else
-			scale = 32700.0 / scale ;
-
-		sf_count_t samples_read = sf_read_float (f, &fftAuxBuffer[0], fftAuxBuffer.size());
-		if(samples_read<(int)fftAuxBuffer.size()){
-			ofLogWarning("ofOpenALSoundPlayer") << "sfReadFile(): read " << samples_read << " float samples, expected "
-			<< fftAuxBuffer.size() << " for " << path;
-		}
-		for (int i = 0 ; i < int(fftAuxBuffer.size()) ; i++){
-			fftAuxBuffer[i] *= scale ;
-			buffer[i] = 32565.0 * fftAuxBuffer[i];
-		}
-	}else{
-		sf_count_t frames_read = sf_readf_short(f,&buffer[0],sfInfo.frames);
-		if(frames_read<sfInfo.frames){
-			ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from buffer, expected "
-			<< sfInfo.frames << " for " << path ;
-			return false;
-		}
-		sf_seek(f,0,SEEK_SET);
-		frames_read = sf_readf_float(f,&fftAuxBuffer[0],sfInfo.frames);
-		if(frames_read<sfInfo.frames){
-			ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from fft buffer, expected "
-			<< sfInfo.frames << " for " << path ;
-			return false;
-		}
+		sf_command (f, SFC_SET_SCALE_FLOAT_INT_READ, nullptr, SF_TRUE) ;
 	}
+
+	data.samples.resize(sfInfo.frames*sfInfo.channels);
+	sf_count_t frames_read = sf_readf_short(f,data.samples.data(),sfInfo.frames);
 	sf_close(f);
+	if(frames_read<sfInfo.frames){
+		ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from buffer, expected "
+		<< sfInfo.frames << " for " << path ;
+		return false;
+	}
 
-	channels = sfInfo.channels;
-	duration = float(sfInfo.frames) / float(sfInfo.samplerate);
-	samplerate = sfInfo.samplerate;
+	data.channels = sfInfo.channels;
+	data.duration = float(sfInfo.frames) / float(sfInfo.samplerate);
+	data.samplerate = sfInfo.samplerate;
 	return true;
 }
 
 #ifdef OF_USING_MPG123
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::mpg123ReadFile(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::mpg123ReadFile(const of::filesystem::path& path, ofOpenALSoundData & data){
 	int err = MPG123_OK;
-	duration = 0.0f;
 	mpg123_handle * f = mpg123_new(nullptr,&err);
 	if(mpg123_open(f,path.string().c_str())!=MPG123_OK){
+		mpg123_delete(f);
 		ofLogError("ofOpenALSoundPlayer") << "mpg123ReadFile(): couldn't read " << path ;
 		return false;
 	}
 
 	mpg123_enc_enum encoding;
 	long int rate;
+	int channels;
 	mpg123_getformat(f,&rate,&channels,(int*)&encoding);
 	if(encoding!=MPG123_ENC_SIGNED_16){
+		mpg123_close(f);
+		mpg123_delete(f);
 		ofLogError("ofOpenALSoundPlayer") << "mpg123ReadFile(): " << getMpg123EncodingString(encoding)
 			<< " encoding for " << path << " unsupported, expecting MPG123_ENC_SIGNED_16";
 		return false;
 	}
-	samplerate = rate;
 
+	auto & buffer = data.samples;
 	size_t done=0;
 	size_t buffer_size = mpg123_outblock( f );
 	buffer.resize(buffer_size/2);
@@ -313,17 +406,15 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const of::filesystem::path& path,std::v
 	mpg123_close(f);
 	mpg123_delete(f);
 
-	fftAuxBuffer.resize(buffer.size());
-	for(int i=0;i<(int)buffer.size();i++){
-		fftAuxBuffer[i] = float(buffer[i])/32565.f;
-	}
-	duration = float(buffer.size()/channels) / float(samplerate);
+	data.channels = channels;
+	data.samplerate = rate;
+	data.duration = float(buffer.size()/channels) / float(rate);
 	return true;
 }
 #endif
 
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::sfStream(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::sfStream(const of::filesystem::path& path,std::vector<short> & buffer){
 	if(!streamf){
 		SF_INFO sfInfo;
 		streamf = sf_open(path.string().c_str(),SFM_READ,&sfInfo);
@@ -332,13 +423,9 @@ bool ofOpenALSoundPlayer::sfStream(const of::filesystem::path& path,std::vector<
 			return false;
 		}
 
-		stream_subformat = sfInfo.format & SF_FORMAT_SUBMASK ;
-		if (stream_subformat == SF_FORMAT_FLOAT || stream_subformat == SF_FORMAT_DOUBLE){
-			sf_command (streamf, SFC_CALC_SIGNAL_MAX, &stream_scale, sizeof (stream_scale)) ;
-			if (stream_scale < 1e-10)
-				stream_scale = 1.0 ;
-			else
-				stream_scale = 32700.0 / stream_scale ;
+		int subformat = sfInfo.format & SF_FORMAT_SUBMASK ;
+		if (subformat == SF_FORMAT_FLOAT || subformat == SF_FORMAT_DOUBLE){
+			sf_command (streamf, SFC_SET_SCALE_FLOAT_INT_READ, nullptr, SF_TRUE) ;
 		}
 		channels = sfInfo.channels;
 		duration = float(sfInfo.frames) / float(sfInfo.samplerate);
@@ -349,36 +436,14 @@ bool ofOpenALSoundPlayer::sfStream(const of::filesystem::path& path,std::vector<
 	int curr_buffer_size = BUFFER_STREAM_SIZE*channels;
 	if(speed>1) curr_buffer_size *= (int)round(speed);
 	buffer.resize(curr_buffer_size);
-	fftAuxBuffer.resize(buffer.size());
-	if (stream_subformat == SF_FORMAT_FLOAT || stream_subformat == SF_FORMAT_DOUBLE){
-		sf_count_t samples_read = sf_read_float (streamf, &fftAuxBuffer[0], fftAuxBuffer.size());
-		stream_samples_read += samples_read;
-		if(samples_read<(int)fftAuxBuffer.size()){
-			fftAuxBuffer.resize(samples_read);
-			buffer.resize(samples_read);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
-			stream_end = true;
-		}
-		for (int i = 0 ; i < int(fftAuxBuffer.size()) ; i++){
-			fftAuxBuffer[i] *= stream_scale ;
-			buffer[i] = 32565.0 * fftAuxBuffer[i];
-		}
-	}else{
-		sf_count_t frames_read = sf_readf_short(streamf,&buffer[0],curr_buffer_size/channels);
-		stream_samples_read += frames_read*channels;
-		if(frames_read<curr_buffer_size/channels){
-			fftAuxBuffer.resize(frames_read*channels);
-			buffer.resize(frames_read*channels);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
-			stream_end = true;
-		}
-		for(int i=0;i<(int)buffer.size();i++){
-			fftAuxBuffer[i]=float(buffer[i])/32565.0f;
-		}
+	sf_count_t frames_read = sf_readf_short(streamf,&buffer[0],curr_buffer_size/channels);
+	stream_samples_read += frames_read*channels;
+	if(frames_read<curr_buffer_size/channels){
+		buffer.resize(frames_read*channels);
+		setPosition(0);
+		if(!bLoop) stopThread();
+		stream_samples_read = 0;
+		stream_end = true;
 	}
 
 	return true;
@@ -386,7 +451,7 @@ bool ofOpenALSoundPlayer::sfStream(const of::filesystem::path& path,std::vector<
 
 #ifdef OF_USING_MPG123
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::mpg123Stream(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::mpg123Stream(const of::filesystem::path& path,std::vector<short> & buffer){
 	if(!mp3streamf){
 		int err = MPG123_OK;
 		mp3streamf = mpg123_new(nullptr,&err);
@@ -417,21 +482,14 @@ bool ofOpenALSoundPlayer::mpg123Stream(const of::filesystem::path& path,std::vec
 	int curr_buffer_size = mp3_buffer_size;
 	if(speed>1) curr_buffer_size *= (int)round(speed);
 	buffer.resize(curr_buffer_size);
-	fftAuxBuffer.resize(buffer.size());
 	size_t done=0;
 	if(mpg123_read(mp3streamf,(unsigned char*)&buffer[0],curr_buffer_size*2,&done)==MPG123_DONE){
 		setPosition(0);
 		buffer.resize(done/2);
-		fftAuxBuffer.resize(done/2);
 		if(!bLoop) stopThread();
 		stream_end = true;
 	}
 
-
-	for(int i=0;i<(int)buffer.size();i++){
-		fftAuxBuffer[i] = float(buffer[i])/32565.f;
-	}
-
 	return true;
 }
 #endif
@@ -440,43 +498,75 @@ bool ofOpenALSoundPlayer::mpg123Stream(const of::filesystem::path& path,std::vec
 bool ofOpenALSoundPlayer::stream(const of::filesystem::path& fileName, std::vector<short> & buffer){
 #ifdef OF_USING_MPG123
 	if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3" || mp3streamf){
-		if(!mpg123Stream(fileName,buffer,fftAuxBuffer)) return false;
+		if(!mpg123Stream(fileName,buffer)) return false;
 	}else
 #endif
-		if(!sfStream(fileName,buffer,fftAuxBuffer)) return false;
+		if(!sfStream(fileName,buffer)) return false;
 
-	fftBuffers.resize(channels);
-	int numFrames = buffer.size()/channels;
-
-	for(int i=0;i<channels;i++){
-		fftBuffers[i].resize(numFrames);
-		for(int j=0;j<numFrames;j++){
-			fftBuffers[i][j] = fftAuxBuffer[j*channels+i];
-		}
+	if(bSpectrum){
+		deinterleave(buffer,channels,fftBuffers);
 	}
 	return true;
 }
 
-bool ofOpenALSoundPlayer::readFile(const of::filesystem::path& fileName, std::vector<short> & buffer){
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::readFile(const of::filesystem::path& fileName, ofOpenALSoundData & data){
 #ifdef OF_USING_MPG123
-	if(ofFilePath::getFileExt(fileName)!="mp3" && ofFilePath::getFileExt(fileName)!="MP3"){
-		if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
-	}else{
-		if(!mpg123ReadFile(fileName,buffer,fftAuxBuffer)) return false;
+	if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3"){
+		return mpg123ReadFile(fileName,data);
 	}
-#else
-	if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
 #endif
-	fftBuffers.resize(channels);
-	int numFrames = buffer.size()/channels;
+	return sfReadFile(fileName,data);
+}
 
-	for(int i=0;i<channels;i++){
-		fftBuffers[i].resize(numFrames);
-		for(int j=0;j<numFrames;j++){
-			fftBuffers[i][j] = fftAuxBuffer[j*channels+i];
+//------------------------------------------------------------
+std::shared_future<std::shared_ptr<ofOpenALSoundData>> ofOpenALSoundPlayer::getSoundData(const of::filesystem::path& path, bool async){
+	auto key = path.string();
+	std::unique_lock<std::mutex> lock(soundCacheMutex());
+	auto & entry = soundCache()[key];
+	if(auto data = entry.data.lock()){
+		std::promise<std::shared_ptr<ofOpenALSoundData>> loaded;
+		loaded.set_value(data);
+		return loaded.get_future().share();
+	}
+
+	// a player loading the same file waits for the decode already running
+	if(entry.decoding.valid()){
+		return entry.decoding;
+	}
+
+	auto decode = std::make_shared<std::packaged_task<std::shared_ptr<ofOpenALSoundData>()>>([path, key]{
+		auto data = std::make_shared<ofOpenALSoundData>();
+		if(!readFile(path, *data)){
+			data.reset();
 		}
+		// the cache only keeps a weak reference, the data goes away with the last player using it
+		std::unique_lock<std::mutex> lock(soundCacheMutex());
+		auto & entry = soundCache()[key];
+		entry.data = data;
+		entry.decoding = {};
+		return data;
+	});
+	entry.decoding = decode->get_future().share();
+	auto future = entry.decoding;
+	lock.unlock();
+
+	if(async){
+		decodeQueue().send(std::function<void()>([decode]{ (*decode)(); }));
+	}else{
+		(*decode)();
 	}
-	return true;
+	return future;
+}
+
+//------------------------------------------------------------
+size_t ofOpenALSoundPlayer::getNumCachedSounds(){
+	std::unique_lock<std::mutex> lock(soundCacheMutex());
+	size_t numSounds = 0;
+	for(auto & entry: soundCache()){
+		numSounds += !entry.second.data.expired();
+	}
+	return numSounds;
 }
 
 //------------------------------------------------------------
@@ -486,7 +576,6 @@ bool ofOpenALSoundPlayer::load(const of::filesystem::path& _fileName, bool is_st
 
 	bMultiPlay = false;
 	isStreaming = is_stream;
-	int err = AL_NO_ERROR;
 
 	// [1] init sound systems, if necessary
 	initialize();
@@ -496,127 +585,156 @@ bool ofOpenALSoundPlayer::load(const of::filesystem::path& _fileName, bool is_st
 	// if they call "loadSound" repeatedly, for example
 
 	unload();
-	ALenum format=AL_FORMAT_MONO16;
 	bLoadedOk = false;
 
 	if(!isStreaming){
-		bLoadedOk = readFile(fileName, buffer);
-	}else{
-		bLoadedOk = stream(fileName, buffer);
+		pendingFileName = fileName;
+		pendingData = getSoundData(fileName, false);
+		return finishLoading();
 	}
+
+	bLoadedOk = stream(fileName, buffer);
 	if( !bLoadedOk ) {
 		ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't read \"" << fileName << "\"";
 		return false;
 	}
+	bLoadedOk = setupSources(fileName);
+	return bLoadedOk;
+}
 
-	int numFrames = buffer.size()/channels;
-
-	if(isStreaming){
-		buffers.resize(channels*2);
-	}else{
-		buffers.resize(channels);
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::loadAsync(const of::filesystem::path& _fileName, bool is_stream){
+	if(is_stream){
+		return load(_fileName, is_stream);
 	}
-	alGenBuffers(buffers.size(), &buffers[0]);
-	if(channels==1){
-		sources.resize(1);
-		alGetError(); // Clear error.
-		alGenSources(1, &sources[0]);
-		err = alGetError();
-		if (err != AL_NO_ERROR){
-			ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't generate source for \"" << fileName << "\": "
-			<< (int) err << " " << getALErrorString(err);
-			return false;
-		}
 
-		for(int i=0; i<(int)buffers.size(); i++){
-			alGetError(); // Clear error.
-			alBufferData(buffers[i],format,&buffer[0],buffer.size()*2,samplerate);
-			err = alGetError();
-			if (err != AL_NO_ERROR){
-				ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create buffer for \"" << fileName << "\": "
-				<< (int) err << " " << getALErrorString(err);
-				return false;
-			}
-			if(isStreaming){
-				stream(fileName,buffer);
+	auto fileName = ofToDataPath(_fileName);
+	bMultiPlay = false;
+	isStreaming = false;
+	initialize();
+	unload();
+	bLoadedOk = false;
+
+	pendingFileName = fileName;
+	pendingData = getSoundData(fileName, true);
+	ofAddListener(ofEvents().update,this,&ofOpenALSoundPlayer::updateLoading);
+	return true;
+}
+
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::isLoading(){
+	if(pendingData.valid() && pendingData.wait_for(std::chrono::seconds(0)) == std::future_status::ready){
+		// apply whatever was set while loading
+		if(finishLoading()){
+			setLoop(bLoop);
+			setSpeed(speed);
+			setPan(pan);
+			setVolume(volume);
+			if(bPlayWhenLoaded){
+				bPlayWhenLoaded = false;
+				play();
 			}
 		}
-		if(isStreaming){
-			alSourceQueueBuffers(sources[0],buffers.size(),&buffers[0]);
-		}else{
-			alSourcei (sources[0], AL_BUFFER,   buffers[0]);
-		}
+	}
+	return pendingData.valid();
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::updateLoading(ofEventArgs & args){
+	isLoading();
+}
+
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::finishLoading(){
+	ofRemoveListener(ofEvents().update,this,&ofOpenALSoundPlayer::updateLoading);
+	auto data = pendingData.get();
+	pendingData = {};
+	if(!data){
+		ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't read \"" << pendingFileName << "\"";
+		bLoadedOk = false;
+		return false;
+	}
+	soundData = data;
+	channels = data->channels;
+	samplerate = data->samplerate;
+	duration = data->duration;
+	bLoadedOk = setupSources(pendingFileName);
+	return bLoadedOk;
+}
+
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::setupSources(const of::filesystem::path& fileName){
+	ALenum format=AL_FORMAT_MONO16;
+	int err = AL_NO_ERROR;
+
+	sources.resize(channels);
+	alGetError(); // Clear error.
+	alGenSources(channels, &sources[0]);
+	err = alGetError();
+	if (err != AL_NO_ERROR){
+		ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't generate sources for \"" << fileName << "\": "
+		<< (int) err << " " << getALErrorString(err);
+		sources.clear();
+		return false;
+	}
 
-		alSourcef (sources[0], AL_PITCH,    1.0f);
-		alSourcef (sources[0], AL_GAIN,     1.0f);
-	    alSourcef (sources[0], AL_ROLLOFF_FACTOR,  0.0);
-	    alSourcei (sources[0], AL_SOURCE_RELATIVE, AL_TRUE);
+	if(!isStreaming){
+		if(!soundData->upload()){
+			ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create buffers for \"" << fileName << "\"";
+			return false;
+		}
+		for(int i=0;i<channels;i++){
+			alSourcei (sources[i], AL_BUFFER,   soundData->buffers[i]   );
+		}
 	}else{
-		std::vector<std::vector<short> > multibuffer;
-		multibuffer.resize(channels);
-		sources.resize(channels);
-		alGenSources(channels, &sources[0]);
-		if(isStreaming){
-			for(int s=0; s<2;s++){
-				for(int i=0;i<channels;i++){
-					multibuffer[i].resize(buffer.size()/channels);
+		// two buffers per channel, one playing while the other is refilled
+		buffers.resize(channels*2);
+		alGenBuffers(buffers.size(), &buffers[0]);
+		std::vector<short> channelBuffer;
+		for(int s=0; s<2;s++){
+			int numFrames = buffer.size()/channels;
+			for(int i=0;i<channels;i++){
+				const short * data = buffer.data();
+				if(channels>1){
+					channelBuffer.resize(numFrames);
 					for(int j=0;j<numFrames;j++){
-						multibuffer[i][j] = buffer[j*channels+i];
+						channelBuffer[j] = buffer[j*channels+i];
 					}
-					alGetError(); // Clear error.
-					alBufferData(buffers[s*2+i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
-					err = alGetError();
-					if ( err != AL_NO_ERROR){
-						ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": " << (int) err << " " << getALErrorString(err);
-						return false;
-					}
-					alSourceQueueBuffers(sources[i],1,&buffers[s*2+i]);
-					stream(fileName,buffer);
-				}
-			}
-		}else{
-			for(int i=0;i<channels;i++){
-				multibuffer[i].resize(buffer.size()/channels);
-				for(int j=0;j<numFrames;j++){
-					multibuffer[i][j] = buffer[j*channels+i];
+					data = channelBuffer.data();
 				}
 				alGetError(); // Clear error.
-				alBufferData(buffers[i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
+				alBufferData(buffers[s*channels+i],format,data,numFrames*2,samplerate);
 				err = alGetError();
-				if (err != AL_NO_ERROR){
-					ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": "
-					<< (int) err << " " << getALErrorString(err);
+				if ( err != AL_NO_ERROR){
+					ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create buffers for \"" << fileName << "\": " << (int) err << " " << getALErrorString(err);
 					return false;
 				}
-				alSourcei (sources[i], AL_BUFFER,   buffers[i]   );
+				alSourceQueueBuffers(sources[i],1,&buffers[s*channels+i]);
 			}
+			stream(fileName,buffer);
 		}
+	}
 
-
-		for(int i=0;i<channels;i++){
-			err = alGetError();
-			if (err != AL_NO_ERROR){
-				ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo sources for \"" << fileName << "\": "
-				<< (int) err << " " << getALErrorString(err);
-				return false;
-			}
-
+	for(int i=0;i<channels;i++){
+		if(channels==1){
+			alSourcef (sources[i], AL_PITCH,    1.0f);
+			alSourcef (sources[i], AL_GAIN,     1.0f);
+		}else{
 			// only stereo panning
-			if(i==0){
-				float pos[3] = {-1,0,0};
-				alSourcefv(sources[i],AL_POSITION,pos);
-			}else{
-				float pos[3] = {1,0,0};
-				alSourcefv(sources[i],AL_POSITION,pos);
-			}
-			alSourcef (sources[i], AL_ROLLOFF_FACTOR,  0.0);
-			alSourcei (sources[i], AL_SOURCE_RELATIVE, AL_TRUE);
+			float pos[3] = {i==0 ? -1.f : 1.f,0,0};
+			alSourcefv(sources[i],AL_POSITION,pos);
 		}
+		alSourcef (sources[i], AL_ROLLOFF_FACTOR,  0.0);
+		alSourcei (sources[i], AL_SOURCE_RELATIVE, AL_TRUE);
 	}
 
-	bLoadedOk = true;
-	return bLoadedOk;
-
+	err = alGetError();
+	if (err != AL_NO_ERROR){
+		ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't setup sources for \"" << fileName << "\": "
+		<< (int) err << " " << getALErrorString(err);
+		return false;
+	}
+	return true;
 }
 
 //------------------------------------------------------------
@@ -709,6 +827,10 @@ void ofOpenALSoundPlayer::unload(){
 	
 	stop();
 	ofRemoveListener(ofEvents().update,this,&ofOpenALSoundPlayer::update);
+	ofRemoveListener(ofEvents().update,this,&ofOpenALSoundPlayer::updateLoading);
+	// an async decode keeps running and stays in the cache for other players
+	pendingData = {};
+	bPlayWhenLoaded = false;
 
 	// Only lock the thread where necessary.
 	{
@@ -721,6 +843,8 @@ void ofOpenALSoundPlayer::unload(){
 		sources.clear();
 		buffers.clear();
 	}
+	soundData.reset();
+	fftBuffers.clear();
 
 	// Free resources and close file descriptors.
 #ifdef OF_USING_MPG123
@@ -839,9 +963,9 @@ int ofOpenALSoundPlayer::getPositionMS() const{
 
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPan(float p){
-	if(sources.empty()) return;
 	p = glm::clamp(p, -1.f, 1.f);
 	pan = p;
+	if(sources.empty()) return;
 	if(channels==1){
 		float pos[3] = {p,0,0};
 		alSourcefv(sources[sources.size()-1],AL_POSITION,pos);
@@ -923,6 +1047,11 @@ void ofOpenALSoundPlayer::setMultiPlay(bool bMp){
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::play(){
+	if(pendingData.valid()){
+		bPlayWhenLoaded = true;
+		return;
+	}
+	if(sources.empty()) return;
 	std::unique_lock<std::mutex> lock(mutex);
 	int err = alGetError();
 
@@ -939,7 +1068,7 @@ void ofOpenALSoundPlayer::play(){
 			return;
 		}
 		for(int i=0;i<channels;i++){
-			alSourcei (sources[sources.size()-channels+i], AL_BUFFER,   buffers[i]   );
+			alSourcei (sources[sources.size()-channels+i], AL_BUFFER,   soundData->buffers[i]   );
 			// only stereo panning
 			if(i==0){
 				float pos[3] = {-1,0,0};
@@ -974,6 +1103,7 @@ void ofOpenALSoundPlayer::play(){
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::stop(){
+	bPlayWhenLoaded = false;
 	if(sources.empty()) return;
 	std::unique_lock<std::mutex> lock(mutex);
 	alSourceStopv(channels,&sources[sources.size()-channels]);
@@ -1010,6 +1140,13 @@ float * ofOpenALSoundPlayer::getCurrentBufferSum(int size){
 		windowedSignal.resize(size);
 	}
 	windowedSignal.assign(windowedSignal.size(),0);
+
+	// the float copy of the samples is only made once a spectrum is requested
+	bSpectrum = true;
+	if(!isStreaming && !soundData) return &windowedSignal[0];
+	const auto & fftBuffers = isStreaming ? this->fftBuffers : soundData->getSpectrumBuffers();
+	if(int(fftBuffers.size()) < channels) return &windowedSignal[0];
+
 	for(int k=0;k<int(sources.size())/channels;k++){
 		if(!isStreaming){
 			ALint state;
@@ -11,12 +11,14 @@ typedef unsigned int ALuint;
 #include "kiss_fft.h"
 #include "kiss_fftr.h"
 #include <sndfile.h>
+#include <future>
 
 #ifdef OF_USING_MPG123
 	typedef struct mpg123_handle_struct mpg123_handle;
 #endif
 
 class ofEventArgs;
+struct ofOpenALSoundData;
 
 //		TO DO :
 //		---------------------------
@@ -47,6 +49,14 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		virtual ~ofOpenALSoundPlayer();
 
         bool load(const of::filesystem::path& fileName, bool stream = false);
+
+		/// decodes the file on a background thread and returns immediately,
+		/// play() and the rest of setters can be called while it loads.
+		/// streams only read their first buffers so they load synchronously.
+		bool loadAsync(const of::filesystem::path& fileName, bool stream = false);
+		/// also finishes the load if the data is ready, otherwise that
+		/// happens in the next update event
+		bool isLoading();
 		void unload();
 		void play();
 		void stop();
@@ -76,6 +86,10 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static void initialize();
 		static void close();
 
+		/// players loading the same file share its decoded samples and
+		/// OpenAL buffers, this is the number of files currently shared
+		static size_t getNumCachedSounds();
+
 		float * getSpectrum(int bands);
 
 		static float * getSystemSpectrum(int bands);
@@ -86,6 +100,9 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 	private:
 		friend void ofOpenALSoundUpdate();
 		void update(ofEventArgs & args);
+		void updateLoading(ofEventArgs & args);
+		bool finishLoading();
+		bool setupSources(const of::filesystem::path& fileName);
 		void initFFT(int bands);
 		float * getCurrentBufferSum(int size);
 
@@ -93,14 +110,15 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static void runWindow(std::vector<float> & signal);
 		static void initSystemFFT(int bands);
 
-        bool sfReadFile(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
-        bool sfStream(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+        static std::shared_future<std::shared_ptr<ofOpenALSoundData>> getSoundData(const of::filesystem::path& path, bool async);
+        static bool sfReadFile(const of::filesystem::path& path, ofOpenALSoundData & data);
+        bool sfStream(const of::filesystem::path& path,std::vector<short> & buffer);
 #ifdef OF_USING_MPG123
-        bool mpg123ReadFile(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
-        bool mpg123Stream(const of::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+        static bool mpg123ReadFile(const of::filesystem::path& path, ofOpenALSoundData & data);
+        bool mpg123Stream(const of::filesystem::path& path,std::vector<short> & buffer);
 #endif
 
-        bool readFile(const of::filesystem::path& fileName,std::vector<short> & buffer);
+        static bool readFile(const of::filesystem::path& fileName, ofOpenALSoundData & data);
         bool stream(const of::filesystem::path& fileName, std::vector<short> & buffer);
 
 		bool isStreaming;
@@ -120,10 +138,15 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		int channels;
 		float duration; //in secs
 		int samplerate;
-		std::vector<ALuint> buffers;
+		std::vector<ALuint> buffers; // only streams own their buffers, the rest share soundData's
 		std::vector<ALuint> sources;
+		std::shared_ptr<ofOpenALSoundData> soundData;
+		std::shared_future<std::shared_ptr<ofOpenALSoundData>> pendingData;
+		of::filesystem::path pendingFileName;
+		bool bPlayWhenLoaded;
 
-		// fft structures
+		// fft structures, only filled once a spectrum is requested
+		bool bSpectrum;
 		std::vector<std::vector<float> > fftBuffers;
 		kiss_fftr_cfg fftCfg;
 		std::vector<float> windowedSignal;
@@ -143,10 +166,7 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		int stream_encoding;
 #endif
 		int mp3_buffer_size;
-		int stream_subformat;
-		double stream_scale;
 		std::vector<short> buffer;
-		std::vector<float> fftAuxBuffer;
 
 		bool stream_end;
 };
@@ -4,10 +4,15 @@
 #include "ofAppRunner.h"
 #include "ofLog.h"
 #include "RtAudio.h"
+#include <chrono>
 
 using std::vector;
 using std::shared_ptr;
 
+namespace{
+	std::atomic<const ofRtAudioSoundStream::RealtimeCheck *> realtimeCheck(nullptr);
+}
+
 //------------------------------------------------------------------------------
 RtAudio::Api toRtAudio(ofSoundDevice::Api api){
 	switch (api) {
@@ -61,8 +66,19 @@ ofSoundDevice::Api toOf(RtAudio::Api api){
 }
 
 //------------------------------------------------------------------------------
-ofRtAudioSoundStream::ofRtAudioSoundStream() {
+ofRtAudioSoundStream::ofRtAudioSoundStream()
+:numCallbacks(0)
+,numXRuns(0)
+,numBufferResizes(0)
+,numAllocations(0)
+,numLocks(0)
+,totalCallbackNanos(0)
+,maxCallbackNanos(0)
+,lastReportedXRuns(0){
 	tickCount = 0;
+	for(auto & bin: histogram){
+		bin = 0;
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -174,12 +190,12 @@ bool ofRtAudioSoundStream::setup(const ofSoundStreamSettings & settings_)
 	options.priority = 1;
 	outputBuffer.setDeviceID(outputParameters.deviceId);
 	inputBuffer.setDeviceID(inputParameters.deviceId);
-	outputBuffer.setSampleRate(settings.sampleRate);
-	inputBuffer.setSampleRate(settings.sampleRate);
 	unsigned int bufferSize = settings.bufferSize;
 	try {
 		audio->openStream((settings.numOutputChannels > 0) ? &outputParameters : nullptr, (settings.numInputChannels > 0) ? &inputParameters : nullptr, RTAUDIO_FLOAT32,
 			settings.sampleRate, &bufferSize, &rtAudioCallback, this, &options);
+
+		allocateBuffers(bufferSize);
 		audio->startStream();
 	}
 	catch (std::exception &error) {
@@ -189,6 +205,20 @@ bool ofRtAudioSoundStream::setup(const ofSoundStreamSettings & settings_)
 	return true;
 }
 
+//------------------------------------------------------------------------------
+void ofRtAudioSoundStream::allocateBuffers(unsigned int bufferSize) {
+	// the device can change the buffer size, allocate the buffers the
+	// listeners get for the final one so the callback doesn't have to
+	settings.bufferSize = bufferSize;
+	inputBuffer.setSampleRate(settings.sampleRate);
+	inputBuffer.setNumChannels(std::max(settings.numInputChannels, size_t(1)));
+	inputBuffer.resize(bufferSize * settings.numInputChannels);
+	outputBuffer.setSampleRate(settings.sampleRate);
+	outputBuffer.setNumChannels(std::max(settings.numOutputChannels, size_t(1)));
+	outputBuffer.resize(bufferSize * settings.numOutputChannels);
+	resetCallbackStats();
+}
+
 //------------------------------------------------------------------------------
 void ofRtAudioSoundStream::start() {
 	if (audio == nullptr) return;
@@ -213,6 +243,13 @@ void ofRtAudioSoundStream::stop() {
 	catch (std::exception &error) {
 		ofLogError() << error.what();
 	}
+
+	// logging from the audio thread could block it, xruns are reported here
+	uint64_t xruns = numXRuns;
+	if (xruns != lastReportedXRuns) {
+		ofLogWarning("ofRtAudioSoundStream") << "stream over/underflow detected " << xruns - lastReportedXRuns << " times";
+		lastReportedXRuns = xruns;
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -265,54 +302,141 @@ ofSoundDevice ofRtAudioSoundStream::getOutDevice() const{
 	return *settings.getOutDevice();
 }
 
+//------------------------------------------------------------------------------
+ofRtAudioSoundStream::CallbackStats ofRtAudioSoundStream::getCallbackStats() const{
+	CallbackStats stats;
+	stats.numCallbacks = numCallbacks;
+	stats.numXRuns = numXRuns;
+	stats.numBufferResizes = numBufferResizes;
+	stats.numAllocations = numAllocations;
+	stats.numLocks = numLocks;
+	for(size_t i = 0; i < CallbackStats::numBins; i++){
+		stats.histogram[i] = histogram[i];
+	}
+	stats.numDeadlineMisses = stats.histogram.back();
+	if(settings.sampleRate > 0){
+		stats.deadlineMicros = settings.bufferSize * 1000000.f / settings.sampleRate;
+	}
+	if(stats.deadlineMicros > 0){
+		float deadlineNanos = stats.deadlineMicros * 1000;
+		if(stats.numCallbacks > 0){
+			stats.averageLoad = totalCallbackNanos / float(stats.numCallbacks) / deadlineNanos;
+		}
+		stats.maxLoad = maxCallbackNanos / deadlineNanos;
+	}
+	return stats;
+}
+
+//------------------------------------------------------------------------------
+void ofRtAudioSoundStream::resetCallbackStats(){
+	numCallbacks = 0;
+	numXRuns = 0;
+	numBufferResizes = 0;
+	numAllocations = 0;
+	numLocks = 0;
+	totalCallbackNanos = 0;
+	maxCallbackNanos = 0;
+	for(auto & bin: histogram){
+		bin = 0;
+	}
+	lastReportedXRuns = 0;
+}
+
+//------------------------------------------------------------------------------
+void ofRtAudioSoundStream::setRealtimeCheck(const RealtimeCheck * check){
+	realtimeCheck = check;
+}
+
+//------------------------------------------------------------------------------
+bool ofRtAudioSoundStream::isRealtimeCheckEnabled(){
+	return realtimeCheck != nullptr;
+}
+
 //------------------------------------------------------------------------------
 int ofRtAudioSoundStream::rtAudioCallback(void *outputBuffer, void *inputBuffer, unsigned int nFramesPerBuffer, double streamTime, RtAudioStreamStatus status, void *data) {
 	ofRtAudioSoundStream * rtStreamPtr = (ofRtAudioSoundStream *)data;
 
-	if (status) {
-		ofLogWarning("ofRtAudioSoundStream") << "stream over/underflow detected";
+	auto check = realtimeCheck.load();
+	if (check) {
+		check->begin();
 	}
 
+	auto start = std::chrono::steady_clock::now();
+
 	// 	rtAudio uses a system by which the audio
 	// 	can be of different formats
 	// 	char, float, etc.
 	// 	we choose float
-	float * fPtrOut = (float *)outputBuffer;
-	float * fPtrIn = (float *)inputBuffer;
+	rtStreamPtr->audioCallback((float *)outputBuffer, (float *)inputBuffer, nFramesPerBuffer, status);
+
+	uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	if (check) {
+		uint64_t allocations = 0;
+		uint64_t locks = 0;
+		check->end(allocations, locks);
+		rtStreamPtr->numAllocations += allocations;
+		rtStreamPtr->numLocks += locks;
+	}
+
+	// the deadline is the duration of the buffer, every bin is 10% of it
+	uint64_t deadlineNanos = uint64_t(nFramesPerBuffer) * 1000000000 / std::max(rtStreamPtr->settings.sampleRate, size_t(1));
+	size_t bin = std::min(size_t(nanos * 10 / std::max(deadlineNanos, uint64_t(1))), CallbackStats::numBins - 1);
+	rtStreamPtr->histogram[bin]++;
+	rtStreamPtr->totalCallbackNanos += nanos;
+	if (nanos > rtStreamPtr->maxCallbackNanos) {
+		rtStreamPtr->maxCallbackNanos = nanos;
+	}
+	rtStreamPtr->numCallbacks++;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+void ofRtAudioSoundStream::audioCallback(float * fPtrOut, float * fPtrIn, size_t nFramesPerBuffer, RtAudioStreamStatus status) {
+	if (status) {
+		numXRuns++;
+	}
+
 	// [zach] memset output to zero before output call
 	// this is because of how rtAudio works: duplex w/ one callback
 	// you need to cut in the middle. if the simpleApp
 	// doesn't produce audio, we pass silence instead of duplex...
 
-	size_t nInputChannels  = rtStreamPtr->getNumInputChannels();
-	size_t nOutputChannels = rtStreamPtr->getNumOutputChannels();
+	size_t nInputChannels  = getNumInputChannels();
+	size_t nOutputChannels = getNumOutputChannels();
 
 	if (nInputChannels > 0) {
-		if (rtStreamPtr->settings.inCallback) {
-			rtStreamPtr->inputBuffer.copyFrom(fPtrIn, nFramesPerBuffer, nInputChannels, rtStreamPtr->getSampleRate());
-			rtStreamPtr->inputBuffer.setTickCount(rtStreamPtr->tickCount);
-			rtStreamPtr->settings.inCallback(rtStreamPtr->inputBuffer);
+		if (settings.inCallback) {
+			// the buffer was allocated in setup, only copy into it
+			size_t numSamples = nFramesPerBuffer * nInputChannels;
+			if (inputBuffer.size() != numSamples || inputBuffer.getNumChannels() != nInputChannels) {
+				inputBuffer.setNumChannels(nInputChannels);
+				inputBuffer.resize(numSamples);
+				numBufferResizes++;
+			}
+			std::copy(fPtrIn, fPtrIn + numSamples, inputBuffer.getBuffer().begin());
+			inputBuffer.setTickCount(tickCount);
+			settings.inCallback(inputBuffer);
 		}
 		// [damian] not sure what this is for? assuming it's for underruns? or for when the sound system becomes broken?
 		memset(fPtrIn, 0, nFramesPerBuffer * nInputChannels * sizeof(float));
 	}
 
 	if (nOutputChannels > 0) {
-		if (rtStreamPtr->settings.outCallback) {
-
-			if (rtStreamPtr->outputBuffer.size() != nFramesPerBuffer*nOutputChannels || rtStreamPtr->outputBuffer.getNumChannels() != nOutputChannels) {
-				rtStreamPtr->outputBuffer.setNumChannels(nOutputChannels);
-				rtStreamPtr->outputBuffer.resize(nFramesPerBuffer*nOutputChannels);
+		if (settings.outCallback) {
+			if (outputBuffer.size() != nFramesPerBuffer*nOutputChannels || outputBuffer.getNumChannels() != nOutputChannels) {
+				outputBuffer.setNumChannels(nOutputChannels);
+				outputBuffer.resize(nFramesPerBuffer*nOutputChannels);
+				numBufferResizes++;
 			}
-			rtStreamPtr->outputBuffer.setTickCount(rtStreamPtr->tickCount);
-			rtStreamPtr->settings.outCallback(rtStreamPtr->outputBuffer);
+			outputBuffer.setTickCount(tickCount);
+			settings.outCallback(outputBuffer);
 		}
-		rtStreamPtr->outputBuffer.copyTo(fPtrOut, nFramesPerBuffer, nOutputChannels, 0);
-		rtStreamPtr->outputBuffer.set(0);
+		outputBuffer.copyTo(fPtrOut, nFramesPerBuffer, nOutputChannels, 0);
+		std::fill(outputBuffer.getBuffer().begin(), outputBuffer.getBuffer().end(), 0.f);
 	}
 
 	// increment tick count
-	rtStreamPtr->tickCount++;
-
-	return 0;
+	tickCount++;
 }
@@ -3,12 +3,60 @@
 #include "ofSoundBaseTypes.h"
 #include "ofSoundBuffer.h"
 #include "ofConstants.h"
+#include <array>
+#include <atomic>
 
 typedef unsigned int RtAudioStreamStatus;
 class RtAudio;
 
+/// \brief Sound stream backed by RtAudio.
+///
+/// The input and output buffers passed to the listeners are allocated in
+/// setup() for the buffer size the device accepted, so the audio callback
+/// itself never allocates or locks as long as the listeners don't.
+///
+/// A realtime check can be installed with setRealtimeCheck() to count the
+/// allocations and locks that happen on the audio thread, including the
+/// ones in the listeners. openFrameworks doesn't include one since it has
+/// to replace the global operator new, the one linked into
+/// tests/sound/rtAudioSoundStream can be added to a debug build of an app.
 class ofRtAudioSoundStream : public ofBaseSoundStream {
 public:
+	/// \brief Timing of the audio callbacks, relative to the duration of a buffer.
+	struct CallbackStats{
+		/// \brief Number of bins in the histogram, each one covers 10% of the
+		///        buffer duration and the last one every callback that took longer.
+		static const size_t numBins = 11;
+
+		uint64_t numCallbacks = 0;
+		/// \brief Callbacks that took longer than the duration of a buffer.
+		uint64_t numDeadlineMisses = 0;
+		/// \brief Over/underflows reported by the device.
+		uint64_t numXRuns = 0;
+		/// \brief Times a buffer had to be resized in the callback because the
+		///        device delivered a different number of frames than in setup.
+		uint64_t numBufferResizes = 0;
+		/// \brief Allocations and locks on the audio thread, only counted
+		///        when a realtime check is installed.
+		uint64_t numAllocations = 0;
+		uint64_t numLocks = 0;
+		/// \brief Duration of a buffer, the deadline of every callback.
+		float deadlineMicros = 0;
+		/// \brief Average and longest callback as a fraction of the deadline.
+		float averageLoad = 0;
+		float maxLoad = 0;
+		std::array<uint64_t, numBins> histogram{};
+	};
+
+	/// \brief Hooks called from the audio thread around every callback.
+	///
+	/// end() adds the allocations and locks seen since begin() on the same
+	/// thread. Both have to be realtime safe themselves.
+	struct RealtimeCheck{
+		void (*begin)();
+		void (*end)(uint64_t & numAllocations, uint64_t & numLocks);
+	};
+
 	ofRtAudioSoundStream();
 	~ofRtAudioSoundStream();
 
@@ -31,6 +79,29 @@ public:
 	ofSoundDevice getInDevice() const;
 	ofSoundDevice getOutDevice() const;
 
+	/// \brief Statistics since setup or the last resetCallbackStats(), can
+	///        be called from any thread while the stream runs.
+	CallbackStats getCallbackStats() const;
+	void resetCallbackStats();
+
+	/// \brief Installs the hooks used by every stream, nullptr removes them.
+	///        The check has to outlive the streams using it.
+	static void setRealtimeCheck(const RealtimeCheck * check);
+
+	/// \returns true if a realtime check is installed and allocations and
+	///          locks on the audio thread are being counted.
+	static bool isRealtimeCheckEnabled();
+
+protected:
+	/// \brief Allocates the listeners' buffers for the buffer size the
+	///        device accepted, called from setup().
+	void allocateBuffers(unsigned int bufferSize);
+
+	/// \brief Called by RtAudio for every buffer, subclasses can call it
+	///        to run the stream without a device.
+	static int rtAudioCallback(void *outputBuffer, void *inputBuffer, unsigned int bufferSize, double streamTime, RtAudioStreamStatus status, void *data);
+
+	ofSoundStreamSettings settings;
 
 private:
 	long unsigned long tickCount;
@@ -38,8 +109,18 @@ private:
 
 	ofSoundBuffer inputBuffer;
 	ofSoundBuffer outputBuffer;
-	ofSoundStreamSettings settings;
 
-	static int rtAudioCallback(void *outputBuffer, void *inputBuffer, unsigned int bufferSize, double streamTime, RtAudioStreamStatus status, void *data);
+	// written only from the audio thread
+	std::atomic<uint64_t> numCallbacks;
+	std::atomic<uint64_t> numXRuns;
+	std::atomic<uint64_t> numBufferResizes;
+	std::atomic<uint64_t> numAllocations;
+	std::atomic<uint64_t> numLocks;
+	std::atomic<uint64_t> totalCallbackNanos;
+	std::atomic<uint64_t> maxCallbackNanos;
+	std::array<std::atomic<uint64_t>, CallbackStats::numBins> histogram;
+	uint64_t lastReportedXRuns;
+
+	void audioCallback(float * output, float * input, size_t numFrames, RtAudioStreamStatus status);
 
 };
@@ -0,0 +1,371 @@
+#include "ofSoundAnalyzer.h"
+#include "ofSoundBuffer.h"
+#include "ofLog.h"
+#include "ofMath.h"
+
+// the middle snapshot index carries this flag when the worker published
+// a snapshot the reader hasn't seen yet
+static const size_t newSnapshotFlag = 4;
+static const size_t snapshotIndexMask = 3;
+
+//--------------------------------------------------------------
+ofSoundAnalyzer::ofSoundAnalyzer()
+:sampleRate(0)
+,ringMask(0)
+,writePosition(0)
+,readPosition(0)
+,numDroppedSamples(0)
+,windowSum(1)
+,fftCfg(nullptr)
+,fluxHistoryIndex(0)
+,fluxSum(0)
+,numFrames(0)
+,numOnsets(0)
+,lastOnsetFrame(0)
+,backSnapshot(0)
+,frontSnapshot(2)
+,middleSnapshot(1)
+,running(false){
+}
+
+//--------------------------------------------------------------
+ofSoundAnalyzer::~ofSoundAnalyzer(){
+	close();
+	if(fftCfg){
+		kiss_fftr_free(fftCfg);
+	}
+}
+
+//--------------------------------------------------------------
+bool ofSoundAnalyzer::setup(const Settings & _settings, size_t _sampleRate){
+	close();
+
+	if(_sampleRate == 0 || _settings.windowSize < 2){
+		ofLogError("ofSoundAnalyzer") << "setup(): invalid sample rate " << _sampleRate << " or window size " << _settings.windowSize;
+		return false;
+	}
+
+	settings = _settings;
+	sampleRate = _sampleRate;
+
+	size_t n = 2;
+	while(n < settings.windowSize){
+		n *= 2;
+	}
+	settings.windowSize = n;
+	settings.hopSize = std::min(std::max(settings.hopSize, size_t(1)), n);
+	settings.numBands = std::max(settings.numBands, size_t(1));
+	size_t numBins = n / 2 + 1;
+
+	// enough room for a few windows or half a second, whatever is larger,
+	// so the worker can fall behind a bit without dropping samples
+	size_t ringSize = 1;
+	while(ringSize < std::max(n * 8, sampleRate / 2)){
+		ringSize *= 2;
+	}
+	ring.assign(ringSize, 0);
+	ringMask = ringSize - 1;
+	writePosition = 0;
+	readPosition = 0;
+	numDroppedSamples = 0;
+
+	frame.assign(n, 0);
+	window.resize(n);
+	windowSum = 0;
+	for(size_t i = 0; i < n; i++){
+		float phase = TWO_PI * i / n;
+		switch(settings.window){
+		case Hann:
+			window[i] = 0.5f - 0.5f * cos(phase);
+			break;
+		case Hamming:
+			window[i] = 0.54f - 0.46f * cos(phase);
+			break;
+		case Blackman:
+			window[i] = 0.42f - 0.5f * cos(phase) + 0.08f * cos(2 * phase);
+			break;
+		case Rectangular:
+		default:
+			window[i] = 1;
+			break;
+		}
+		windowSum += window[i];
+	}
+
+	if(fftCfg){
+		kiss_fftr_free(fftCfg);
+	}
+	fftCfg = kiss_fftr_alloc(n, 0, nullptr, nullptr);
+	fftInput.assign(n, 0);
+	fftOutput.resize(numBins);
+	previousSpectrum.assign(numBins, 0);
+
+	// band edges as bin indices, every band gets at least one bin until
+	// there's no bins left, the DC bin is never part of a band
+	bandEdges.resize(settings.numBands + 1);
+	float nyquist = sampleRate / 2.f;
+	float minFrequency = ofClamp(settings.minFrequency, getBinFrequency(1), nyquist);
+	for(size_t i = 0; i <= settings.numBands; i++){
+		float pct = float(i) / settings.numBands;
+		float frequency;
+		if(settings.logBands){
+			frequency = minFrequency * pow(nyquist / minFrequency, pct);
+		}else{
+			frequency = getBinFrequency(1) + (nyquist - getBinFrequency(1)) * pct;
+		}
+		size_t bin = std::max(size_t(round(frequency * n / sampleRate)), size_t(1));
+		if(i > 0){
+			bin = std::max(bin, bandEdges[i - 1] + 1);
+		}
+		bandEdges[i] = std::min(bin, numBins);
+	}
+	bandEdges.back() = numBins;
+
+	fluxHistory.assign(std::max(size_t(round(0.5f * sampleRate / settings.hopSize)), size_t(1)), 0);
+	fluxHistoryIndex = 0;
+	fluxSum = 0;
+	numFrames = 0;
+	numOnsets = 0;
+	lastOnsetFrame = 0;
+
+	for(auto & snapshot: snapshots){
+		snapshot = Snapshot();
+		snapshot.spectrum.assign(numBins, 0);
+		snapshot.bands.assign(settings.numBands, 0);
+		snapshot.bandFrequencies.resize(settings.numBands);
+		for(size_t i = 0; i < settings.numBands; i++){
+			float low = getBinFrequency(bandEdges[i]);
+			float high = getBinFrequency(std::max(bandEdges[i + 1], bandEdges[i] + 1) - 1);
+			snapshot.bandFrequencies[i] = settings.logBands ? sqrt(low * high) : (low + high) / 2;
+		}
+	}
+	backSnapshot = 0;
+	middleSnapshot = 1;
+	frontSnapshot = 2;
+
+	running = true;
+	if(settings.threaded){
+		worker = std::thread(&ofSoundAnalyzer::threadedFunction, this);
+	}
+	return true;
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::close(){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		running = false;
+	}
+	condition.notify_all();
+	analyzedCondition.notify_all();
+	if(worker.joinable()){
+		worker.join();
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::process(const ofSoundBuffer & buffer){
+	process(buffer.getBuffer().data(), buffer.getNumFrames(), buffer.getNumChannels());
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::process(const float * samples, size_t numFrames, size_t numChannels){
+	if(!running || numChannels == 0){
+		return;
+	}
+
+	uint64_t write = writePosition.load(std::memory_order_relaxed);
+	uint64_t read = readPosition.load(std::memory_order_acquire);
+	size_t available = ring.size() - size_t(write - read);
+	size_t count = std::min(numFrames, available);
+	if(count < numFrames){
+		numDroppedSamples += numFrames - count;
+	}
+
+	int channel = settings.channel;
+	if(channel >= 0 && size_t(channel) < numChannels){
+		for(size_t i = 0; i < count; i++){
+			ring[(write + i) & ringMask] = samples[i * numChannels + channel];
+		}
+	}else if(numChannels == 1){
+		for(size_t i = 0; i < count; i++){
+			ring[(write + i) & ringMask] = samples[i];
+		}
+	}else{
+		float gain = 1.f / numChannels;
+		for(size_t i = 0; i < count; i++){
+			float sum = 0;
+			for(size_t c = 0; c < numChannels; c++){
+				sum += samples[i * numChannels + c];
+			}
+			ring[(write + i) & ringMask] = sum * gain;
+		}
+	}
+	writePosition.store(write + count, std::memory_order_release);
+
+	if(settings.threaded){
+		// notifying without the lock can miss a wake up if the worker is
+		// just about to wait, the wait has a timeout so it only adds latency
+		condition.notify_one();
+	}else{
+		analyzeAvailable();
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::audioIn(ofSoundBuffer & buffer){
+	process(buffer);
+}
+
+//--------------------------------------------------------------
+const ofSoundAnalyzer::Snapshot & ofSoundAnalyzer::getSnapshot(){
+	if(middleSnapshot.load(std::memory_order_acquire) & newSnapshotFlag){
+		frontSnapshot = middleSnapshot.exchange(frontSnapshot) & snapshotIndexMask;
+	}
+	return snapshots[frontSnapshot];
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::waitForAnalysis(){
+	if(!settings.threaded){
+		return;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	analyzedCondition.wait(lock, [this]{
+		return !running || writePosition - readPosition < settings.hopSize;
+	});
+}
+
+//--------------------------------------------------------------
+const ofSoundAnalyzer::Settings & ofSoundAnalyzer::getSettings() const{
+	return settings;
+}
+
+//--------------------------------------------------------------
+size_t ofSoundAnalyzer::getSampleRate() const{
+	return sampleRate;
+}
+
+//--------------------------------------------------------------
+uint64_t ofSoundAnalyzer::getNumDroppedSamples() const{
+	return numDroppedSamples;
+}
+
+//--------------------------------------------------------------
+float ofSoundAnalyzer::getBinFrequency(size_t bin) const{
+	if(settings.windowSize == 0){
+		return 0;
+	}
+	return float(bin) * sampleRate / settings.windowSize;
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::threadedFunction(){
+	while(running){
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait_for(lock, std::chrono::milliseconds(10), [this]{
+				return !running || writePosition - readPosition >= settings.hopSize;
+			});
+		}
+		analyzeAvailable();
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::analyzeAvailable(){
+	size_t n = settings.windowSize;
+	size_t hop = settings.hopSize;
+	uint64_t read = readPosition.load(std::memory_order_relaxed);
+	uint64_t write = writePosition.load(std::memory_order_acquire);
+	bool analyzed = false;
+	while(write - read >= hop){
+		// slide the window by one hop and append the new samples
+		std::copy(frame.begin() + hop, frame.end(), frame.begin());
+		for(size_t i = 0; i < hop; i++){
+			frame[n - hop + i] = ring[(read + i) & ringMask];
+		}
+		read += hop;
+		readPosition.store(read, std::memory_order_release);
+
+		analyzeFrame(read);
+		publish();
+		analyzed = true;
+
+		write = writePosition.load(std::memory_order_acquire);
+	}
+
+	if(analyzed && settings.threaded){
+		// take the lock so waitForAnalysis can't miss the notification
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+		}
+		analyzedCondition.notify_all();
+	}
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::analyzeFrame(uint64_t position){
+	auto & snapshot = snapshots[backSnapshot];
+	size_t n = settings.windowSize;
+
+	float sumSquares = 0;
+	float peak = 0;
+	for(size_t i = 0; i < n; i++){
+		float sample = frame[i];
+		sumSquares += sample * sample;
+		peak = std::max(peak, std::abs(sample));
+		fftInput[i] = sample * window[i];
+	}
+	snapshot.rms = sqrt(sumSquares / n);
+	snapshot.peak = peak;
+
+	kiss_fftr(fftCfg, fftInput.data(), fftOutput.data());
+
+	// same normalization as ofGetSoundSpectrum, a full scale sine in the
+	// center of a bin has a magnitude of 1
+	float normalizer = 2.f / windowSum;
+	float flux = 0;
+	for(size_t i = 0; i < snapshot.spectrum.size(); i++){
+		float magnitude = sqrt(fftOutput[i].r * fftOutput[i].r + fftOutput[i].i * fftOutput[i].i) * normalizer;
+		flux += std::max(magnitude - previousSpectrum[i], 0.f);
+		previousSpectrum[i] = magnitude;
+		snapshot.spectrum[i] = magnitude;
+	}
+
+	for(size_t band = 0; band < settings.numBands; band++){
+		size_t begin = bandEdges[band];
+		size_t end = bandEdges[band + 1];
+		float sum = 0;
+		for(size_t i = begin; i < end; i++){
+			sum += snapshot.spectrum[i];
+		}
+		snapshot.bands[band] = end > begin ? sum / (end - begin) : 0;
+	}
+
+	float average = fluxSum / fluxHistory.size();
+	fluxSum += flux - fluxHistory[fluxHistoryIndex];
+	fluxHistory[fluxHistoryIndex] = flux;
+	fluxHistoryIndex = (fluxHistoryIndex + 1) % fluxHistory.size();
+
+	uint64_t minFrames = uint64_t(settings.onsetMinInterval * sampleRate / settings.hopSize);
+	bool onset = flux > settings.onsetMinFlux
+		&& flux > average * settings.onsetThreshold
+		&& (numOnsets == 0 || numFrames - lastOnsetFrame >= minFrames);
+	if(onset){
+		numOnsets++;
+		lastOnsetFrame = numFrames;
+	}
+
+	snapshot.flux = flux;
+	snapshot.onset = onset;
+	snapshot.numOnsets = numOnsets;
+	snapshot.frame = numFrames;
+	snapshot.position = position;
+	numFrames++;
+}
+
+//--------------------------------------------------------------
+void ofSoundAnalyzer::publish(){
+	backSnapshot = middleSnapshot.exchange(backSnapshot | newSnapshotFlag) & snapshotIndexMask;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "ofSoundBaseTypes.h"
+#include "kiss_fftr.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class ofSoundBuffer;
+
+/// \brief Real-time spectrum, level and onset analysis of a sound stream.
+///
+/// The audio callback only copies the incoming samples into a lock-free
+/// ring buffer, the analysis runs on a worker thread: every hop size
+/// samples it windows the last window size samples, runs an FFT and
+/// computes the magnitude spectrum, the energy in a set of bands, RMS,
+/// peak and a spectral flux onset detector.
+///
+/// Results are published as a snapshot that can be read from any other
+/// thread without locking the worker or the audio thread:
+///
+/// ~~~~{.cpp}
+/// // setup
+/// ofSoundAnalyzer::Settings analyzerSettings;
+/// analyzerSettings.windowSize = 2048;
+/// analyzerSettings.hopSize = 512;
+/// analyzer.setup(analyzerSettings, 44100);
+/// soundSettings.setInListener(&analyzer);
+///
+/// // update
+/// auto & analysis = analyzer.getSnapshot();
+/// if(analysis.numOnsets != lastNumOnsets) ...
+/// ~~~~
+///
+/// The analyzer can also be fed from an app's own audioIn() or audioOut()
+/// by calling process() with the buffer.
+class ofSoundAnalyzer: public ofBaseSoundInput{
+public:
+	enum Window{
+		Rectangular,
+		Hann,
+		Hamming,
+		Blackman,
+	};
+
+	struct Settings{
+		/// \brief Samples per FFT, rounded up to a power of two.
+		size_t windowSize = 1024;
+		/// \brief Samples between the start of consecutive windows.
+		size_t hopSize = 256;
+		Window window = Hann;
+		/// \brief Number of bands the spectrum is summarized in.
+		size_t numBands = 32;
+		/// \brief Logarithmically spaced bands from minFrequency, otherwise linear.
+		bool logBands = true;
+		float minFrequency = 40;
+		/// \brief Channel to analyze, -1 mixes all the channels.
+		int channel = -1;
+		/// \brief An onset is detected when the spectral flux is this many
+		///        times the average of the last half second.
+		float onsetThreshold = 1.5f;
+		/// \brief Spectral flux below this is never an onset, avoids
+		///        detecting onsets in the noise floor after silence.
+		float onsetMinFlux = 0.01f;
+		/// \brief Minimum time between onsets in seconds.
+		float onsetMinInterval = 0.05f;
+		/// \brief Analyze on a worker thread, false analyzes in process()
+		///        which is useful for offline analysis but not real-time safe.
+		bool threaded = true;
+	};
+
+	/// \brief The result of analyzing one window.
+	struct Snapshot{
+		/// \brief Magnitude of each FFT bin, windowSize / 2 + 1 values.
+		std::vector<float> spectrum;
+		/// \brief Average magnitude of the bins in each band.
+		std::vector<float> bands;
+		/// \brief Center frequency of each band in Hz.
+		std::vector<float> bandFrequencies;
+		float rms = 0;
+		float peak = 0;
+		float flux = 0;
+		/// \brief True if an onset was detected in this window.
+		bool onset = false;
+		/// \brief Onsets detected since setup, compare with a previous
+		///        value to not miss onsets between reads.
+		uint64_t numOnsets = 0;
+		/// \brief Number of windows analyzed since setup.
+		uint64_t frame = 0;
+		/// \brief Position of the end of the window in the stream, in samples.
+		uint64_t position = 0;
+	};
+
+	ofSoundAnalyzer();
+	~ofSoundAnalyzer();
+
+	ofSoundAnalyzer(const ofSoundAnalyzer &) = delete;
+	ofSoundAnalyzer & operator=(const ofSoundAnalyzer &) = delete;
+
+	/// \brief Allocates everything the analysis needs and starts the worker.
+	bool setup(const Settings & settings, size_t sampleRate);
+	void close();
+
+	/// \brief Feed samples to the analyzer, can be called from the audio thread.
+	///
+	/// Never allocates or locks when threaded, if the worker falls behind
+	/// the samples that don't fit in the ring buffer are dropped.
+	void process(const ofSoundBuffer & buffer);
+	void process(const float * samples, size_t numFrames, size_t numChannels);
+
+	/// \brief Latest analysis, only valid until the next call from the same thread.
+	///
+	/// Has to be called from a single thread, usually the main one.
+	const Snapshot & getSnapshot();
+
+	/// \brief Blocks until every sample passed to process() so far has been analyzed.
+	void waitForAnalysis();
+
+	const Settings & getSettings() const;
+	size_t getSampleRate() const;
+	uint64_t getNumDroppedSamples() const;
+
+	/// \brief Frequency in Hz of an FFT bin.
+	float getBinFrequency(size_t bin) const;
+
+	void audioIn(ofSoundBuffer & buffer);
+
+private:
+	void threadedFunction();
+	void analyzeAvailable();
+	void analyzeFrame(uint64_t position);
+	void publish();
+
+	Settings settings;
+	size_t sampleRate;
+
+	// single producer single consumer ring buffer of mono samples
+	std::vector<float> ring;
+	size_t ringMask;
+	std::atomic<uint64_t> writePosition;
+	std::atomic<uint64_t> readPosition;
+	std::atomic<uint64_t> numDroppedSamples;
+
+	// analysis state, only touched by the worker
+	std::vector<float> frame;
+	std::vector<float> window;
+	float windowSum;
+	kiss_fftr_cfg fftCfg;
+	std::vector<kiss_fft_scalar> fftInput;
+	std::vector<kiss_fft_cpx> fftOutput;
+	std::vector<float> previousSpectrum;
+	std::vector<size_t> bandEdges;
+	std::vector<float> fluxHistory;
+	size_t fluxHistoryIndex;
+	float fluxSum;
+	uint64_t numFrames;
+	uint64_t numOnsets;
+	uint64_t lastOnsetFrame;
+
+	// triple buffer, the worker writes back, the reader owns front and
+	// middle holds the latest complete snapshot plus a flag if it's new
+	std::array<Snapshot, 3> snapshots;
+	size_t backSnapshot;
+	size_t frontSnapshot;
+	std::atomic<size_t> middleSnapshot;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::condition_variable analyzedCondition;
+	std::atomic<bool> running;
+};
@@ -17,6 +17,36 @@
 #include <memory>
 #include <functional>
 
+// std::string_view is used by some functions when building with c++17 and
+// the standard library has it. __cpp_lib_string_view is only defined once
+// <version> or <string_view> are included so it can't be checked here
+#ifndef OF_HAS_STRING_VIEW
+	#if (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)) && defined(__has_include)
+		#if __has_include(<string_view>)
+			#include <string_view>
+			#define OF_HAS_STRING_VIEW 1
+		#endif
+	#endif
+	#ifndef OF_HAS_STRING_VIEW
+		#define OF_HAS_STRING_VIEW 0
+	#endif
+#endif
+
+// std::to_chars and std::from_chars are used to convert numbers when the
+// standard library supports them for floating point numbers too
+#if defined(__has_include)
+	#if __has_include(<charconv>)
+		#include <charconv>
+	#endif
+#endif
+#ifndef OF_HAS_TO_CHARS
+	#ifdef __cpp_lib_to_chars
+		#define OF_HAS_TO_CHARS 1
+	#else
+		#define OF_HAS_TO_CHARS 0
+	#endif
+#endif
+
 // Set to 1 for compatibility with old projects using ofVec instead of glm
 #ifndef OF_USE_LEGACY_VECTOR_MATH
 	#define OF_USE_LEGACY_VECTOR_MATH 0
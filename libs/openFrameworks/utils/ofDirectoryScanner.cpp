@@ -0,0 +1,359 @@
+#include "ofDirectoryScanner.h"
+#include "ofThreadChannel.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+//----------------------------------------------------------
+ofDirectoryEntry::ofDirectoryEntry()
+:depth(0)
+,directory(false)
+,hidden(false)
+,statusRead(false)
+,size(0)
+,lastWriteTime(){
+}
+
+//----------------------------------------------------------
+ofDirectoryEntry::ofDirectoryEntry(const of::filesystem::directory_entry & entry, size_t depth)
+:depth(depth)
+,directory(false)
+,hidden(false)
+,statusRead(false)
+,size(0)
+,lastWriteTime(){
+	setPath(entry.path());
+	// the type usually comes with the listing so this doesn't need to stat
+	// the file, std::filesystem caches it but only through is_directory()
+	try{
+#if OF_USING_STD_FS && !OF_USE_EXPERIMENTAL_FS
+		directory = entry.is_directory();
+#else
+		directory = of::filesystem::is_directory(entry.status());
+#endif
+	}catch(...){
+		directory = false;
+	}
+}
+
+//----------------------------------------------------------
+ofDirectoryEntry::ofDirectoryEntry(const of::filesystem::path & path, bool isDirectory, size_t depth)
+:depth(depth)
+,directory(isDirectory)
+,hidden(false)
+,statusRead(false)
+,size(0)
+,lastWriteTime(){
+	setPath(path);
+}
+
+//----------------------------------------------------------
+void ofDirectoryEntry::setPath(const of::filesystem::path & path){
+	entryPath = path;
+	const auto & native = entryPath.native();
+	auto nameStart = native.find_last_of(of::filesystem::path::preferred_separator);
+	nameStart = nameStart == native.npos ? 0 : nameStart + 1;
+#ifndef TARGET_WIN32
+	hidden = nameStart < native.size() && native[nameStart] == '.';
+#endif
+	auto dot = native.find_last_of('.');
+	if(dot != native.npos && dot > nameStart){
+		extension.reserve(native.size() - dot - 1);
+		for(auto c = native.begin() + dot + 1; c != native.end(); ++c){
+			extension += (char)std::tolower((unsigned char)*c);
+		}
+	}
+}
+
+//----------------------------------------------------------
+const of::filesystem::path & ofDirectoryEntry::path() const{
+	return entryPath;
+}
+
+//----------------------------------------------------------
+std::string ofDirectoryEntry::getFileName() const{
+	return entryPath.filename().string();
+}
+
+//----------------------------------------------------------
+const std::string & ofDirectoryEntry::getExtension() const{
+	return extension;
+}
+
+//----------------------------------------------------------
+bool ofDirectoryEntry::isDirectory() const{
+	return directory;
+}
+
+//----------------------------------------------------------
+bool ofDirectoryEntry::isHidden() const{
+	return hidden;
+}
+
+//----------------------------------------------------------
+size_t ofDirectoryEntry::getDepth() const{
+	return depth;
+}
+
+//----------------------------------------------------------
+void ofDirectoryEntry::readStatus() const{
+	if(statusRead){
+		return;
+	}
+	statusRead = true;
+	try{
+		if(!directory){
+			size = of::filesystem::file_size(entryPath);
+		}
+		lastWriteTime = of::filesystem::last_write_time(entryPath);
+	}catch(std::exception & e){
+		ofLogError("ofDirectoryEntry") << "couldn't read status of " << entryPath << ": " << e.what();
+	}
+}
+
+//----------------------------------------------------------
+uint64_t ofDirectoryEntry::getSize() const{
+	readStatus();
+	return size;
+}
+
+//----------------------------------------------------------
+ofDirectoryEntry::Time ofDirectoryEntry::getLastWriteTime() const{
+	readStatus();
+	return lastWriteTime;
+}
+
+//----------------------------------------------------------
+ofFile ofDirectoryEntry::getFile(ofFile::Mode mode, bool binary) const{
+	ofFile file;
+	file.openFromCWD(entryPath, mode, binary);
+	return file;
+}
+
+//----------------------------------------------------------
+bool ofDirectoryScanner::Settings::accepts(const ofDirectoryEntry & entry) const{
+	if(entry.isHidden() && !showHidden){
+		return false;
+	}
+	if(entry.isDirectory()){
+		return includeDirectories;
+	}
+	return extensions.empty() || std::find(extensions.begin(), extensions.end(), entry.getExtension()) != extensions.end();
+}
+
+namespace{
+	struct Directory{
+		of::filesystem::path path;
+		size_t depth;
+	};
+
+	bool shouldWalk(const of::filesystem::directory_entry & entry, const ofDirectoryEntry & scanned, const ofDirectoryScanner::Settings & settings){
+		if(!settings.recursive || !scanned.isDirectory()){
+			return false;
+		}
+		if(scanned.isHidden() && !settings.showHidden){
+			return false;
+		}
+		if(!settings.followSymlinks){
+			try{
+				return !of::filesystem::is_symlink(entry.symlink_status());
+			}catch(...){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// lists a single directory, calls found for every entry that passes the
+	// filters and subdirectory for the ones that have to be walked into
+	template<typename Found, typename Subdirectory>
+	void listDirectory(const Directory & directory, const ofDirectoryScanner::Settings & settings, Found found, Subdirectory subdirectory){
+		try{
+			of::filesystem::directory_iterator end;
+			for(of::filesystem::directory_iterator it(directory.path); it != end; ++it){
+				ofDirectoryEntry entry(*it, directory.depth);
+				if(shouldWalk(*it, entry, settings)){
+					subdirectory(Directory{entry.path(), directory.depth + 1});
+				}
+				if(settings.accepts(entry)){
+					found(std::move(entry));
+				}
+			}
+		}catch(std::exception & e){
+			ofLogWarning("ofDirectoryScanner") << "couldn't list " << directory.path << ": " << e.what();
+		}
+	}
+}
+
+//----------------------------------------------------------
+size_t ofDirectoryScanner::scan(const of::filesystem::path & path, const Settings & _settings, const Callback & callback){
+	of::filesystem::path root = ofToDataPath(path, true);
+	if(!of::filesystem::is_directory(root)){
+		ofLogError("ofDirectoryScanner") << "scan(): " << root << " is not a directory";
+		return 0;
+	}
+
+	Settings settings = _settings;
+	for(auto & extension: settings.extensions){
+		extension = ofToLower(extension);
+		if(!extension.empty() && extension[0] == '.'){
+			extension.erase(0, 1);
+		}
+	}
+
+	size_t numThreads = settings.numThreads;
+	if(numThreads == 0){
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	if(!settings.recursive){
+		numThreads = 1;
+	}
+
+	size_t numFound = 0;
+	if(numThreads == 1){
+		// the callback is called once a directory is listed so exceptions
+		// it throws aren't mistaken for errors reading the directory
+		std::vector<Directory> pending{Directory{root, 0}};
+		std::vector<ofDirectoryEntry> found;
+		while(!pending.empty()){
+			auto directory = std::move(pending.back());
+			pending.pop_back();
+			listDirectory(directory, settings,
+				[&](ofDirectoryEntry && entry){
+					found.push_back(std::move(entry));
+				},
+				[&](Directory && subdirectory){
+					pending.push_back(std::move(subdirectory));
+				});
+			for(auto & entry: found){
+				callback(entry);
+			}
+			numFound += found.size();
+			found.clear();
+		}
+		return numFound;
+	}
+
+	// the workers share a queue of directories still to list and send
+	// what they find in batches to this thread, the last worker to finish
+	// sends an empty batch to signal the end
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<Directory> pending{Directory{root, 0}};
+	size_t numBusy = 0;
+	bool stopped = false;
+	std::atomic<size_t> numRunning(numThreads);
+	ofThreadChannel<std::vector<ofDirectoryEntry>> batches;
+	const size_t batchSize = 256;
+
+	auto worker = [&]{
+		std::vector<ofDirectoryEntry> batch;
+		std::vector<Directory> subdirectories;
+		while(true){
+			Directory directory;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]{
+					return !pending.empty() || numBusy == 0 || stopped;
+				});
+				if(pending.empty() || stopped){
+					break;
+				}
+				directory = std::move(pending.front());
+				pending.pop_front();
+				numBusy++;
+			}
+
+			listDirectory(directory, settings,
+				[&](ofDirectoryEntry && entry){
+					batch.push_back(std::move(entry));
+					if(batch.size() == batchSize){
+						batches.send(std::move(batch));
+						batch.clear();
+					}
+				},
+				[&](Directory && subdirectory){
+					subdirectories.push_back(std::move(subdirectory));
+				});
+
+			std::unique_lock<std::mutex> lock(mutex);
+			for(auto & subdirectory: subdirectories){
+				pending.push_back(std::move(subdirectory));
+			}
+			subdirectories.clear();
+			numBusy--;
+			if(!pending.empty() || numBusy == 0){
+				condition.notify_all();
+			}
+		}
+
+		if(!batch.empty()){
+			batches.send(std::move(batch));
+		}
+		if(--numRunning == 0){
+			batches.send(std::vector<ofDirectoryEntry>());
+		}
+	};
+
+	// if the callback throws, or a thread can't be started, the workers
+	// are stopped and joined before the exception leaves this function
+	std::vector<std::thread> threads;
+	auto stopWorkers = [&]{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			stopped = true;
+			pending.clear();
+		}
+		condition.notify_all();
+		batches.close();
+		for(auto & thread: threads){
+			thread.join();
+		}
+	};
+
+	try{
+		for(size_t i = 0; i < numThreads; i++){
+			threads.emplace_back(worker);
+		}
+
+		std::vector<ofDirectoryEntry> batch;
+		while(batches.receive(batch) && !batch.empty()){
+			for(auto & entry: batch){
+				callback(entry);
+			}
+			numFound += batch.size();
+		}
+	}catch(...){
+		stopWorkers();
+		throw;
+	}
+
+	for(auto & thread: threads){
+		thread.join();
+	}
+	return numFound;
+}
+
+//----------------------------------------------------------
+std::vector<ofDirectoryEntry> ofDirectoryScanner::list(const of::filesystem::path & path, const Settings & settings){
+	std::vector<ofDirectoryEntry> entries;
+	scan(path, settings, [&](const ofDirectoryEntry & entry){
+		entries.push_back(entry);
+	});
+	if(settings.sort){
+		std::sort(entries.begin(), entries.end(), [](const ofDirectoryEntry & a, const ofDirectoryEntry & b){
+			return ofDirectory::naturalLess(a.path(), b.path());
+		});
+	}
+	return entries;
+}
+
+//----------------------------------------------------------
+std::vector<ofDirectoryEntry> ofDirectoryScanner::list(const of::filesystem::path & path){
+	return list(path, Settings());
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ofFileUtils.h"
+#include <functional>
+
+/// \brief A file or directory found by ofDirectoryScanner.
+///
+/// Only keeps what the directory listing already provides: the path, if
+/// it's a directory and its lowercase extension, computed once so filtering
+/// and grouping by extension doesn't allocate. The size and modification
+/// time need an extra system call so they are only read the first time
+/// they are asked for.
+class ofDirectoryEntry{
+public:
+	/// \brief file_time_type with std::filesystem, std::time_t with boost.
+	typedef decltype(of::filesystem::last_write_time(of::filesystem::path())) Time;
+
+	ofDirectoryEntry();
+	ofDirectoryEntry(const of::filesystem::directory_entry & entry, size_t depth);
+	ofDirectoryEntry(const of::filesystem::path & path, bool isDirectory, size_t depth);
+
+	const of::filesystem::path & path() const;
+	std::string getFileName() const;
+
+	/// \brief Extension in lowercase without the dot.
+	const std::string & getExtension() const;
+
+	bool isDirectory() const;
+	bool isHidden() const;
+
+	/// \brief Depth relative to the scanned directory, 0 for its direct children.
+	size_t getDepth() const;
+
+	/// \brief Size in bytes, read the first time it's called.
+	uint64_t getSize() const;
+
+	/// \brief Modification time, read the first time it's called.
+	Time getLastWriteTime() const;
+
+	/// \brief An ofFile for this entry, doesn't resolve the path again.
+	ofFile getFile(ofFile::Mode mode = ofFile::Reference, bool binary = true) const;
+
+private:
+	void setPath(const of::filesystem::path & path);
+	void readStatus() const;
+
+	of::filesystem::path entryPath;
+	std::string extension;
+	size_t depth;
+	bool directory;
+	bool hidden;
+
+	mutable bool statusRead;
+	mutable uint64_t size;
+	mutable Time lastWriteTime;
+};
+
+/// \brief Lists the contents of a directory tree quickly.
+///
+/// Unlike ofDirectory it doesn't create an ofFile for every entry and
+/// can walk subdirectories with several threads at the same time. The
+/// entries are streamed to a callback as they are found, which always
+/// runs on the thread that called scan(), so it's possible to start
+/// working on the first files before the whole tree has been read:
+///
+/// ~~~~{.cpp}
+/// ofDirectoryScanner::Settings settings;
+/// settings.recursive = true;
+/// settings.extensions = {"jpg", "png"};
+/// ofDirectoryScanner::scan("photos", settings, [&](const ofDirectoryEntry & entry){
+///     thumbnails.load(entry.path());
+/// });
+/// ~~~~
+///
+/// When walking with more than one thread the order of the entries isn't
+/// defined, list() can sort them in natural order afterwards.
+class ofDirectoryScanner{
+public:
+	struct Settings{
+		/// \brief Also list the contents of the subdirectories.
+		bool recursive = false;
+		/// \brief Follow symbolic links to directories when recursive.
+		bool followSymlinks = false;
+		bool showHidden = false;
+		/// \brief Report directories to the callback, they are walked
+		///        into when recursive either way.
+		bool includeDirectories = false;
+		/// \brief Only report files with these extensions, case insensitive
+		///        and without the dot, empty reports every file.
+		std::vector<std::string> extensions;
+		/// \brief Threads walking subdirectories when recursive, 0 uses one per core.
+		size_t numThreads = 0;
+		/// \brief Sort the result of list() in natural order.
+		bool sort = true;
+
+		/// \returns true if an entry passes the hidden, directory and extension filters.
+		bool accepts(const ofDirectoryEntry & entry) const;
+	};
+
+	typedef std::function<void(const ofDirectoryEntry &)> Callback;
+
+	/// \brief Walks a directory calling callback for every entry that passes the filters.
+	/// \param path Directory to scan, relative to data.
+	/// \returns Number of entries reported or 0 if the directory doesn't exist.
+	static size_t scan(const of::filesystem::path & path, const Settings & settings, const Callback & callback);
+
+	/// \brief Walks a directory and returns every entry that passes the filters.
+	static std::vector<ofDirectoryEntry> list(const of::filesystem::path & path, const Settings & settings);
+	static std::vector<ofDirectoryEntry> list(const of::filesystem::path & path);
+};
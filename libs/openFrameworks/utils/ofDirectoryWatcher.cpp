@@ -0,0 +1,309 @@
+#include "ofDirectoryWatcher.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+#ifdef TARGET_LINUX
+#include <sys/inotify.h>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------
+ofDirectoryWatcher::ofDirectoryWatcher()
+:running(false)
+,native(false){
+#ifdef TARGET_LINUX
+	inotifyFd = -1;
+#endif
+}
+
+//----------------------------------------------------------
+ofDirectoryWatcher::~ofDirectoryWatcher(){
+	close();
+}
+
+//----------------------------------------------------------
+bool ofDirectoryWatcher::setup(const Settings & _settings){
+	close();
+
+	settings = _settings;
+	root = ofToDataPath(settings.path, true);
+	if(!of::filesystem::is_directory(root)){
+		ofLogError("ofDirectoryWatcher") << "setup(): " << root << " is not a directory";
+		return false;
+	}
+
+	scanSettings = ofDirectoryScanner::Settings();
+	scanSettings.recursive = settings.recursive;
+	scanSettings.showHidden = settings.showHidden;
+	scanSettings.includeDirectories = settings.includeDirectories;
+	scanSettings.numThreads = 1;
+	scanSettings.sort = false;
+	for(auto & extension: settings.extensions){
+		auto lower = ofToLower(extension);
+		if(!lower.empty() && lower[0] == '.'){
+			lower.erase(0, 1);
+		}
+		scanSettings.extensions.push_back(lower);
+	}
+
+	running = true;
+	native = false;
+#ifdef TARGET_LINUX
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(inotifyFd >= 0 && addWatch(root, false)){
+		native = true;
+		thread = std::thread(&ofDirectoryWatcher::inotifyFunction, this);
+	}else{
+		ofLogWarning("ofDirectoryWatcher") << "setup(): couldn't use inotify, polling " << root << " instead";
+		if(inotifyFd >= 0){
+			::close(inotifyFd);
+			inotifyFd = -1;
+		}
+	}
+#endif
+	if(!native){
+		// the first scan happens before returning so changes right after
+		// setup aren't mistaken for the initial state
+		scanStatus(polledStatus);
+		thread = std::thread(&ofDirectoryWatcher::pollFunction, this);
+	}
+
+	if(settings.notifyOnUpdate){
+		ofAddListener(ofEvents().update, this, &ofDirectoryWatcher::onUpdate);
+	}
+	return true;
+}
+
+//----------------------------------------------------------
+void ofDirectoryWatcher::close(){
+	if(!running){
+		return;
+	}
+	running = false;
+	if(thread.joinable()){
+		thread.join();
+	}
+#ifdef TARGET_LINUX
+	if(inotifyFd >= 0){
+		::close(inotifyFd);
+		inotifyFd = -1;
+	}
+	watches.clear();
+	knownFiles.clear();
+#endif
+	polledStatus.clear();
+	if(settings.notifyOnUpdate){
+		ofRemoveListener(ofEvents().update, this, &ofDirectoryWatcher::onUpdate);
+	}
+	Event event;
+	while(events.tryReceive(event)){}
+}
+
+//----------------------------------------------------------
+size_t ofDirectoryWatcher::update(){
+	size_t numEvents = 0;
+	Event event;
+	while(events.tryReceive(event)){
+		ofNotifyEvent(changed, event, this);
+		numEvents++;
+	}
+	return numEvents;
+}
+
+//----------------------------------------------------------
+void ofDirectoryWatcher::onUpdate(ofEventArgs &){
+	update();
+}
+
+//----------------------------------------------------------
+bool ofDirectoryWatcher::isNative() const{
+	return native;
+}
+
+//----------------------------------------------------------
+bool ofDirectoryWatcher::isWatching() const{
+	return running;
+}
+
+//----------------------------------------------------------
+const ofDirectoryWatcher::Settings & ofDirectoryWatcher::getSettings() const{
+	return settings;
+}
+
+//----------------------------------------------------------
+void ofDirectoryWatcher::queue(EventType type, const of::filesystem::path & path, bool isDirectory){
+	if(scanSettings.accepts(ofDirectoryEntry(path, isDirectory, 0))){
+		events.send(Event{type, path, isDirectory});
+	}
+}
+
+//----------------------------------------------------------
+void ofDirectoryWatcher::scanStatus(std::map<of::filesystem::path, FileStatus> & status){
+	status.clear();
+	ofDirectoryScanner::scan(root, scanSettings, [&](const ofDirectoryEntry & entry){
+		status[entry.path()] = FileStatus{entry.getSize(), entry.getLastWriteTime(), entry.isDirectory()};
+	});
+}
+
+//----------------------------------------------------------
+void ofDirectoryWatcher::pollFunction(){
+	auto & previous = polledStatus;
+	std::map<of::filesystem::path, FileStatus> current;
+	while(running){
+		auto start = ofGetElapsedTimeMillis();
+		while(running && ofGetElapsedTimeMillis() - start < settings.pollIntervalMs){
+			ofSleepMillis(10);
+		}
+		if(!running){
+			break;
+		}
+
+		scanStatus(current);
+		// both maps are sorted so they can be compared in a single pass
+		auto before = previous.begin();
+		auto now = current.begin();
+		while(before != previous.end() || now != current.end()){
+			if(now == current.end() || (before != previous.end() && before->first < now->first)){
+				events.send(Event{Removed, before->first, before->second.isDirectory});
+				++before;
+			}else if(before == previous.end() || now->first < before->first){
+				events.send(Event{Added, now->first, now->second.isDirectory});
+				++now;
+			}else{
+				if(!now->second.isDirectory && (now->second.size != before->second.size || now->second.lastWriteTime != before->second.lastWriteTime)){
+					events.send(Event{Modified, now->first, false});
+				}
+				++before;
+				++now;
+			}
+		}
+		std::swap(previous, current);
+	}
+}
+
+#ifdef TARGET_LINUX
+//----------------------------------------------------------
+bool ofDirectoryWatcher::addWatch(const of::filesystem::path & path, bool reportContents){
+	auto mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ONLYDIR;
+	int watch = inotify_add_watch(inotifyFd, path.c_str(), mask);
+	if(watch < 0){
+		ofLogError("ofDirectoryWatcher") << "couldn't watch " << path << ": " << strerror(errno);
+		return false;
+	}
+	watches[watch] = path;
+
+	// the files already there are remembered so a file moved over one of
+	// them is reported as modified, like the polling backend does. for a
+	// directory created after the watch started its contents could have
+	// been created before the new watch was in place so they are reported
+	// as added
+	ofDirectoryScanner::Settings contents = scanSettings;
+	contents.recursive = false;
+	contents.includeDirectories = true;
+	contents.extensions.clear();
+	ofDirectoryScanner::scan(path, contents, [&](const ofDirectoryEntry & entry){
+		if(entry.isDirectory()){
+			if(settings.recursive){
+				if(reportContents){
+					queue(Added, entry.path(), true);
+				}
+				addWatch(entry.path(), reportContents);
+			}
+		}else{
+			if(scanSettings.accepts(entry)){
+				knownFiles.insert(entry.path());
+			}
+			if(reportContents){
+				queue(Added, entry.path(), false);
+			}
+		}
+	});
+	return true;
+}
+
+//----------------------------------------------------------
+void ofDirectoryWatcher::inotifyFunction(){
+	std::vector<char> buffer(64 * 1024);
+	while(running){
+		pollfd fd{inotifyFd, POLLIN, 0};
+		if(poll(&fd, 1, 100) <= 0){
+			continue;
+		}
+		auto numRead = read(inotifyFd, buffer.data(), buffer.size());
+		if(numRead <= 0){
+			continue;
+		}
+
+		for(ssize_t i = 0; i < numRead; ){
+			auto event = reinterpret_cast<const inotify_event *>(buffer.data() + i);
+			i += sizeof(inotify_event) + event->len;
+
+			if(event->mask & IN_Q_OVERFLOW){
+				ofLogWarning("ofDirectoryWatcher") << "too many changes at once, some events were lost";
+				continue;
+			}
+			if(event->mask & IN_IGNORED){
+				watches.erase(event->wd);
+				continue;
+			}
+			auto watch = watches.find(event->wd);
+			if(event->len == 0 || watch == watches.end()){
+				continue;
+			}
+			if(event->name[0] == '.' && !settings.showHidden){
+				continue;
+			}
+
+			auto path = watch->second / event->name;
+			bool isDirectory = event->mask & IN_ISDIR;
+			if(event->mask & (IN_CREATE | IN_MOVED_TO)){
+				if(isDirectory){
+					queue(Added, path, true);
+					if(settings.recursive){
+						addWatch(path, true);
+					}
+				}else if(!scanSettings.accepts(ofDirectoryEntry(path, false, 0))){
+					continue;
+				}else if(knownFiles.insert(path).second){
+					queue(Added, path, false);
+				}else{
+					// moved over an existing file, there's no event for the
+					// file it replaced
+					queue(Modified, path, false);
+				}
+			}else if(event->mask & (IN_DELETE | IN_MOVED_FROM)){
+				queue(Removed, path, isDirectory);
+				if(!isDirectory){
+					knownFiles.erase(path);
+				}else{
+					// paths are compared by component so the contents of a
+					// directory are together after it
+					auto prefix = path.native() + '/';
+					auto it = knownFiles.lower_bound(path);
+					while(it != knownFiles.end() && it->native().compare(0, prefix.size(), prefix) == 0){
+						it = knownFiles.erase(it);
+					}
+				}
+				if(isDirectory && (event->mask & IN_MOVED_FROM)){
+					// a deleted directory removes its own watches but a moved
+					// one would keep reporting with the old paths
+					auto prefix = path.native() + '/';
+					for(auto it = watches.begin(); it != watches.end(); ){
+						auto & watched = it->second.native();
+						if(watched == path.native() || watched.compare(0, prefix.size(), prefix) == 0){
+							inotify_rm_watch(inotifyFd, it->first);
+							it = watches.erase(it);
+						}else{
+							++it;
+						}
+					}
+				}
+			}else if(event->mask & IN_CLOSE_WRITE){
+				queue(Modified, path, isDirectory);
+			}
+		}
+	}
+}
+#endif
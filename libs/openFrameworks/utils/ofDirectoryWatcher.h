@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ofDirectoryScanner.h"
+#include "ofEvents.h"
+#include "ofThreadChannel.h"
+#include <atomic>
+#include <map>
+#include <set>
+#include <thread>
+
+/// \brief Notifies when files are added, removed or modified in a directory.
+///
+/// Watches a directory, and optionally all its subdirectories, from a
+/// background thread. On Linux it uses inotify so changes are reported as
+/// they happen without reading the directories again, on other platforms
+/// the tree is scanned periodically and compared with the previous scan.
+///
+/// The events are queued and notified from the update event so listeners
+/// always run on the main thread:
+///
+/// ~~~~{.cpp}
+/// ofDirectoryWatcher::Settings settings;
+/// settings.path = "shaders";
+/// settings.extensions = {"frag", "vert"};
+/// watcher.setup(settings);
+/// ofAddListener(watcher.changed, this, &ofApp::shaderChanged);
+///
+/// void ofApp::shaderChanged(const ofDirectoryWatcher::Event & event){
+///     if(event.type == ofDirectoryWatcher::Modified) shader.load(...);
+/// }
+/// ~~~~
+class ofDirectoryWatcher{
+public:
+	enum EventType{
+		Added,
+		Removed,
+		Modified,
+	};
+
+	struct Event{
+		EventType type;
+		/// \brief Absolute path of the file or directory that changed.
+		of::filesystem::path path;
+		bool isDirectory;
+	};
+
+	struct Settings{
+		/// \brief Directory to watch, relative to data.
+		of::filesystem::path path;
+		bool recursive = true;
+		bool showHidden = false;
+		/// \brief Report events for directories too, files are always reported.
+		bool includeDirectories = false;
+		/// \brief Only report files with these extensions, empty reports every file.
+		std::vector<std::string> extensions;
+		/// \brief Time between scans when the platform can't notify changes.
+		uint64_t pollIntervalMs = 500;
+		/// \brief Notify the events from the update event, otherwise they
+		///        are queued until update() is called.
+		bool notifyOnUpdate = true;
+	};
+
+	ofDirectoryWatcher();
+	~ofDirectoryWatcher();
+
+	ofDirectoryWatcher(const ofDirectoryWatcher &) = delete;
+	ofDirectoryWatcher & operator=(const ofDirectoryWatcher &) = delete;
+
+	/// \brief Starts watching, stops a previous watch first.
+	bool setup(const Settings & settings);
+	void close();
+
+	/// \brief Notifies the events queued since the last call.
+	/// \returns Number of events notified.
+	size_t update();
+
+	/// \returns true if changes are notified by the system instead of polling.
+	bool isNative() const;
+	bool isWatching() const;
+	const Settings & getSettings() const;
+
+	/// \brief Notified from update() for every change.
+	ofEvent<const Event> changed;
+
+private:
+	struct FileStatus{
+		uint64_t size;
+		ofDirectoryEntry::Time lastWriteTime;
+		bool isDirectory;
+	};
+
+	void onUpdate(ofEventArgs & args);
+	void queue(EventType type, const of::filesystem::path & path, bool isDirectory);
+	void pollFunction();
+	void scanStatus(std::map<of::filesystem::path, FileStatus> & status);
+#ifdef TARGET_LINUX
+	bool addWatch(const of::filesystem::path & path, bool reportContents);
+	void inotifyFunction();
+	int inotifyFd;
+	std::map<int, of::filesystem::path> watches;
+	std::set<of::filesystem::path> knownFiles;
+#endif
+
+	Settings settings;
+	ofDirectoryScanner::Settings scanSettings;
+	of::filesystem::path root;
+	std::map<of::filesystem::path, FileStatus> polledStatus;
+	ofThreadChannel<Event> events;
+	std::thread thread;
+	std::atomic<bool> running;
+	bool native;
+};
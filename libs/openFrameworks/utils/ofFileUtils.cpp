@@ -5,6 +5,8 @@
 #ifndef TARGET_WIN32
 	#include <pwd.h>
 	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
 	#include <unistd.h>
 #endif
 
@@ -73,11 +75,37 @@ namespace of{
 //------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------
+// a file mapped copy on write: the pages are read from the file when they
+// are first accessed and copied privately if they are written to
+struct ofBuffer::Mapping{
+	char * data = nullptr;
+	std::size_t size = 0;
+#ifdef TARGET_WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE fileMapping = nullptr;
+#endif
+
+	~Mapping(){
+#ifdef TARGET_WIN32
+		if(data) UnmapViewOfFile(data);
+		if(fileMapping) CloseHandle(fileMapping);
+		if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+		if(data) munmap(data, size);
+#endif
+	}
+};
+
 //--------------------------------------------------
 ofBuffer::ofBuffer()
 :currentLine(end(),end()){
 }
 
+//--------------------------------------------------
+ofBuffer::~ofBuffer(){
+}
+
 //--------------------------------------------------
 ofBuffer::ofBuffer(const char * buffer, std::size_t size)
 :buffer(buffer,buffer+size)
@@ -90,26 +118,142 @@ ofBuffer::ofBuffer(istream & stream, std::size_t ioBlockSize)
 	set(stream, ioBlockSize);
 }
 
+//--------------------------------------------------
+ofBuffer::ofBuffer(const ofBuffer & other)
+:buffer(other.begin(), other.end())
+,currentLine(end(),end()){
+}
+
+//--------------------------------------------------
+ofBuffer & ofBuffer::operator=(const ofBuffer & other){
+	if(&other != this){
+		set(other.getData(), other.size());
+	}
+	return *this;
+}
+
+//--------------------------------------------------
+ofBuffer::ofBuffer(ofBuffer && other) noexcept
+:buffer(std::move(other.buffer))
+,mapping(std::move(other.mapping))
+,currentLine(end(),end()){
+	other.currentLine = Line(other.end(), other.end());
+}
+
+//--------------------------------------------------
+ofBuffer & ofBuffer::operator=(ofBuffer && other) noexcept{
+	if(&other != this){
+		buffer = std::move(other.buffer);
+		mapping = std::move(other.mapping);
+		currentLine = Line(end(), end());
+		other.buffer.clear();
+		other.currentLine = Line(other.end(), other.end());
+	}
+	return *this;
+}
+
 //--------------------------------------------------
 bool ofBuffer::set(istream & stream, std::size_t ioBlockSize){
 	if(stream.bad()){
 		clear();
 		return false;
 	}else{
-		buffer.clear();
+		clear();
 	}
 
-	vector<char> aux_buffer(ioBlockSize);
+	// when the stream knows its size read everything at once instead of
+	// growing the buffer one block at a time
+	auto start = stream.tellg();
+	if(start != std::streampos(-1) && stream.seekg(0, ios::end)){
+		auto end = stream.tellg();
+		stream.seekg(start);
+		if(end != std::streampos(-1) && end > start){
+			buffer.resize(std::size_t(end - start));
+			stream.read(buffer.data(), buffer.size());
+			buffer.resize(stream.gcount());
+		}
+	}
+	stream.clear(stream.rdstate() & ~ios::failbit);
+
 	while(stream.good()){
-		stream.read(&aux_buffer[0], ioBlockSize);
-		append(aux_buffer.data(), stream.gcount());
+		auto size = buffer.size();
+		buffer.resize(size + ioBlockSize);
+		stream.read(buffer.data() + size, ioBlockSize);
+		buffer.resize(size + stream.gcount());
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofBuffer::mapFile(const of::filesystem::path & _path){
+	auto path = ofToDataPath(_path, true);
+	clear();
+
+	std::unique_ptr<Mapping> newMapping(new Mapping);
+#ifdef TARGET_WIN32
+	newMapping->file = CreateFileW(of::filesystem::path(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	LARGE_INTEGER size;
+	if(newMapping->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(newMapping->file, &size)){
+		ofLogError("ofBuffer") << "mapFile(): couldn't open " << path;
+		return false;
 	}
+	if(size.QuadPart == 0){
+		return true;
+	}
+	newMapping->fileMapping = CreateFileMapping(newMapping->file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if(newMapping->fileMapping){
+		newMapping->data = static_cast<char*>(MapViewOfFile(newMapping->fileMapping, FILE_MAP_COPY, 0, 0, 0));
+	}
+	if(!newMapping->data){
+		ofLogError("ofBuffer") << "mapFile(): couldn't map " << path;
+		return false;
+	}
+	newMapping->size = size.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	struct stat status;
+	if(fd < 0 || fstat(fd, &status) != 0){
+		ofLogError("ofBuffer") << "mapFile(): couldn't open " << path << ": " << strerror(errno);
+		if(fd >= 0) ::close(fd);
+		return false;
+	}
+	if(status.st_size == 0){
+		::close(fd);
+		return true;
+	}
+	void * data = mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file open
+	::close(fd);
+	if(data == MAP_FAILED){
+		ofLogError("ofBuffer") << "mapFile(): couldn't map " << path << ": " << strerror(errno);
+		return false;
+	}
+	newMapping->data = static_cast<char*>(data);
+	newMapping->size = status.st_size;
+	madvise(data, status.st_size, MADV_SEQUENTIAL);
+#endif
+
+	mapping = std::move(newMapping);
+	currentLine = Line(end(), end());
 	return true;
 }
 
+//--------------------------------------------------
+bool ofBuffer::isMapped() const{
+	return mapping != nullptr;
+}
+
+//--------------------------------------------------
+void ofBuffer::unmap(){
+	if(mapping){
+		buffer.assign(mapping->data, mapping->data + mapping->size);
+		mapping.reset();
+	}
+}
+
 //--------------------------------------------------
 void ofBuffer::setall(char mem){
-	buffer.assign(buffer.size(), mem);
+	std::fill(begin(), end(), mem);
 }
 
 //--------------------------------------------------
@@ -117,13 +261,15 @@ bool ofBuffer::writeTo(ostream & stream) const {
 	if(stream.bad()){
 		return false;
 	}
-	stream.write(buffer.data(), buffer.size());
+	stream.write(getData(), size());
 	return stream.good();
 }
 
 //--------------------------------------------------
 void ofBuffer::set(const char * buffer, std::size_t size){
+	// the source could be inside the mapping so it's released after copying
 	this->buffer.assign(buffer, buffer+size);
+	mapping.reset();
 }
 
 //--------------------------------------------------
@@ -138,17 +284,28 @@ void ofBuffer::append(const std::string& buffer){
 
 //--------------------------------------------------
 void ofBuffer::append(const char * buffer, std::size_t size){
+	if(mapping){
+		vector<char> contents;
+		contents.reserve(mapping->size + size);
+		contents.insert(contents.end(), mapping->data, mapping->data + mapping->size);
+		contents.insert(contents.end(), buffer, buffer + size);
+		this->buffer.swap(contents);
+		mapping.reset();
+		return;
+	}
 	this->buffer.insert(this->buffer.end(), buffer, buffer + size);
 }
 
 //--------------------------------------------------
 void ofBuffer::reserve(std::size_t size){
+	unmap();
 	buffer.reserve(size);
 }
 
 //--------------------------------------------------
 void ofBuffer::clear(){
 	buffer.clear();
+	mapping.reset();
 }
 
 //--------------------------------------------------
@@ -158,18 +315,25 @@ void ofBuffer::allocate(std::size_t size){
 
 //--------------------------------------------------
 void ofBuffer::resize(std::size_t size){
+	if(mapping && size != mapping->size){
+		vector<char> contents(mapping->data, mapping->data + std::min(size, mapping->size));
+		contents.resize(size);
+		buffer.swap(contents);
+		mapping.reset();
+		return;
+	}
 	buffer.resize(size);
 }
 
 
 //--------------------------------------------------
 char * ofBuffer::getData(){
-	return buffer.data();
+	return mapping ? mapping->data : buffer.data();
 }
 
 //--------------------------------------------------
 const char * ofBuffer::getData() const{
-	return buffer.data();
+	return mapping ? mapping->data : buffer.data();
 }
 
 //--------------------------------------------------
@@ -184,10 +348,10 @@ const char * ofBuffer::getBinaryBuffer() const {
 
 //--------------------------------------------------
 string ofBuffer::getText() const {
-	if(buffer.empty()){
+	if(size() == 0){
 		return "";
 	}
-	return std::string(buffer.begin(), buffer.end());
+	return std::string(begin(), end());
 }
 
 //--------------------------------------------------
@@ -203,7 +367,7 @@ ofBuffer & ofBuffer::operator=(const std::string & text){
 
 //--------------------------------------------------
 std::size_t ofBuffer::size() const {
-	return buffer.size();
+	return mapping ? mapping->size : buffer.size();
 }
 
 //--------------------------------------------------
@@ -233,61 +397,84 @@ void ofBuffer::resetLineReader(){
 }
 
 //--------------------------------------------------
-vector<char>::iterator ofBuffer::begin(){
-	return buffer.begin();
+char * ofBuffer::begin(){
+	return getData();
 }
 
 //--------------------------------------------------
-vector<char>::iterator ofBuffer::end(){
-	return buffer.end();
+char * ofBuffer::end(){
+	return getData() + size();
 }
 
 //--------------------------------------------------
-vector<char>::const_iterator ofBuffer::begin() const{
-	return buffer.begin();
+const char * ofBuffer::begin() const{
+	return getData();
 }
 
 //--------------------------------------------------
-vector<char>::const_iterator ofBuffer::end() const{
-	return buffer.end();
+const char * ofBuffer::end() const{
+	return getData() + size();
 }
 
 //--------------------------------------------------
-vector<char>::reverse_iterator ofBuffer::rbegin(){
-	return buffer.rbegin();
+std::reverse_iterator<char *> ofBuffer::rbegin(){
+	return std::reverse_iterator<char *>(end());
 }
 
 //--------------------------------------------------
-vector<char>::reverse_iterator ofBuffer::rend(){
-	return buffer.rend();
+std::reverse_iterator<char *> ofBuffer::rend(){
+	return std::reverse_iterator<char *>(begin());
 }
 
 //--------------------------------------------------
-vector<char>::const_reverse_iterator ofBuffer::rbegin() const{
-	return buffer.rbegin();
+std::reverse_iterator<const char *> ofBuffer::rbegin() const{
+	return std::reverse_iterator<const char *>(end());
 }
 
 //--------------------------------------------------
-vector<char>::const_reverse_iterator ofBuffer::rend() const{
-	return buffer.rend();
+std::reverse_iterator<const char *> ofBuffer::rend() const{
+	return std::reverse_iterator<const char *>(begin());
 }
 
 //--------------------------------------------------
-ofBuffer::Line::Line(vector<char>::iterator _begin, vector<char>::iterator _end)
-	:_current(_begin)
+// ranges of std::vector<char> iterators, what ofBuffer used to return, as
+// pointers. an empty range has no element to take the address of
+static std::pair<char *, char *> ofBufferRange(std::vector<char>::iterator begin, std::vector<char>::iterator end){
+	if(begin == end){
+		return {nullptr, nullptr};
+	}
+	auto data = &*begin;
+	return {data, data + (end - begin)};
+}
+
+//--------------------------------------------------
+ofBuffer::Line::Line(char * _begin, char * _end)
+	:lineRead(false)
+	,_current(_begin)
 	,_begin(_begin)
-	,_end(_end){
+	,_end(_end)
+	,_lineEnd(_begin){
+	findLineEnd();
+}
 
+//--------------------------------------------------
+ofBuffer::Line::Line(std::vector<char>::iterator _begin, std::vector<char>::iterator _end)
+	:Line(ofBufferRange(_begin, _end).first, ofBufferRange(_begin, _end).second){
+}
+
+//--------------------------------------------------
+void ofBuffer::Line::findLineEnd(){
 	if(_begin == _end){
-		line =  "";
+		_current = _lineEnd = _end;
 		return;
 	}
 
-	_current = std::find(_begin, _end, '\n');
+	auto newLine = static_cast<char*>(memchr(_begin, '\n', _end - _begin));
+	_current = newLine ? newLine : _end;
 	if(_current - 1 >= _begin && *(_current - 1) == '\r'){
-		line = string(_begin, _current - 1);
+		_lineEnd = _current - 1;
 	}else{
-		line = string(_begin, _current);
+		_lineEnd = _current;
 	}
 	if(_current != _end){
 		_current+=1;
@@ -296,22 +483,36 @@ ofBuffer::Line::Line(vector<char>::iterator _begin, vector<char>::iterator _end)
 
 //--------------------------------------------------
 const std::string & ofBuffer::Line::operator*() const{
-	return line;
+	return asString();
 }
 
 //--------------------------------------------------
 const std::string * ofBuffer::Line::operator->() const{
-	return &line;
+	return &asString();
 }
 
 //--------------------------------------------------
 const std::string & ofBuffer::Line::asString() const{
+	if(!lineRead){
+		line.assign(_begin, _lineEnd);
+		lineRead = true;
+	}
 	return line;
 }
 
+#if OF_HAS_STRING_VIEW
+//--------------------------------------------------
+std::string_view ofBuffer::Line::asStringView() const{
+	return std::string_view(_begin, _lineEnd - _begin);
+}
+#endif
+
 //--------------------------------------------------
 ofBuffer::Line & ofBuffer::Line::operator++(){
-	*this = Line(_current,_end);
+	// keeps the string to reuse its memory for the next line
+	_begin = _current;
+	lineRead = false;
+	findLineEnd();
 	return *this;
 }
 
@@ -339,7 +540,13 @@ bool ofBuffer::Line::empty() const{
 
 
 //--------------------------------------------------
-ofBuffer::RLine::RLine(vector<char>::reverse_iterator _rbegin, vector<char>::reverse_iterator _rend)
+ofBuffer::RLine::RLine(std::vector<char>::reverse_iterator _rbegin, std::vector<char>::reverse_iterator _rend)
+	:RLine(std::reverse_iterator<char *>(ofBufferRange(_rend.base(), _rbegin.base()).second),
+		std::reverse_iterator<char *>(ofBufferRange(_rend.base(), _rbegin.base()).first)){
+}
+
+//--------------------------------------------------
+ofBuffer::RLine::RLine(std::reverse_iterator<char *> _rbegin, std::reverse_iterator<char *> _rend)
 	:_current(_rbegin)
 	,_rbegin(_rbegin)
 	,_rend(_rend){
@@ -398,10 +605,14 @@ bool ofBuffer::RLine::empty() const{
 }
 
 //--------------------------------------------------
-ofBuffer::Lines::Lines(vector<char>::iterator begin, vector<char>::iterator end)
+ofBuffer::Lines::Lines(char * begin, char * end)
 :_begin(begin)
 ,_end(end){}
 
+//--------------------------------------------------
+ofBuffer::Lines::Lines(std::vector<char>::iterator begin, std::vector<char>::iterator end)
+:Lines(ofBufferRange(begin, end).first, ofBufferRange(begin, end).second){}
+
 //--------------------------------------------------
 ofBuffer::Line ofBuffer::Lines::begin(){
 	return Line(_begin,_end);
@@ -414,10 +625,15 @@ ofBuffer::Line ofBuffer::Lines::end(){
 
 
 //--------------------------------------------------
-ofBuffer::RLines::RLines(vector<char>::reverse_iterator rbegin, vector<char>::reverse_iterator rend)
+ofBuffer::RLines::RLines(std::reverse_iterator<char *> rbegin, std::reverse_iterator<char *> rend)
 :_rbegin(rbegin)
 ,_rend(rend){}
 
+//--------------------------------------------------
+ofBuffer::RLines::RLines(std::vector<char>::reverse_iterator rbegin, std::vector<char>::reverse_iterator rend)
+:RLines(std::reverse_iterator<char *>(ofBufferRange(rend.base(), rbegin.base()).second),
+	std::reverse_iterator<char *>(ofBufferRange(rend.base(), rbegin.base()).first)){}
+
 //--------------------------------------------------
 ofBuffer::RLine ofBuffer::RLines::begin(){
 	return RLine(_rbegin,_rend);
@@ -438,6 +654,80 @@ ofBuffer::RLines ofBuffer::getReverseLines(){
 	return ofBuffer::RLines(rbegin(), rend());
 }
 
+#if OF_HAS_STRING_VIEW
+//--------------------------------------------------
+ofBuffer::LineViews::iterator::iterator(const char * begin, const char * end)
+:_begin(begin)
+,_lineEnd(begin)
+,_next(begin)
+,_end(end){
+	findLineEnd();
+}
+
+//--------------------------------------------------
+void ofBuffer::LineViews::iterator::findLineEnd(){
+	if(_begin == _end){
+		_lineEnd = _next = _end;
+		return;
+	}
+	auto newLine = static_cast<const char*>(memchr(_begin, '\n', _end - _begin));
+	_lineEnd = newLine ? newLine : _end;
+	_next = newLine ? newLine + 1 : _end;
+	if(_lineEnd != _begin && *(_lineEnd - 1) == '\r'){
+		_lineEnd -= 1;
+	}
+}
+
+//--------------------------------------------------
+std::string_view ofBuffer::LineViews::iterator::operator*() const{
+	return std::string_view(_begin, _lineEnd - _begin);
+}
+
+//--------------------------------------------------
+ofBuffer::LineViews::iterator & ofBuffer::LineViews::iterator::operator++(){
+	_begin = _next;
+	findLineEnd();
+	return *this;
+}
+
+//--------------------------------------------------
+ofBuffer::LineViews::iterator ofBuffer::LineViews::iterator::operator++(int){
+	iterator tmp(*this);
+	operator++();
+	return tmp;
+}
+
+//--------------------------------------------------
+bool ofBuffer::LineViews::iterator::operator!=(iterator const & rhs) const{
+	return rhs._begin != _begin || rhs._end != _end;
+}
+
+//--------------------------------------------------
+bool ofBuffer::LineViews::iterator::operator==(iterator const & rhs) const{
+	return rhs._begin == _begin && rhs._end == _end;
+}
+
+//--------------------------------------------------
+ofBuffer::LineViews::LineViews(const char * begin, const char * end)
+:_begin(begin)
+,_end(end){}
+
+//--------------------------------------------------
+ofBuffer::LineViews::iterator ofBuffer::LineViews::begin() const{
+	return iterator(_begin, _end);
+}
+
+//--------------------------------------------------
+ofBuffer::LineViews::iterator ofBuffer::LineViews::end() const{
+	return iterator(_end, _end);
+}
+
+//--------------------------------------------------
+ofBuffer::LineViews ofBuffer::getLineViews() const{
+	return LineViews(begin(), end());
+}
+#endif
+
 //--------------------------------------------------
 ostream & operator<<(ostream & ostr, const ofBuffer & buf){
 	buf.writeTo(ostr);
@@ -456,6 +746,13 @@ ofBuffer ofBufferFromFile(const of::filesystem::path & path, bool binary){
 	return ofBuffer(f);
 }
 
+//--------------------------------------------------
+ofBuffer ofBufferFromMappedFile(const of::filesystem::path & path){
+	ofBuffer buffer;
+	buffer.mapFile(path);
+	return buffer;
+}
+
 //--------------------------------------------------
 bool ofBufferToFile(const of::filesystem::path & path, const ofBuffer& buffer, bool binary){
 	ofFile f(path, ofFile::WriteOnly, binary);
@@ -1399,27 +1696,45 @@ std::size_t ofDirectory::listDir(){
 		return 0;
 	}
 
+	// filter on the paths before creating the ofFiles, every ofFile created
+	// or copied (as the vector grows) would otherwise resolve its path again
+	vector<of::filesystem::path> paths;
+	bool filterExtensions = !extensions.empty() && !ofContains(extensions, (string)"*");
+	string extension;
 	of::filesystem::directory_iterator end_iter;
 	if ( of::filesystem::exists(myDir) && of::filesystem::is_directory(myDir)){
 		for( of::filesystem::directory_iterator dir_iter(myDir) ; dir_iter != end_iter ; ++dir_iter){
-			files.emplace_back(dir_iter->path().string(), ofFile::Reference);
+			const auto & entryPath = dir_iter->path();
+			const auto & native = entryPath.native();
+			auto nameStart = native.find_last_of(of::filesystem::path::preferred_separator) + 1;
+#ifndef TARGET_WIN32
+			if(!showHidden && nameStart < native.size() && native[nameStart] == '.'){
+				continue;
+			}
+#endif
+			if(filterExtensions){
+				auto dot = native.find_last_of('.');
+				extension.clear();
+				if(dot != native.npos && dot > nameStart){
+					for(auto c = native.begin() + dot + 1; c != native.end(); ++c){
+						extension += (char)std::tolower((unsigned char)*c);
+					}
+				}
+				if(std::find(extensions.begin(), extensions.end(), extension) == extensions.end()){
+					continue;
+				}
+			}
+			paths.push_back(entryPath);
 		}
 	}else{
 		ofLogError("ofDirectory") << "listDir:() source directory does not exist: " << myDir ;
 		return 0;
 	}
 
-	if(!showHidden){
-		ofRemove(files, [](ofFile & file){
-			return file.isHidden();
-		});
-	}
-
-
-	if(!extensions.empty() && !ofContains(extensions, (string)"*")){
-		ofRemove(files, [&](ofFile & file){
-			return std::find(extensions.begin(), extensions.end(), ofToLower(file.getExtension())) == extensions.end();
-		});
+	files.resize(paths.size());
+	for(size_t i = 0; i < paths.size(); i++){
+		files[i].myFile = std::move(paths[i]);
+		files[i].mode = ofFile::Reference;
 	}
 
 	if(ofGetLogLevel() == OF_LOG_VERBOSE){
@@ -1477,39 +1792,67 @@ void ofDirectory::reset(){
 }
 
 //------------------------------------------------------------------------------------------------------------
-static bool natural(const ofFile& a, const ofFile& b) {
-	string aname = a.getBaseName(), bname = b.getBaseName();
-	int aint = ofToInt(aname), bint = ofToInt(bname);
-	if(ofToString(aint) == aname && ofToString(bint) == bname) {
-		return aint < bint;
-	} else {
-		return a < b;
+template<typename Char>
+static int compareNatural(const Char * a, const Char * aEnd, const Char * b, const Char * bEnd){
+	auto isDigit = [](Char c){ return c >= '0' && c <= '9'; };
+	while(a != aEnd && b != bEnd){
+		if(isDigit(*a) && isDigit(*b)){
+			// compare the numbers without leading zeros by length first
+			// and then digit by digit, so they can be of any size
+			while(a != aEnd && *a == '0') a++;
+			while(b != bEnd && *b == '0') b++;
+			auto aDigits = a, bDigits = b;
+			while(a != aEnd && isDigit(*a)) a++;
+			while(b != bEnd && isDigit(*b)) b++;
+			if(a - aDigits != b - bDigits){
+				return a - aDigits < b - bDigits ? -1 : 1;
+			}
+			for(; aDigits != a; aDigits++, bDigits++){
+				if(*aDigits != *bDigits){
+					return *aDigits < *bDigits ? -1 : 1;
+				}
+			}
+		}else{
+			if(*a != *b){
+				return *a < *b ? -1 : 1;
+			}
+			a++;
+			b++;
+		}
 	}
+	return (a != aEnd) - (b != bEnd);
 }
 
-
-//------------------------------------------------------------------------------------------------------------
-struct StringSort{
-    of::filesystem::path path;
-    string basename;
-    int nameInt;
-    string stringInt;
-};
-
 //------------------------------------------------------------------------------------------------------------
-static bool naturalStr(const StringSort& a, const StringSort& b) {
-    if(a.stringInt == a.basename && b.stringInt == b.basename) {
-        return a.nameInt < b.nameInt;
-    } else {
-        return a.path < b.path;
-    }
+bool ofDirectory::naturalLess(const of::filesystem::path & a, const of::filesystem::path & b){
+	const auto & aStr = a.native();
+	const auto & bStr = b.native();
+	auto result = compareNatural(aStr.data(), aStr.data() + aStr.size(), bStr.data(), bStr.data() + bStr.size());
+	if(result == 0){
+		// equal numbers written with different leading zeros
+		return aStr < bStr;
+	}
+	return result < 0;
 }
 
 //------------------------------------------------------------------------------------------------------------
-static bool byDate(const ofFile& a, const ofFile& b) {
-	auto ta = of::filesystem::last_write_time(a);
-	auto tb = of::filesystem::last_write_time(b);
-	return ta < tb;
+// copying an ofFile resolves its path again so rather than sorting the files
+// sort their indices and then move the paths to their new position
+template<typename Compare>
+static void sortFiles(vector<ofFile> & files, Compare compare){
+	vector<size_t> order(files.size());
+	for(size_t i = 0; i < order.size(); i++){
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), compare);
+
+	vector<of::filesystem::path> paths(files.size());
+	for(size_t i = 0; i < order.size(); i++){
+		paths[i] = of::filesystem::path(files[order[i]]);
+	}
+	for(size_t i = 0; i < paths.size(); i++){
+		files[i].openFromCWD(paths[i], ofFile::Reference);
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1517,7 +1860,15 @@ void ofDirectory::sortByDate() {
 	if (files.empty() && !myDir.empty()) {
 		listDir();
 	}
-	ofSort(files, byDate);
+	// read every date once instead of on every comparison
+	vector<decltype(of::filesystem::last_write_time(myDir))> dates;
+	dates.reserve(files.size());
+	for(auto & file: files){
+		dates.push_back(of::filesystem::last_write_time(file.myFile));
+	}
+	sortFiles(files, [&](size_t a, size_t b){
+		return dates[a] < dates[b];
+	});
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -1526,44 +1877,20 @@ void ofDirectory::sort(const SortMode & mode){
 		listDir();
 	}
 
-    if( mode == ofDirectory::SORT_NATURAL ){
-        vector <StringSort> sort;
-        sort.reserve(files.size());
-
-        for( auto & f : files ){
-            StringSort ss;
-            ss.path = f.path();
-            ss.basename = f.getBaseName();
-            ss.nameInt = ofToInt(ss.basename);
-            ss.stringInt = ofToString(ss.nameInt);
-            sort.push_back(ss);
-        }
-        
-        ofSort(sort, naturalStr);
-        files.clear();
-        files.reserve(sort.size());
-        for( auto & s : sort ){
-            files.emplace_back( s.path , ofFile::Reference);
-        }
-    }
-    else if(mode == ofDirectory::SORT_FAST){
-        std::vector <string> sort;
-        sort.reserve(files.size());
-        
-        for( auto & f : files ){
-            string ss = f.getFileName();
-            sort.push_back(ss);
-        }
-
-        std::sort(sort.begin(), sort.end());
-        files.clear();
-        files.reserve(sort.size());
-        for( auto & s : sort ){
-            files.emplace_back( myDir / of::filesystem::path(s), ofFile::Reference);
-        }
-    }else if(mode == ofDirectory::SORT_BY_DATE){
-        sortByDate();
-    }
+	// all the files are in the same directory so comparing the whole
+	// paths gives the same order as comparing their names
+	if( mode == ofDirectory::SORT_NATURAL ){
+		sortFiles(files, [&](size_t a, size_t b){
+			return naturalLess(files[a].myFile, files[b].myFile);
+		});
+	}
+	else if(mode == ofDirectory::SORT_FAST){
+		sortFiles(files, [&](size_t a, size_t b){
+			return files[a].myFile.native() < files[b].myFile.native();
+		});
+	}else if(mode == ofDirectory::SORT_BY_DATE){
+		sortByDate();
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------
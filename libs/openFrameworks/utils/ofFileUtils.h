@@ -3,6 +3,7 @@
 // FIXME: constants deprecated only
 #include "ofConstants.h"
 #include <fstream>
+#include <iterator>
 
 //----------------------------------------------------------
 // ofBuffer
@@ -12,10 +13,22 @@
 ///
 /// A buffer of data which can be accessed as simple bytes or text.
 ///
+/// The contents are usually owned by the buffer but it can also map a file
+/// into memory, see mapFile(), so big files don't need to be read or
+/// copied until they are accessed.
+///
 class ofBuffer {
 
 public:
 	ofBuffer();
+	~ofBuffer();
+
+	/// Copying a buffer that maps a file copies its contents into memory,
+	/// move it instead to keep the mapping.
+	ofBuffer(const ofBuffer & other);
+	ofBuffer & operator=(const ofBuffer & other);
+	ofBuffer(ofBuffer && other) noexcept;
+	ofBuffer & operator=(ofBuffer && other) noexcept;
 
 	/// Create a buffer and set its contents from a raw byte pointer.
 	///
@@ -45,10 +58,31 @@ public:
 
 	/// Set contents of the buffer from an input stream.
 	///
+	/// If the stream can tell its size, like a file, the rest of it is read
+	/// at once, otherwise it's read in chunks of ioBlockSize.
+	///
 	/// \param stream input stream to copy data from
 	/// \param ioBlockSize the number of bytes to read from the stream in chunks
 	bool set(std::istream & stream, std::size_t ioBlockSize = 1024);
 
+	/// Map a file into memory instead of reading it.
+	///
+	/// The contents are read by the system as they are accessed and only
+	/// the parts in use take memory, which makes it possible to work with
+	/// files bigger than the available memory. Writing to the data doesn't
+	/// modify the file, the changed pages are copied privately, and any
+	/// function that changes the size of the buffer copies the contents
+	/// into memory and releases the file.
+	///
+	/// \warning The file shouldn't be truncated while it's mapped, reading
+	/// the part that is gone crashes the application.
+	/// \param path file to map, relative to the data folder
+	/// \returns true if the file could be mapped
+	bool mapFile(const of::filesystem::path & path);
+
+	/// \returns true if the contents are a file mapped with mapFile()
+	bool isMapped() const;
+
 	/// Set all bytes in the buffer to a given value.
 	///
 	/// \param mem byte value to set
@@ -134,24 +168,39 @@ public:
 	friend std::ostream & operator<<(std::ostream & ostr, const ofBuffer & buf);
 	friend std::istream & operator>>(std::istream & istr, ofBuffer & buf);
 
-	std::vector<char>::iterator begin();
-	std::vector<char>::iterator end();
-	std::vector<char>::const_iterator begin() const;
-	std::vector<char>::const_iterator end() const;
-	std::vector<char>::reverse_iterator rbegin();
-	std::vector<char>::reverse_iterator rend();
-	std::vector<char>::const_reverse_iterator rbegin() const;
-	std::vector<char>::const_reverse_iterator rend() const;
+	/// The iterators are pointers to the data since a mapped buffer has no
+	/// std::vector, use these types or auto to store them.
+	using iterator = char *;
+	using const_iterator = const char *;
+	using reverse_iterator = std::reverse_iterator<char *>;
+	using const_reverse_iterator = std::reverse_iterator<const char *>;
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+	reverse_iterator rbegin();
+	reverse_iterator rend();
+	const_reverse_iterator rbegin() const;
+	const_reverse_iterator rend() const;
 
 	/// A line of text in the buffer.
 	///
-
+	/// The string is only created when the line is accessed.
 	struct Line {
+		Line(char * _begin, char * _end);
 		Line(std::vector<char>::iterator _begin, std::vector<char>::iterator _end);
 		const std::string & operator*() const;
 		const std::string * operator->() const;
 		const std::string & asString() const;
 
+#if OF_HAS_STRING_VIEW
+		/// The line without copying it.
+		///
+		/// \warning Only valid until the buffer is modified or destroyed.
+		std::string_view asStringView() const;
+#endif
+
 		using value_type = std::string;
 		using iterator_category = std::forward_iterator_tag;
 		using difference_type = std::ptrdiff_t;
@@ -171,13 +220,17 @@ public:
 		bool empty() const;
 
 	private:
-		std::string line;
-		std::vector<char>::iterator _current, _begin, _end;
+		void findLineEnd();
+
+		mutable std::string line;
+		mutable bool lineRead;
+		char * _current, * _begin, * _end, * _lineEnd;
 	};
 
 	/// A line of text in the buffer.
 	///
 	struct RLine {
+		RLine(std::reverse_iterator<char *> _begin, std::reverse_iterator<char *> _end);
 		RLine(std::vector<char>::reverse_iterator _begin, std::vector<char>::reverse_iterator _end);
 		const std::string & operator*() const;
 		const std::string * operator->() const;
@@ -203,12 +256,13 @@ public:
 
 	private:
 		std::string line;
-		std::vector<char>::reverse_iterator _current, _rbegin, _rend;
+		std::reverse_iterator<char *> _current, _rbegin, _rend;
 	};
 
 	/// A series of text lines in the buffer.
 	///
 	struct Lines {
+		Lines(char * begin, char * end);
 		Lines(std::vector<char>::iterator begin, std::vector<char>::iterator end);
 
 		/// Get the first line in the buffer.
@@ -221,12 +275,13 @@ public:
 		RLine rend();
 
 	private:
-		std::vector<char>::iterator _begin, _end;
+		char * _begin, * _end;
 	};
 
 	/// A series of text lines in the buffer.
 	///
 	struct RLines {
+		RLines(std::reverse_iterator<char *> rbegin, std::reverse_iterator<char *> rend);
 		RLines(std::vector<char>::reverse_iterator rbegin, std::vector<char>::reverse_iterator rend);
 
 		/// Get the first line in the buffer.
@@ -236,7 +291,7 @@ public:
 		RLine end();
 
 	private:
-		std::vector<char>::reverse_iterator _rbegin, _rend;
+		std::reverse_iterator<char *> _rbegin, _rend;
 	};
 
 	/// Access the contents of the buffer as a series of text lines.
@@ -256,8 +311,63 @@ public:
 	/// \returns buffer text lines
 	RLines getReverseLines();
 
+#if OF_HAS_STRING_VIEW
+	/// A series of text lines in the buffer as string views.
+	///
+	/// Unlike Lines, iterating doesn't copy any line into a string, which
+	/// is faster for big files, specially with mapped buffers.
+	///
+	/// ~~~~{.cpp}
+	/// for(std::string_view line: buffer.getLineViews()){
+	///     ...
+	/// }
+	/// ~~~~
+	///
+	/// \warning The views are only valid until the buffer is modified or destroyed.
+	struct LineViews {
+		struct iterator {
+			iterator(const char * begin, const char * end);
+			std::string_view operator*() const;
+
+			using value_type = std::string_view;
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type *;
+			using reference = value_type;
+
+			iterator & operator++();
+			iterator operator++(int);
+			bool operator!=(iterator const & rhs) const;
+			bool operator==(iterator const & rhs) const;
+
+		private:
+			void findLineEnd();
+			const char * _begin, * _lineEnd, * _next, * _end;
+		};
+
+		LineViews(const char * begin, const char * end);
+		iterator begin() const;
+		iterator end() const;
+
+	private:
+		const char * _begin, * _end;
+	};
+
+	/// Access the contents of the buffer as a series of text lines without
+	/// copying them.
+	///
+	/// Lines are separated by '\n' or '\r\n' which are not part of the views.
+	LineViews getLineViews() const;
+#endif
+
 private:
+	struct Mapping;
+
+	// copies the mapped contents into memory and releases the file
+	void unmap();
+
 	std::vector<char> buffer;
+	std::unique_ptr<Mapping> mapping;
 	Line currentLine;
 };
 
@@ -271,6 +381,17 @@ private:
 /// split at endline characters automatically
 ofBuffer ofBufferFromFile(const of::filesystem::path & path, bool binary = true);
 
+//--------------------------------------------------
+/// Map a file into memory, see ofBuffer::mapFile().
+///
+/// Faster than ofBufferFromFile for big files and doesn't need memory
+/// for the whole file.
+///
+/// \param path file to map
+/// \returns a buffer with the contents of the file or an empty buffer if
+/// the file couldn't be mapped
+ofBuffer ofBufferFromMappedFile(const of::filesystem::path & path);
+
 //--------------------------------------------------
 /// Write the contents of a buffer to a file at path.
 ///
@@ -822,6 +943,8 @@ public:
 	static bool removeFile(const of::filesystem::path & path, bool bRelativeToData = true);
 
 private:
+	friend class ofDirectory;
+
 	bool isWriteMode();
 	bool openStream(Mode _mode, bool binary);
 	void copyFrom(const ofFile & mom);
@@ -1116,6 +1239,16 @@ public:
 	/// nothing to sort.
 	void sortByDate();
 
+	/// Compare two paths in natural order.
+	///
+	/// Runs of digits are compared by their numeric value so "frame2.png"
+	/// goes before "frame10.png", the rest is compared character by
+	/// character. Doesn't copy the paths so it's cheap enough to be used
+	/// directly as a sort comparator.
+	///
+	/// \returns true if a goes before b
+	static bool naturalLess(const of::filesystem::path & a, const of::filesystem::path & b);
+
 	/// Get a sorted ofDirectory instance using the current path.
 	///
 	/// \returns sorted ofDirectory instance
@@ -31,6 +31,139 @@ inline ofJson ofLoadJson(const of::filesystem::path& filename){
 	return json;
 }
 
+/// \brief Read the Json file at the given path as a stream of SAX events.
+///
+/// Values are forwarded to sax as they are read instead of building an
+/// ofJson DOM, so memory use doesn't depend on the size of the file.
+/// \param filename The file to load from.
+/// \param sax The handler receiving the parse events.
+/// \returns true if the whole file was parsed and sax never returned false.
+inline bool ofLoadJsonSax(const of::filesystem::path& filename, nlohmann::json_sax<ofJson> & sax){
+	ofFile jsonFile(filename);
+	if(!jsonFile.exists()){
+		ofLogError("ofLoadJsonSax") << "Error loading json from " << filename.string() << ": file doesn't exist";
+		return false;
+	}
+	try{
+		return ofJson::sax_parse(jsonFile, &sax);
+	}catch(std::exception & e){
+		ofLogError("ofLoadJsonSax") << "Error loading json from " << filename.string() << ": " << e.what();
+	}catch(...){
+		ofLogError("ofLoadJsonSax") << "Error loading json from " << filename.string();
+	}
+	return false;
+}
+
+namespace of{
+namespace priv{
+	// Builds each child of the root container on its own and hands it to
+	// the callback, releasing it before the next one is read.
+	class JsonElementStreamer: public nlohmann::json_sax<ofJson>{
+	public:
+		using Callback = std::function<bool(const std::string & key, ofJson & element)>;
+
+		JsonElementStreamer(const Callback & callback)
+		:callback(callback){}
+
+		bool null() override{ return value(nullptr); }
+		bool boolean(bool val) override{ return value(val); }
+		bool number_integer(number_integer_t val) override{ return value(val); }
+		bool number_unsigned(number_unsigned_t val) override{ return value(val); }
+		bool number_float(number_float_t val, const string_t &) override{ return value(val); }
+		bool string(string_t & val) override{ return value(std::move(val)); }
+		bool binary(binary_t & val) override{ return value(ofJson::binary(std::move(val))); }
+
+		bool start_object(std::size_t) override{ return open(ofJson::object()); }
+		bool start_array(std::size_t) override{ return open(ofJson::array()); }
+		bool end_object() override{ return close(); }
+		bool end_array() override{ return close(); }
+
+		bool key(string_t & val) override{
+			if(stack.empty()){
+				rootKey = val;
+			}else{
+				currentKey = val;
+			}
+			return true;
+		}
+
+		bool parse_error(std::size_t position, const std::string &, const nlohmann::detail::exception & e) override{
+			ofLogError("ofLoadJsonElements") << "Error parsing json at byte " << position << ": " << e.what();
+			return false;
+		}
+
+	private:
+		ofJson * insert(ofJson && v){
+			if(stack.empty()){
+				element = std::move(v);
+				return &element;
+			}
+			auto & parent = *stack.back();
+			if(parent.is_array()){
+				parent.push_back(std::move(v));
+				return &parent.back();
+			}
+			auto & slot = parent[currentKey];
+			slot = std::move(v);
+			return &slot;
+		}
+
+		bool value(ofJson && v){
+			if(depth == 0){
+				// a scalar document is its own only element
+				element = std::move(v);
+				return emit();
+			}
+			insert(std::move(v));
+			return stack.empty() ? emit() : true;
+		}
+
+		bool open(ofJson && container){
+			if(depth++ == 0){
+				return true;
+			}
+			stack.push_back(insert(std::move(container)));
+			return true;
+		}
+
+		bool close(){
+			if(--depth == 0){
+				return true;
+			}
+			stack.pop_back();
+			return stack.empty() ? emit() : true;
+		}
+
+		bool emit(){
+			bool keepGoing = callback(rootKey, element);
+			element = nullptr;
+			return keepGoing;
+		}
+
+		Callback callback;
+		ofJson element;
+		std::vector<ofJson*> stack;
+		std::string rootKey;
+		std::string currentKey;
+		size_t depth = 0;
+	};
+}
+}
+
+/// \brief Stream the children of the root of a Json file one at a time.
+///
+/// For a root array the callback receives every element with an empty key,
+/// for a root object every value with its key. Only the current element is
+/// kept in memory so arbitrarily large exports can be processed, return
+/// false from the callback to stop reading.
+/// \param filename The file to load from.
+/// \param callback Called once per child of the root.
+/// \returns true if the whole file was read successfully.
+inline bool ofLoadJsonElements(const of::filesystem::path& filename, std::function<bool(const std::string & key, ofJson & element)> callback){
+	of::priv::JsonElementStreamer streamer(callback);
+	return ofLoadJsonSax(filename, streamer);
+}
+
 /// \brief Save minified Json to the given path.
 /// \param filename The destination path.
 /// \param json The Json to save.
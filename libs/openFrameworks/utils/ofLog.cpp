@@ -1,6 +1,14 @@
 #include "ofLog.h"
 #include <ofUtils.h>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
 #ifdef TARGET_ANDROID
 	#include "ofxAndroidLogChannel.h"
 #endif
@@ -10,6 +18,11 @@ using std::string;
 using std::shared_ptr;
 
 static ofLogLevel currentLogLevel =  OF_LOG_NOTICE;
+// range of the levels set for specific modules, lets checkLog decide
+// without looking the module up when no module level could change the result
+static bool hasModuleLevels = false;
+static ofLogLevel minModuleLevel = OF_LOG_SILENT;
+static ofLogLevel maxModuleLevel = OF_LOG_VERBOSE;
 
 bool ofLog::bAutoSpace = false;
 string & ofLog::getPadding() {
@@ -44,6 +57,13 @@ void ofSetLogLevel(ofLogLevel level){
 //--------------------------------------------------
 void ofSetLogLevel(string module, ofLogLevel level){
 	getModules()[module] = level;
+	hasModuleLevels = true;
+	minModuleLevel = OF_LOG_SILENT;
+	maxModuleLevel = OF_LOG_VERBOSE;
+	for(auto & moduleLevel: getModules()){
+		minModuleLevel = std::min(minModuleLevel, moduleLevel.second);
+		maxModuleLevel = std::max(maxModuleLevel, moduleLevel.second);
+	}
 }
 
 //--------------------------------------------------
@@ -65,6 +85,14 @@ void ofLogToFile(const of::filesystem::path & path, bool append){
 	ofLog::setChannel(std::make_shared<ofFileLoggerChannel>(path,append));
 }
 
+//--------------------------------------------------
+void ofLogToFileAsync(const of::filesystem::path & path, bool append){
+	ofAsyncLoggerChannel::Settings settings;
+	settings.path = path;
+	settings.append = append;
+	ofLog::setChannel(std::make_shared<ofAsyncLoggerChannel>(settings));
+}
+
 //--------------------------------------------------
 void ofLogToConsole(){
 	ofLog::setChannel(shared_ptr<ofConsoleLoggerChannel>(new ofConsoleLoggerChannel, std::function<void(ofBaseLoggerChannel *)>(noopDeleter)));
@@ -77,23 +105,34 @@ void ofLogToDebugView() {
 #endif
 
 //--------------------------------------------------
-ofLog::ofLog(){
-	level = OF_LOG_NOTICE;
-	module = "";
-	bPrinted = false;
+ofLog::ofLog()
+:ofLog(OF_LOG_NOTICE, "", false){
 }
 		
 //--------------------------------------------------
-ofLog::ofLog(ofLogLevel _level){
-	level = _level;
-	module = "";
-	bPrinted = false;
+ofLog::ofLog(ofLogLevel _level)
+:ofLog(_level, "", false){
 }
 
 //--------------------------------------------------
-ofLog::ofLog(ofLogLevel level, const string & message){
+ofLog::ofLog(ofLogLevel level, const string & message)
+:ofLog(level, "", true){
 	_log(level,"",message);
-	bPrinted = true;
+}
+
+//--------------------------------------------------
+ofLog::ofLog(ofLogLevel _level, const string & _module, bool _bPrinted)
+:level(_level)
+,bPrinted(_bPrinted)
+,bEnabled(false){
+	// the level is checked once here so the << of a disabled message
+	// don't format anything and the module is only copied if needed
+	if(!bPrinted){
+		bEnabled = checkLog(level, _module);
+		if(bEnabled){
+			module = _module;
+		}
+	}
 }
 
 
@@ -111,18 +150,27 @@ void ofLog::setAutoSpace(bool autoSpace){
 //-------------------------------------------------------
 ofLog::~ofLog(){
 	// don't log if we printed in the constructor already
-	if(!bPrinted){
-		_log(level,module,message.str());
+	if(!bPrinted && bEnabled){
+		channel()->log(level, module, message ? message->str() : string());
 	}
 }
 
 bool ofLog::checkLog(ofLogLevel level, const string & module){
-	if(getModules().find(module)==getModules().end()){
-		if(level >= currentLogLevel) return true;
+	if(!hasModuleLevels){
+		return level >= currentLogLevel;
+	}
+	if(level >= std::max(currentLogLevel, maxModuleLevel)){
+		return true;
+	}
+	if(level < std::min(currentLogLevel, minModuleLevel)){
+		return false;
+	}
+	auto it = getModules().find(module);
+	if(it == getModules().end()){
+		return level >= currentLogLevel;
 	}else{
-		if(level >= getModules()[module]) return true;
+		return level >= it->second;
 	}
-	return false;
 }
 
 //-------------------------------------------------------
@@ -133,63 +181,53 @@ void ofLog::_log(ofLogLevel level, const string & module, const string & message
 }
 
 //--------------------------------------------------
-ofLogVerbose::ofLogVerbose(const string & _module){
-	level = OF_LOG_VERBOSE;
-	module = _module;
-	bPrinted=false;
+ofLogVerbose::ofLogVerbose(const string & _module)
+:ofLog(OF_LOG_VERBOSE, _module, false){
 }
 
-ofLogVerbose::ofLogVerbose(const string & _module, const string & _message){
+ofLogVerbose::ofLogVerbose(const string & _module, const string & _message)
+:ofLog(OF_LOG_VERBOSE, _module, true){
 	_log(OF_LOG_VERBOSE,_module,_message);
-	bPrinted = true;
 }
 
 //--------------------------------------------------
-ofLogNotice::ofLogNotice(const string & _module){
-	level = OF_LOG_NOTICE;
-	module = _module;
-	bPrinted=false;
+ofLogNotice::ofLogNotice(const string & _module)
+:ofLog(OF_LOG_NOTICE, _module, false){
 }
 
-ofLogNotice::ofLogNotice(const string & _module, const string & _message){
+ofLogNotice::ofLogNotice(const string & _module, const string & _message)
+:ofLog(OF_LOG_NOTICE, _module, true){
 	_log(OF_LOG_NOTICE,_module,_message);
-	bPrinted = true;
 }
 
 //--------------------------------------------------
-ofLogWarning::ofLogWarning(const string & _module){
-	level = OF_LOG_WARNING;
-	module = _module;
-	bPrinted=false;
+ofLogWarning::ofLogWarning(const string & _module)
+:ofLog(OF_LOG_WARNING, _module, false){
 }
 
-ofLogWarning::ofLogWarning(const string & _module, const string & _message){
+ofLogWarning::ofLogWarning(const string & _module, const string & _message)
+:ofLog(OF_LOG_WARNING, _module, true){
 	_log(OF_LOG_WARNING,_module,_message);
-	bPrinted = true;
 }
 
 //--------------------------------------------------
-ofLogError::ofLogError(const string & _module){
-	level = OF_LOG_ERROR;
-	module = _module;
-	bPrinted=false;
+ofLogError::ofLogError(const string & _module)
+:ofLog(OF_LOG_ERROR, _module, false){
 }
 
-ofLogError::ofLogError(const string & _module, const string & _message){
+ofLogError::ofLogError(const string & _module, const string & _message)
+:ofLog(OF_LOG_ERROR, _module, true){
 	_log(OF_LOG_ERROR,_module,_message);
-	bPrinted = true;
 }
 
 //--------------------------------------------------
-ofLogFatalError::ofLogFatalError(const string &  _module){
-	level = OF_LOG_FATAL_ERROR;
-	module = _module;
-	bPrinted=false;
+ofLogFatalError::ofLogFatalError(const string & _module)
+:ofLog(OF_LOG_FATAL_ERROR, _module, false){
 }
 
-ofLogFatalError::ofLogFatalError(const string & _module, const string & _message){
+ofLogFatalError::ofLogFatalError(const string & _module, const string & _message)
+:ofLog(OF_LOG_FATAL_ERROR, _module, true){
 	_log(OF_LOG_FATAL_ERROR,_module,_message);
-	bPrinted = true;
 }
 
 
@@ -288,3 +326,417 @@ void ofFileLoggerChannel::log(ofLogLevel level, const string & module, const str
 	file << message << std::endl;
 }
 
+
+//--------------------------------------------------
+// bounded queue with one slot per message, several threads can log at the
+// same time without locking: each one claims a position with a compare and
+// swap and publishes the slot through its sequence number once it's filled.
+// the slots keep their strings so their capacity is reused by later messages
+struct ofAsyncLoggerChannel::Queue{
+	struct Slot{
+		std::atomic<uint64_t> sequence;
+		ofLogLevel level;
+		uint64_t time;
+		std::string module;
+		std::string message;
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	uint64_t mask = 0;
+	std::atomic<uint64_t> enqueuePos{0};
+	uint64_t dequeuePos = 0;
+	std::atomic<uint64_t> flushedPos{0};
+	std::atomic<uint64_t> flushRequest{0};
+	std::atomic<uint64_t> numDropped{0};
+	std::atomic<bool> writerSleeping{false};
+	std::atomic<bool> running{false};
+	// log() and flush() calls inside the queue, close() waits for them to
+	// leave once it stops accepting new ones
+	std::atomic<bool> accepting{false};
+	std::atomic<size_t> numProducers{0};
+
+	std::mutex mutex;
+	std::condition_variable messageAvailable;
+	std::condition_variable messagesWritten;
+	std::condition_variable producersLeft;
+
+	FILE * file = nullptr;
+	Format format = Text;
+	OverflowPolicy overflowPolicy = Block;
+	std::chrono::milliseconds flushInterval{100};
+	std::thread thread;
+
+	bool enter();
+	void leave();
+	void stop();
+	bool push(ofLogLevel level, const std::string & module, const std::string & message, OverflowPolicy policy);
+	bool pop(std::string & buffer, FILE *& out);
+	void wakeWriter();
+	void waitUntilWritten(uint64_t target);
+	void writerFunction();
+	void append(std::string & buffer, ofLogLevel level, uint64_t time, const std::string & module, const std::string & message) const;
+};
+
+//--------------------------------------------------
+static uint64_t ofAsyncLoggerTime(){
+	using namespace std::chrono;
+	return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+//--------------------------------------------------
+static void ofAppendJsonString(std::string & buffer, const std::string & str){
+	static const char * hex = "0123456789abcdef";
+	buffer += '"';
+	for(auto c: str){
+		switch(c){
+			case '"': buffer += "\\\""; break;
+			case '\\': buffer += "\\\\"; break;
+			case '\n': buffer += "\\n"; break;
+			case '\r': buffer += "\\r"; break;
+			case '\t': buffer += "\\t"; break;
+			default:
+				if((unsigned char)c < 0x20){
+					buffer += "\\u00";
+					buffer += hex[(c >> 4) & 0xf];
+					buffer += hex[c & 0xf];
+				}else{
+					buffer += c;
+				}
+		}
+	}
+	buffer += '"';
+}
+
+//--------------------------------------------------
+template<typename T>
+static void ofAppendBinary(std::string & buffer, T value){
+	char bytes[sizeof(T)];
+	memcpy(bytes, &value, sizeof(T));
+	buffer.append(bytes, sizeof(T));
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::Queue::append(std::string & buffer, ofLogLevel level, uint64_t time, const std::string & module, const std::string & message) const{
+	switch(format){
+		case Text:
+			buffer += '[';
+			buffer += ofGetLogLevelName(level, true);
+			buffer += "] ";
+			if(!module.empty()){
+				buffer += module;
+				buffer += ": ";
+			}
+			buffer += message;
+			buffer += '\n';
+			break;
+		case JsonLines:
+			buffer += "{\"time\":";
+			buffer += std::to_string(time);
+			buffer += ",\"level\":\"";
+			buffer += ofGetLogLevelName(level);
+			buffer += "\",\"module\":";
+			ofAppendJsonString(buffer, module);
+			buffer += ",\"message\":";
+			ofAppendJsonString(buffer, message);
+			buffer += "}\n";
+			break;
+		case Binary:{
+			auto moduleLength = std::min<size_t>(module.size(), std::numeric_limits<uint16_t>::max());
+			auto messageLength = std::min<size_t>(message.size(), std::numeric_limits<uint32_t>::max());
+			ofAppendBinary<uint64_t>(buffer, time);
+			ofAppendBinary<uint8_t>(buffer, level);
+			ofAppendBinary<uint16_t>(buffer, moduleLength);
+			ofAppendBinary<uint32_t>(buffer, messageLength);
+			buffer.append(module, 0, moduleLength);
+			buffer.append(message, 0, messageLength);
+			break;
+		}
+	}
+}
+
+//--------------------------------------------------
+bool ofAsyncLoggerChannel::Queue::enter(){
+	numProducers++;
+	if(!accepting){
+		leave();
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::Queue::leave(){
+	if(--numProducers == 0 && !accepting){
+		std::unique_lock<std::mutex> lock(mutex);
+		producersLeft.notify_all();
+	}
+}
+
+//--------------------------------------------------
+// the writer keeps running until the threads that were already logging
+// leave, so the ones waiting for a free slot can finish and everything up
+// to the last enqueued message is written before the file is closed
+void ofAsyncLoggerChannel::Queue::stop(){
+	accepting = false;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		producersLeft.wait(lock, [this]{
+			return numProducers == 0;
+		});
+		running = false;
+		messageAvailable.notify_one();
+	}
+	if(thread.joinable()){
+		thread.join();
+	}
+	if(file){
+		fclose(file);
+		file = nullptr;
+	}
+}
+
+//--------------------------------------------------
+bool ofAsyncLoggerChannel::Queue::push(ofLogLevel level, const std::string & module, const std::string & message, OverflowPolicy policy){
+	auto time = ofAsyncLoggerTime();
+	Slot * slot;
+	auto pos = enqueuePos.load(std::memory_order_relaxed);
+	while(true){
+		slot = &slots[pos & mask];
+		auto sequence = slot->sequence.load(std::memory_order_acquire);
+		auto diff = int64_t(sequence) - int64_t(pos);
+		if(diff == 0){
+			if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+				break;
+			}
+		}else if(diff < 0){
+			// the queue is full
+			if(policy == Drop){
+				numDropped++;
+				return false;
+			}
+			wakeWriter();
+			std::this_thread::yield();
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}else{
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->level = level;
+	slot->time = time;
+	slot->module.assign(module);
+	slot->message.assign(message);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(writerSleeping.load(std::memory_order_relaxed)){
+		wakeWriter();
+	}
+	return true;
+}
+
+//--------------------------------------------------
+bool ofAsyncLoggerChannel::Queue::pop(std::string & buffer, FILE *& out){
+	auto & slot = slots[dequeuePos & mask];
+	if(slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1){
+		return false;
+	}
+	// without a file errors go to stderr like ofConsoleLoggerChannel, the
+	// batch is cut when the stream changes so the order is kept
+	FILE * target = file ? file : (slot.level < OF_LOG_ERROR ? stdout : stderr);
+	if(target != out){
+		if(!buffer.empty()){
+			return false;
+		}
+		out = target;
+	}
+	append(buffer, slot.level, slot.time, slot.module, slot.message);
+	slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+	dequeuePos++;
+	return true;
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::Queue::wakeWriter(){
+	std::unique_lock<std::mutex> lock(mutex);
+	messageAvailable.notify_one();
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::Queue::waitUntilWritten(uint64_t target){
+	auto request = flushRequest.load();
+	while(request < target && !flushRequest.compare_exchange_weak(request, target)){}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	messageAvailable.notify_one();
+	messagesWritten.wait(lock, [&]{
+		return flushedPos.load() >= target;
+	});
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::Queue::writerFunction(){
+	const size_t batchSize = 64 * 1024;
+	std::string batch;
+	batch.reserve(batchSize * 2);
+	FILE * out = file ? file : stdout;
+	uint64_t reportedDropped = 0;
+	bool dirty = false;
+	auto lastFlush = std::chrono::steady_clock::now();
+
+	while(true){
+		while(batch.size() < batchSize && pop(batch, out)){}
+
+		auto dropped = numDropped.load();
+		if(dropped != reportedDropped && batch.size() < batchSize){
+			append(batch, OF_LOG_WARNING, ofAsyncLoggerTime(), "ofAsyncLoggerChannel", "dropped " + std::to_string(dropped - reportedDropped) + " messages, the queue was full");
+			reportedDropped = dropped;
+		}
+
+		if(!batch.empty()){
+			fwrite(batch.data(), 1, batch.size(), out);
+			batch.clear();
+			dirty = true;
+		}
+
+		bool idle = slots[dequeuePos & mask].sequence.load(std::memory_order_acquire) != dequeuePos + 1;
+		auto now = std::chrono::steady_clock::now();
+		bool requested = flushedPos.load() < flushRequest.load() && dequeuePos >= flushRequest.load();
+		if(dirty && (idle || requested || now - lastFlush >= flushInterval)){
+			fflush(out);
+			dirty = false;
+			lastFlush = now;
+		}
+		if(idle || requested){
+			flushedPos = dequeuePos;
+			std::unique_lock<std::mutex> lock(mutex);
+			messagesWritten.notify_all();
+		}
+
+		if(!idle){
+			continue;
+		}
+		if(!running){
+			break;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		writerSleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(running && slots[dequeuePos & mask].sequence.load(std::memory_order_acquire) != dequeuePos + 1){
+			messageAvailable.wait_for(lock, flushInterval);
+		}
+		writerSleeping = false;
+	}
+}
+
+//--------------------------------------------------
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(){
+	setup(Settings());
+}
+
+//--------------------------------------------------
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(const Settings & settings){
+	setup(settings);
+}
+
+//--------------------------------------------------
+ofAsyncLoggerChannel::~ofAsyncLoggerChannel(){
+	close();
+}
+
+//--------------------------------------------------
+bool ofAsyncLoggerChannel::setup(const Settings & _settings){
+	close();
+	settings = _settings;
+
+	FILE * file = nullptr;
+	if(!settings.path.empty()){
+		of::filesystem::path path = ofToDataPath(settings.path, true);
+#ifdef TARGET_WIN32
+		file = _wfopen(path.c_str(), settings.append ? L"ab" : L"wb");
+#else
+		file = fopen(path.c_str(), settings.append ? "ab" : "wb");
+#endif
+		if(!file){
+			ofConsoleLoggerChannel().log(OF_LOG_ERROR, "ofAsyncLoggerChannel", "setup(): couldn't open " + path.string());
+			return false;
+		}
+		if(settings.format == Text){
+			auto header = "\n\n--------------------------------------- " + ofGetTimestampString() + "\n";
+			fwrite(header.data(), 1, header.size(), file);
+		}
+	}
+
+	size_t size = 2;
+	while(size < settings.queueSize){
+		size *= 2;
+	}
+
+	auto newQueue = std::make_shared<Queue>();
+	newQueue->slots.reset(new Queue::Slot[size]);
+	for(size_t i = 0; i < size; i++){
+		newQueue->slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	newQueue->mask = size - 1;
+	newQueue->file = file;
+	newQueue->format = settings.format;
+	newQueue->overflowPolicy = settings.overflowPolicy;
+	newQueue->flushInterval = std::chrono::milliseconds(std::max<uint64_t>(settings.flushIntervalMs, 1));
+	newQueue->running = true;
+	newQueue->accepting = true;
+	newQueue->thread = std::thread(&Queue::writerFunction, newQueue.get());
+	// another thread could have called setup() at the same time
+	auto previous = std::atomic_exchange(&queue, newQueue);
+	if(previous){
+		previous->stop();
+	}
+	return true;
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const string & message){
+	auto queue = std::atomic_load(&this->queue);
+	if(!queue || !queue->enter()){
+		ofConsoleLoggerChannel().log(level, module, message);
+		return;
+	}
+	queue->push(level, module, message, level == OF_LOG_FATAL_ERROR ? Block : queue->overflowPolicy);
+	if(level == OF_LOG_FATAL_ERROR){
+		queue->waitUntilWritten(queue->enqueuePos.load());
+	}
+	queue->leave();
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::flush(){
+	auto queue = std::atomic_load(&this->queue);
+	if(!queue || !queue->enter()){
+		return;
+	}
+	queue->waitUntilWritten(queue->enqueuePos.load());
+	queue->leave();
+}
+
+//--------------------------------------------------
+void ofAsyncLoggerChannel::close(){
+	// the closed queue only keeps the dropped count available
+	auto closed = std::make_shared<Queue>();
+	auto queue = std::atomic_exchange(&this->queue, closed);
+	if(!queue){
+		return;
+	}
+	queue->stop();
+	closed->numDropped += queue->numDropped.load();
+}
+
+//--------------------------------------------------
+uint64_t ofAsyncLoggerChannel::getNumDropped() const{
+	auto queue = std::atomic_load(&this->queue);
+	return queue ? queue->numDropped.load() : 0;
+}
+
+//--------------------------------------------------
+const ofAsyncLoggerChannel::Settings & ofAsyncLoggerChannel::getSettings() const{
+	return settings;
+}
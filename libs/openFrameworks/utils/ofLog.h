@@ -238,6 +238,15 @@ class ofBaseLoggerChannel;
 /// \param append True if you want to append to the existing file.
 void ofLogToFile(const of::filesystem::path & path, bool append=false);
 
+/// \brief Set the logging to output to a file from a background thread.
+///
+/// Like ofLogToFile but messages are only queued when logged and written
+/// in batches by an ofAsyncLoggerChannel, so logging doesn't wait for the disk.
+///
+/// \param path The path to the log file to use.
+/// \param append True if you want to append to the existing file.
+void ofLogToFileAsync(const of::filesystem::path & path, bool append=false);
+
 /// \brief Set the logging to ouptut to the console.
 /// 
 /// This is the default state and can be called to reset console logging
@@ -434,7 +443,12 @@ class ofLog{
 		/// \param format The printf-style format string.
 		template <typename ... Args>
 		ofLog(ofLogLevel level, const char* format, Args&& ... args)
-			: ofLog(level, ofVAArgsToString(format, args...)){}
+			: ofLog(level, std::string(), true){
+			// only format the message if it's going to be printed
+			if(checkLog(level, "")){
+				_log(level, "", ofVAArgsToString(format, args...));
+			}
+		}
 		/// \}
 	
 		//--------------------------------------------------
@@ -474,12 +488,16 @@ class ofLog{
 		/// This allows the class to use the << std::ostream to read data of
 		/// almost any type.
 		///
+		/// Nothing is formatted if the level is disabled for the module.
+		///
 		/// \tparam T the data type to be streamed.
 		/// \param value the data to be streamed.
 		/// \returns A reference to itself.
 		template <class T> 
 		ofLog& operator<<(const T& value){
-			message << value << getPadding();
+			if(bEnabled){
+				stream() << value << getPadding();
+			}
 			return *this;
 		}
 	
@@ -491,7 +509,9 @@ class ofLog{
 		/// \param func A function pointer that takes a std::ostream as an argument.
 		/// \returns A reference to itself.
 		ofLog& operator<<(std::ostream& (*func)(std::ostream&)){
-			func(message);
+			if(bEnabled){
+				func(stream());
+			}
 			return *this;
 		}
 	
@@ -505,7 +525,15 @@ class ofLog{
 
 		ofLogLevel level; ///< Log level.
 		bool bPrinted;	  ///< Has the message been printed in the constructor?
+		bool bEnabled;	  ///< Is the level enabled for the module, checked in the constructor.
 		std::string module;    ///< The destination module for this message.
+
+		/// \brief Start a message, used by the derived classes.
+		/// \param level The log level.
+		/// \param module The target module, only kept if the level is enabled.
+		/// \param bPrinted True if the constructor prints the message, false
+		/// to stream it.
+		ofLog(ofLogLevel level, const std::string & module, bool bPrinted);
 		
 		/// \brief Print a log line.
 		/// \param level The log level.
@@ -514,17 +542,29 @@ class ofLog{
 		void _log(ofLogLevel level, const std::string & module, const std::string & message);
 	
 		/// \brief Determine if the given module is active at the given log level.
+		///
+		/// Only looks the module up if some module has a level that would
+		/// change the result.
+		///
 		/// \param level The log level.
 		/// \param module The target module.
 		/// \returns true if the given module is active at the given log level.
-		bool checkLog(ofLogLevel level, const std::string & module);
+		static bool checkLog(ofLogLevel level, const std::string & module);
 	
 		static std::shared_ptr<ofBaseLoggerChannel> & channel();	///< The target channel.
 	
 		/// \endcond
 	
 	private:
-		std::stringstream message;	///< Temporary buffer.
+		/// \brief The buffer for the message, created on the first enabled <<.
+		std::stringstream & stream(){
+			if(!message){
+				message.reset(new std::stringstream);
+			}
+			return *message;
+		}
+
+		std::unique_ptr<std::stringstream> message;	///< Temporary buffer.
 		
 		static bool bAutoSpace; ///< Should space be added between messages?
 		
@@ -554,7 +594,11 @@ class ofLogVerbose : public ofLog{
 		/// \param format The printf-style format string.
 		template <typename ... Args>
 		ofLogVerbose(const std::string & module, const char* format, Args&& ... args)
-			: ofLogVerbose(module, ofVAArgsToString(format, args...)){}
+			: ofLog(OF_LOG_VERBOSE, module, true){
+			if(checkLog(OF_LOG_VERBOSE, module)){
+				_log(OF_LOG_VERBOSE, module, ofVAArgsToString(format, args...));
+			}
+		}
 };
 
 /// \brief Derived log class for easy notice logging.
@@ -576,7 +620,11 @@ class ofLogNotice : public ofLog{
 		/// \param format The printf-style format string.
 		template <typename ... Args>
 		ofLogNotice(const std::string & module, const char* format, Args&& ... args)
-			: ofLogNotice(module, ofVAArgsToString(format, args...)){}
+			: ofLog(OF_LOG_NOTICE, module, true){
+			if(checkLog(OF_LOG_NOTICE, module)){
+				_log(OF_LOG_NOTICE, module, ofVAArgsToString(format, args...));
+			}
+		}
 };
 
 /// \brief Derived log class for easy warning logging.
@@ -597,7 +645,11 @@ class ofLogWarning : public ofLog{
 	/// \param format The printf-style format string.
 		template <typename ... Args>
 		ofLogWarning(const std::string & module, const char* format, Args&& ... args)
-			: ofLogWarning(module, ofVAArgsToString(format, args...)){}
+			: ofLog(OF_LOG_WARNING, module, true){
+			if(checkLog(OF_LOG_WARNING, module)){
+				_log(OF_LOG_WARNING, module, ofVAArgsToString(format, args...));
+			}
+		}
 };
 
 /// \brief Derived log class for easy error logging.
@@ -619,7 +671,11 @@ class ofLogError : public ofLog{
 		/// \param format The printf-style format string.
 		template <typename ... Args>
 		ofLogError(const std::string & module, const char* format, Args&& ... args)
-			: ofLogError(module, ofVAArgsToString(format, args...)){}
+			: ofLog(OF_LOG_ERROR, module, true){
+			if(checkLog(OF_LOG_ERROR, module)){
+				_log(OF_LOG_ERROR, module, ofVAArgsToString(format, args...));
+			}
+		}
 };
 
 /// \brief Derived log class for easy fatal error logging.
@@ -641,7 +697,11 @@ class ofLogFatalError : public ofLog{
 		/// \param format The printf-style format string.
 		template <typename ... Args>
 		ofLogFatalError(const std::string & module, const char* format, Args&& ... args)
-			: ofLogFatalError(module, ofVAArgsToString(format, args...)){}
+			: ofLog(OF_LOG_FATAL_ERROR, module, true){
+			if(checkLog(OF_LOG_FATAL_ERROR, module)){
+				_log(OF_LOG_FATAL_ERROR, module, ofVAArgsToString(format, args...));
+			}
+		}
 };
 
 
@@ -724,3 +784,95 @@ private:
 };
 
 /// \endcond
+
+/// \brief A logger channel that writes its messages from a background thread.
+///
+/// log() only copies the message into a preallocated queue, once the queue
+/// slots have grown to the usual message size it doesn't allocate or lock.
+/// A single thread formats the queued messages and writes them in large
+/// batches, flushing the file when there's nothing left to write or every
+/// flushIntervalMs, so logging from time critical code doesn't wait for the
+/// disk or the console.
+///
+/// Messages can be written as text, like ofFileLoggerChannel, as one json
+/// object per line or as binary records to be parsed by other tools. Each
+/// binary record is the time in microseconds as uint64, the level as uint8,
+/// the module and message lengths as uint16 and uint32 followed by the
+/// module and message, all in the native byte order.
+///
+/// Fatal errors wait for every message logged before them to be written.
+///
+/// ~~~~{.cpp}
+/// ofAsyncLoggerChannel::Settings settings;
+/// settings.path = "log.jsonl";
+/// settings.format = ofAsyncLoggerChannel::JsonLines;
+/// ofSetLoggerChannel(std::make_shared<ofAsyncLoggerChannel>(settings));
+/// ~~~~
+class ofAsyncLoggerChannel: public ofBaseLoggerChannel{
+public:
+	enum Format{
+		Text,
+		JsonLines,
+		Binary,
+	};
+
+	enum OverflowPolicy{
+		/// \brief log() waits for the writer thread to free a slot.
+		Block,
+		/// \brief log() discards the message, the number of dropped
+		///        messages is written to the log once there's space again.
+		Drop,
+	};
+
+	struct Settings{
+		/// \brief File to write to, relative to data, empty writes to the console.
+		of::filesystem::path path;
+		bool append = false;
+		Format format = Text;
+		/// \brief Messages that can wait to be written, rounded up to a power of 2.
+		size_t queueSize = 8192;
+		OverflowPolicy overflowPolicy = Block;
+		/// \brief Longest time written messages wait in the file buffers.
+		uint64_t flushIntervalMs = 100;
+	};
+
+	/// \brief Create a channel that writes text to the console.
+	ofAsyncLoggerChannel();
+	ofAsyncLoggerChannel(const Settings & settings);
+
+	/// \brief Writes the queued messages and stops the writer thread.
+	virtual ~ofAsyncLoggerChannel();
+
+	/// \brief Starts writing with new settings, closes the previous output first.
+	/// \returns false if the file couldn't be opened.
+	bool setup(const Settings & settings);
+
+	/// \brief Queue a message, after close() it's written to the console directly.
+	///
+	/// Safe to call from any thread, also while another one calls setup()
+	/// or close().
+	void log(ofLogLevel level, const std::string & module, const std::string & message);
+
+	/// \brief Wait until every message logged before the call is written and flushed.
+	void flush();
+
+	/// \brief Writes the queued messages and closes the output.
+	///
+	/// Messages that other threads are logging at the same time are
+	/// written before the output is closed, the ones logged after go to
+	/// the console.
+	void close();
+
+	/// \returns Number of messages discarded because the queue was full.
+	uint64_t getNumDropped() const;
+
+	const Settings & getSettings() const;
+
+private:
+	struct Queue;
+	// log() and flush() work on their own copy so the queue outlives them
+	// if another thread closes the channel
+	std::shared_ptr<Queue> queue;
+	Settings settings;
+};
+
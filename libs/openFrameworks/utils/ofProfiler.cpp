@@ -0,0 +1,391 @@
+#include "ofProfiler.h"
+#include "ofAppRunner.h"
+#include "ofEvents.h"
+#include "ofGraphics.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+std::atomic<bool> ofProfiler::enabled(false);
+
+#ifndef OF_DISABLE_PROFILER
+
+namespace{
+	const auto startTime = std::chrono::steady_clock::now();
+
+	struct Entry{
+		std::atomic<const char *> name;
+		std::atomic<uint64_t> start;
+		std::atomic<uint64_t> end;
+	};
+
+	// written only by its thread. begun is increased before overwriting an
+	// entry and written after, so a reader can tell which entries could have
+	// changed while it was copying them
+	struct ThreadBuffer{
+		ThreadBuffer(size_t size)
+		:entries(size)
+		,begun(0)
+		,written(0)
+		,firstValid(0)
+		,finished(false){}
+
+		std::vector<Entry> entries;
+		std::atomic<uint64_t> begun;
+		std::atomic<uint64_t> written;
+		std::atomic<uint64_t> firstValid;
+		std::atomic<bool> finished;
+		std::string name;
+	};
+
+	struct Registry{
+		std::mutex mutex;
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+		size_t bufferSize = 65536;
+		size_t numThreads = 0;
+		ofEventListener summaryListener;
+	};
+
+	// never destroyed so threads that finish during static destruction can
+	// still mark their buffers
+	Registry & registry(){
+		static Registry * registry = new Registry;
+		return *registry;
+	}
+
+	struct ThreadState{
+		std::shared_ptr<ThreadBuffer> buffer;
+		std::string name;
+
+		~ThreadState(){
+			if(buffer){
+				buffer->finished = true;
+			}
+		}
+	};
+
+	thread_local ThreadState threadState;
+
+	ThreadBuffer & getThreadBuffer(){
+		auto & state = threadState;
+		if(!state.buffer){
+			auto & registry = ::registry();
+			std::unique_lock<std::mutex> lock(registry.mutex);
+			state.buffer = std::make_shared<ThreadBuffer>(registry.bufferSize);
+			if(!state.name.empty()){
+				state.buffer->name = state.name;
+			}else if(ofIsCurrentThreadTheMainThread()){
+				state.buffer->name = "main";
+			}else{
+				state.buffer->name = "thread " + ofToString(++registry.numThreads);
+			}
+			registry.buffers.push_back(state.buffer);
+		}
+		return *state.buffer;
+	}
+
+	struct NameLess{
+		bool operator()(const char * a, const char * b) const{
+			return strcmp(a, b) < 0;
+		}
+	};
+
+	void appendJsonString(std::string & out, const char * str){
+		out += '"';
+		for(; *str; ++str){
+			if(*str == '"' || *str == '\\'){
+				out += '\\';
+			}
+			if((unsigned char)*str >= 0x20){
+				out += *str;
+			}
+		}
+		out += '"';
+	}
+
+	// the trace format uses microseconds, keeping the nanoseconds as decimals
+	void appendMicros(std::string & out, uint64_t nanos){
+		ofAppendToString(out, nanos / 1000);
+		auto decimals = nanos % 1000;
+		out += '.';
+		out += char('0' + decimals / 100);
+		out += char('0' + decimals / 10 % 10);
+		out += char('0' + decimals % 10);
+	}
+}
+
+//--------------------------------------------------
+void ofProfiler::setEnabled(bool _enabled){
+	enabled = _enabled;
+}
+
+//--------------------------------------------------
+bool ofProfiler::isEnabled(){
+	return enabled;
+}
+
+//--------------------------------------------------
+void ofProfiler::setBufferSize(size_t numZones){
+	auto & registry = ::registry();
+	std::unique_lock<std::mutex> lock(registry.mutex);
+	registry.bufferSize = std::max(numZones, size_t(1));
+}
+
+//--------------------------------------------------
+void ofProfiler::setThreadName(const std::string & name){
+	threadState.name = name;
+	if(threadState.buffer){
+		std::unique_lock<std::mutex> lock(registry().mutex);
+		threadState.buffer->name = name;
+	}
+}
+
+//--------------------------------------------------
+std::vector<std::string> ofProfiler::getThreadNames(){
+	auto & registry = ::registry();
+	std::unique_lock<std::mutex> lock(registry.mutex);
+	std::vector<std::string> names;
+	for(auto & buffer: registry.buffers){
+		names.push_back(buffer->name);
+	}
+	return names;
+}
+
+//--------------------------------------------------
+uint64_t ofProfiler::getTimeNanos(){
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//--------------------------------------------------
+void ofProfiler::record(const char * name, uint64_t startNanos, uint64_t endNanos){
+	auto & buffer = getThreadBuffer();
+	auto index = buffer.written.load(std::memory_order_relaxed);
+	buffer.begun.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	auto & entry = buffer.entries[index % buffer.entries.size()];
+	entry.name.store(name, std::memory_order_relaxed);
+	entry.start.store(startNanos, std::memory_order_relaxed);
+	entry.end.store(endNanos, std::memory_order_relaxed);
+	buffer.written.store(index + 1, std::memory_order_release);
+}
+
+//--------------------------------------------------
+std::vector<ofProfiler::Zone> ofProfiler::getZones(){
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	{
+		auto & registry = ::registry();
+		std::unique_lock<std::mutex> lock(registry.mutex);
+		buffers = registry.buffers;
+	}
+
+	std::vector<Zone> zones;
+	for(size_t thread = 0; thread < buffers.size(); thread++){
+		auto & buffer = *buffers[thread];
+		uint64_t size = buffer.entries.size();
+		auto written = buffer.written.load(std::memory_order_acquire);
+		auto first = std::max(written > size ? written - size : 0, buffer.firstValid.load());
+		auto numZones = zones.size();
+		for(auto index = first; index < written; index++){
+			auto & entry = buffer.entries[index % size];
+			zones.push_back(Zone{entry.name.load(std::memory_order_relaxed), entry.start.load(std::memory_order_relaxed), entry.end.load(std::memory_order_relaxed), thread});
+		}
+
+		// the thread could have overwritten the oldest entries meanwhile
+		std::atomic_thread_fence(std::memory_order_acquire);
+		auto begun = buffer.begun.load(std::memory_order_relaxed);
+		if(begun > size + first){
+			auto numOverwritten = std::min(begun - size - first, written - first);
+			zones.erase(zones.begin() + numZones, zones.begin() + numZones + numOverwritten);
+		}
+	}
+
+	std::sort(zones.begin(), zones.end(), [](const Zone & a, const Zone & b){
+		return a.startNanos < b.startNanos;
+	});
+	return zones;
+}
+
+//--------------------------------------------------
+std::vector<ofProfiler::ZoneStats> ofProfiler::getSummary(float seconds){
+	auto now = getTimeNanos();
+	uint64_t window = seconds * 1000000000.;
+	auto since = now > window ? now - window : 0;
+
+	std::map<const char *, ZoneStats, NameLess> byName;
+	for(auto & zone: getZones()){
+		if(zone.endNanos < since){
+			continue;
+		}
+		auto & stats = byName.emplace(zone.name, ZoneStats{zone.name, 0, 0, 0, 0}).first->second;
+		double millis = (zone.endNanos - zone.startNanos) / 1000000.;
+		stats.count++;
+		stats.totalMillis += millis;
+		stats.maxMillis = std::max(stats.maxMillis, millis);
+	}
+
+	std::vector<ZoneStats> summary;
+	for(auto & named: byName){
+		named.second.averageMillis = named.second.totalMillis / named.second.count;
+		summary.push_back(named.second);
+	}
+	std::sort(summary.begin(), summary.end(), [](const ZoneStats & a, const ZoneStats & b){
+		return a.totalMillis > b.totalMillis;
+	});
+	return summary;
+}
+
+//--------------------------------------------------
+bool ofProfiler::saveChromeTrace(const of::filesystem::path & path){
+	auto names = getThreadNames();
+	auto zones = getZones();
+
+	std::string out = "{\"traceEvents\":[";
+	bool first = true;
+	for(size_t thread = 0; thread < names.size(); thread++){
+		out += first ? "\n" : ",\n";
+		first = false;
+		out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+		ofAppendToString(out, thread);
+		out += ",\"args\":{\"name\":";
+		appendJsonString(out, names[thread].c_str());
+		out += "}}";
+	}
+	for(auto & zone: zones){
+		out += first ? "\n" : ",\n";
+		first = false;
+		out += "{\"name\":";
+		appendJsonString(out, zone.name);
+		out += ",\"ph\":\"X\",\"pid\":0,\"tid\":";
+		ofAppendToString(out, zone.thread);
+		out += ",\"ts\":";
+		appendMicros(out, zone.startNanos);
+		out += ",\"dur\":";
+		appendMicros(out, zone.endNanos - zone.startNanos);
+		out += '}';
+	}
+	out += "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+	if(!ofBufferToFile(path, ofBuffer(out.data(), out.size()))){
+		ofLogError("ofProfiler") << "saveChromeTrace(): couldn't save " << path;
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------
+void ofProfiler::clear(){
+	auto & registry = ::registry();
+	std::unique_lock<std::mutex> lock(registry.mutex);
+	auto & buffers = registry.buffers;
+	buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const std::shared_ptr<ThreadBuffer> & buffer){
+		return buffer->finished.load();
+	}), buffers.end());
+	for(auto & buffer: buffers){
+		buffer->firstValid = buffer->written.load();
+	}
+}
+
+//--------------------------------------------------
+void ofProfiler::drawSummary(float x, float y, float seconds){
+	auto summary = getSummary(seconds);
+	size_t nameWidth = 4;
+	for(auto & stats: summary){
+		nameWidth = std::max(nameWidth, strlen(stats.name));
+	}
+
+	auto column = [](const std::string & str, size_t width){
+		return str.size() < width ? str + std::string(width - str.size(), ' ') : str;
+	};
+	std::string text = column("zone", nameWidth) + "  count   avg ms   max ms  total ms";
+	for(auto & stats: summary){
+		text += "\n" + column(stats.name, nameWidth);
+		text += "  " + ofToString(stats.count, 5, ' ');
+		text += "  " + ofToString(stats.averageMillis, 3, 7, ' ');
+		text += "  " + ofToString(stats.maxMillis, 3, 7, ' ');
+		text += "  " + ofToString(stats.totalMillis, 3, 8, ' ');
+	}
+	ofDrawBitmapStringHighlight(text, glm::vec2(x, y));
+}
+
+//--------------------------------------------------
+void ofProfiler::setShowSummary(bool show){
+	auto & registry = ::registry();
+	if(show){
+		registry.summaryListener = ofEvents().draw.newListener([](ofEventArgs &){
+			drawSummary(10, 20);
+		}, OF_EVENT_ORDER_AFTER_APP);
+	}else{
+		registry.summaryListener.unsubscribe();
+	}
+}
+
+#else
+
+// the zones are compiled out and so is everything that records, stores or
+// draws them, the functions stay so apps that call them still build
+
+//--------------------------------------------------
+void ofProfiler::setEnabled(bool){
+	ofLogWarning("ofProfiler") << "setEnabled(): openFrameworks was compiled with OF_DISABLE_PROFILER";
+}
+
+//--------------------------------------------------
+bool ofProfiler::isEnabled(){
+	return false;
+}
+
+//--------------------------------------------------
+void ofProfiler::setBufferSize(size_t){
+}
+
+//--------------------------------------------------
+void ofProfiler::setThreadName(const std::string &){
+}
+
+//--------------------------------------------------
+std::vector<std::string> ofProfiler::getThreadNames(){
+	return {};
+}
+
+//--------------------------------------------------
+uint64_t ofProfiler::getTimeNanos(){
+	return 0;
+}
+
+//--------------------------------------------------
+void ofProfiler::record(const char *, uint64_t, uint64_t){
+}
+
+//--------------------------------------------------
+std::vector<ofProfiler::Zone> ofProfiler::getZones(){
+	return {};
+}
+
+//--------------------------------------------------
+std::vector<ofProfiler::ZoneStats> ofProfiler::getSummary(float){
+	return {};
+}
+
+//--------------------------------------------------
+bool ofProfiler::saveChromeTrace(const of::filesystem::path & path){
+	ofLogError("ofProfiler") << "saveChromeTrace(): openFrameworks was compiled with OF_DISABLE_PROFILER, not saving " << path;
+	return false;
+}
+
+//--------------------------------------------------
+void ofProfiler::clear(){
+}
+
+//--------------------------------------------------
+void ofProfiler::drawSummary(float, float, float){
+}
+
+//--------------------------------------------------
+void ofProfiler::setShowSummary(bool){
+}
+
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <atomic>
+
+/// \brief Measures how long scopes of code take, from any thread.
+///
+/// Zones are placed with OF_PROFILE_ZONE, which records the time from that
+/// line to the end of the enclosing scope. The core already has zones
+/// around the main loop, the setup, update and draw events, texture
+/// uploads and image loading. ofThread and the ofTaskScheduler workers
+/// only name their threads, a zone around a thread's whole function
+/// would only be recorded when the thread exits:
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+///     OF_PROFILE_ZONE("particles");
+///     particles.update();
+/// }
+///
+/// void ofApp::keyPressed(int key){
+///     if(key == 's') ofProfiler::saveChromeTrace("trace.json");
+/// }
+/// ~~~~
+///
+/// Each thread writes the zones it finishes to its own ring buffer so
+/// recording doesn't lock, the oldest zones are overwritten when it's full.
+/// Nothing is recorded until the profiler is enabled, a disabled zone only
+/// checks a flag. Defining OF_DISABLE_PROFILER when compiling
+/// openFrameworks removes the zones and the whole implementation, the
+/// functions below are then empty and nothing is recorded.
+///
+/// The trace can be opened in chrome://tracing or https://ui.perfetto.dev.
+class ofProfiler{
+public:
+	/// \brief A finished zone, times in nanoseconds since the profiler started.
+	struct Zone{
+		const char * name;
+		uint64_t startNanos;
+		uint64_t endNanos;
+		/// \brief Index of the thread in getThreadNames().
+		size_t thread;
+	};
+
+	struct ZoneStats{
+		const char * name;
+		size_t count;
+		double totalMillis;
+		double averageMillis;
+		double maxMillis;
+	};
+
+	static void setEnabled(bool enabled);
+	static bool isEnabled();
+
+	/// \brief Zones kept per thread, applies to threads that record their
+	/// first zone after calling it. 65536 by default.
+	static void setBufferSize(size_t numZones);
+
+	/// \brief Name of the calling thread in the trace, ofThread sets it
+	/// to its thread name.
+	static void setThreadName(const std::string & name);
+	static std::vector<std::string> getThreadNames();
+
+	/// \brief The zones still in the buffers of every thread, sorted by start time.
+	static std::vector<Zone> getZones();
+
+	/// \brief Zones that finished in the last seconds grouped by name, the
+	/// ones that took most time first.
+	static std::vector<ZoneStats> getSummary(float seconds = 1);
+
+	/// \brief Saves the zones in the chrome trace event format.
+	static bool saveChromeTrace(const of::filesystem::path & path);
+
+	/// \brief Removes the recorded zones and the buffers of finished threads.
+	static void clear();
+
+	/// \brief Draws getSummary() at a position of the screen.
+	static void drawSummary(float x, float y, float seconds = 1);
+
+	/// \brief Draws the summary at the top left after every draw event.
+	static void setShowSummary(bool show);
+
+	/// \brief Time used for the zones, nanoseconds since the profiler started.
+	static uint64_t getTimeNanos();
+
+	/// \brief Called by ofProfilerZone, records a zone in the calling thread's buffer.
+	static void record(const char * name, uint64_t startNanos, uint64_t endNanos);
+
+private:
+	friend class ofProfilerZone;
+	static std::atomic<bool> enabled;
+};
+
+/// \brief Records the time between its construction and destruction.
+///
+/// Usually placed with OF_PROFILE_ZONE. The name has to stay valid until
+/// the zones are saved, usually a string literal.
+class ofProfilerZone{
+public:
+	ofProfilerZone(const char * name)
+	:name(ofProfiler::enabled.load(std::memory_order_relaxed) ? name : nullptr)
+	,start(this->name ? ofProfiler::getTimeNanos() : 0){}
+
+	~ofProfilerZone(){
+		if(name){
+			ofProfiler::record(name, start, ofProfiler::getTimeNanos());
+		}
+	}
+
+	ofProfilerZone(const ofProfilerZone &) = delete;
+	ofProfilerZone & operator=(const ofProfilerZone &) = delete;
+
+private:
+	const char * name;
+	uint64_t start;
+};
+
+#define OF_PROFILE_CONCAT_(a, b) a##b
+#define OF_PROFILE_CONCAT(a, b) OF_PROFILE_CONCAT_(a, b)
+
+#ifdef OF_DISABLE_PROFILER
+	#define OF_PROFILE_ZONE(name)
+#else
+	/// \brief Records the time until the end of the current scope as a zone.
+	#define OF_PROFILE_ZONE(name) ofProfilerZone OF_PROFILE_CONCAT(ofProfilerZone_, __LINE__)(name)
+#endif
+
+/// \brief A zone named after the enclosing function.
+#define OF_PROFILE_FUNCTION() OF_PROFILE_ZONE(__func__)
@@ -0,0 +1,328 @@
+#include "ofTaskScheduler.h"
+#include "ofAppBaseWindow.h"
+#include "ofAppRunner.h"
+#include "ofLog.h"
+#include "ofMainLoop.h"
+#include "ofProfiler.h"
+#include "ofUtils.h"
+#include <stdexcept>
+
+namespace{
+	std::atomic<size_t> numWaiters(0);
+	std::mutex waitMutex;
+	std::condition_variable waitCondition;
+
+	// the scheduler and worker running in the current thread, if any
+	thread_local ofTaskScheduler * currentScheduler = nullptr;
+	thread_local size_t currentWorker = 0;
+}
+
+//--------------------------------------------------
+void of::priv::notifyTaskWaiters(){
+	if(numWaiters > 0){
+		std::unique_lock<std::mutex> lock(waitMutex);
+		waitCondition.notify_all();
+	}
+}
+
+//--------------------------------------------------
+ofTaskScheduler::ofTaskScheduler(size_t numWorkers)
+:numQueued(0)
+,numSleeping(0)
+,running(false)
+,listenedEvents(nullptr){
+	start(numWorkers);
+}
+
+//--------------------------------------------------
+ofTaskScheduler::~ofTaskScheduler(){
+	updateListener.unsubscribe();
+	stop();
+
+	// the tasks that didn't run fail so whoever waits for them doesn't
+	// hang, failing them queues their continuations which fail the same way
+	auto destroyed = std::make_exception_ptr(std::runtime_error("ofTaskScheduler destroyed before the task ran"));
+	while(true){
+		std::deque<Task> pending;
+		for(auto & queue: queues){
+			std::unique_lock<std::mutex> lock(queue->mutex);
+			for(auto & task: queue->tasks){
+				pending.push_back(std::move(task));
+			}
+			queue->tasks.clear();
+		}
+		{
+			std::unique_lock<std::mutex> lock(mainThreadMutex);
+			for(auto & task: mainThreadTasks){
+				pending.push_back(std::move(task));
+			}
+			mainThreadTasks.clear();
+		}
+		if(pending.empty()){
+			break;
+		}
+		for(auto & task: pending){
+			if(task.state){
+				task.state->setException(destroyed);
+			}
+		}
+	}
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::start(size_t numWorkers){
+	if(numWorkers == 0){
+		numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+
+	// keeps the tasks queued by the previous workers, they are moved to
+	// the queue for other threads
+	std::deque<Task> pending;
+	for(auto & queue: queues){
+		for(auto & task: queue->tasks){
+			pending.push_back(std::move(task));
+		}
+	}
+	queues.clear();
+	for(size_t i = 0; i < numWorkers + 1; i++){
+		queues.emplace_back(new Queue);
+	}
+	queues.back()->tasks = std::move(pending);
+
+	running = true;
+	for(size_t i = 0; i < numWorkers; i++){
+		workers.emplace_back(&ofTaskScheduler::workerFunction, this, i);
+	}
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::stop(){
+	{
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	workAvailable.notify_all();
+	for(auto & worker: workers){
+		worker.join();
+	}
+	workers.clear();
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::setNumWorkers(size_t numWorkers){
+	if(isWorkerThread()){
+		ofLogError("ofTaskScheduler") << "setNumWorkers(): can't be called from a task";
+		return;
+	}
+	stop();
+	start(numWorkers);
+}
+
+//--------------------------------------------------
+size_t ofTaskScheduler::getNumWorkers() const{
+	return workers.size();
+}
+
+//--------------------------------------------------
+bool ofTaskScheduler::isWorkerThread() const{
+	return currentScheduler == this;
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::submit(std::function<void()> && task){
+	enqueue({std::move(task), nullptr});
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::enqueue(Task && task){
+	// a worker keeps what it submits in its own queue, where it's probably
+	// still hot in the cache, the rest goes to the last queue
+	auto & queue = isWorkerThread() ? *queues[currentWorker] : *queues.back();
+	{
+		std::unique_lock<std::mutex> lock(queue.mutex);
+		numQueued++;
+		queue.tasks.push_back(std::move(task));
+	}
+	if(numSleeping > 0){
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		workAvailable.notify_one();
+	}
+	of::priv::notifyTaskWaiters();
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::enqueueOnMainThread(Task && task){
+	{
+		std::unique_lock<std::mutex> lock(mainThreadMutex);
+		mainThreadTasks.push_back(std::move(task));
+	}
+	listenToUpdate();
+	of::priv::notifyTaskWaiters();
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::listenToUpdate(){
+	// the update event belongs to the window, which might not exist yet
+	// when the scheduler is created, so it's listened to once there's a
+	// task for the main thread. a scheduler being destroyed doesn't listen
+	if(!running){
+		return;
+	}
+	auto window = ofGetMainLoop()->getCurrentWindow();
+	if(!window){
+		return;
+	}
+	std::unique_lock<std::mutex> lock(listenerMutex);
+	if(listenedEvents != &window->events()){
+		listenedEvents = &window->events();
+		updateListener = listenedEvents->update.newListener([this](ofEventArgs &){
+			updateMainThread();
+		}, OF_EVENT_ORDER_BEFORE_APP);
+	}
+}
+
+//--------------------------------------------------
+bool ofTaskScheduler::popTask(size_t worker, Task & task){
+	if(numQueued == 0){
+		return false;
+	}
+
+	// a worker takes from its own queue from the back, newest first, then
+	// the oldest tasks of the other queues starting by the one for external
+	// threads. external threads use that last queue as their own but take
+	// from the front like any other thief
+	auto external = queues.size() - 1;
+	if(worker < external){
+		auto & own = *queues[worker];
+		std::unique_lock<std::mutex> lock(own.mutex);
+		if(!own.tasks.empty()){
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			numQueued--;
+			return true;
+		}
+	}
+	for(size_t i = 0; i < queues.size(); i++){
+		auto victim = i == 0 ? external : (worker + i) % queues.size();
+		if(i > 0 && (victim == worker || victim == external)){
+			continue;
+		}
+		auto & queue = *queues[victim];
+		std::unique_lock<std::mutex> lock(queue.mutex);
+		if(!queue.tasks.empty()){
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			numQueued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::runTask(Task & task){
+	try{
+		task.run();
+	}catch(const std::exception & e){
+		ofLogError("ofTaskScheduler") << "task threw an exception: " << e.what();
+	}catch(...){
+		ofLogError("ofTaskScheduler") << "task threw an unknown exception";
+	}
+	task = Task();
+}
+
+//--------------------------------------------------
+bool ofTaskScheduler::runPendingTask(){
+	Task task;
+	auto worker = isWorkerThread() ? currentWorker : queues.size() - 1;
+	if(popTask(worker, task)){
+		runTask(task);
+		return true;
+	}
+	return false;
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::waitUntil(const std::function<bool()> & done){
+	bool mainThread = ofIsCurrentThreadTheMainThread();
+	while(!done()){
+		if(runPendingTask()){
+			continue;
+		}
+		// a task waiting for a result from the main thread would never
+		// finish if the main thread is the one waiting for it
+		if(mainThread && updateMainThread() > 0){
+			continue;
+		}
+
+		numWaiters++;
+		{
+			std::unique_lock<std::mutex> lock(waitMutex);
+			waitCondition.wait_for(lock, std::chrono::milliseconds(10), [&]{
+				if(done() || numQueued > 0){
+					return true;
+				}
+				std::unique_lock<std::mutex> mainLock(mainThreadMutex);
+				return mainThread && !mainThreadTasks.empty();
+			});
+		}
+		numWaiters--;
+	}
+}
+
+//--------------------------------------------------
+size_t ofTaskScheduler::updateMainThread(){
+	std::deque<Task> tasks;
+	{
+		std::unique_lock<std::mutex> lock(mainThreadMutex);
+		std::swap(tasks, mainThreadTasks);
+	}
+	for(auto & task: tasks){
+		runTask(task);
+	}
+	return tasks.size();
+}
+
+//--------------------------------------------------
+size_t ofTaskScheduler::getChunkSize(size_t count, size_t grainSize) const{
+	if(grainSize > 0){
+		return grainSize;
+	}
+	// a few chunks per thread so the ones that finish early can take
+	// work from the slower ones
+	size_t numChunks = (getNumWorkers() + 1) * 4;
+	return std::max((count + numChunks - 1) / numChunks, size_t(1));
+}
+
+//--------------------------------------------------
+void ofTaskScheduler::workerFunction(size_t index){
+	currentScheduler = this;
+	currentWorker = index;
+#ifndef OF_DISABLE_PROFILER
+	ofProfiler::setThreadName("task worker " + ofToString(index));
+#endif
+
+	Task task;
+	while(running){
+		if(popTask(index, task)){
+			runTask(task);
+			continue;
+		}
+
+		numSleeping++;
+		{
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			workAvailable.wait(lock, [this]{
+				return !running || numQueued > 0;
+			});
+		}
+		numSleeping--;
+	}
+	currentScheduler = nullptr;
+}
+
+//--------------------------------------------------
+ofTaskScheduler & ofGetTaskScheduler(){
+	static ofTaskScheduler scheduler;
+	return scheduler;
+}
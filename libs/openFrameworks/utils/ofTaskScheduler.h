@@ -0,0 +1,464 @@
+#pragma once
+
+#include "ofEvents.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class ofTaskScheduler;
+
+namespace of{
+namespace priv{
+	// wakes up the threads waiting for a task or a parallel loop to finish,
+	// only locks when there's someone waiting
+	void notifyTaskWaiters();
+
+	class TaskStateBase{
+	public:
+		virtual ~TaskStateBase(){}
+
+		bool isReady() const{
+			return ready.load();
+		}
+
+		std::exception_ptr getException() const{
+			return exception;
+		}
+
+		void setException(std::exception_ptr e){
+			exception = e;
+			finish();
+		}
+
+		// runs continuation right away if the task already finished,
+		// otherwise from the thread that finishes it
+		void onFinished(std::function<void()> && continuation){
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				if(!ready){
+					continuations.push_back(std::move(continuation));
+					return;
+				}
+			}
+			continuation();
+		}
+
+	protected:
+		void finish(){
+			std::vector<std::function<void()>> toRun;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				ready = true;
+				std::swap(toRun, continuations);
+			}
+			notifyTaskWaiters();
+			for(auto & continuation: toRun){
+				continuation();
+			}
+		}
+
+	private:
+		std::atomic<bool> ready{false};
+		std::exception_ptr exception;
+		std::mutex mutex;
+		std::vector<std::function<void()>> continuations;
+	};
+
+	template<typename T>
+	class TaskState: public TaskStateBase{
+	public:
+		template<typename F>
+		void run(F & f){
+			try{
+				value.reset(new T(f()));
+				finish();
+			}catch(...){
+				setException(std::current_exception());
+			}
+		}
+
+		template<typename F>
+		auto call(F & f) -> decltype(f(std::declval<const T &>())){
+			return f(*value);
+		}
+
+		const T & get() const{
+			if(getException()){
+				std::rethrow_exception(getException());
+			}
+			return *value;
+		}
+
+	private:
+		std::unique_ptr<T> value;
+	};
+
+	template<>
+	class TaskState<void>: public TaskStateBase{
+	public:
+		template<typename F>
+		void run(F & f){
+			try{
+				f();
+				finish();
+			}catch(...){
+				setException(std::current_exception());
+			}
+		}
+
+		template<typename F>
+		auto call(F & f) -> decltype(f()){
+			return f();
+		}
+
+		void get() const{
+			if(getException()){
+				std::rethrow_exception(getException());
+			}
+		}
+	};
+
+	template<typename T, typename F>
+	struct ContinuationResult{
+		typedef decltype(std::declval<F &>()(std::declval<const T &>())) type;
+	};
+
+	template<typename F>
+	struct ContinuationResult<void, F>{
+		typedef decltype(std::declval<F &>()()) type;
+	};
+}
+}
+
+/// \brief The result of a function running in an ofTaskScheduler.
+///
+/// Copies share the same result. get() waits for the function to finish
+/// and returns what it returned or rethrows the exception it threw. While
+/// waiting the thread runs other tasks from the scheduler instead of
+/// blocking, so waiting from inside a task doesn't deadlock.
+template<typename T>
+class ofTask{
+public:
+	ofTask()
+	:scheduler(nullptr){}
+
+	ofTask(std::shared_ptr<of::priv::TaskState<T>> state, ofTaskScheduler * scheduler)
+	:state(state)
+	,scheduler(scheduler){}
+
+	/// \returns false for a default constructed task.
+	bool isValid() const{
+		return state != nullptr;
+	}
+
+	bool isReady() const{
+		return state && state->isReady();
+	}
+
+	void wait() const;
+
+	/// \brief Waits for the task and returns its result, rethrows the
+	/// exception the function threw if it failed.
+	auto get() const -> decltype(std::declval<of::priv::TaskState<T>>().get()){
+		wait();
+		return state->get();
+	}
+
+	/// \brief Runs f with the result of this task once it finishes.
+	///
+	/// f receives the value this task returned, nothing for ofTask<void>.
+	/// If this task failed f isn't called and the returned task fails with
+	/// the same exception.
+	template<typename F>
+	auto then(F f) const -> ofTask<typename of::priv::ContinuationResult<T, F>::type>;
+
+	/// \brief Like then() but f runs in the main thread, from the update
+	/// event. Useful for anything that needs the GL context.
+	template<typename F>
+	auto thenOnMainThread(F f) const -> ofTask<typename of::priv::ContinuationResult<T, F>::type>;
+
+private:
+	template<typename F>
+	auto continueWith(F f, bool mainThread) const -> ofTask<typename of::priv::ContinuationResult<T, F>::type>;
+
+	std::shared_ptr<of::priv::TaskState<T>> state;
+	ofTaskScheduler * scheduler;
+};
+
+/// \brief A pool of worker threads that run short tasks.
+///
+/// Unlike ofThread, which is one thread doing one long job, the scheduler
+/// shares a few threads, one per core by default, between many small
+/// functions. Every worker has its own queue and takes work from the
+/// others when it runs out so the load stays balanced. ofGetTaskScheduler()
+/// returns a scheduler shared by the whole app:
+///
+/// ~~~~{.cpp}
+/// // runs in a worker, the texture is loaded in the main thread afterwards
+/// ofGetTaskScheduler().async([path]{
+///     ofPixels pixels;
+///     ofLoadImage(pixels, path);
+///     return pixels;
+/// }).thenOnMainThread([this](const ofPixels & pixels){
+///     texture.loadData(pixels);
+/// });
+///
+/// // splits the rows between every worker and the calling thread
+/// ofGetTaskScheduler().parallelFor(0, pixels.getHeight(), [&](size_t y){
+///     for(auto & pixel: pixels.getLine(y)) ...
+/// });
+/// ~~~~
+class ofTaskScheduler{
+public:
+	/// \param numWorkers Worker threads, 0 uses one less than the number of
+	/// cores since the thread waiting for the results also runs tasks.
+	ofTaskScheduler(size_t numWorkers = 0);
+
+	/// \brief Waits for the tasks that are running, the ones still queued
+	/// fail with an exception so get() doesn't wait forever for them.
+	/// Functions queued with submit() are discarded.
+	~ofTaskScheduler();
+
+	ofTaskScheduler(const ofTaskScheduler &) = delete;
+	ofTaskScheduler & operator=(const ofTaskScheduler &) = delete;
+
+	/// \brief Restarts the workers with a different number of threads.
+	///
+	/// Waits for the tasks that are running, the ones still queued are
+	/// kept. No other thread should be using the scheduler meanwhile.
+	void setNumWorkers(size_t numWorkers);
+	size_t getNumWorkers() const;
+
+	/// \brief Runs f in a worker thread.
+	template<typename F>
+	auto async(F f) -> ofTask<decltype(f())>;
+
+	/// \brief Runs f in the main thread from the next update event, even
+	/// when called from the main thread.
+	///
+	/// The scheduler starts listening to the update event of the window
+	/// that exists when this is first called, if there's none yet the
+	/// functions only run from updateMainThread() or while the main thread
+	/// waits for a task.
+	template<typename F>
+	auto runOnMainThread(F f) -> ofTask<decltype(f())>;
+
+	/// \brief Calls f(index) for every index in [begin, end) in parallel and
+	/// waits for all of them.
+	/// \param grainSize Indices run together in the same task, 0 splits the
+	/// range in a few chunks per thread.
+	template<typename F>
+	void parallelFor(size_t begin, size_t end, F f, size_t grainSize = 0);
+
+	/// \brief Like parallelFor() but calls f(chunkBegin, chunkEnd) once per
+	/// chunk, so the loop over the chunk can be optimized as a whole.
+	template<typename F>
+	void parallelForRange(size_t begin, size_t end, F f, size_t grainSize = 0);
+
+	/// \brief Queues a function without a result, exceptions it throws are logged.
+	void submit(std::function<void()> && task);
+
+	/// \brief Runs the functions queued with runOnMainThread(), called from
+	/// the update event.
+	/// \returns Number of functions run.
+	size_t updateMainThread();
+
+	/// \brief Runs one queued task in the calling thread.
+	/// \returns false if there was nothing to run.
+	bool runPendingTask();
+
+	/// \brief Runs queued tasks in the calling thread until done returns true.
+	void waitUntil(const std::function<bool()> & done);
+
+	/// \returns true if called from one of this scheduler's workers.
+	bool isWorkerThread() const;
+
+private:
+	template<typename T>
+	friend class ofTask;
+
+	// the state is kept to fail the result of the tasks that never run,
+	// it's null for the functions queued with submit()
+	struct Task{
+		std::function<void()> run;
+		std::shared_ptr<of::priv::TaskStateBase> state;
+	};
+
+	struct Queue{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void start(size_t numWorkers);
+	void stop();
+	void workerFunction(size_t index);
+	void enqueue(Task && task);
+	void enqueueOnMainThread(Task && task);
+	void listenToUpdate();
+	void runTask(Task & task);
+	bool popTask(size_t worker, Task & task);
+	size_t getChunkSize(size_t count, size_t grainSize) const;
+
+	// one queue per worker plus a last one for tasks coming from other threads
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<size_t> numQueued;
+	std::atomic<size_t> numSleeping;
+	std::atomic<bool> running;
+	std::mutex sleepMutex;
+	std::condition_variable workAvailable;
+
+	std::mutex mainThreadMutex;
+	std::deque<Task> mainThreadTasks;
+	std::mutex listenerMutex;
+	ofCoreEvents * listenedEvents;
+	ofEventListener updateListener;
+};
+
+/// \brief Scheduler shared by the whole app, created the first time it's used.
+ofTaskScheduler & ofGetTaskScheduler();
+
+//--------------------------------------------------
+template<typename T>
+void ofTask<T>::wait() const{
+	if(!state || state->isReady()){
+		return;
+	}
+	auto taskState = state;
+	scheduler->waitUntil([taskState]{
+		return taskState->isReady();
+	});
+}
+
+//--------------------------------------------------
+template<typename T>
+template<typename F>
+auto ofTask<T>::then(F f) const -> ofTask<typename of::priv::ContinuationResult<T, F>::type>{
+	return continueWith(std::move(f), false);
+}
+
+//--------------------------------------------------
+template<typename T>
+template<typename F>
+auto ofTask<T>::thenOnMainThread(F f) const -> ofTask<typename of::priv::ContinuationResult<T, F>::type>{
+	return continueWith(std::move(f), true);
+}
+
+//--------------------------------------------------
+template<typename T>
+template<typename F>
+auto ofTask<T>::continueWith(F f, bool mainThread) const -> ofTask<typename of::priv::ContinuationResult<T, F>::type>{
+	typedef typename of::priv::ContinuationResult<T, F>::type R;
+	auto previous = state;
+	auto next = std::make_shared<of::priv::TaskState<R>>();
+	auto taskScheduler = scheduler;
+	std::function<void()> run = [previous, next, f]() mutable{
+		if(previous->getException()){
+			next->setException(previous->getException());
+		}else{
+			auto call = [&]{
+				return previous->call(f);
+			};
+			next->run(call);
+		}
+	};
+	previous->onFinished([taskScheduler, mainThread, run, next]() mutable{
+		if(mainThread){
+			taskScheduler->enqueueOnMainThread({std::move(run), next});
+		}else{
+			taskScheduler->enqueue({std::move(run), next});
+		}
+	});
+	return ofTask<R>(next, scheduler);
+}
+
+//--------------------------------------------------
+template<typename F>
+auto ofTaskScheduler::async(F f) -> ofTask<decltype(f())>{
+	typedef decltype(f()) R;
+	auto state = std::make_shared<of::priv::TaskState<R>>();
+	enqueue({[state, f]() mutable{
+		state->run(f);
+	}, state});
+	return ofTask<R>(state, this);
+}
+
+//--------------------------------------------------
+template<typename F>
+auto ofTaskScheduler::runOnMainThread(F f) -> ofTask<decltype(f())>{
+	typedef decltype(f()) R;
+	auto state = std::make_shared<of::priv::TaskState<R>>();
+	enqueueOnMainThread({[state, f]() mutable{
+		state->run(f);
+	}, state});
+	return ofTask<R>(state, this);
+}
+
+//--------------------------------------------------
+template<typename F>
+void ofTaskScheduler::parallelFor(size_t begin, size_t end, F f, size_t grainSize){
+	parallelForRange(begin, end, [&f](size_t chunkBegin, size_t chunkEnd){
+		for(size_t i = chunkBegin; i < chunkEnd; i++){
+			f(i);
+		}
+	}, grainSize);
+}
+
+//--------------------------------------------------
+template<typename F>
+void ofTaskScheduler::parallelForRange(size_t begin, size_t end, F f, size_t grainSize){
+	if(end <= begin){
+		return;
+	}
+	size_t chunkSize = getChunkSize(end - begin, grainSize);
+	size_t numChunks = (end - begin + chunkSize - 1) / chunkSize;
+	if(numChunks == 1){
+		f(begin, end);
+		return;
+	}
+
+	// the chunks are claimed one at a time by the calling thread and the
+	// helpers, a helper that starts after every chunk was claimed returns
+	// without touching f, which only lives until this function returns
+	struct Loop{
+		std::atomic<size_t> nextChunk{0};
+		std::atomic<size_t> numDone{0};
+		std::mutex mutex;
+		std::exception_ptr exception;
+	};
+	auto loop = std::make_shared<Loop>();
+	auto body = &f;
+	auto runChunks = [loop, body, begin, end, chunkSize, numChunks]{
+		size_t chunk;
+		while((chunk = loop->nextChunk++) < numChunks){
+			size_t chunkBegin = begin + chunk * chunkSize;
+			try{
+				(*body)(chunkBegin, std::min(chunkBegin + chunkSize, end));
+			}catch(...){
+				std::unique_lock<std::mutex> lock(loop->mutex);
+				if(!loop->exception){
+					loop->exception = std::current_exception();
+				}
+			}
+			if(++loop->numDone == numChunks){
+				of::priv::notifyTaskWaiters();
+			}
+		}
+	};
+
+	auto numHelpers = std::min(numChunks - 1, getNumWorkers());
+	for(size_t i = 0; i < numHelpers; i++){
+		submit(runChunks);
+	}
+	runChunks();
+	waitUntil([&]{
+		return loop->numDone == numChunks;
+	});
+	if(loop->exception){
+		std::rethrow_exception(loop->exception);
+	}
+}
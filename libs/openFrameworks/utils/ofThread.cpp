@@ -1,5 +1,6 @@
 #include "ofThread.h"
 #include "ofLog.h"
+#include "ofProfiler.h"
 
 #ifdef TARGET_ANDROID
 #include <jni.h>
@@ -159,6 +160,10 @@ void ofThread::run(){
 	}
 #endif
 
+#ifndef OF_DISABLE_PROFILER
+	ofProfiler::setThreadName(getThreadName());
+#endif
+
 	// user function
     // should loop endlessly.
 	try{
@@ -10,6 +10,8 @@ using std::string;
 	#include <curl/curl.h>
 	#include "ofThreadChannel.h"
 	#include "ofThread.h"
+	#include <condition_variable>
+	#include <ctime>
 static bool curlInited = false;
 #endif
 
@@ -20,7 +22,217 @@ ofEvent<ofHttpResponse> & ofURLResponseEvent() {
 	return *event;
 }
 
+ofEvent<ofHttpProgress> & ofURLProgressEvent() {
+	static ofEvent<ofHttpProgress> * event = new ofEvent<ofHttpProgress>;
+	return *event;
+}
+
 #if !defined(TARGET_IMPLEMENTS_URL_LOADER)
+namespace {
+// keeps the responses of GET requests in a folder with the headers needed to
+// revalidate them. the files are named after a hash of the url that has to
+// stay the same between runs
+class URLCache {
+public:
+	struct Entry {
+		string etag;
+		string lastModified;
+		time_t expires = 0;
+	};
+
+	void setDirectory(const of::filesystem::path & path) {
+		std::unique_lock<std::mutex> lock(mutex);
+		directory = path.empty() ? path : of::filesystem::path(ofToDataPath(path, true));
+		if (!directory.empty()) {
+			std::error_code error;
+			of::filesystem::create_directories(directory, error);
+		}
+	}
+
+	bool isEnabled() {
+		std::unique_lock<std::mutex> lock(mutex);
+		return !directory.empty();
+	}
+
+	bool getEntry(const string & url, Entry & entry) {
+		std::unique_lock<std::mutex> lock(mutex);
+		auto path = getPath(url, ".meta");
+		std::error_code error;
+		if (directory.empty() || !of::filesystem::exists(path, error)) {
+			return false;
+		}
+		auto lines = ofSplitString(ofBufferFromFile(path).getText(), "\n");
+		// the url is saved too in case of a collision
+		if (lines.size() < 4 || lines[0] != url) {
+			return false;
+		}
+		entry.etag = lines[1];
+		entry.lastModified = lines[2];
+		entry.expires = ofToInt64(lines[3]);
+		return true;
+	}
+
+	bool load(const string & url, ofBuffer & data) {
+		std::unique_lock<std::mutex> lock(mutex);
+		auto path = getPath(url, ".data");
+		std::error_code error;
+		if (directory.empty() || !of::filesystem::exists(path, error)) {
+			return false;
+		}
+		data = ofBufferFromFile(path);
+		return true;
+	}
+
+	// the metadata is written last so an interrupted write leaves no entry
+	void store(const string & url, const Entry & entry, const ofBuffer * data) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (directory.empty()) {
+			return;
+		}
+		std::error_code error;
+		if (data) {
+			of::filesystem::remove(getPath(url, ".meta"), error);
+			ofBufferToFile(getPath(url, ".data"), *data);
+		}
+		string meta = url + "\n" + entry.etag + "\n" + entry.lastModified + "\n" + ofToString(int64_t(entry.expires)) + "\n";
+		ofBufferToFile(getPath(url, ".meta"), ofBuffer(meta.data(), meta.size()));
+	}
+
+	void remove(const string & url) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (directory.empty()) {
+			return;
+		}
+		std::error_code error;
+		of::filesystem::remove(getPath(url, ".meta"), error);
+		of::filesystem::remove(getPath(url, ".data"), error);
+	}
+
+	void clear() {
+		std::unique_lock<std::mutex> lock(mutex);
+		std::error_code error;
+		if (directory.empty() || !of::filesystem::exists(directory, error)) {
+			return;
+		}
+		for (auto & file : of::filesystem::directory_iterator(directory, error)) {
+			auto extension = file.path().extension();
+			if (extension == ".meta" || extension == ".data") {
+				of::filesystem::remove(file.path(), error);
+			}
+		}
+	}
+
+private:
+	of::filesystem::path getPath(const string & url, const string & extension) const {
+		// 64 bit FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (unsigned char c : url) {
+			hash = (hash ^ c) * 1099511628211ull;
+		}
+		return directory / (ofToHex(hash) + extension);
+	}
+
+	std::mutex mutex;
+	of::filesystem::path directory;
+};
+
+// reads the validators and expiration of a response, returns false if it
+// can't be cached. validators missing in the headers are kept from the entry.
+// the entries are only keyed by url so responses that vary with the request
+// headers aren't cached, except for Accept-Encoding which is the same in
+// every request the cache is used for
+bool parseCacheHeaders(const map<string, string> & headers, URLCache::Entry & entry) {
+	auto vary = headers.find("vary");
+	if (vary != headers.end()) {
+		for (auto & field : ofSplitString(ofToLower(vary->second), ",", true, true)) {
+			if (field != "accept-encoding") {
+				return false;
+			}
+		}
+	}
+
+	bool noStore = false;
+	bool noCache = false;
+	int64_t maxAge = -1;
+	auto cacheControl = headers.find("cache-control");
+	if (cacheControl != headers.end()) {
+		for (auto & directive : ofSplitString(ofToLower(cacheControl->second), ",", true, true)) {
+			if (directive == "no-store") {
+				noStore = true;
+			} else if (directive == "no-cache") {
+				noCache = true;
+			} else if (directive.compare(0, 8, "max-age=") == 0) {
+				maxAge = ofToInt64(directive.substr(8));
+			}
+		}
+	}
+
+	auto now = time(nullptr);
+	entry.expires = 0;
+	if (noCache) {
+		// always revalidated
+	} else if (maxAge >= 0) {
+		entry.expires = now + maxAge;
+	} else {
+		auto expires = headers.find("expires");
+		if (expires != headers.end()) {
+			entry.expires = std::max(curl_getdate(expires->second.c_str(), nullptr), time_t(0));
+		}
+	}
+
+	auto etag = headers.find("etag");
+	if (etag != headers.end()) {
+		entry.etag = etag->second;
+	}
+	auto lastModified = headers.find("last-modified");
+	if (lastModified != headers.end()) {
+		entry.lastModified = lastModified->second;
+	}
+	return !noStore && (!entry.etag.empty() || !entry.lastModified.empty() || entry.expires > now);
+}
+
+// a request while curl runs it
+struct Transfer {
+	Transfer(const ofHttpRequest & request)
+		: request(request)
+		, response(request, 0, "")
+		, body(request.body) { }
+
+	~Transfer() {
+		if (headers) {
+			curl_slist_free_all(headers);
+		}
+	}
+
+	// opened with the first bytes of the body, once the status tells if
+	// the server sent the rest of a resumed file or all of it
+	bool openFile() {
+		long status = 0;
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+		if (status != 206) {
+			resumeFrom = 0;
+		}
+		saveTo.reset(new ofFile(request.name, resumeFrom > 0 ? ofFile::Append : ofFile::WriteOnly, true));
+		return saveTo->is_open();
+	}
+
+	ofHttpRequest request;
+	ofHttpResponse response;
+	std::string body; ///< POST data left to send
+	CURL * curl = nullptr;
+	curl_slist * headers = nullptr;
+	std::unique_ptr<ofFile> saveTo;
+	uint64_t resumeFrom = 0;
+	bool aborted = false; ///< cancelled by the receive callback
+	bool writeFailed = false; ///< the file couldn't be opened or written
+	bool cacheable = false;
+	bool revalidating = false;
+	URLCache::Entry cached;
+	ofHttpProgress progress;
+	std::function<void(const ofHttpProgress &)> notifyProgress;
+};
+}
+
 class ofURLFileLoaderImpl : public ofThread, public ofBaseURLFileLoader {
 public:
 	ofURLFileLoaderImpl();
@@ -34,31 +246,69 @@ public:
 	void stop();
 	ofHttpResponse handleRequest(const ofHttpRequest & request);
 	int handleRequestAsync(const ofHttpRequest & request); // returns id
+	void setMaxConcurrentRequests(size_t numRequests);
+	void setMaxConnectionsPerHost(size_t numConnections);
+	void setCacheDirectory(const of::filesystem::path & path);
+	void clearCache();
 
 protected:
 	// threading -----------------------------------------------
 	void threadedFunction();
 	void start();
+	void wakeUp();
 	void update(ofEventArgs & args); // notify in update so the notification is thread safe
 
 private:
-	// perform the requests on the thread
+	bool loadFromCache(Transfer & transfer);
+	void setupTransfer(CURL * curl, Transfer & transfer);
+	void finishTransfer(CURL * curl, Transfer & transfer, CURLcode err);
+
+	// run on the thread, every transfer there shares the connections of
+	// the multi handle
+	void startTransfers(map<CURL *, std::unique_ptr<Transfer>> & active);
+	void cancelTransfers(map<CURL *, std::unique_ptr<Transfer>> & active);
+	void removeTransfer(map<CURL *, std::unique_ptr<Transfer>> & active, CURL * curl);
+
+	CURLM * multi;
+	std::mutex mutex;
+	// highest priority first, the ones with the same priority in the order they came
+	std::multimap<int, ofHttpRequest, std::greater<int>> requests;
+	// ids of the requests taken from the queue that haven't finished yet
+	// and the ones among them that were removed while running
+	set<int> runningRequests;
+	set<int> cancelledRequests;
+	// without curl_multi_wakeup the thread waits here while it's idle
+	std::condition_variable idle;
+	size_t maxConcurrentRequests;
+	size_t maxConnectionsPerHost;
+	bool settingsChanged;
+
+	// the last progress of each request since the previous update
+	map<int, std::pair<std::function<void(const ofHttpProgress &)>, ofHttpProgress>> progress;
 
-	ofThreadChannel<ofHttpRequest> requests;
 	ofThreadChannel<ofHttpResponse> responses;
-	ofThreadChannel<int> cancelRequestQueue;
-	set<int> cancelledRequests;
+	URLCache cache;
+	ofEventListener updateListener;
 };
 
-ofURLFileLoaderImpl::ofURLFileLoaderImpl() {
+ofURLFileLoaderImpl::ofURLFileLoaderImpl()
+	: maxConcurrentRequests(8)
+	, maxConnectionsPerHost(6)
+	, settingsChanged(true) {
 	if (!curlInited) {
 		curl_global_init(CURL_GLOBAL_ALL);
+		curlInited = true;
 	}
+	// the multi handle keeps the connections of finished transfers open so
+	// the next requests to the same host can reuse them
+	multi = curl_multi_init();
 }
 
 ofURLFileLoaderImpl::~ofURLFileLoaderImpl() {
 	clear();
 	stop();
+	responses.close();
+	curl_multi_cleanup(multi);
 }
 
 ofHttpResponse ofURLFileLoaderImpl::get(const string & url) {
@@ -68,9 +318,7 @@ ofHttpResponse ofURLFileLoaderImpl::get(const string & url) {
 
 int ofURLFileLoaderImpl::getAsync(const string & url, const string & name) {
 	ofHttpRequest request(url, name.empty() ? url : name);
-	requests.send(request);
-	start();
-	return request.getId();
+	return handleRequestAsync(request);
 }
 
 ofHttpResponse ofURLFileLoaderImpl::saveTo(const string & url, const of::filesystem::path & path) {
@@ -80,75 +328,287 @@ ofHttpResponse ofURLFileLoaderImpl::saveTo(const string & url, const of::filesys
 
 int ofURLFileLoaderImpl::saveAsync(const string & url, const of::filesystem::path & path) {
 	ofHttpRequest request(url, path.string(), true);
-	requests.send(request);
-	start();
-	return request.getId();
+	return handleRequestAsync(request);
 }
 
 void ofURLFileLoaderImpl::remove(int id) {
-	cancelRequestQueue.send(id);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (auto it = requests.begin(); it != requests.end(); ++it) {
+			if (it->second.getId() == id) {
+				requests.erase(it);
+				return;
+			}
+		}
+		// already running, once it's finished there's nothing to cancel
+		if (runningRequests.find(id) == runningRequests.end()) {
+			return;
+		}
+		cancelledRequests.insert(id);
+	}
+	wakeUp();
 }
 
 void ofURLFileLoaderImpl::clear() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		requests.clear();
+	}
 	ofHttpResponse resp;
-	ofHttpRequest req;
-	while (requests.tryReceive(req)) { }
 	while (responses.tryReceive(resp)) { }
 }
 
 void ofURLFileLoaderImpl::start() {
 	if (!isThreadRunning()) {
-		ofAddListener(ofEvents().update, this, &ofURLFileLoaderImpl::update);
+		updateListener = ofEvents().update.newListener(this, &ofURLFileLoaderImpl::update);
 		startThread();
 	}
 }
 
+void ofURLFileLoaderImpl::wakeUp() {
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(multi);
+#else
+	// locking makes sure the thread is either waiting or will see the change
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.notify_all();
+#endif
+}
+
 void ofURLFileLoaderImpl::stop() {
 	stopThread();
-	requests.close();
-	responses.close();
+	wakeUp();
 	waitForThread();
+	std::unique_lock<std::mutex> lock(mutex);
+	requests.clear();
+	runningRequests.clear();
+	cancelledRequests.clear();
+}
+
+void ofURLFileLoaderImpl::setMaxConcurrentRequests(size_t numRequests) {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		maxConcurrentRequests = std::max(numRequests, size_t(1));
+	}
+	wakeUp();
+}
+
+void ofURLFileLoaderImpl::setMaxConnectionsPerHost(size_t numConnections) {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		maxConnectionsPerHost = numConnections;
+		settingsChanged = true;
+	}
+	wakeUp();
+}
+
+void ofURLFileLoaderImpl::setCacheDirectory(const of::filesystem::path & path) {
+	cache.setDirectory(path);
+}
+
+void ofURLFileLoaderImpl::clearCache() {
+	cache.clear();
 }
 
 void ofURLFileLoaderImpl::threadedFunction() {
 	setThreadName("ofURLFileLoader " + ofToString(getThreadId()));
+	map<CURL *, std::unique_ptr<Transfer>> active;
 	while (isThreadRunning()) {
-		int cancelled = 0;
-		while (cancelRequestQueue.tryReceive(cancelled)) {
-			cancelledRequests.insert(cancelled);
-		}
-		ofHttpRequest request;
-		if (requests.receive(request)) {
-			if (cancelledRequests.find(request.getId()) == cancelledRequests.end()) {
-				ofHttpResponse response(handleRequest(request));
-				int status = response.status;
-				if (!responses.send(std::move(response))) {
-					break;
-				}
-				if (status == -1) {
-					// retry
-					requests.send(request);
-				}
-			} else {
-				cancelledRequests.erase(cancelled);
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (settingsChanged) {
+				curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(maxConnectionsPerHost));
+				settingsChanged = false;
+			}
+		}
+		cancelTransfers(active);
+		startTransfers(active);
+
+		int running = 0;
+		curl_multi_perform(multi, &running);
+		int left = 0;
+		bool finished = false;
+		while (CURLMsg * msg = curl_multi_info_read(multi, &left)) {
+			if (msg->msg != CURLMSG_DONE) {
+				continue;
+			}
+			// msg is invalid once the handle is removed
+			CURL * curl = msg->easy_handle;
+			CURLcode err = msg->data.result;
+			if (active.find(curl) == active.end()) {
+				continue;
+			}
+			auto transfer = std::move(active[curl]);
+			removeTransfer(active, curl);
+			finished = true;
+			finishTransfer(curl, *transfer, err);
+			curl_easy_cleanup(curl);
+
+			int status = transfer->response.status;
+			responses.send(std::move(transfer->response));
+			// the data given to the receive callback can't be taken back and
+			// a file that can't be written won't work the next time either
+			bool retry = status == -1 && !transfer->request.receive && !transfer->writeFailed;
+			std::unique_lock<std::mutex> lock(mutex);
+			auto id = transfer->request.getId();
+			runningRequests.erase(id);
+			if (cancelledRequests.erase(id) == 0 && retry) {
+				// resumed requests continue where they stopped
+				requests.emplace(transfer->request.priority, transfer->request);
 			}
+		}
+
+		// waits for data on the connections or for wakeUp(), unless the
+		// finished transfers left room to start others
+		if (finished) {
+			continue;
+		}
+#if LIBCURL_VERSION_NUM >= 0x074400
+		curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+#else
+		// curl_multi_wait returns right away without connections to wait
+		// on so an idle thread sleeps until there's something to do
+		if (active.empty()) {
+			std::unique_lock<std::mutex> lock(mutex);
+			idle.wait_for(lock, std::chrono::seconds(1), [this] {
+				return !requests.empty() || settingsChanged || !isThreadRunning();
+			});
 		} else {
-			break;
+			curl_multi_wait(multi, nullptr, 0, 50, nullptr);
+		}
+#endif
+	}
+
+	while (!active.empty()) {
+		auto curl = active.begin()->first;
+		removeTransfer(active, curl);
+		curl_easy_cleanup(curl);
+	}
+}
+
+void ofURLFileLoaderImpl::startTransfers(map<CURL *, std::unique_ptr<Transfer>> & active) {
+	while (true) {
+		std::unique_ptr<Transfer> transfer;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (requests.empty() || active.size() >= maxConcurrentRequests) {
+				return;
+			}
+			transfer.reset(new Transfer(requests.begin()->second));
+			requests.erase(requests.begin());
+			runningRequests.insert(transfer->request.getId());
+		}
+
+		if (loadFromCache(*transfer)) {
+			responses.send(std::move(transfer->response));
+			std::unique_lock<std::mutex> lock(mutex);
+			runningRequests.erase(transfer->request.getId());
+			cancelledRequests.erase(transfer->request.getId());
+			continue;
+		}
+		auto & request = transfer->request;
+		if (request.progress || ofURLProgressEvent().size() > 0) {
+			auto callback = request.progress;
+			transfer->notifyProgress = [this, callback](const ofHttpProgress & progress) {
+				std::unique_lock<std::mutex> lock(mutex);
+				this->progress[progress.requestId] = std::make_pair(callback, progress);
+			};
+		}
+		CURL * curl = curl_easy_init();
+		setupTransfer(curl, *transfer);
+		curl_multi_add_handle(multi, curl);
+		active[curl] = std::move(transfer);
+	}
+}
+
+void ofURLFileLoaderImpl::cancelTransfers(map<CURL *, std::unique_ptr<Transfer>> & active) {
+	// the ids of requests that aren't transferring are kept, they are
+	// dropped when those requests finish instead of being retried
+	std::vector<CURL *> cancelled;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (cancelledRequests.empty()) {
+			return;
+		}
+		for (auto & transfer : active) {
+			auto id = transfer.second->request.getId();
+			if (cancelledRequests.erase(id) > 0) {
+				runningRequests.erase(id);
+				cancelled.push_back(transfer.first);
+			}
 		}
 	}
+	for (auto curl : cancelled) {
+		removeTransfer(active, curl);
+		curl_easy_cleanup(curl);
+	}
+}
+
+void ofURLFileLoaderImpl::removeTransfer(map<CURL *, std::unique_ptr<Transfer>> & active, CURL * curl) {
+	curl_multi_remove_handle(multi, curl);
+	active.erase(curl);
 }
 
 namespace {
-size_t saveToFile_cb(void * buffer, size_t size, size_t nmemb, void * userdata) {
-	auto saveTo = (ofFile *)userdata;
-	saveTo->write((const char *)buffer, size * nmemb);
-	return size * nmemb;
+// each chunk of the body goes to the receive callback, the file or the
+// response data as it arrives. returning less than the size cancels it
+size_t receive_cb(void * buffer, size_t size, size_t nmemb, void * userdata) {
+	auto transfer = (Transfer *)userdata;
+	auto & request = transfer->request;
+	auto bytes = size * nmemb;
+	if (request.receive) {
+		if (!request.receive((const char *)buffer, bytes)) {
+			transfer->aborted = true;
+			return 0;
+		}
+	} else if (request.saveTo) {
+		long status = 0;
+		curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &status);
+		if (transfer->resumeFrom > 0 && status >= 300) {
+			// an error page would replace the partial file
+			return bytes;
+		}
+		if (!transfer->saveTo && !transfer->openFile()) {
+			transfer->writeFailed = true;
+			return 0;
+		}
+		transfer->saveTo->write((const char *)buffer, bytes);
+		if (!transfer->saveTo->good()) {
+			transfer->writeFailed = true;
+			return 0;
+		}
+	} else {
+		transfer->response.data.append((const char *)buffer, bytes);
+	}
+	return bytes;
+}
+
+int progress_cb(void * userdata, curl_off_t downloadTotal, curl_off_t downloaded, curl_off_t, curl_off_t) {
+	auto transfer = (Transfer *)userdata;
+	auto & progress = transfer->progress;
+	uint64_t bytesReceived = transfer->resumeFrom + downloaded;
+	uint64_t totalBytes = downloadTotal > 0 ? transfer->resumeFrom + downloadTotal : 0;
+	if (bytesReceived != progress.bytesReceived || totalBytes != progress.totalBytes) {
+		progress.bytesReceived = bytesReceived;
+		progress.totalBytes = totalBytes;
+		transfer->notifyProgress(progress);
+	}
+	return 0;
 }
 
-size_t saveToMemory_cb(void * buffer, size_t size, size_t nmemb, void * userdata) {
+size_t saveHeader_cb(char * buffer, size_t size, size_t nitems, void * userdata) {
 	auto response = (ofHttpResponse *)userdata;
-	response->data.append((const char *)buffer, size * nmemb);
-	return size * nmemb;
+	string line(buffer, size * nitems);
+	if (line.compare(0, 5, "HTTP/") == 0) {
+		// status line of a new response, after a redirection
+		response->headers.clear();
+	} else {
+		auto colon = line.find(':');
+		if (colon != string::npos) {
+			response->headers[ofToLower(ofTrim(line.substr(0, colon)))] = ofTrim(line.substr(colon + 1));
+		}
+	}
+	return size * nitems;
 }
 
 size_t readBody_cb(void * ptr, size_t size, size_t nmemb, void * userdata) {
@@ -169,15 +629,34 @@ size_t readBody_cb(void * ptr, size_t size, size_t nmemb, void * userdata) {
 }
 }
 
-ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request) {
-	std::unique_ptr<CURL, void (*)(CURL *)> curl = std::unique_ptr<CURL, void (*)(CURL *)>(curl_easy_init(), curl_easy_cleanup);
-	curl_slist * headers = nullptr;
-	curl_easy_setopt(curl.get(), CURLOPT_SSL_VERIFYPEER, true);
-	curl_easy_setopt(curl.get(), CURLOPT_SSL_VERIFYHOST, 2);
-	curl_easy_setopt(curl.get(), CURLOPT_URL, request.url.c_str());
+bool ofURLFileLoaderImpl::loadFromCache(Transfer & transfer) {
+	auto & request = transfer.request;
+	// requests with their own headers, like Authorization or Accept, could
+	// get a different response than the one cached for the same url
+	transfer.cacheable = request.method == ofHttpRequest::GET && request.headers.empty() && !request.saveTo && !request.receive && request.body.empty() && cache.isEnabled();
+	if (!transfer.cacheable || !cache.getEntry(request.url, transfer.cached)) {
+		return false;
+	}
+	// still fresh, no need to ask the server
+	if (transfer.cached.expires > time(nullptr) && cache.load(request.url, transfer.response.data)) {
+		transfer.response.status = 200;
+		transfer.response.fromCache = true;
+		return true;
+	}
+	transfer.revalidating = true;
+	return false;
+}
+
+void ofURLFileLoaderImpl::setupTransfer(CURL * curl, Transfer & transfer) {
+	auto & request = transfer.request;
+	auto & headers = transfer.headers;
+	transfer.curl = curl;
+	curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, true);
+	curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2);
+	curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
 
 	// always follow redirections
-	curl_easy_setopt(curl.get(), CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 
 	// Set content type and any other header
 	if (request.contentType != "") {
@@ -187,73 +666,161 @@ ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request)
 		headers = curl_slist_append(headers, (it->first + ": " + it->second).c_str());
 	}
 
-	curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headers);
+	// asks the server to only send the data if it changed since it was cached
+	if (transfer.revalidating) {
+		if (!transfer.cached.etag.empty()) {
+			headers = curl_slist_append(headers, ("If-None-Match: " + transfer.cached.etag).c_str());
+		}
+		if (!transfer.cached.lastModified.empty()) {
+			headers = curl_slist_append(headers, ("If-Modified-Since: " + transfer.cached.lastModified).c_str());
+		}
+	}
 
-	std::string body = request.body;
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
 	// set body if there's any
 	if (request.body != "") {
-		//		curl_easy_setopt(curl.get(), CURLOPT_UPLOAD, 1L); // Tis does PUT instead of POST
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, request.body.size());
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, nullptr);
-		//curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, request.body.c_str());
-		curl_easy_setopt(curl.get(), CURLOPT_READFUNCTION, readBody_cb);
-		curl_easy_setopt(curl.get(), CURLOPT_READDATA, &body);
+		//		curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L); // Tis does PUT instead of POST
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, request.body.size());
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+		//curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+		curl_easy_setopt(curl, CURLOPT_READFUNCTION, readBody_cb);
+		curl_easy_setopt(curl, CURLOPT_READDATA, &transfer.body);
 	} else {
-		//		curl_easy_setopt(curl.get(), CURLOPT_UPLOAD, 0L);
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, 0);
-		//curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, nullptr);
-		curl_easy_setopt(curl.get(), CURLOPT_READFUNCTION, nullptr);
-		curl_easy_setopt(curl.get(), CURLOPT_READDATA, nullptr);
+		//		curl_easy_setopt(curl, CURLOPT_UPLOAD, 0L);
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 0);
+		//curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+		curl_easy_setopt(curl, CURLOPT_READFUNCTION, nullptr);
+		curl_easy_setopt(curl, CURLOPT_READDATA, nullptr);
 	}
 	if (request.method == ofHttpRequest::GET) {
-		curl_easy_setopt(curl.get(), CURLOPT_HTTPGET, 1);
-		curl_easy_setopt(curl.get(), CURLOPT_POST, 0);
+		curl_easy_setopt(curl, CURLOPT_HTTPGET, 1);
+		curl_easy_setopt(curl, CURLOPT_POST, 0);
 	} else {
-		curl_easy_setopt(curl.get(), CURLOPT_POST, 1);
-		curl_easy_setopt(curl.get(), CURLOPT_HTTPGET, 0);
+		curl_easy_setopt(curl, CURLOPT_POST, 1);
+		curl_easy_setopt(curl, CURLOPT_HTTPGET, 0);
 	}
 
 	if (request.timeoutSeconds > 0) {
-		curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT, request.timeoutSeconds);
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT, request.timeoutSeconds);
 	}
 
-	// start request and receive response
-	ofHttpResponse response(request, 0, "");
-	CURLcode err = CURLE_OK;
-	if (request.saveTo) {
-		ofFile saveTo(request.name, ofFile::WriteOnly, true);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &saveTo);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, saveToFile_cb);
-		err = curl_easy_perform(curl.get());
-	} else {
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, saveToMemory_cb);
-		err = curl_easy_perform(curl.get());
+	// asks for the bytes missing in the file
+	if (request.saveTo && request.resume && !request.receive) {
+		std::error_code error;
+		auto size = of::filesystem::file_size(ofToDataPath(request.name, true), error);
+		if (!error && size > 0) {
+			transfer.resumeFrom = size;
+			curl_easy_setopt(curl, CURLOPT_RANGE, (ofToString(size) + "-").c_str());
+		}
+	}
+
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, saveHeader_cb);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer.response);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, receive_cb);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+
+	if (transfer.notifyProgress) {
+		transfer.progress.requestId = request.getId();
+		transfer.progress.name = request.name;
+		curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+		curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_cb);
+		curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &transfer);
 	}
+}
+
+void ofURLFileLoaderImpl::finishTransfer(CURL * curl, Transfer & transfer, CURLcode err) {
+	auto & response = transfer.response;
 	if (err == CURLE_OK) {
 		long http_code = 0;
-		curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &http_code);
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
 		response.status = http_code;
+		// responses without a body still create the file
+		if (transfer.request.saveTo && !transfer.request.receive && !transfer.saveTo && transfer.resumeFrom == 0) {
+			transfer.openFile();
+		}
 	} else {
-		response.error = curl_easy_strerror(err);
+		if (transfer.aborted) {
+			response.error = "cancelled by the receive callback";
+		} else if (transfer.writeFailed) {
+			response.error = "couldn't write to " + transfer.request.name;
+		} else {
+			response.error = curl_easy_strerror(err);
+		}
 		response.status = -1;
 	}
+	// the file has to be complete before the response is notified
+	if (transfer.saveTo) {
+		transfer.saveTo->close();
+	}
 
-	if (headers) {
-		curl_slist_free_all(headers);
+	if (!transfer.cacheable) {
+		return;
 	}
+	auto & url = transfer.request.url;
+	auto entry = transfer.cached;
+	if (response.status == 304 && transfer.revalidating) {
+		// not modified, the server can still send new expiration headers
+		if (parseCacheHeaders(response.headers, entry) && cache.load(url, response.data)) {
+			response.status = 200;
+			response.fromCache = true;
+			cache.store(url, entry, nullptr);
+		} else {
+			cache.remove(url);
+		}
+	} else if (response.status == 200) {
+		entry = URLCache::Entry();
+		if (parseCacheHeaders(response.headers, entry)) {
+			cache.store(url, entry, &response.data);
+		} else {
+			cache.remove(url);
+		}
+	}
+}
 
-	return response;
+ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request) {
+	Transfer transfer(request);
+	if (loadFromCache(transfer)) {
+		return transfer.response;
+	}
+	transfer.notifyProgress = request.progress;
+
+	// reused by the requests of each thread so they can keep the connections
+	// open, curl_easy_reset keeps them
+	thread_local std::unique_ptr<CURL, void (*)(CURL *)> curl(curl_easy_init(), curl_easy_cleanup);
+	curl_easy_reset(curl.get());
+	setupTransfer(curl.get(), transfer);
+
+	// start request and receive response
+	CURLcode err = curl_easy_perform(curl.get());
+	finishTransfer(curl.get(), transfer, err);
+	return transfer.response;
 }
 
 int ofURLFileLoaderImpl::handleRequestAsync(const ofHttpRequest & request) {
-	requests.send(request);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		requests.emplace(request.priority, request);
+	}
 	start();
+	wakeUp();
 	return request.getId();
 }
 
 void ofURLFileLoaderImpl::update(ofEventArgs & args) {
+	// before the responses so the last progress comes before done
+	map<int, std::pair<std::function<void(const ofHttpProgress &)>, ofHttpProgress>> progress;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		std::swap(progress, this->progress);
+	}
+	for (auto & requestProgress : progress) {
+		if (requestProgress.second.first) {
+			requestProgress.second.first(requestProgress.second.second);
+		}
+		ofNotifyEvent(ofURLProgressEvent(), requestProgress.second.second);
+	}
+
 	ofHttpResponse response;
 	while (responses.tryReceive(response)) {
 		try {
@@ -311,6 +878,22 @@ int ofURLFileLoader::handleRequestAsync(const ofHttpRequest & request) {
 	return impl->handleRequestAsync(request);
 }
 
+void ofURLFileLoader::setMaxConcurrentRequests(size_t numRequests) {
+	impl->setMaxConcurrentRequests(numRequests);
+}
+
+void ofURLFileLoader::setMaxConnectionsPerHost(size_t numConnections) {
+	impl->setMaxConnectionsPerHost(numConnections);
+}
+
+void ofURLFileLoader::setCacheDirectory(const of::filesystem::path & path) {
+	impl->setCacheDirectory(path);
+}
+
+void ofURLFileLoader::clearCache() {
+	impl->clearCache();
+}
+
 static bool initialized = false;
 static ofURLFileLoader & getFileLoader() {
 	static ofURLFileLoader * fileLoader = new ofURLFileLoader;
@@ -389,6 +972,14 @@ void ofStopURLLoader() {
 	getFileLoader().stop();
 }
 
+void ofSetURLMaxConcurrentRequests(size_t numRequests) {
+	getFileLoader().setMaxConcurrentRequests(numRequests);
+}
+
+void ofSetURLCacheDirectory(const of::filesystem::path & path) {
+	getFileLoader().setCacheDirectory(path);
+}
+
 void ofURLFileLoaderShutdown() {
 	if (initialized) {
 		ofRemoveAllURLRequests();
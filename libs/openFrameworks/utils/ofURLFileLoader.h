@@ -6,6 +6,7 @@
 #include <map>
 
 class ofHttpResponse;
+class ofHttpProgress;
 
 /// \class ofHttpRequest
 /// \brief An HTTP GET or POST request.
@@ -22,6 +23,27 @@ public:
 	std::string contentType; ///< POST data mime type
 	std::function<void(const ofHttpResponse &)> done;
 	size_t timeoutSeconds = 0;
+	int priority = 0; ///< asynchronous requests with a higher priority start first when the loader is busy
+
+	/// \brief Receives the body in chunks as it arrives instead of keeping it
+	/// in the response data or saving it to a file.
+	///
+	/// Called from the loader thread for asynchronous requests. Returning
+	/// false cancels the request.
+	std::function<bool(const char * data, size_t size)> receive;
+
+	/// \brief Called with the progress of the download while it runs.
+	///
+	/// Called in the update event for asynchronous requests and from the
+	/// thread making the request for blocking ones.
+	std::function<void(const ofHttpProgress &)> progress;
+
+	/// \brief Continue downloading a partial file instead of overwriting it.
+	///
+	/// Only used when saving to a file. Asks the server for the bytes after
+	/// the ones already in the file, the file is overwritten if the server
+	/// sends the whole body instead.
+	bool resume = false;
 
 	/// \return the unique id for this request
 	int getId() const;
@@ -52,6 +74,18 @@ public:
 	ofBuffer data; ///< response raw data
 	int status; ///< HTTP response status (200: OK, 404: Not Found, etc)
 	std::string error; ///< HTTP error string, if any (OK, Not Found, etc)
+	std::map<std::string, std::string> headers; ///< HTTP response header keys, in lowercase, & values
+	bool fromCache = false; ///< was the data loaded from the disk cache?
+};
+
+/// \class ofHttpProgress
+/// \brief The progress of an HTTP request while its response arrives.
+class ofHttpProgress {
+public:
+	int requestId = 0; ///< id of the request
+	std::string name; ///< name of the request
+	uint64_t bytesReceived = 0; ///< bytes of the body received, including the ones resumed from a partial file
+	uint64_t totalBytes = 0; ///< size of the body, 0 if the server didn't send it
 };
 
 /// \brief Make an HTTP GET request.
@@ -104,8 +138,20 @@ void ofRemoveAllURLRequests();
 /// \brief Stop & remove all active and waiting HTTP requests.
 void ofStopURLLoader();
 
+/// \brief Maximum number of asynchronous HTTP requests running at once.
+/// \param numRequests maximum number of requests, 8 by default
+void ofSetURLMaxConcurrentRequests(size_t numRequests);
+
+/// \brief Enable a disk cache for the HTTP GET requests.
+/// \param path folder to keep the cached responses in, empty to disable the cache
+void ofSetURLCacheDirectory(const of::filesystem::path & path);
+
 ofEvent<ofHttpResponse> & ofURLResponseEvent();
 
+/// \brief Notified in the update event with the progress of the asynchronous
+/// HTTP requests that are downloading.
+ofEvent<ofHttpProgress> & ofURLProgressEvent();
+
 template <class T>
 void ofRegisterURLNotification(T * obj) {
 	ofAddListener(ofURLResponseEvent(), obj, &T::urlResponse);
@@ -184,6 +230,36 @@ public:
 	/// \return unique id of the active HTTP request
 	int handleRequestAsync(const ofHttpRequest & request);
 
+	/// \brief Set how many asynchronous requests run at the same time.
+	///
+	/// The rest wait in a queue ordered by their priority. Connections to
+	/// the same host are kept open and reused by the following requests.
+	///
+	/// \param numRequests maximum number of requests, 8 by default
+	void setMaxConcurrentRequests(size_t numRequests);
+
+	/// \brief Set how many connections can be open to the same host.
+	/// \param numConnections maximum number of connections, 0 for no limit, 6 by default
+	void setMaxConnectionsPerHost(size_t numConnections);
+
+	/// \brief Enable a disk cache for the GET requests kept in memory.
+	///
+	/// Responses with an ETag or Last-Modified header are saved to the
+	/// folder. Requesting them again sends a conditional request and, if the
+	/// server answers that they didn't change, returns the saved data. The
+	/// ones still fresh according to their Cache-Control or Expires headers
+	/// are returned without contacting the server.
+	///
+	/// The responses are saved by url only, so requests with their own
+	/// headers and responses with a Vary header other than Accept-Encoding
+	/// always go to the server.
+	///
+	/// \param path folder to keep the cached responses in, empty to disable the cache
+	void setCacheDirectory(const of::filesystem::path & path);
+
+	/// \brief Remove all the responses saved in the disk cache.
+	void clearCache();
+
 private:
 	std::shared_ptr<ofBaseURLFileLoader> impl;
 };
@@ -253,4 +329,22 @@ public:
 	///
 	/// \return unique id of the active HTTP request
 	virtual int handleRequestAsync(const ofHttpRequest & request) = 0;
+
+	/// \brief Set how many asynchronous requests run at the same time.
+	///
+	/// Ignored by implementations that can't control it.
+	virtual void setMaxConcurrentRequests(size_t) { }
+
+	/// \brief Set how many connections can be open to the same host.
+	///
+	/// Ignored by implementations that can't control it.
+	virtual void setMaxConnectionsPerHost(size_t) { }
+
+	/// \brief Enable a disk cache for the GET requests kept in memory.
+	///
+	/// Ignored by implementations that can't control it.
+	virtual void setCacheDirectory(const of::filesystem::path &) { }
+
+	/// \brief Remove all the responses saved in the disk cache.
+	virtual void clearCache() { }
 };
@@ -11,7 +11,10 @@
 #include "ofPixels.h"
 
 #include "uriparser/Uri.h"
+#include <cerrno>
 #include <chrono>
+#include <cstring>
+#include <limits>
 #include <locale>
 #include <numeric>
 
@@ -95,7 +98,7 @@ public:
 		fixedRateStep = stepNanos;
 		loopListener = mainLoop.loopEvent.newListener([this] {
 			fixedRateTime.nanoseconds += fixedRateStep;
-			while (fixedRateTime.nanoseconds > 1000000000) {
+			while (fixedRateTime.nanoseconds >= 1000000000) {
 				fixedRateTime.nanoseconds -= 1000000000;
 				fixedRateTime.seconds += 1;
 			}
@@ -114,7 +117,9 @@ public:
 
 	//--------------------------------------
 	void resetElapsedTimeCounter() {
-		startTime = getMonotonicTimeForMode(ofTime::System);
+		// with a fixed rate the elapsed time restarts from the virtual clock
+		// so it only depends on the number of frames since the reset
+		startTime = getMonotonicTimeForMode(mode);
 	}
 
 private:
@@ -486,9 +491,162 @@ string ofToHex(const char * value) {
 	return ofToHex((string)value);
 }
 
+//----------------------------------------
+static void appendPadded(string & str, const char * first, const char * last, int width, char fill) {
+	auto length = last - first;
+	if (width > length) {
+		str.append(width - length, fill);
+	}
+	str.append(first, last);
+}
+
+//----------------------------------------
+void of::priv::appendNumber(string & str, long long value, int width, char fill) {
+	char buffer[32];
+#if OF_HAS_TO_CHARS
+	auto last = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+#else
+	auto last = buffer + snprintf(buffer, sizeof(buffer), "%lld", value);
+#endif
+	appendPadded(str, buffer, last, width, fill);
+}
+
+//----------------------------------------
+void of::priv::appendNumber(string & str, unsigned long long value, int width, char fill) {
+	char buffer[32];
+#if OF_HAS_TO_CHARS
+	auto last = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+#else
+	auto last = buffer + snprintf(buffer, sizeof(buffer), "%llu", value);
+#endif
+	appendPadded(str, buffer, last, width, fill);
+}
+
+//----------------------------------------
+void of::priv::appendNumber(string & str, double value, int precision, int width, char fill) {
+	// same output as a stream, 6 significant digits by default and fixed
+	// notation when a precision or width is given
+	bool fixed = precision >= 0 || width > 0;
+	if (precision < 0) {
+		precision = 6;
+	}
+	char buffer[128];
+#if OF_HAS_TO_CHARS
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, fixed ? std::chars_format::fixed : std::chars_format::general, precision);
+	if (result.ec == std::errc()) {
+		appendPadded(str, buffer, result.ptr, width, fill);
+		return;
+	}
+#else
+	auto length = snprintf(buffer, sizeof(buffer), fixed ? "%.*f" : "%.*g", precision, value);
+	if (length >= 0 && length < int(sizeof(buffer))) {
+		appendPadded(str, buffer, buffer + length, width, fill);
+		return;
+	}
+#endif
+	// only very big numbers in fixed notation or a huge precision get here
+	auto big = ofVAArgsToString(fixed ? "%.*f" : "%.*g", precision, value);
+	appendPadded(str, big.data(), big.data() + big.size(), width, fill);
+}
+
+//----------------------------------------
+template <typename T>
+static bool parseNumber(const char * first, const char * last, T & value) {
+	// like a stream skip the leading whitespace and accept a + sign
+	while (first != last && std::isspace((unsigned char)*first)) {
+		++first;
+	}
+	if (first != last && *first == '+' && (last - first == 1 || first[1] != '-')) {
+		++first;
+	}
+#if OF_HAS_TO_CHARS
+	T parsed;
+	auto result = std::from_chars(first, last, parsed);
+	if (result.ec != std::errc()) {
+		return false;
+	}
+	value = parsed;
+	return true;
+#else
+	// strto* need a null terminated string, numbers longer than the
+	// buffer wouldn't fit in any of the types anyway
+	char buffer[128];
+	size_t length = std::min<size_t>(last - first, sizeof(buffer) - 1);
+	memcpy(buffer, first, length);
+	buffer[length] = 0;
+	if (length == 0 || std::isspace((unsigned char)buffer[0]) || (std::is_unsigned<T>::value && buffer[0] == '-')) {
+		return false;
+	}
+	char * end;
+	errno = 0;
+	if (std::is_floating_point<T>::value) {
+		auto parsed = std::is_same<T, float>::value ? strtof(buffer, &end) : strtod(buffer, &end);
+		if (end == buffer || errno == ERANGE) {
+			return false;
+		}
+		value = T(parsed);
+	} else if (std::is_signed<T>::value) {
+		auto parsed = strtoll(buffer, &end, 10);
+		if (end == buffer || errno == ERANGE || parsed < (long long)std::numeric_limits<T>::lowest() || parsed > (long long)std::numeric_limits<T>::max()) {
+			return false;
+		}
+		value = T(parsed);
+	} else {
+		auto parsed = strtoull(buffer, &end, 10);
+		if (end == buffer || errno == ERANGE || parsed > (unsigned long long)std::numeric_limits<T>::max()) {
+			return false;
+		}
+		value = T(parsed);
+	}
+	return true;
+#endif
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, int & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, unsigned int & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, long & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, unsigned long & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, long long & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, unsigned long long & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, float & value) {
+	return parseNumber(first, last, value);
+}
+
+//----------------------------------------
+bool ofParseNumber(const char * first, const char * last, double & value) {
+	return parseNumber(first, last, value);
+}
+
 //----------------------------------------
 int ofToInt(const string & intString) {
-	return ofTo<int>(intString);
+	int x = 0;
+	ofParseNumber(intString.data(), intString.data() + intString.size(), x);
+	return x;
 }
 
 //----------------------------------------
@@ -542,17 +700,23 @@ string ofHexToString(const string & stringHexString) {
 
 //----------------------------------------
 float ofToFloat(const string & floatString) {
-	return ofTo<float>(floatString);
+	float x = 0;
+	ofParseNumber(floatString.data(), floatString.data() + floatString.size(), x);
+	return x;
 }
 
 //----------------------------------------
 double ofToDouble(const string & doubleString) {
-	return ofTo<double>(doubleString);
+	double x = 0;
+	ofParseNumber(doubleString.data(), doubleString.data() + doubleString.size(), x);
+	return x;
 }
 
 //----------------------------------------
 int64_t ofToInt64(const string & intString) {
-	return ofTo<int64_t>(intString);
+	int64_t x = 0;
+	ofParseNumber(intString.data(), intString.data() + intString.size(), x);
+	return x;
 }
 
 //----------------------------------------
@@ -633,30 +797,111 @@ string ofBinaryToString(const string & value) {
 }
 
 //--------------------------------------------------
-vector<string> ofSplitString(const string & source, const string & delimiter, bool ignoreEmpty, bool trim) {
-	vector<string> result;
-	if (delimiter.empty()) {
-		result.push_back(source);
-		return result;
+static bool isAsciiSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+//--------------------------------------------------
+// calls token for every token in [first, last) without copying them
+template <typename Token>
+static void splitString(const char * first, const char * last, const char * delimiter, size_t delimiterSize, bool ignoreEmpty, bool trim, Token token) {
+	if (delimiterSize == 0) {
+		token(first, last);
+		return;
 	}
-	string::const_iterator substart = source.begin(), subend;
+	auto substart = first;
 	while (true) {
-		subend = search(substart, source.end(), delimiter.begin(), delimiter.end());
-		string sub(substart, subend);
+		auto subend = std::search(substart, last, delimiter, delimiter + delimiterSize);
+		auto tokenStart = substart;
+		auto tokenEnd = subend;
 		if (trim) {
-			sub = ofTrim(sub);
+			while (tokenStart != tokenEnd && isAsciiSpace(*tokenStart)) {
+				++tokenStart;
+			}
+			while (tokenEnd != tokenStart && isAsciiSpace(*(tokenEnd - 1))) {
+				--tokenEnd;
+			}
 		}
-		if (!ignoreEmpty || !sub.empty()) {
-			result.push_back(sub);
+		if (!ignoreEmpty || tokenStart != tokenEnd) {
+			token(tokenStart, tokenEnd);
 		}
-		if (subend == source.end()) {
+		if (subend == last) {
 			break;
 		}
-		substart = subend + delimiter.size();
+		substart = subend + delimiterSize;
 	}
+}
+
+//--------------------------------------------------
+vector<string> ofSplitString(const string & source, const string & delimiter, bool ignoreEmpty, bool trim) {
+	vector<string> result;
+	splitString(source.data(), source.data() + source.size(), delimiter.data(), delimiter.size(), ignoreEmpty, trim, [&](const char * first, const char * last) {
+		result.emplace_back(first, last);
+	});
 	return result;
 }
 
+//--------------------------------------------------
+void ofSplitString(const string & source, const string & delimiter, vector<string> & tokens, bool ignoreEmpty, bool trim) {
+	// the strings already in the vector are assigned instead of replaced so
+	// their memory is reused
+	size_t numTokens = 0;
+	splitString(source.data(), source.data() + source.size(), delimiter.data(), delimiter.size(), ignoreEmpty, trim, [&](const char * first, const char * last) {
+		if (numTokens < tokens.size()) {
+			tokens[numTokens].assign(first, last);
+		} else {
+			tokens.emplace_back(first, last);
+		}
+		numTokens++;
+	});
+	tokens.resize(numTokens);
+}
+
+#if OF_HAS_STRING_VIEW
+//--------------------------------------------------
+void ofSplitString(std::string_view source, std::string_view delimiter, vector<std::string_view> & tokens, bool ignoreEmpty, bool trim) {
+	tokens.clear();
+	splitString(source.data(), source.data() + source.size(), delimiter.data(), delimiter.size(), ignoreEmpty, trim, [&](const char * first, const char * last) {
+		tokens.emplace_back(first, last - first);
+	});
+}
+
+//--------------------------------------------------
+vector<std::string_view> ofSplitStringViews(std::string_view source, std::string_view delimiter, bool ignoreEmpty, bool trim) {
+	vector<std::string_view> tokens;
+	ofSplitString(source, delimiter, tokens, ignoreEmpty, trim);
+	return tokens;
+}
+
+//--------------------------------------------------
+bool ofNextToken(std::string_view & remaining, std::string_view delimiter, std::string_view & token) {
+	if (remaining.data() == nullptr) {
+		return false;
+	}
+	auto end = delimiter.empty() ? std::string_view::npos : remaining.find(delimiter);
+	if (end == std::string_view::npos) {
+		token = remaining;
+		// a null view marks the end, an empty one can still have an empty token
+		remaining = std::string_view();
+	} else {
+		token = remaining.substr(0, end);
+		remaining.remove_prefix(end + delimiter.size());
+	}
+	return true;
+}
+
+//--------------------------------------------------
+std::string_view ofTrimView(std::string_view src) {
+	while (!src.empty() && isAsciiSpace(src.front())) {
+		src.remove_prefix(1);
+	}
+	while (!src.empty() && isAsciiSpace(src.back())) {
+		src.remove_suffix(1);
+	}
+	return src;
+}
+#endif
+
 //--------------------------------------------------
 string ofJoinString(const vector<string> & stringElements, const string & delimiter) {
 	string str;
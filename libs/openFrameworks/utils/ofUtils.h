@@ -410,6 +410,69 @@ bool ofContains(const std::vector<T> & values, const T & target) {
 /// \returns A vector of strings split with the delimiter.
 std::vector<std::string> ofSplitString(const std::string & source, const std::string & delimiter, bool ignoreEmpty = false, bool trim = false);
 
+/// \brief Splits a string into an existing vector of strings.
+///
+/// Works like ofSplitString but reuses the vector and the strings already in
+/// it, so splitting many lines with a similar number of tokens, like the rows
+/// of a csv file, doesn't allocate once the tokens have grown to their usual
+/// size. Trimming only removes ASCII whitespace.
+///
+/// \param source The string to split.
+/// \param delimiter The delimiter string.
+/// \param tokens The vector to write the tokens to, its previous contents are replaced.
+/// \param ignoreEmpty Set to true to remove empty tokens.
+/// \param trim Set to true to trim the resulting tokens.
+void ofSplitString(const std::string & source, const std::string & delimiter, std::vector<std::string> & tokens, bool ignoreEmpty = false, bool trim = false);
+
+#if OF_HAS_STRING_VIEW
+/// \brief Splits a string into views of the original string.
+///
+/// No token is copied, the views point to the characters in source so it
+/// has to outlive them. The vector is cleared first and can be reused
+/// between calls to avoid allocating:
+///
+/// ~~~~{.cpp}
+/// std::vector<std::string_view> columns;
+/// for (auto line : buffer.getLineViews()) {
+///     ofSplitString(line, ",", columns);
+///     float x = 0;
+///     ofParseNumber(columns[0], x);
+/// }
+/// ~~~~
+///
+/// \param source The string to split.
+/// \param delimiter The delimiter string.
+/// \param tokens The vector to write the tokens to, its previous contents are replaced.
+/// \param ignoreEmpty Set to true to remove empty tokens.
+/// \param trim Set to true to remove ASCII whitespace around the tokens.
+void ofSplitString(std::string_view source, std::string_view delimiter, std::vector<std::string_view> & tokens, bool ignoreEmpty = false, bool trim = false);
+
+/// \brief Splits a string into views of the original string.
+/// \returns A vector of views of source, only valid while source is.
+std::vector<std::string_view> ofSplitStringViews(std::string_view source, std::string_view delimiter, bool ignoreEmpty = false, bool trim = false);
+
+/// \brief Gets the next token of a string without splitting it all first.
+///
+/// Removes the token and its delimiter from the front of remaining:
+///
+/// ~~~~{.cpp}
+/// std::string_view remaining = "1 2 3";
+/// std::string_view token;
+/// while (ofNextToken(remaining, " ", token)) {
+///     // token is "1", "2" and "3"
+/// }
+/// ~~~~
+///
+/// \param remaining The part of the string still to tokenize.
+/// \param delimiter The delimiter string.
+/// \param token Set to the next token, which can be empty.
+/// \returns false once there are no tokens left.
+bool ofNextToken(std::string_view & remaining, std::string_view delimiter, std::string_view & token);
+
+/// \brief Removes the ASCII whitespace around a string without copying it.
+std::string_view ofTrimView(std::string_view src);
+#endif
+
 /// \brief Join a vector of strings together into one string.
 /// \param stringElements The vector of strings to join.
 /// \param delimiter The delimiter to put betweeen each string.
@@ -648,6 +711,49 @@ std::string ofVAArgsToString(const char * format, Args &&... args) {
 	return s;
 }
 
+/*! \cond PRIVATE */
+namespace of {
+namespace priv {
+// the numbers ofToString writes with std::to_chars instead of a stream,
+// char types are written as characters so they still go to the stream
+template <class T>
+struct isCharconvNumber : std::integral_constant<bool,
+	(std::is_integral<T>::value && sizeof(T) > 1 && !std::is_same<T, wchar_t>::value && !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value) || std::is_same<T, float>::value || std::is_same<T, double>::value> { };
+
+void appendNumber(std::string & str, long long value, int width, char fill);
+void appendNumber(std::string & str, unsigned long long value, int width, char fill);
+void appendNumber(std::string & str, double value, int precision, int width, char fill);
+
+template <class T>
+void appendToString(std::string & str, const T & value, int precision, int width, char fill, std::true_type) {
+	if (std::is_floating_point<T>::value) {
+		appendNumber(str, double(value), precision, width, fill);
+	} else if (std::is_signed<T>::value) {
+		appendNumber(str, (long long)(value), width, fill);
+	} else {
+		appendNumber(str, (unsigned long long)(value), width, fill);
+	}
+}
+
+template <class T>
+void appendToString(std::string & str, const T & value, int precision, int width, char fill, std::false_type) {
+	std::ostringstream out;
+	if (precision >= 0 || width > 0) {
+		out << std::fixed;
+	}
+	if (precision >= 0) {
+		out << std::setprecision(precision);
+	}
+	if (width > 0) {
+		out << std::setfill(fill) << std::setw(width);
+	}
+	out << value;
+	str += out.str();
+}
+}
+}
+/*! \endcond */
+
 /// \section String Conversion
 /// \brief Convert a value to a string.
 ///
@@ -663,12 +769,16 @@ std::string ofVAArgsToString(const char * format, Args &&... args) {
 ///
 /// \tparam T The data type of the value to convert to a string.
 /// \param value The value to convert to a string.
+/// Numbers are written with std::to_chars when the standard library has
+/// it, with the same output a stream would produce, any other type needs
+/// a stream << operator.
+///
 /// \returns A string representing the value or an empty string on failure.
 template <class T>
 std::string ofToString(const T & value) {
-	std::ostringstream out;
-	out << value;
-	return out.str();
+	std::string str;
+	of::priv::appendToString(str, value, -1, 0, ' ', of::priv::isCharconvNumber<T>());
+	return str;
 }
 
 /// \brief Convert a value to a string with a specific precision.
@@ -681,9 +791,9 @@ std::string ofToString(const T & value) {
 /// \returns The string representation of the value.
 template <class T>
 std::string ofToString(const T & value, int precision) {
-	std::ostringstream out;
-	out << std::fixed << std::setprecision(precision) << value;
-	return out.str();
+	std::string str;
+	of::priv::appendToString(str, value, precision, 0, ' ', of::priv::isCharconvNumber<T>());
+	return str;
 }
 
 /// \brief Convert a value to a string with a specific width and fill
@@ -697,9 +807,9 @@ std::string ofToString(const T & value, int precision) {
 /// \returns The string representation of the value.
 template <class T>
 std::string ofToString(const T & value, int width, char fill) {
-	std::ostringstream out;
-	out << std::fixed << std::setfill(fill) << std::setw(width) << value;
-	return out.str();
+	std::string str;
+	of::priv::appendToString(str, value, -1, width, fill, of::priv::isCharconvNumber<T>());
+	return str;
 }
 
 /// \brief Convert a value to a string with a specific precision, width and filll
@@ -714,9 +824,9 @@ std::string ofToString(const T & value, int width, char fill) {
 /// \returns The string representation of the value.
 template <class T>
 std::string ofToString(const T & value, int precision, int width, char fill) {
-	std::ostringstream out;
-	out << std::fixed << std::setfill(fill) << std::setw(width) << std::setprecision(precision) << value;
-	return out.str();
+	std::string str;
+	of::priv::appendToString(str, value, precision, width, fill, of::priv::isCharconvNumber<T>());
+	return str;
 }
 
 /// \brief Convert a vector of values to a comma-delimited string.
@@ -729,17 +839,58 @@ std::string ofToString(const T & value, int precision, int width, char fill) {
 /// \returns a comma-delimited string representation of the intput values.
 template <class T>
 std::string ofToString(const std::vector<T> & values) {
-	std::stringstream out;
+	std::string str;
 	int n = values.size();
-	out << "{";
+	str += "{";
 	if (n > 0) {
 		for (int i = 0; i < n - 1; i++) {
-			out << values[i] << ", ";
+			of::priv::appendToString(str, values[i], -1, 0, ' ', of::priv::isCharconvNumber<T>());
+			str += ", ";
 		}
-		out << values[n - 1];
+		of::priv::appendToString(str, values[n - 1], -1, 0, ' ', of::priv::isCharconvNumber<T>());
 	}
-	out << "}";
-	return out.str();
+	str += "}";
+	return str;
+}
+
+/// \brief Append a value to the end of a string.
+///
+/// Writes the same as ofToString(value) without creating a new string, so
+/// building a line of text in a string that is cleared and reused every
+/// frame doesn't allocate:
+///
+/// ~~~~{.cpp}
+/// hud.clear();
+/// hud += "fps: ";
+/// ofAppendToString(hud, ofGetFrameRate(), 1);
+/// ~~~~
+///
+/// \param str The string to append to.
+/// \param value The value to convert to a string.
+template <class T>
+void ofAppendToString(std::string & str, const T & value) {
+	of::priv::appendToString(str, value, -1, 0, ' ', of::priv::isCharconvNumber<T>());
+}
+
+/// \brief Append a value with a specific precision to the end of a string.
+/// \sa ofToString(const T & value, int precision)
+template <class T>
+void ofAppendToString(std::string & str, const T & value, int precision) {
+	of::priv::appendToString(str, value, precision, 0, ' ', of::priv::isCharconvNumber<T>());
+}
+
+/// \brief Append a value with a specific width and fill to the end of a string.
+/// \sa ofToString(const T & value, int width, char fill)
+template <class T>
+void ofAppendToString(std::string & str, const T & value, int width, char fill) {
+	of::priv::appendToString(str, value, -1, width, fill, of::priv::isCharconvNumber<T>());
+}
+
+/// \brief Append a value with a specific precision, width and fill to the end of a string.
+/// \sa ofToString(const T & value, int precision, int width, char fill)
+template <class T>
+void ofAppendToString(std::string & str, const T & value, int precision, int width, char fill) {
+	of::priv::appendToString(str, value, precision, width, fill, of::priv::isCharconvNumber<T>());
 }
 
 /// \brief Convert a string represetnation to another type.
@@ -832,6 +983,41 @@ double ofToDouble(const std::string & doubleString);
 /// \returns the boolean represented by the string or 0 on failure.
 bool ofToBool(const std::string & boolString);
 
+/// \brief Parse a number from a range of characters without allocating.
+///
+/// Like ofToInt or ofToFloat, leading whitespace and a + sign are skipped
+/// and the number ends at the first character that can't be part of it.
+/// Uses std::from_chars when the standard library has it.
+///
+/// \param first The first character to parse.
+/// \param last One past the last character to parse.
+/// \param value Set to the parsed number, left unchanged on failure.
+/// \returns true if a number was found and fits in the type of value.
+bool ofParseNumber(const char * first, const char * last, int & value);
+bool ofParseNumber(const char * first, const char * last, unsigned int & value);
+bool ofParseNumber(const char * first, const char * last, long & value);
+bool ofParseNumber(const char * first, const char * last, unsigned long & value);
+bool ofParseNumber(const char * first, const char * last, long long & value);
+bool ofParseNumber(const char * first, const char * last, unsigned long long & value);
+bool ofParseNumber(const char * first, const char * last, float & value);
+bool ofParseNumber(const char * first, const char * last, double & value);
+
+#if OF_HAS_STRING_VIEW
+/// \brief Parse a number from a string or a part of one without allocating.
+/// \sa ofParseNumber(const char * first, const char * last, int & value)
+template <class T>
+bool ofParseNumber(std::string_view str, T & value) {
+	return ofParseNumber(str.data(), str.data() + str.size(), value);
+}
+#else
+/// \brief Parse a number from a string without allocating.
+/// \sa ofParseNumber(const char * first, const char * last, int & value)
+template <class T>
+bool ofParseNumber(const std::string & str, T & value) {
+	return ofParseNumber(str.data(), str.data() + str.size(), value);
+}
+#endif
+
 /// \brief Converts any value to its equivalent hexadecimal representation.
 ///
 /// The hexadecimal representation corresponds to the way a number is stored in
@@ -1,9 +1,89 @@
 #include "ofXml.h"
 #include "ofUtils.h"
 #include <clocale>
+#include <fstream>
+
+#ifndef TARGET_WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 using std::string;
 
+namespace{
+	// Copy on write mapping of a file, pugixml writes into the buffer while
+	// parsing in place but those writes never reach the file.
+	class ofXmlFileMapping{
+	public:
+		ofXmlFileMapping(const of::filesystem::path & path){
+#ifdef TARGET_WIN32
+			file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if(file == INVALID_HANDLE_VALUE){
+				return;
+			}
+			LARGE_INTEGER fileSize;
+			if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0){
+				return;
+			}
+			mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if(!mapping){
+				return;
+			}
+			data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+			if(data){
+				size = size_t(fileSize.QuadPart);
+			}
+#else
+			int fd = open(path.string().c_str(), O_RDONLY);
+			if(fd < 0){
+				return;
+			}
+			struct stat st;
+			if(fstat(fd, &st) == 0 && st.st_size > 0){
+				void * ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				if(ptr != MAP_FAILED){
+					data = ptr;
+					size = size_t(st.st_size);
+					madvise(data, size, MADV_SEQUENTIAL);
+				}
+			}
+			close(fd);
+#endif
+		}
+
+		~ofXmlFileMapping(){
+#ifdef TARGET_WIN32
+			if(data) UnmapViewOfFile(data);
+			if(mapping) CloseHandle(mapping);
+			if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+			if(data) munmap(data, size);
+#endif
+		}
+
+		ofXmlFileMapping(const ofXmlFileMapping &) = delete;
+		ofXmlFileMapping & operator=(const ofXmlFileMapping &) = delete;
+
+		void * data = nullptr;
+		size_t size = 0;
+#ifdef TARGET_WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#endif
+	};
+
+	// Keeps the mapping alive for as long as the document that points into it.
+	// The document is declared last so it's destroyed before the mapping.
+	struct ofXmlMappedDocument{
+		ofXmlMappedDocument(const of::filesystem::path & path)
+		:mapping(path){}
+		ofXmlFileMapping mapping;
+		pugi::xml_document doc;
+	};
+}
+
 ofXml::ofXml()
 :doc(new pugi::xml_document){
 	xml = doc->root();
@@ -29,6 +109,24 @@ bool ofXml::load(const of::filesystem::path & file){
 	}
 }
 
+bool ofXml::loadMapped(const of::filesystem::path & file){
+	auto mapped = std::make_shared<ofXmlMappedDocument>(ofToDataPath(file));
+	if(!mapped->mapping.data){
+		ofLogVerbose("ofXml") << "Cannot map file " << file << ", loading it instead";
+		return load(file);
+	}
+	auto res = mapped->doc.load_buffer_inplace(mapped->mapping.data, mapped->mapping.size);
+	if( res ){
+		// aliasing constructor: the document shares ownership of the mapping
+		doc = std::shared_ptr<pugi::xml_document>(mapped, &mapped->doc);
+		xml = doc->root();
+		return true;
+	}else{
+		ofLogWarning("ofXml") << "Cannot load file " << file << ": " << res.description();
+		return false;
+	}
+}
+
 bool ofXml::load(const ofBuffer & buffer){
 	return parse(buffer.getText());
 }
@@ -206,23 +304,80 @@ bool ofXml::removeAttribute(ofXml::Attribute && attr){
 	return xml.remove_attribute(attr.attr);
 }
 
+namespace{
+	// Visits every node matching segments below node in document order until
+	// found returns false.
+	template<typename F>
+	bool ofXmlWalkPath(const pugi::xml_node & node, const std::vector<std::string> & segments, size_t depth, F & found){
+		auto name = segments[depth].c_str();
+		for(auto child = node.child(name); child; child = child.next_sibling(name)){
+			if(depth + 1 == segments.size()){
+				if(!found(child)) return false;
+			}else if(!ofXmlWalkPath(child, segments, depth + 1, found)){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ofXmlIsNameChar(char c){
+		return isalnum((unsigned char)c) || c == '_' || c == '-' || c == '.' || c == ':' || (unsigned char)c >= 0x80;
+	}
+}
+
 ofXml ofXml::findFirst(const std::string & path) const{
+	return findFirst(Query(path));
+}
+
+ofXml::Search ofXml::find(const std::string & path) const{
+	return find(Query(path));
+}
+
+ofXml ofXml::findFirst(const Query & query) const{
+	if(!query.segments.empty()){
+		pugi::xml_node first;
+		auto found = [&](const pugi::xml_node & node){
+			first = node;
+			return false;
+		};
+		ofXmlWalkPath(this->xml, query.segments, 0, found);
+		return ofXml(doc, first);
+	}
+	if(!query.query){
+		return ofXml();
+	}
 	try{
-		return ofXml(doc, this->xml.select_node(path.c_str()).node());
+		return ofXml(doc, this->xml.select_node(*query.query).node());
 	}catch(pugi::xpath_exception & e){
 		return ofXml();
 	}
 }
 
-ofXml::Search ofXml::find(const std::string & path) const{
+ofXml::Search ofXml::find(const Query & query) const{
+	if(!query.segments.empty()){
+		std::vector<pugi::xpath_node> nodes;
+		auto found = [&](const pugi::xml_node & node){
+			nodes.emplace_back(node);
+			return true;
+		};
+		ofXmlWalkPath(this->xml, query.segments, 0, found);
+		return ofXml::Search(doc, pugi::xpath_node_set(nodes.data(), nodes.data() + nodes.size(), pugi::xpath_node_set::type_sorted));
+	}
+	if(!query.query){
+		return ofXml::Search();
+	}
 	try{
-		return ofXml::Search(doc, this->xml.select_nodes(path.c_str()));
+		return ofXml::Search(doc, this->xml.select_nodes(*query.query));
 	}catch(pugi::xpath_exception & e){
 		ofLogError() << e.what();
 		return ofXml::Search();
 	}
 }
 
+ofXml ofXml::getChildByPath(const std::string & path) const{
+	return ofXml(doc, this->xml.first_element_by_path(path.c_str()));
+}
+
 std::string ofXml::getValue() const{
 	return this->xml.text().as_string();
 }
@@ -331,6 +486,53 @@ ofXml::Attribute ofXml::Attribute::getPreviousAttribute() const{
 }
 
 
+//-----------------------------------------------
+// Query
+
+ofXml::Query::Query(const std::string & path)
+:path(path){
+	// a/b/c made only of element names is walked directly, anything else
+	// (axes, predicates, functions, absolute paths...) goes through XPath
+	bool childPath = !path.empty();
+	size_t start = 0;
+	for(size_t i = 0; i <= path.size() && childPath; i++){
+		if(i == path.size() || path[i] == '/'){
+			auto segment = path.substr(start, i - start);
+			childPath = !segment.empty() && !isdigit((unsigned char)segment[0]) && segment[0] != '-' && segment[0] != '.';
+			segments.push_back(segment);
+			start = i + 1;
+		}else{
+			childPath = ofXmlIsNameChar(path[i]);
+		}
+	}
+	if(childPath){
+		return;
+	}
+	segments.clear();
+	try{
+		query = std::make_shared<pugi::xpath_query>(path.c_str());
+		if(!*query){
+			ofLogError("ofXml") << "Cannot compile query " << path << ": " << query->result().description();
+			query.reset();
+		}
+	}catch(pugi::xpath_exception & e){
+		ofLogError("ofXml") << "Cannot compile query " << path << ": " << e.what();
+		query.reset();
+	}
+}
+
+const std::string & ofXml::Query::getPath() const{
+	return path;
+}
+
+bool ofXml::Query::isChildPath() const{
+	return !segments.empty();
+}
+
+ofXml::Query::operator bool() const{
+	return !segments.empty() || query;
+}
+
 //-----------------------------------------------
 // Search
 
@@ -439,6 +641,328 @@ ofXmlSearchIterator ofXmlSearchIterator::operator--(int){
 	}
 }
 
+//----------------------------------------------------
+// SAX parser
+namespace{
+	void ofXmlAppendUtf8(std::string & out, uint32_t cp){
+		if(cp < 0x80){
+			out += char(cp);
+		}else if(cp < 0x800){
+			out += char(0xC0 | (cp >> 6));
+			out += char(0x80 | (cp & 0x3F));
+		}else if(cp < 0x10000){
+			out += char(0xE0 | (cp >> 12));
+			out += char(0x80 | ((cp >> 6) & 0x3F));
+			out += char(0x80 | (cp & 0x3F));
+		}else{
+			out += char(0xF0 | (cp >> 18));
+			out += char(0x80 | ((cp >> 12) & 0x3F));
+			out += char(0x80 | ((cp >> 6) & 0x3F));
+			out += char(0x80 | (cp & 0x3F));
+		}
+	}
+
+	// Parses the digits of a numeric character reference, &#65; or &#x41;.
+	// Only digits are accepted, no whitespace, sign or empty number, and the
+	// code point has to be a unicode scalar value other than 0.
+	bool ofXmlParseCharRef(const char * begin, const char * end, uint32_t & cp){
+		int base = 10;
+		if(begin < end && (*begin == 'x' || *begin == 'X')){
+			base = 16;
+			begin++;
+		}
+		if(begin == end){
+			return false;
+		}
+		cp = 0;
+		for(; begin < end; begin++){
+			uint32_t digit;
+			if(*begin >= '0' && *begin <= '9'){
+				digit = *begin - '0';
+			}else if(base == 16 && *begin >= 'a' && *begin <= 'f'){
+				digit = *begin - 'a' + 10;
+			}else if(base == 16 && *begin >= 'A' && *begin <= 'F'){
+				digit = *begin - 'A' + 10;
+			}else{
+				return false;
+			}
+			cp = cp * base + digit;
+			if(cp > 0x10FFFF){
+				return false;
+			}
+		}
+		return cp != 0 && (cp < 0xD800 || cp > 0xDFFF);
+	}
+
+	// Decodes the predefined and numeric character references, unknown
+	// entities and invalid references are copied verbatim like pugixml does.
+	void ofXmlDecodeEntities(const char * begin, const char * end, std::string & out){
+		out.clear();
+		out.reserve(end - begin);
+		while(begin < end){
+			auto amp = static_cast<const char*>(memchr(begin, '&', end - begin));
+			if(!amp){
+				out.append(begin, end);
+				return;
+			}
+			out.append(begin, amp);
+			auto semicolon = static_cast<const char*>(memchr(amp, ';', end - amp));
+			if(!semicolon){
+				out.append(amp, end);
+				return;
+			}
+			std::string entity(amp + 1, semicolon);
+			if(entity == "lt") out += '<';
+			else if(entity == "gt") out += '>';
+			else if(entity == "amp") out += '&';
+			else if(entity == "quot") out += '"';
+			else if(entity == "apos") out += '\'';
+			else if(entity.size() > 1 && entity[0] == '#'){
+				uint32_t cp;
+				if(ofXmlParseCharRef(amp + 2, semicolon, cp)){
+					ofXmlAppendUtf8(out, cp);
+				}else{
+					out.append(amp, semicolon + 1);
+				}
+			}else{
+				out.append(amp, semicolon + 1);
+			}
+			begin = semicolon + 1;
+		}
+	}
+
+	bool ofXmlIsSpace(char c){
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	class ofXmlSaxReader{
+	public:
+		ofXmlSaxReader(std::istream & stream, ofXmlSaxHandler & handler, size_t chunkSize)
+		:stream(stream)
+		,handler(handler)
+		,chunkSize(std::max<size_t>(chunkSize, 1)){}
+
+		bool parse(){
+			// a UTF-8 byte order mark is accepted like pugixml does for load()
+			if(startsWith("\xEF\xBB\xBF")){
+				pos += 3;
+			}
+			bool foundRoot = false;
+			while(ensure(1)){
+				if(buffer[pos] != '<'){
+					if(!readText(foundRoot)) return false;
+				}else if(startsWith("<!--")){
+					if(!skipPast("-->")) return error("unterminated comment");
+				}else if(startsWith("<![CDATA[")){
+					if(open.empty()) return error("CDATA outside of the document element");
+					auto end = find("]]>", 9);
+					if(end == std::string::npos) return error("unterminated CDATA section");
+					text.assign(buffer, pos + 9, end - 9);
+					pos += end + 3;
+					if(!handler.text(text)) return false;
+				}else if(startsWith("<?")){
+					if(!skipPast("?>")) return error("unterminated processing instruction");
+				}else if(startsWith("<!")){
+					auto end = findTagEnd(true);
+					if(end == std::string::npos) return error("unterminated declaration");
+					pos += end + 1;
+				}else if(startsWith("</")){
+					if(!readEndTag()) return false;
+				}else{
+					if(open.empty() && foundRoot) return error("multiple document elements");
+					foundRoot = true;
+					if(!readStartTag()) return false;
+				}
+			}
+			if(!open.empty()) return error("unexpected end of document, missing </" + open.back() + ">");
+			if(!foundRoot) return error("no document element found");
+			return true;
+		}
+
+	private:
+		// Reads another chunk, first discarding the already parsed prefix of
+		// the buffer so it never grows past the token being parsed.
+		bool fill(){
+			if(pos > 0){
+				buffer.erase(0, pos);
+				consumed += pos;
+				pos = 0;
+			}
+			if(!stream){
+				return false;
+			}
+			auto size = buffer.size();
+			buffer.resize(size + chunkSize);
+			stream.read(&buffer[size], chunkSize);
+			auto read = size_t(stream.gcount());
+			buffer.resize(size + read);
+			return read > 0;
+		}
+
+		bool ensure(size_t n){
+			while(buffer.size() - pos < n){
+				if(!fill()) return false;
+			}
+			return true;
+		}
+
+		bool startsWith(const char * token){
+			auto len = strlen(token);
+			return ensure(len) && buffer.compare(pos, len, token) == 0;
+		}
+
+		// Offsets are relative to pos so they survive fill()
+		size_t find(const char * token, size_t from){
+			auto len = strlen(token);
+			while(true){
+				auto found = buffer.find(token, pos + from);
+				if(found != std::string::npos){
+					return found - pos;
+				}
+				auto available = buffer.size() - pos;
+				from = available >= len ? available - len + 1 : 0;
+				if(!fill()) return std::string::npos;
+			}
+		}
+
+		bool skipPast(const char * token){
+			auto end = find(token, 2);
+			if(end == std::string::npos) return false;
+			pos += end + strlen(token);
+			return true;
+		}
+
+		// Finds the closing '>' of a tag skipping quoted values, and for the
+		// doctype also its internal subset between brackets.
+		size_t findTagEnd(bool brackets){
+			char quote = 0;
+			int depth = 0;
+			size_t i = 1;
+			while(true){
+				for(; pos + i < buffer.size(); ++i){
+					char c = buffer[pos + i];
+					if(quote){
+						if(c == quote) quote = 0;
+					}else if(c == '"' || c == '\''){
+						quote = c;
+					}else if(brackets && c == '['){
+						++depth;
+					}else if(brackets && c == ']'){
+						--depth;
+					}else if(c == '>' && depth <= 0){
+						return i;
+					}
+				}
+				if(!fill()) return std::string::npos;
+			}
+		}
+
+		bool readText(bool foundRoot){
+			auto end = find("<", 0);
+			auto len = end == std::string::npos ? buffer.size() - pos : end;
+			const char * begin = buffer.data() + pos;
+			bool whitespace = std::all_of(begin, begin + len, ofXmlIsSpace);
+			if(!whitespace){
+				if(open.empty()){
+					return error(foundRoot ? "text after the document element" : "text before the document element");
+				}
+				ofXmlDecodeEntities(begin, begin + len, text);
+			}
+			pos += len;
+			return whitespace || handler.text(text);
+		}
+
+		bool readStartTag(){
+			auto end = findTagEnd(false);
+			if(end == std::string::npos) return error("unterminated start tag");
+			const char * c = buffer.data() + pos + 1;
+			const char * tagEnd = buffer.data() + pos + end;
+			bool selfClosing = tagEnd > c && *(tagEnd - 1) == '/';
+			if(selfClosing) --tagEnd;
+
+			const char * nameEnd = c;
+			while(nameEnd < tagEnd && !ofXmlIsSpace(*nameEnd)) ++nameEnd;
+			if(nameEnd == c) return error("missing element name");
+			name.assign(c, nameEnd);
+
+			attributes.clear();
+			c = nameEnd;
+			while(true){
+				while(c < tagEnd && ofXmlIsSpace(*c)) ++c;
+				if(c == tagEnd) break;
+				const char * attrNameEnd = c;
+				while(attrNameEnd < tagEnd && *attrNameEnd != '=' && !ofXmlIsSpace(*attrNameEnd)) ++attrNameEnd;
+				std::string attrName(c, attrNameEnd);
+				c = attrNameEnd;
+				while(c < tagEnd && ofXmlIsSpace(*c)) ++c;
+				if(c == tagEnd || *c != '=') return error("attribute " + attrName + " of <" + name + "> has no value");
+				++c;
+				while(c < tagEnd && ofXmlIsSpace(*c)) ++c;
+				if(c == tagEnd || (*c != '"' && *c != '\'')) return error("attribute " + attrName + " of <" + name + "> is not quoted");
+				const char * valueEnd = static_cast<const char*>(memchr(c + 1, *c, tagEnd - c - 1));
+				if(!valueEnd) return error("attribute " + attrName + " of <" + name + "> is not terminated");
+				attributes.emplace_back(std::move(attrName), std::string());
+				ofXmlDecodeEntities(c + 1, valueEnd, attributes.back().second);
+				c = valueEnd + 1;
+			}
+			pos += end + 1;
+
+			if(!handler.startElement(name, attributes)) return false;
+			if(selfClosing){
+				return handler.endElement(name);
+			}
+			open.push_back(name);
+			return true;
+		}
+
+		bool readEndTag(){
+			auto end = findTagEnd(false);
+			if(end == std::string::npos) return error("unterminated end tag");
+			const char * begin = buffer.data() + pos + 2;
+			const char * tagEnd = buffer.data() + pos + end;
+			while(tagEnd > begin && ofXmlIsSpace(*(tagEnd - 1))) --tagEnd;
+			name.assign(begin, tagEnd);
+			if(open.empty() || open.back() != name){
+				return error("unexpected end tag </" + name + ">");
+			}
+			open.pop_back();
+			pos += end + 1;
+			return handler.endElement(name);
+		}
+
+		bool error(const std::string & message){
+			auto offset = consumed + pos;
+			ofLogWarning("ofXml") << "SAX parse error at offset " << offset << ": " << message;
+			handler.error(message, offset);
+			return false;
+		}
+
+		std::istream & stream;
+		ofXmlSaxHandler & handler;
+		size_t chunkSize;
+		std::string buffer;
+		size_t pos = 0;
+		size_t consumed = 0;
+		std::vector<std::string> open;
+		ofXmlSaxAttributes attributes;
+		std::string name;
+		std::string text;
+	};
+}
+
+bool ofXmlSaxParse(std::istream & stream, ofXmlSaxHandler & handler, size_t chunkSize){
+	return ofXmlSaxReader(stream, handler, chunkSize).parse();
+}
+
+bool ofXmlSaxParse(const of::filesystem::path & file, ofXmlSaxHandler & handler, size_t chunkSize){
+	std::ifstream stream(ofToDataPath(file), std::ios::binary);
+	if(!stream){
+		ofLogWarning("ofXml") << "Cannot open file " << file;
+		return false;
+	}
+	return ofXmlSaxParse(stream, handler, chunkSize);
+}
+
 void ofSerialize(ofXml & xml, const ofAbstractParameter & parameter){
 	if(!parameter.isSerializable()){
 		return;
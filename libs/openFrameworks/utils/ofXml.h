@@ -77,6 +77,31 @@ public:
 		friend class ofXml;
 	};
 
+	/// \brief A path expression compiled once and reusable across calls and
+	/// documents by find() and findFirst().
+	///
+	/// Plain child paths like "a/b/c" are split into their element names and
+	/// walked directly without going through XPath at all, any other
+	/// expression is compiled into a pugi::xpath_query.
+	class Query{
+	public:
+		Query(){}
+		explicit Query(const std::string & path);
+
+		const std::string & getPath() const;
+
+		// True if the path was a plain child path that skips XPath
+		bool isChildPath() const;
+
+		// False if the expression couldn't be compiled
+		operator bool() const;
+	private:
+		std::string path;
+		std::vector<std::string> segments;
+		std::shared_ptr<pugi::xpath_query> query;
+		friend class ofXml;
+	};
+
 	template<class It>
 	class Range{
 	public:
@@ -101,6 +126,15 @@ public:
 
 	bool load(const of::filesystem::path & file);
 	bool load(const ofBuffer & buffer);
+
+	/// \brief Load a file by memory mapping it and parsing it in place.
+	///
+	/// Names and values reference the mapped file directly instead of
+	/// being copied into the document, so large files load faster and
+	/// with roughly half the peak memory of load(). The mapping is
+	/// private: modifying the document never touches the file on disk.
+	/// Falls back to load() when the file can't be mapped.
+	bool loadMapped(const of::filesystem::path & file);
 	bool parse(const std::string & xmlStr);
 	bool save(const of::filesystem::path & file) const;
 	void clear();
@@ -160,6 +194,12 @@ public:
 
 	ofXml findFirst(const std::string & path) const;
 	Search find(const std::string & path) const;
+	ofXml findFirst(const Query & query) const;
+	Search find(const Query & query) const;
+
+	/// \brief Get the first descendant following a "a/b/c" style path of
+	/// element names, without compiling an XPath expression.
+	ofXml getChildByPath(const std::string & path) const;
 
 	template<typename T>
 	T getValue() const{
@@ -403,6 +443,32 @@ private:
 	mutable ofXml xml;
 	friend ofXml::Search;
 };
+/// \brief Attributes of an element as reported to an ofXmlSaxHandler,
+/// in document order and with entities already decoded.
+using ofXmlSaxAttributes = std::vector<std::pair<std::string, std::string>>;
+
+/// \brief Receives events from ofXmlSaxParse as a document is read.
+///
+/// Every callback can return false to stop parsing early. Whitespace only
+/// text, comments, processing instructions and the doctype are skipped.
+class ofXmlSaxHandler{
+public:
+	virtual ~ofXmlSaxHandler(){}
+	virtual bool startElement(const std::string &, const ofXmlSaxAttributes &){ return true; }
+	virtual bool endElement(const std::string &){ return true; }
+	virtual bool text(const std::string &){ return true; }
+	virtual void error(const std::string &, size_t){}
+};
+
+/// \brief Read an xml document incrementally, forwarding its contents to
+/// handler instead of building a DOM.
+///
+/// Memory use is bounded by chunkSize plus the largest single tag or text
+/// node, independently of the size of the whole document.
+/// \returns true if the whole document was read and is well formed.
+bool ofXmlSaxParse(std::istream & stream, ofXmlSaxHandler & handler, size_t chunkSize = 64 * 1024);
+bool ofXmlSaxParse(const of::filesystem::path & file, ofXmlSaxHandler & handler, size_t chunkSize = 64 * 1024);
+
 // serializer
 void ofSerialize(ofXml & xml, const ofAbstractParameter & parameter);
 void ofDeserialize(const ofXml & xml, ofAbstractParameter & parameter);
@@ -837,6 +837,151 @@ uint64_t ofGstUtils::getMaxLatencyNanos() const{
 
 
 
+#if GST_VERSION_MAJOR>0
+//-------------------------------------------------
+//----------------------------------------- videoFrame
+//-------------------------------------------------
+
+static std::atomic<uint64_t> numFramePixelCopies{0};
+
+ofGstVideoFrame::ofGstVideoFrame(shared_ptr<GstSample> sample, uint64_t frameNumber)
+:sample(sample)
+,frame()
+,mapped(false)
+,padded(false)
+,pixelFormat(OF_PIXELS_UNKNOWN)
+,timestamp(-1)
+,duration(-1)
+,receivedTime(ofGetElapsedTimeMicros())
+,frameNumber(frameNumber){
+	GstBuffer * buffer = gst_sample_get_buffer(sample.get());
+	GstCaps * caps = gst_sample_get_caps(sample.get());
+	GstVideoInfo info;
+	if(!buffer || !caps || !gst_video_info_from_caps(&info, caps)){
+		ofLogError("ofGstVideoFrame") << "couldn't get the video info of the sample";
+		return;
+	}
+	if(!gst_video_frame_map(&frame, &info, buffer, GST_MAP_READ)){
+		ofLogError("ofGstVideoFrame") << "couldn't map the sample buffer";
+		return;
+	}
+	mapped = true;
+	pixelFormat = ofGstVideoUtils::getOFFormat(GST_VIDEO_FRAME_FORMAT(&frame));
+	if(GST_BUFFER_PTS_IS_VALID(buffer)){
+		timestamp = GST_BUFFER_PTS(buffer);
+	}
+	if(GST_BUFFER_DURATION_IS_VALID(buffer)){
+		duration = GST_BUFFER_DURATION(buffer);
+	}
+
+	// the buffer can only be wrapped if it has the same layout as ofPixels:
+	// no padding at the end of the rows and the planes one after the other
+	size_t width = getWidth();
+	size_t height = getHeight();
+	padded = GST_VIDEO_FRAME_SIZE(&frame) != ofPixels::bytesFromPixelFormat(width, height, pixelFormat);
+	if(getNumPlanes() == 1){
+		padded |= getPlaneStride(0) != width * GST_VIDEO_FRAME_COMP_PSTRIDE(&frame, 0);
+	}
+	for(size_t i = 1; i < getNumPlanes(); i++){
+		size_t previousHeight = GST_VIDEO_FRAME_COMP_HEIGHT(&frame, i - 1);
+		padded |= getPlaneData(i) != getPlaneData(i - 1) + getPlaneStride(i - 1) * previousHeight;
+	}
+	if(!padded){
+		pixels.setFromExternalPixels(const_cast<unsigned char*>(getPlaneData(0)), width, height, pixelFormat);
+	}
+}
+
+ofGstVideoFrame::~ofGstVideoFrame(){
+	release();
+}
+
+void ofGstVideoFrame::release(){
+	if(mapped){
+		gst_video_frame_unmap(&frame);
+		mapped = false;
+	}
+	pixels.clear();
+	sample.reset();
+}
+
+bool ofGstVideoFrame::isMapped() const{
+	return mapped;
+}
+
+const ofPixels & ofGstVideoFrame::getPixels() const{
+	// the frame can be shared between threads, only the first call copies
+	// and the others wait for it
+	if(mapped && padded){
+		std::call_once(pixelsCopied, [this]{
+			pixels.allocate(getWidth(), getHeight(), pixelFormat);
+			for(size_t i = 0; i < pixels.getNumPlanes() && i < getNumPlanes(); i++){
+				auto plane = pixels.getPlane(i);
+				size_t rowBytes = plane.getBytesStride();
+				const unsigned char * src = getPlaneData(i);
+				size_t srcStride = getPlaneStride(i);
+				for(size_t y = 0; y < plane.getHeight(); y++){
+					memcpy(plane.getData() + y * rowBytes, src + y * srcStride, rowBytes);
+				}
+			}
+			numFramePixelCopies++;
+		});
+	}
+	return pixels;
+}
+
+bool ofGstVideoFrame::hasPaddedRows() const{
+	return padded;
+}
+
+size_t ofGstVideoFrame::getNumPlanes() const{
+	return mapped ? GST_VIDEO_FRAME_N_PLANES(&frame) : 0;
+}
+
+const unsigned char * ofGstVideoFrame::getPlaneData(size_t plane) const{
+	return mapped ? static_cast<const unsigned char*>(GST_VIDEO_FRAME_PLANE_DATA(&frame, plane)) : nullptr;
+}
+
+size_t ofGstVideoFrame::getPlaneStride(size_t plane) const{
+	return mapped ? GST_VIDEO_FRAME_PLANE_STRIDE(&frame, plane) : 0;
+}
+
+size_t ofGstVideoFrame::getWidth() const{
+	return GST_VIDEO_FRAME_WIDTH(&frame);
+}
+
+size_t ofGstVideoFrame::getHeight() const{
+	return GST_VIDEO_FRAME_HEIGHT(&frame);
+}
+
+ofPixelFormat ofGstVideoFrame::getPixelFormat() const{
+	return pixelFormat;
+}
+
+int64_t ofGstVideoFrame::getTimestampNanos() const{
+	return timestamp;
+}
+
+int64_t ofGstVideoFrame::getDurationNanos() const{
+	return duration;
+}
+
+uint64_t ofGstVideoFrame::getReceivedTimeMicros() const{
+	return receivedTime;
+}
+
+uint64_t ofGstVideoFrame::getFrameNumber() const{
+	return frameNumber;
+}
+
+GstSample * ofGstVideoFrame::getSample() const{
+	return sample.get();
+}
+
+uint64_t ofGstVideoFrame::getNumPixelCopies(){
+	return numFramePixelCopies;
+}
+#endif
+
 //-------------------------------------------------
 //----------------------------------------- videoUtils
 //-------------------------------------------------
@@ -857,6 +1002,16 @@ ofGstVideoUtils::ofGstVideoUtils(){
 	glContext = NULL;
 #endif
 	copyPixels = false;
+#if GST_VERSION_MAJOR>0
+	frameQueueSize = 0;
+	lastQueuedBuffer = nullptr;
+	lastQueuedTimestamp = GST_CLOCK_TIME_NONE;
+#endif
+	numFramesReceived = 0;
+	numFramesDropped = 0;
+	numFramesCopied = 0;
+	decodeLatency = 0;
+	maxDecodeLatency = 0;
 }
 
 ofGstVideoUtils::~ofGstVideoUtils(){
@@ -877,7 +1032,17 @@ void ofGstVideoUtils::close(){
 	
 #if GST_VERSION_MAJOR==1
 	while(!bufferQueue.empty()) bufferQueue.pop();
+	frameQueue.clear();
+	frontFrame.reset();
+	backFrame.reset();
+	lastQueuedBuffer = nullptr;
+	lastQueuedTimestamp = GST_CLOCK_TIME_NONE;
 #endif
+	numFramesReceived = 0;
+	numFramesDropped = 0;
+	numFramesCopied = 0;
+	decodeLatency = 0;
+	maxDecodeLatency = 0;
 }
 
 bool ofGstVideoUtils::isInitialized() const{
@@ -913,6 +1078,20 @@ void ofGstVideoUtils::update(){
 		if(!isFrameByFrame()){
 			std::unique_lock<std::mutex> lock(mutex);
 			bHavePixelsChanged = bBackPixelsChanged;
+#if GST_VERSION_MAJOR>0
+			if (bHavePixelsChanged && backFrame){
+				// with the frame queue the pixels just point to the newest frame
+				bBackPixelsChanged=false;
+				auto newFrame = std::move(backFrame);
+				lock.unlock();
+				if(newFrame->hasPaddedRows()){
+					numFramesCopied++;
+				}
+				auto & framePixels = newFrame->getPixels();
+				pixels.setFromExternalPixels(const_cast<unsigned char*>(framePixels.getData()),framePixels.getWidth(),framePixels.getHeight(),framePixels.getPixelFormat());
+				frontFrame = newFrame;
+			}else
+#endif
 			if (bHavePixelsChanged){
 				bBackPixelsChanged=false;
 				std::swap(pixels,backPixels);
@@ -1258,6 +1437,9 @@ void ofGstVideoUtils::reallocateOnNextFrame(){
 	backBuffer.reset();
 #if GST_VERSION_MAJOR==1
 	while(!bufferQueue.empty()) bufferQueue.pop();
+	frameQueue.clear();
+	frontFrame.reset();
+	backFrame.reset();
 #endif
 }
 
@@ -1354,6 +1536,21 @@ GstFlowReturn ofGstVideoUtils::process_sample(shared_ptr<GstSample> sample){
 	}
 #endif
 
+	if(pixels.isAllocated()){
+		updateDecodeLatency(sample.get());
+	}
+
+	if(frameQueueSize > 0 && pixels.isAllocated()){
+		// appsink hands the first buffer both as preroll and as sample
+		GstClockTime timestamp = GST_BUFFER_PTS(_buffer);
+		if(_buffer == lastQueuedBuffer && timestamp == lastQueuedTimestamp){
+			return GST_FLOW_OK;
+		}
+		lastQueuedBuffer = _buffer;
+		lastQueuedTimestamp = timestamp;
+		return queueFrame(sample);
+	}
+
 	// video frame has normal texture
 	gst_buffer_map (_buffer, &mapinfo, GST_MAP_READ);
 	guint size = mapinfo.size;
@@ -1374,6 +1571,13 @@ GstFlowReturn ofGstVideoUtils::process_sample(shared_ptr<GstSample> sample){
 	}
 
 	if(pixels.isAllocated()){
+		numFramesReceived++;
+		if(bBackPixelsChanged){
+			numFramesDropped++;
+		}
+		if(stride > 0 || copyPixels){
+			numFramesCopied++;
+		}
 		if(stride > 0) {
 			if(pixels.getPixelFormat() == OF_PIXELS_I420){
 				GstVideoInfo v_info = getVideoInfo(sample.get());
@@ -1408,6 +1612,132 @@ GstFlowReturn ofGstVideoUtils::process_sample(shared_ptr<GstSample> sample){
 }
 #endif
 
+#if GST_VERSION_MAJOR>0
+GstFlowReturn ofGstVideoUtils::queueFrame(shared_ptr<GstSample> sample){
+	auto frame = std::make_shared<ofGstVideoFrame>(sample, numFramesReceived++);
+	if(!frame->isMapped()){
+		return GST_FLOW_ERROR;
+	}
+
+	mutex.lock();
+	frameQueue.push_back(frame);
+	while(frameQueue.size() > frameQueueSize){
+		frameQueue.pop_front();
+		numFramesDropped++;
+	}
+	backFrame = frame;
+	bBackPixelsChanged = true;
+	mutex.unlock();
+
+	// padded frames are only copied when someone listens, the copy stays
+	// with the frame so getPixels() won't copy them again
+	if(!frame->hasPaddedRows() || prerollEvent.size() > 0){
+		auto & framePixels = frame->getPixels();
+		eventPixels.setFromExternalPixels(const_cast<unsigned char*>(framePixels.getData()),framePixels.getWidth(),framePixels.getHeight(),framePixels.getPixelFormat());
+		ofNotifyEvent(prerollEvent,eventPixels);
+	}
+	return GST_FLOW_OK;
+}
+
+void ofGstVideoUtils::setFrameQueueSize(size_t numFrames){
+	bool modeChanged = (numFrames > 0) != (frameQueueSize > 0);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		frameQueueSize = numFrames;
+		while(frameQueue.size() > frameQueueSize){
+			frameQueue.pop_front();
+		}
+		if(frameQueueSize == 0){
+			backFrame.reset();
+		}
+	}
+
+	// the pixels might point to a frame or to a buffer that is not a frame,
+	// start again from the pixels' own memory
+	if(modeChanged && pixels.isAllocated()){
+		allocate(pixels.getWidth(), pixels.getHeight(), pixels.getPixelFormat());
+		frontFrame.reset();
+	}
+}
+
+size_t ofGstVideoUtils::getFrameQueueSize() const{
+	return frameQueueSize;
+}
+
+shared_ptr<ofGstVideoFrame> ofGstVideoUtils::popFrame(){
+	std::unique_lock<std::mutex> lock(mutex);
+	if(frameQueue.empty()){
+		return nullptr;
+	}
+	auto frame = std::move(frameQueue.front());
+	frameQueue.pop_front();
+	return frame;
+}
+
+size_t ofGstVideoUtils::popFrames(std::vector<shared_ptr<ofGstVideoFrame>> & frames){
+	std::unique_lock<std::mutex> lock(mutex);
+	size_t numFrames = frameQueue.size();
+	std::move(frameQueue.begin(), frameQueue.end(), std::back_inserter(frames));
+	frameQueue.clear();
+	return numFrames;
+}
+
+size_t ofGstVideoUtils::getNumQueuedFrames() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return frameQueue.size();
+}
+#endif
+
+uint64_t ofGstVideoUtils::getNumFramesReceived() const{
+	return numFramesReceived;
+}
+
+uint64_t ofGstVideoUtils::getNumFramesDropped() const{
+	return numFramesDropped;
+}
+
+uint64_t ofGstVideoUtils::getNumFramesCopied() const{
+	return numFramesCopied;
+}
+
+uint64_t ofGstVideoUtils::getDecodeLatencyMicros() const{
+	return decodeLatency;
+}
+
+uint64_t ofGstVideoUtils::getMaxDecodeLatencyMicros() const{
+	return maxDecodeLatency;
+}
+
+void ofGstVideoUtils::updateDecodeLatency(GstSample * sample){
+	// the base time and clock are only meaningful while playing
+	GstElement * pipeline = getPipeline();
+	if(!pipeline || GST_STATE(pipeline) != GST_STATE_PLAYING){
+		return;
+	}
+	GstBuffer * buffer = gst_sample_get_buffer(sample);
+	GstSegment * segment = gst_sample_get_segment(sample);
+	if(!buffer || !segment || !GST_BUFFER_PTS_IS_VALID(buffer) || segment->format != GST_FORMAT_TIME){
+		return;
+	}
+	GstClock * clock = gst_element_get_clock(pipeline);
+	if(!clock){
+		return;
+	}
+	GstClockTime now = gst_clock_get_time(clock);
+	gst_object_unref(clock);
+	GstClockTime baseTime = gst_element_get_base_time(pipeline);
+	guint64 runningTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+	if(runningTime == GST_CLOCK_TIME_NONE || now < baseTime + runningTime){
+		decodeLatency = decodeLatency * 15 / 16;
+		return;
+	}
+	uint64_t latency = (now - baseTime - runningTime) / 1000;
+	decodeLatency = (decodeLatency * 15 + latency) / 16;
+	if(latency > maxDecodeLatency){
+		maxDecodeLatency = latency;
+	}
+}
+
 #if GST_VERSION_MAJOR==0
 GstFlowReturn ofGstVideoUtils::preroll_cb(shared_ptr<GstBuffer> buffer){
 	GstFlowReturn ret = process_buffer(buffer);
@@ -11,6 +11,8 @@
 #include <gst/gstpad.h>
 #include <gst/video/video.h>
 #include <queue>
+#include <deque>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 
@@ -149,6 +151,74 @@ private:
 
 
 
+#if GST_VERSION_MAJOR>0
+//-------------------------------------------------
+//----------------------------------------- videoFrame
+//-------------------------------------------------
+
+/// a decoded video frame that keeps the GstSample it came from mapped
+///
+/// the pixels point straight into the gstreamer buffer so nothing is
+/// copied, which also means that upstream elements can't reuse the buffer
+/// until the frame is released, either by calling release() or when the
+/// last shared_ptr to it goes away
+class ofGstVideoFrame{
+public:
+	ofGstVideoFrame(std::shared_ptr<GstSample> sample, uint64_t frameNumber);
+	~ofGstVideoFrame();
+
+	ofGstVideoFrame(const ofGstVideoFrame&) = delete;
+	ofGstVideoFrame & operator=(const ofGstVideoFrame&) = delete;
+
+	/// unmap the buffer and give it back to gstreamer, the frame can't
+	/// be used after this
+	void release();
+	bool isMapped() const;
+
+	/// the pixels of the frame, if the buffer has padding at the end of
+	/// the rows they are copied the first time this is called. can be
+	/// called from several threads at once
+	const ofPixels & getPixels() const;
+	bool hasPaddedRows() const;
+
+	/// direct access to the mapped planes, never copies
+	size_t getNumPlanes() const;
+	const unsigned char * getPlaneData(size_t plane=0) const;
+	size_t getPlaneStride(size_t plane=0) const;
+
+	size_t getWidth() const;
+	size_t getHeight() const;
+	ofPixelFormat getPixelFormat() const;
+
+	/// presentation timestamp of the buffer in the stream, -1 if unknown
+	int64_t getTimestampNanos() const;
+	/// duration of the buffer, -1 if unknown
+	int64_t getDurationNanos() const;
+	/// ofGetElapsedTimeMicros() when the frame arrived from the pipeline
+	uint64_t getReceivedTimeMicros() const;
+	/// position of the frame in the order frames arrived since the pipeline was set
+	uint64_t getFrameNumber() const;
+
+	GstSample * getSample() const;
+
+	/// number of times getPixels() had to copy padded rows, for all frames
+	static uint64_t getNumPixelCopies();
+
+private:
+	std::shared_ptr<GstSample> sample;
+	GstVideoFrame frame;
+	bool mapped;
+	bool padded;
+	mutable ofPixels pixels;
+	mutable std::once_flag pixelsCopied;
+	ofPixelFormat pixelFormat;
+	int64_t timestamp;
+	int64_t duration;
+	uint64_t receivedTime;
+	uint64_t frameNumber;
+};
+#endif
+
 //-------------------------------------------------
 //----------------------------------------- videoUtils
 //-------------------------------------------------
@@ -189,6 +259,46 @@ public:
 	// https://bugzilla.gnome.org/show_bug.cgi?id=737427
 	void setCopyPixels(bool copy);
 
+#if GST_VERSION_MAJOR>0
+	/// keep the numFrames most recent frames in a queue that the app can
+	/// pop from, 0 (the default) disables it
+	///
+	/// frames hold the mapped gstreamer buffers so they are delivered
+	/// without copies, getPixels() also points to the most recent one
+	/// after update() instead of being swapped with a back buffer. when
+	/// the queue is full the oldest frame is dropped.
+	///
+	/// keep in mind that every queued or used frame holds a buffer that
+	/// upstream elements like decoders or cameras may have a limited
+	/// number of, release them as soon as possible
+	void setFrameQueueSize(size_t numFrames);
+	size_t getFrameQueueSize() const;
+
+	/// get the oldest frame in the queue, nullptr if it's empty
+	std::shared_ptr<ofGstVideoFrame> popFrame();
+
+	/// move all the queued frames, oldest first, to the end of frames
+	/// returns the number of frames added
+	size_t popFrames(std::vector<std::shared_ptr<ofGstVideoFrame>> & frames);
+
+	size_t getNumQueuedFrames() const;
+#endif
+
+	/// frames received from the pipeline since it was set
+	uint64_t getNumFramesReceived() const;
+
+	/// frames that were replaced before update() or popFrame() got to them
+	uint64_t getNumFramesDropped() const;
+
+	/// frames whose pixels had to be copied because of padding or setCopyPixels()
+	uint64_t getNumFramesCopied() const;
+
+	/// how late frames arrive at the sink compared to their presentation
+	/// time while playing, averaged over the last frames. the sink waits
+	/// for frames that are early so this is ~0 unless decoding falls behind
+	uint64_t getDecodeLatencyMicros() const;
+	uint64_t getMaxDecodeLatencyMicros() const;
+
 	// this events happen in a different thread
 	// do not use them for opengl stuff
 	ofEvent<ofPixels> prerollEvent;
@@ -202,6 +312,8 @@ protected:
 	GstFlowReturn buffer_cb(std::shared_ptr<GstBuffer> buffer);
 #else
 	GstFlowReturn process_sample(std::shared_ptr<GstSample> sample);
+	GstFlowReturn queueFrame(std::shared_ptr<GstSample> sample);
+	void updateDecodeLatency(GstSample * sample);
 	GstFlowReturn preroll_cb(std::shared_ptr<GstSample> buffer);
 	GstFlowReturn buffer_cb(std::shared_ptr<GstSample> buffer);
 #endif
@@ -216,19 +328,29 @@ private:
 	bool			bIsFrameNew;			// if we are new
 	bool			bHavePixelsChanged;
 	bool			bBackPixelsChanged;
-	std::mutex		mutex;
+	mutable std::mutex	mutex;
 #if GST_VERSION_MAJOR==0
 	std::shared_ptr<GstBuffer> 	frontBuffer, backBuffer;
 #else
 	std::shared_ptr<GstSample> 	frontBuffer, backBuffer;
 	std::queue<std::shared_ptr<GstSample> > bufferQueue;
 	GstMapInfo mapinfo;
+	std::deque<std::shared_ptr<ofGstVideoFrame>> frameQueue;
+	std::shared_ptr<ofGstVideoFrame> frontFrame, backFrame;
+	std::atomic<size_t> frameQueueSize; // read by the streaming thread without the mutex
+	GstBuffer * lastQueuedBuffer;
+	GstClockTime lastQueuedTimestamp;
 	#ifdef OF_USE_GST_GL
 		ofTexture		frontTexture, backTexture;
 	#endif
 #endif
 	ofPixelFormat	internalPixelFormat;
 	bool copyPixels; // fix for certain versions bug with v4l2
+	std::atomic<uint64_t> numFramesReceived;
+	std::atomic<uint64_t> numFramesDropped;
+	std::atomic<uint64_t> numFramesCopied;
+	std::atomic<uint64_t> decodeLatency;
+	std::atomic<uint64_t> maxDecodeLatency;
 
 #ifdef OF_USE_GST_GL
 	GstGLDisplay *		glDisplay;
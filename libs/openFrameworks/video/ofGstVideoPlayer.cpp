@@ -11,6 +11,155 @@
 #include <gst/app/gstappsink.h>
 #include "ofConstants.h"
 #include "ofGstUtils.h"
+#include <algorithm>
+#include <thread>
+
+//-------------------------------------------------
+//----------------------------------------- decodeScheduler
+//-------------------------------------------------
+
+ofGstDecodeScheduler::ofGstDecodeScheduler()
+:maxDecoderThreads(std::max(std::thread::hardware_concurrency(), 1u))
+,maxConcurrentPrerolls(2)
+,prerollTimeout(5000){
+}
+
+void ofGstDecodeScheduler::setMaxDecoderThreads(size_t numThreads){
+	std::unique_lock<std::mutex> lock(mutex);
+	maxDecoderThreads = std::max(numThreads, size_t(1));
+}
+
+size_t ofGstDecodeScheduler::getMaxDecoderThreads() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return maxDecoderThreads;
+}
+
+void ofGstDecodeScheduler::setMaxConcurrentPrerolls(size_t numPrerolls){
+	std::unique_lock<std::mutex> lock(mutex);
+	maxConcurrentPrerolls = std::max(numPrerolls, size_t(1));
+}
+
+size_t ofGstDecodeScheduler::getMaxConcurrentPrerolls() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return maxConcurrentPrerolls;
+}
+
+void ofGstDecodeScheduler::setPrerollTimeoutMillis(uint64_t timeout){
+	std::unique_lock<std::mutex> lock(mutex);
+	prerollTimeout = timeout;
+}
+
+size_t ofGstDecodeScheduler::getNumPlayers() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return players.size();
+}
+
+size_t ofGstDecodeScheduler::getNumVisiblePlayers() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return std::count_if(players.begin(), players.end(), [](ofGstVideoPlayer * player){
+		return player->isVisible();
+	});
+}
+
+size_t ofGstDecodeScheduler::getNumPendingLoads() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return pendingLoads.size();
+}
+
+size_t ofGstDecodeScheduler::getNumPrerolling() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	return prerolling.size();
+}
+
+size_t ofGstDecodeScheduler::getDecoderThreadsFor(const ofGstVideoPlayer & player) const{
+	// a decoder can't have less than one thread, 0 lets it choose its own
+	// number. hidden players are paused so that one is enough to resume
+	// them, what's left of the budget is split between the visible ones
+	if(!player.isVisible()){
+		return 1;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	size_t numVisible = std::count_if(players.begin(), players.end(), [](ofGstVideoPlayer * player){
+		return player->isVisible();
+	});
+	size_t numHidden = players.size() - numVisible;
+	size_t available = maxDecoderThreads > numHidden ? maxDecoderThreads - numHidden : 0;
+	return std::max(available / std::max(numVisible, size_t(1)), size_t(1));
+}
+
+void ofGstDecodeScheduler::update(){
+	std::vector<ofGstVideoPlayer*> toStart;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto now = ofGetElapsedTimeMillis();
+		for(auto it = prerolling.begin(); it != prerolling.end();){
+			if(now - it->second > prerollTimeout){
+				ofLogWarning("ofGstDecodeScheduler") << "update(): preroll took more than " << prerollTimeout << "ms, starting the next load";
+				it = prerolling.erase(it);
+			}else{
+				++it;
+			}
+		}
+
+		// visible players first, the rest keep the order they were loaded in
+		std::stable_partition(pendingLoads.begin(), pendingLoads.end(), [](ofGstVideoPlayer * player){
+			return player->isVisible();
+		});
+		size_t numToStart = std::min(pendingLoads.size(), maxConcurrentPrerolls - std::min(prerolling.size(), maxConcurrentPrerolls));
+		toStart.assign(pendingLoads.begin(), pendingLoads.begin() + numToStart);
+		pendingLoads.erase(pendingLoads.begin(), pendingLoads.begin() + numToStart);
+		for(auto player: toStart){
+			prerolling[player] = now;
+		}
+	}
+
+	// outside of the lock, the player calls prerollDone from the gstreamer thread
+	for(auto player: toStart){
+		std::string uri = std::move(player->pendingLoad);
+		player->pendingLoad.clear();
+		if(!player->startLoad(uri)){
+			prerollDone(player);
+		}else if(player->bPlayWhenLoaded){
+			player->bPlayWhenLoaded = false;
+			player->videoUtils.play();
+		}
+	}
+}
+
+void ofGstDecodeScheduler::add(ofGstVideoPlayer * player){
+	std::unique_lock<std::mutex> lock(mutex);
+	if(std::find(players.begin(), players.end(), player) == players.end()){
+		players.push_back(player);
+	}
+}
+
+void ofGstDecodeScheduler::remove(ofGstVideoPlayer * player){
+	cancelLoad(player);
+	std::unique_lock<std::mutex> lock(mutex);
+	players.erase(std::remove(players.begin(), players.end(), player), players.end());
+}
+
+void ofGstDecodeScheduler::requestLoad(ofGstVideoPlayer * player){
+	std::unique_lock<std::mutex> lock(mutex);
+	if(std::find(pendingLoads.begin(), pendingLoads.end(), player) == pendingLoads.end()){
+		pendingLoads.push_back(player);
+	}
+}
+
+void ofGstDecodeScheduler::cancelLoad(ofGstVideoPlayer * player){
+	std::unique_lock<std::mutex> lock(mutex);
+	pendingLoads.erase(std::remove(pendingLoads.begin(), pendingLoads.end(), player), pendingLoads.end());
+	prerolling.erase(player);
+}
+
+void ofGstDecodeScheduler::prerollDone(ofGstVideoPlayer * player){
+	std::unique_lock<std::mutex> lock(mutex);
+	prerolling.erase(player);
+}
+
+//-------------------------------------------------
+//----------------------------------------- videoPlayer
+//-------------------------------------------------
 
 ofGstVideoPlayer::ofGstVideoPlayer(){
 	nFrames						= 0;
@@ -19,6 +168,9 @@ ofGstVideoPlayer::ofGstVideoPlayer(){
 	bIsAllocated				= false;
 	threadAppSink				= false;
 	bAsyncLoad					= false;
+	bVisible					= true;
+	bResumeWhenVisible			= false;
+	bPlayWhenLoaded				= false;
 	videoUtils.setSinkListener(this);
 	fps_d = 1;
 	fps_n = 1;
@@ -26,6 +178,9 @@ ofGstVideoPlayer::ofGstVideoPlayer(){
 
 ofGstVideoPlayer::~ofGstVideoPlayer(){
 	close();
+	if(scheduler){
+		scheduler->remove(this);
+	}
 }
 
 bool ofGstVideoPlayer::setPixelFormat(ofPixelFormat pixelFormat){
@@ -208,6 +363,21 @@ bool ofGstVideoPlayer::load(std::string name){
 	}
 	ofLogVerbose("ofGstVideoPlayer") << "loadMovie(): loading \"" << name << "\"";
 
+	if(scheduler){
+		scheduler->cancelLoad(this);
+		pendingLoad.clear();
+		// async loads wait for a free preroll slot, started from update()
+		if(bIsStream){
+			pendingLoad = name;
+			scheduler->requestLoad(this);
+			scheduler->update();
+			return true;
+		}
+	}
+	return startLoad(name);
+}
+
+bool ofGstVideoPlayer::startLoad(std::string name){
 	if(isInitialized()){
 		gst_element_set_state (videoUtils.getPipeline(), GST_STATE_READY);
 		if(!bIsStream){
@@ -226,8 +396,14 @@ bool ofGstVideoPlayer::load(std::string name){
 		}
 	}else{
 		ofGstUtils::startGstMainLoop();
-		return createPipeline(name) &&
-				videoUtils.startPipeline() &&
+		if(!createPipeline(name)){
+			return false;
+		}
+#if GST_CHECK_VERSION(1,10,0)
+		// decoders are created while prerolling, the scheduler limits their threads
+		g_signal_connect(videoUtils.getPipeline(), "deep-element-added", G_CALLBACK(&ofGstVideoPlayer::on_element_added), this);
+#endif
+		return videoUtils.startPipeline() &&
 				(bIsStream || allocate());
 	}
 }
@@ -303,8 +479,34 @@ bool ofGstVideoPlayer::allocate(){
 
 void ofGstVideoPlayer::on_stream_prepared(){
 	if(!bIsAllocated) allocate();
+	if(scheduler) scheduler->prerollDone(this);
 }
 
+#if GST_CHECK_VERSION(1,10,0)
+void ofGstVideoPlayer::on_element_added(GstBin *, GstBin *, GstElement * element, ofGstVideoPlayer * player){
+	auto scheduler = player->scheduler;
+	GstElementFactory * factory = gst_element_get_factory(element);
+	if(!scheduler || !factory || !gst_element_factory_list_is_type(factory, GST_ELEMENT_FACTORY_TYPE_DECODER)){
+		return;
+	}
+
+	// each decoder family names the property differently
+	for(auto property: {"max-threads", "threads", "n-threads"}){
+		GParamSpec * spec = g_object_class_find_property(G_OBJECT_GET_CLASS(element), property);
+		if(spec && (spec->flags & G_PARAM_WRITABLE)){
+			int threads = scheduler->getDecoderThreadsFor(*player);
+			GValue value = G_VALUE_INIT;
+			g_value_init(&value, G_TYPE_INT);
+			g_value_set_int(&value, threads);
+			g_object_set_property(G_OBJECT(element), property, &value);
+			g_value_unset(&value);
+			ofLogVerbose("ofGstVideoPlayer") << "limiting " << GST_ELEMENT_NAME(element) << " to " << threads << " decoding threads";
+			break;
+		}
+	}
+}
+#endif
+
 int	ofGstVideoPlayer::getCurrentFrame() const {
 	int frame = 0;
 
@@ -351,23 +553,38 @@ bool ofGstVideoPlayer::isStream() const {
 }
 
 void ofGstVideoPlayer::update(){
+	if(scheduler) scheduler->update();
 	videoUtils.update();
 }
 
 void ofGstVideoPlayer::play(){
-	videoUtils.play();
+	if(!bVisible){
+		bResumeWhenVisible = true;
+	}else if(isLoadPending()){
+		bPlayWhenLoaded = true;
+	}else{
+		videoUtils.play();
+	}
 }
 
 void ofGstVideoPlayer::stop(){
+	bResumeWhenVisible = false;
+	bPlayWhenLoaded = false;
 	videoUtils.stop();
 }
 
 void ofGstVideoPlayer::setPaused(bool bPause){
-	videoUtils.setPaused(bPause);
+	if(!bVisible){
+		bResumeWhenVisible = !bPause;
+	}else if(isLoadPending()){
+		bPlayWhenLoaded = !bPause;
+	}else{
+		videoUtils.setPaused(bPause);
+	}
 }
 
 bool ofGstVideoPlayer::isPaused() const {
-	return videoUtils.isPaused();
+	return videoUtils.isPaused() && !bResumeWhenVisible && !bPlayWhenLoaded;
 }
 
 bool ofGstVideoPlayer::isLoaded() const {
@@ -375,7 +592,7 @@ bool ofGstVideoPlayer::isLoaded() const {
 }
 
 bool ofGstVideoPlayer::isPlaying() const {
-	return videoUtils.isPlaying();
+	return videoUtils.isPlaying() || bResumeWhenVisible || bPlayWhenLoaded;
 }
 
 float ofGstVideoPlayer::getPosition() const {
@@ -415,6 +632,12 @@ void ofGstVideoPlayer::setSpeed(float speed){
 }
 
 void ofGstVideoPlayer::close(){
+	if(scheduler){
+		scheduler->cancelLoad(this);
+	}
+	pendingLoad.clear();
+	bResumeWhenVisible = false;
+	bPlayWhenLoaded = false;
 	bIsAllocated = false;
 	videoUtils.close();
 }
@@ -447,6 +670,64 @@ ofGstVideoUtils * ofGstVideoPlayer::getGstVideoUtils(){
 	return &videoUtils;
 }
 
+void ofGstVideoPlayer::setDecodeScheduler(std::shared_ptr<ofGstDecodeScheduler> scheduler){
+	if(this->scheduler){
+		this->scheduler->remove(this);
+	}
+	this->scheduler = scheduler;
+	if(scheduler){
+		scheduler->add(this);
+	}
+}
+
+std::shared_ptr<ofGstDecodeScheduler> ofGstVideoPlayer::getDecodeScheduler() const{
+	return scheduler;
+}
+
+void ofGstVideoPlayer::setVisible(bool visible){
+	if(visible == bVisible){
+		return;
+	}
+	bVisible = visible;
+	if(visible){
+		if(bResumeWhenVisible){
+			bResumeWhenVisible = false;
+			play();
+		}
+	}else if(bPlayWhenLoaded){
+		bPlayWhenLoaded = false;
+		bResumeWhenVisible = true;
+	}else if(!videoUtils.isPaused() && (videoUtils.isPlaying() || !videoUtils.isLoaded())){
+		// also covers streams that would start playing as soon as they preroll
+		videoUtils.setPaused(true);
+		bResumeWhenVisible = true;
+	}
+}
+
+bool ofGstVideoPlayer::isVisible() const{
+	return bVisible;
+}
+
+bool ofGstVideoPlayer::isLoadPending() const{
+	return !pendingLoad.empty();
+}
+
+uint64_t ofGstVideoPlayer::getNumFramesDecoded() const{
+	return videoUtils.getNumFramesReceived();
+}
+
+uint64_t ofGstVideoPlayer::getNumFramesDropped() const{
+	return videoUtils.getNumFramesDropped();
+}
+
+uint64_t ofGstVideoPlayer::getDecodeLatencyMicros() const{
+	return videoUtils.getDecodeLatencyMicros();
+}
+
+uint64_t ofGstVideoPlayer::getMaxDecodeLatencyMicros() const{
+	return videoUtils.getMaxDecodeLatencyMicros();
+}
+
 void ofGstVideoPlayer::setFrameByFrame(bool frameByFrame){
 	videoUtils.setFrameByFrame(frameByFrame);
 }
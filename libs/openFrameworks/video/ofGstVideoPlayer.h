@@ -1,6 +1,82 @@
 #pragma once
 
 #include "ofGstUtils.h"
+#include <map>
+
+class ofGstVideoPlayer;
+
+/// coordinates the decoding of many ofGstVideoPlayer, for example in a
+/// video wall, so they don't oversubscribe the machine
+///
+/// players using the same scheduler:
+/// - share a budget of decoder threads. every decoder needs at least one,
+///   hidden players get only that one and visible ones split the rest of
+///   the budget, so it's only exceeded when there are more players than
+///   threads. the number of threads is set when the decoder is created so
+///   it only changes for a player when it loads a new video, players that
+///   become visible or hidden later keep theirs until then
+/// - preroll a few at a time when loaded with loadAsync, visible players first,
+///   the rest wait in a queue that is processed from the players' update()
+///
+/// ~~~~{.cpp}
+/// auto scheduler = std::make_shared<ofGstDecodeScheduler>();
+/// scheduler->setMaxDecoderThreads(8);
+/// for(auto & player: players){
+///     auto gstPlayer = std::make_shared<ofGstVideoPlayer>();
+///     gstPlayer->setDecodeScheduler(scheduler);
+///     player.setPlayer(gstPlayer);
+///     player.loadAsync(path);
+///     player.play();
+/// }
+/// ~~~~
+///
+/// use ofGstVideoPlayer::setVisible() to stop decoding players that are
+/// not on screen
+class ofGstDecodeScheduler{
+public:
+	ofGstDecodeScheduler();
+
+	/// total number of decoder threads for all the players, defaults to
+	/// the number of cores. each player gets at least one
+	void setMaxDecoderThreads(size_t numThreads);
+	size_t getMaxDecoderThreads() const;
+
+	/// number of players that can be prerolling at the same time, defaults to 2
+	void setMaxConcurrentPrerolls(size_t numPrerolls);
+	size_t getMaxConcurrentPrerolls() const;
+
+	/// a preroll that takes longer than this, usually because of an error,
+	/// stops blocking the queue
+	void setPrerollTimeoutMillis(uint64_t timeout);
+
+	size_t getNumPlayers() const;
+	size_t getNumVisiblePlayers() const;
+	size_t getNumPendingLoads() const;
+	size_t getNumPrerolling() const;
+
+	/// threads a decoder created now for this player would get
+	size_t getDecoderThreadsFor(const ofGstVideoPlayer & player) const;
+
+	/// start the pending loads that fit, called from ofGstVideoPlayer::update()
+	void update();
+
+private:
+	friend class ofGstVideoPlayer;
+
+	void add(ofGstVideoPlayer * player);
+	void remove(ofGstVideoPlayer * player);
+	void requestLoad(ofGstVideoPlayer * player);
+	void cancelLoad(ofGstVideoPlayer * player);
+	void prerollDone(ofGstVideoPlayer * player);
+
+	mutable std::mutex mutex;
+	std::vector<ofGstVideoPlayer*> players;
+	std::vector<ofGstVideoPlayer*> pendingLoads;
+	std::map<ofGstVideoPlayer*, uint64_t> prerolling; // player -> start time in ms
+	size_t maxDecoderThreads;
+	size_t maxConcurrentPrerolls;
+	uint64_t prerollTimeout;
+};
 
 
 class ofGstVideoPlayer: public ofBaseVideoPlayer, public ofGstAppSink{
@@ -31,6 +107,9 @@ public:
 	void 	play();
 	void 	stop();
 	void 	setPaused(bool bPause);
+	/// isPaused() and isPlaying() report the state requested with play()
+	/// and setPaused(), which is held back while the player is hidden or a
+	/// loadAsync is pending. getGstVideoUtils() has the pipeline's state
 	bool 	isPaused() const;
 	bool 	isLoaded() const;
 	bool 	isPlaying() const;
@@ -63,10 +142,33 @@ public:
 
 	ofGstVideoUtils * getGstVideoUtils();
 
+	/// share decoder threads and preroll slots with other players,
+	/// needs to be called before load
+	void setDecodeScheduler(std::shared_ptr<ofGstDecodeScheduler> scheduler);
+	std::shared_ptr<ofGstDecodeScheduler> getDecodeScheduler() const;
+
+	/// hidden players stop decoding, play() and setPaused() are
+	/// remembered and applied once the player is visible again
+	void setVisible(bool visible);
+	bool isVisible() const;
+
+	/// true while a loadAsync is waiting for the scheduler to start it
+	bool isLoadPending() const;
+
+	/// decoding statistics since the video was loaded
+	uint64_t getNumFramesDecoded() const;
+	uint64_t getNumFramesDropped() const;
+	uint64_t getDecodeLatencyMicros() const;
+	uint64_t getMaxDecodeLatencyMicros() const;
+
 protected:
 	bool allocate();
 	bool createPipeline(std::string uri);
+	bool startLoad(std::string uri);
 	void on_stream_prepared();
+#if GST_CHECK_VERSION(1,10,0)
+	static void on_element_added(GstBin * bin, GstBin * subBin, GstElement * element, ofGstVideoPlayer * player);
+#endif
 
 	// return true to set the message as attended so upstream doesn't try to process it
 	virtual bool on_message(GstMessage* msg){return false;};
@@ -79,5 +181,12 @@ private:
 	bool				bIsAllocated;
 	bool				bAsyncLoad;
 	bool				threadAppSink;
+	std::atomic<bool>	bVisible;
+	bool				bResumeWhenVisible;
+	bool				bPlayWhenLoaded;
+	std::string			pendingLoad;
+	std::shared_ptr<ofGstDecodeScheduler> scheduler;
 	ofGstVideoUtils		videoUtils;
+
+	friend class ofGstDecodeScheduler;
 };
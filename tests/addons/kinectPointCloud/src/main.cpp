@@ -0,0 +1,174 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxKinect.h"
+#include "ofxKinectPlayer.h"
+#include "ofxKinectRecorder.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// a tilted plane with a sphere in front of it and a hole with no depth
+	void makeDepthFrame(ofShortPixels & depth, int frame){
+		depth.allocate(640, 480, 1);
+		for(int y = 0; y < 480; y++){
+			for(int x = 0; x < 640; x++){
+				float z = 3000 + x * 2 + frame * 10;
+				float dx = x - 320 - frame;
+				float dy = y - 240;
+				if(dx * dx + dy * dy < 100 * 100){
+					z = 800 + sqrt(dx * dx + dy * dy) * 5;
+				}
+				if(x < 20 && y < 20){
+					z = 0;
+				}
+				depth[y * 640 + x] = z;
+			}
+		}
+	}
+
+	void record(const std::string & filename, int numFrames){
+		ofxKinectRecorder recorder;
+		ofxTest(recorder.open(filename, 640, 480, 3, 0.1042f, 120.f), "open recording");
+		ofShortPixels depth;
+		ofPixels video;
+		video.allocate(640, 480, OF_PIXELS_RGB);
+		for(int i = 0; i < numFrames; i++){
+			makeDepthFrame(depth, i);
+			video.setColor(ofColor(i, 255 - i, 128));
+			recorder.addFrame(depth, video, i * 33333);
+		}
+		ofxTestEq(recorder.getNumFrames(), numFrames, "all frames recorded");
+		recorder.close();
+	}
+
+	void testPlayer(const std::string & filename, int numFrames){
+		ofxKinectPlayer player;
+		player.setUseTexture(false);
+		ofxTest(player.load(filename), "load recording");
+		ofxTestEq(player.getTotalNumFrames(), numFrames, "number of frames");
+		player.setLoop(false);
+		player.update();
+		ofxTest(player.isFrameNew(), "first frame is new");
+		ofxTestEq(player.getCurrentFrame(), 0, "first frame");
+		ofShortPixels expected;
+		makeDepthFrame(expected, 0);
+		ofxTest(std::equal(expected.begin(), expected.end(), player.getRawDepthPixels().begin()), "depth matches the recorded frame");
+		ofxTestEq(player.getPixels().getColor(10, 10), ofColor(0, 255, 128), "video matches the recorded frame");
+		for(int i = 1; i < numFrames; i++){
+			player.update();
+		}
+		ofxTestEq(player.getCurrentFrame(), numFrames - 1, "a frame per update");
+		player.update();
+		ofxTest(player.getIsMovieDone() && !player.isFrameNew(), "stops at the end when not looping");
+
+		player.setFrame(5);
+		player.update();
+		ofxTestEq(player.getCurrentFrame(), 5, "seek");
+		ofxTestEq(player.getDistanceAt(10, 10), 0.f, "no depth in the hole");
+	}
+
+	void testPointCloud(const std::string & filename){
+		ofxKinectPlayer player;
+		player.setUseTexture(false);
+		player.load(filename);
+		player.update();
+
+		// everything but the hole without clipping
+		std::vector<float> points(640 * 480 * 3);
+		size_t n = player.getPointCloud(points.data(), 1, false);
+		ofxTestEq(n, size_t(640 * 480 - 20 * 20), "pixels without depth are dropped");
+
+		bool same = true;
+		size_t i = 0;
+		for(int y = 0; y < 480; y++){
+			for(int x = 0; x < 640; x++){
+				if(player.getDistanceAt(x, y) == 0) continue;
+				auto p = player.getWorldCoordinateAt(x, y);
+				same &= glm::distance(glm::vec3(p), glm::vec3(points[i * 3], points[i * 3 + 1], points[i * 3 + 2])) < 0.01f;
+				i++;
+			}
+		}
+		ofxTest(same, "same coordinates as getWorldCoordinateAt()");
+
+		// only the sphere is closer than 1.5m
+		player.setDepthClipping(500, 1500);
+		size_t sphere = player.getPointCloud(points.data(), 1, true);
+		size_t expected = 0;
+		for(auto z: player.getRawDepthPixels()){
+			expected += z >= 500 && z <= 1500;
+		}
+		ofxTestEq(sphere, expected, "clipping uses setDepthClipping()");
+		bool inside = true;
+		for(size_t j = 0; j < sphere; j++){
+			inside &= points[j * 3 + 2] >= 500 && points[j * 3 + 2] <= 1500;
+		}
+		ofxTest(inside, "clipped points are inside the range");
+
+		ofMesh mesh;
+		player.getPointCloud(mesh, 2, false, true);
+		ofxTestEq(mesh.getNumVertices(), size_t(320 * 240 - 10 * 10), "step decimates in both directions");
+		ofxTestEq(mesh.getNumColors(), mesh.getNumVertices(), "a color per point");
+		ofxTest(glm::distance(mesh.getVertex(0), glm::vec3(player.getWorldCoordinateAt(20, 0))) < 0.01f, "first decimated point");
+	}
+
+	void benchmark(const std::string & filename){
+		ofxKinectPlayer player;
+		player.setUseTexture(false);
+		player.load(filename);
+		player.update();
+		const int frames = 100;
+
+		ofMesh mesh;
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			mesh.clear();
+			for(int y = 0; y < 480; y++){
+				for(int x = 0; x < 640; x++){
+					if(player.getDistanceAt(x, y) > 0){
+						mesh.addVertex(player.getWorldCoordinateAt(x, y));
+					}
+				}
+			}
+		}
+		auto perPixel = ofGetElapsedTimeMicros() - start;
+
+		start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			player.getPointCloud(mesh, 1, false);
+		}
+		auto bulk = ofGetElapsedTimeMicros() - start;
+
+		start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			player.getPointCloud(mesh, 2, true);
+		}
+		auto decimated = ofGetElapsedTimeMicros() - start;
+
+		start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			player.update();
+		}
+		auto playback = ofGetElapsedTimeMicros() - start;
+
+		ofLogNotice() << "point cloud per pixel: " << perPixel / frames << "us, bulk: " << bulk / frames
+			<< "us, decimated and clipped: " << decimated / frames << "us, playback: " << playback / frames << "us per frame";
+	}
+
+	void run(){
+		std::string filename = "depth.kinect";
+		int numFrames = 30;
+		record(filename, numFrames);
+		testPlayer(filename, numFrames);
+		testPointCloud(filename);
+		benchmark(filename);
+		ofFile::removeFile(filename);
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -0,0 +1,140 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxOpenCv.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// draws non overlapping discs on a grid so both finders see the same blobs
+	ofPixels makeBlobImage(int width, int height, int cellSize){
+		ofPixels pixels;
+		pixels.allocate(width, height, OF_PIXELS_GRAY);
+		pixels.set(0);
+		for(int cy = cellSize / 2; cy + cellSize / 2 <= height; cy += cellSize){
+			for(int cx = cellSize / 2; cx + cellSize / 2 <= width; cx += cellSize){
+				int r = ofRandom(cellSize / 8, cellSize / 2 - 2);
+				for(int y = cy - r; y <= cy + r; y++){
+					for(int x = cx - r; x <= cx + r; x++){
+						if((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r){
+							pixels[y * width + x] = 255;
+						}
+					}
+				}
+			}
+		}
+		return pixels;
+	}
+
+	void testCorrectness(){
+		ofPixels pixels;
+		pixels.allocate(16, 12, OF_PIXELS_GRAY);
+		pixels.set(0);
+		for(int y = 2; y < 6; y++){
+			for(int x = 3; x < 11; x++){
+				pixels[y * 16 + x] = 255;
+			}
+		}
+		// a diagonal line is a single 8-connected blob
+		for(int i = 0; i < 4; i++){
+			pixels[(7 + i) * 16 + 1 + i] = 255;
+		}
+
+		ofxCvBlobFinder finder;
+		ofxTestEq(finder.findBlobs(pixels, 0, 1000, 10), 2, "finds both blobs");
+		ofxTestEq(finder.blobs[0].area, 32.f, "area is the number of pixels and blobs are sorted by area");
+		ofxTestEq(finder.blobs[0].boundingRect, ofRectangle(3, 2, 8, 4), "bounding rect");
+		ofxTestEq(finder.blobs[0].centroid.x, 6.5f, "centroid x");
+		ofxTestEq(finder.blobs[0].centroid.y, 3.5f, "centroid y");
+		ofxTestEq(finder.blobs[0].nPts, 4, "an approximated rectangle contour has 4 corners");
+		ofxTestEq(finder.blobs[1].area, 4.f, "diagonal pixels are connected");
+		ofxTestEq(finder.getLabels()[2 * 16 + 3], finder.getLabel(0), "label image matches the blobs");
+		ofxTestEq(finder.findBlobs(pixels, 10, 1000, 10), 1, "area range filters blobs");
+
+		auto image = makeBlobImage(640, 480, 40);
+		ofxCvGrayscaleImage gray;
+		gray.setUseTexture(false);
+		gray.setFromPixels(image);
+		ofxCvContourFinder legacy;
+		legacy.findContours(gray, 20, 640 * 480, 1000, false);
+		for(int threads: {1, 4}){
+			finder.setNumThreads(threads);
+			finder.findBlobs(image, 20, 640 * 480, 1000);
+			ofxTestEq(finder.blobs.size(), legacy.blobs.size(), "same number of blobs as ofxCvContourFinder with " + ofToString(threads) + " threads");
+			bool sameBlobs = finder.blobs.size() == legacy.blobs.size();
+			for(auto & blob: finder.blobs){
+				bool found = false;
+				for(auto & other: legacy.blobs){
+					found |= blob.boundingRect == other.boundingRect && glm::distance(blob.centroid, other.centroid) < 1;
+				}
+				sameBlobs &= found;
+			}
+			ofxTest(sameBlobs, "same bounding rects and centroids as ofxCvContourFinder with " + ofToString(threads) + " threads");
+		}
+
+		// with a ROI both report positions relative to it and the size of
+		// the whole image
+		gray.setROI(100, 50, 320, 240);
+		legacy.findContours(gray, 20, 640 * 480, 1000, false);
+		finder.findContours(gray, 20, 640 * 480, 1000, false);
+		ofxTestEq(finder.getWidth(), legacy.getWidth(), "same width as ofxCvContourFinder with a ROI");
+		ofxTestEq(finder.getHeight(), legacy.getHeight(), "same height as ofxCvContourFinder with a ROI");
+		bool sameRects = finder.blobs.size() == legacy.blobs.size();
+		for(auto & blob: finder.blobs){
+			bool found = false;
+			for(auto & other: legacy.blobs){
+				found |= blob.boundingRect == other.boundingRect;
+			}
+			sameRects &= found;
+		}
+		ofxTest(sameRects, "same bounding rects as ofxCvContourFinder with a ROI");
+		gray.resetROI();
+	}
+
+	void benchmark(){
+		auto image = makeBlobImage(1280, 720, 24);
+		ofxCvGrayscaleImage gray;
+		gray.setUseTexture(false);
+		gray.setFromPixels(image);
+		const int frames = 60;
+
+		ofxCvContourFinder legacy;
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			legacy.findContours(gray, 20, 1280 * 720, 1000, false);
+		}
+		auto legacyTime = ofGetElapsedTimeMicros() - start;
+		ofLogNotice() << "ofxCvContourFinder: " << legacyTime / frames << "us per frame, " << legacy.nBlobs << " blobs";
+
+		for(int threads: {1, 2, 4, 8}){
+			ofxCvBlobFinder finder;
+			finder.setNumThreads(threads);
+			start = ofGetElapsedTimeMicros();
+			for(int i = 0; i < frames; i++){
+				finder.findBlobs(image, 20, 1280 * 720, 1000);
+			}
+			auto time = ofGetElapsedTimeMicros() - start;
+			ofLogNotice() << "ofxCvBlobFinder " << threads << " threads: " << time / frames << "us per frame, " << finder.nBlobs << " blobs";
+
+			start = ofGetElapsedTimeMicros();
+			for(int i = 0; i < frames; i++){
+				finder.findBlobs(image, 20, 1280 * 720, 1000, false);
+			}
+			time = ofGetElapsedTimeMicros() - start;
+			ofLogNotice() << "ofxCvBlobFinder " << threads << " threads without contours: " << time / frames << "us per frame";
+		}
+	}
+
+	void run(){
+		ofSeedRandom(0);
+		testCorrectness();
+		benchmark();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
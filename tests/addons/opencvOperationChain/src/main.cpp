@@ -0,0 +1,122 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxOpenCv.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void randomize(ofxCvGrayscaleImage & image, int width, int height){
+		ofPixels pixels;
+		pixels.allocate(width, height, OF_PIXELS_GRAY);
+		for(auto & p: pixels){
+			p = ofRandom(256);
+		}
+		image.setUseTexture(false);
+		image.setFromPixels(pixels);
+	}
+
+	bool samePixels(ofxCvGrayscaleImage & a, ofxCvGrayscaleImage & b){
+		auto & pa = a.getPixels();
+		auto & pb = b.getPixels();
+		return std::equal(pa.begin(), pa.end(), pb.begin(), pb.end());
+	}
+
+	void run(){
+		const int width = 1280;
+		const int height = 720;
+		ofxCvGrayscaleImage source, background, mask, sequential, fused;
+		randomize(source, width, height);
+		randomize(background, width, height);
+		randomize(mask, width, height);
+		sequential.setUseTexture(false);
+		fused.setUseTexture(false);
+
+		ofxCvOperationChain constants;
+		constants.add(12).subtract(4.5).threshold(100).invert();
+		sequential = source;
+		sequential += 12;
+		sequential -= 4.5;
+		sequential.threshold(100);
+		sequential.invert();
+		fused = source;
+		ofxTest(constants.apply(fused), "apply a chain of constant operations");
+		ofxTest(samePixels(sequential, fused), "constant chain matches the sequential operations");
+
+		ofxCvOperationChain chain;
+		chain.absDiff(background).threshold(30).multiply(mask).add(background).erode().dilate().add(8);
+		sequential = source;
+		sequential.absDiff(background);
+		sequential.threshold(30);
+		sequential *= mask;
+		sequential += background;
+		sequential.erode();
+		sequential.dilate();
+		sequential += 8;
+		fused = source;
+		ofxTest(chain.apply(fused), "apply a chain with image operands and filters");
+		ofxTest(samePixels(sequential, fused), "fused chain matches the sequential operations");
+
+		fused = source;
+		chain.setNumThreads(4);
+		chain.apply(fused);
+		ofxTest(samePixels(sequential, fused), "parallel chain matches the sequential operations");
+
+		ofxCvColorImage color;
+		color.allocate(width, height);
+		ofxTest(!chain.apply(color), "operands of a different type are rejected");
+
+		ofPixels colorPixels;
+		colorPixels.allocate(width, height, OF_PIXELS_RGB);
+		for(auto & p: colorPixels){
+			p = ofRandom(256);
+		}
+		ofxCvColorImage colorSequential, colorFused;
+		colorSequential.setUseTexture(false);
+		colorFused.setUseTexture(false);
+		colorSequential.setFromPixels(colorPixels);
+		colorFused.setFromPixels(colorPixels);
+		colorSequential += 20;
+		colorSequential -= 3;
+		colorSequential.invert();
+		ofxCvOperationChain colorChain;
+		colorChain.add(20).subtract(3).invert();
+		ofxTest(colorChain.apply(colorFused), "apply a constant chain to a color image");
+		auto & pa = colorSequential.getPixels();
+		auto & pb = colorFused.getPixels();
+		ofxTest(std::equal(pa.begin(), pa.end(), pb.begin(), pb.end()), "scalar operations change every channel like ofxCvColorImage");
+
+		const int frames = 100;
+		ofxCvOperationChain pixelChain;
+		pixelChain.absDiff(background).add(10).threshold(30).multiply(mask).add(background).invert();
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			sequential = source;
+			sequential.absDiff(background);
+			sequential += 10;
+			sequential.threshold(30);
+			sequential *= mask;
+			sequential += background;
+			sequential.invert();
+		}
+		auto sequentialTime = ofGetElapsedTimeMicros() - start;
+		for(int threads: {1, 4}){
+			pixelChain.setNumThreads(threads);
+			start = ofGetElapsedTimeMicros();
+			for(int i = 0; i < frames; i++){
+				fused = source;
+				pixelChain.apply(fused);
+			}
+			auto fusedTime = ofGetElapsedTimeMicros() - start;
+			ofLogNotice() << "6 operations, sequential: " << sequentialTime / frames << "us, fused with " << threads << " threads: " << fusedTime / frames << "us per frame";
+		}
+		ofxTest(samePixels(sequential, fused), "benchmark chains match");
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -0,0 +1,103 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void run(){
+		auto window = std::dynamic_pointer_cast<ofAppNoWindow>(ofGetCurrentWindow());
+		ofxTest(window != nullptr, "running on ofAppNoWindow");
+		if(!window){
+			return;
+		}
+
+		ofAppNoWindow::RunSettings settings;
+		settings.fixedStepFps = 25;
+		settings.pipelineOutput = true;
+		settings.recordTimings = true;
+		window->setRunSettings(settings);
+
+		// the app's own update and draw are already running the tests so
+		// the frames are driven by listeners on the window's events
+		std::vector<float> times;
+		std::vector<uint64_t> frames;
+		std::vector<uint64_t> outputs;
+		std::mutex outputsMutex;
+		bool outputOverlapsDraw = false;
+		std::atomic<bool> drawing(false);
+		auto updateListener = window->events().update.newListener([&](ofEventArgs &){
+			times.push_back(ofGetElapsedTimef());
+			frames.push_back(ofGetFrameNum());
+		});
+		auto drawListener = window->events().draw.newListener([&](ofEventArgs &){
+			drawing = true;
+			ofSleepMillis(5);
+			drawing = false;
+		});
+		auto outputListener = window->output.newListener([&](const uint64_t & frame){
+			ofSleepMillis(5);
+			outputOverlapsDraw |= drawing;
+			std::unique_lock<std::mutex> lock(outputsMutex);
+			outputs.push_back(frame);
+		});
+
+		// paced to the wall clock this would take 2 seconds
+		ofSetFrameRate(10);
+		auto then = ofGetSystemTimeMicros();
+		size_t numFrames = 20;
+		auto firstFrame = ofGetFrameNum();
+		for(size_t i = 0; i < numFrames; i++){
+			ofGetMainLoop()->loopOnce();
+		}
+		window->close();
+		auto realTime = (ofGetSystemTimeMicros() - then) / 1000000.f;
+
+		ofxTestEq(times.size(), numFrames, "frames run");
+		bool fixedStep = true;
+		bool consecutive = true;
+		for(size_t i = 0; i < times.size(); i++){
+			fixedStep &= std::abs(times[i] - i / 25.f) < 0.0001f;
+			consecutive &= frames[i] == firstFrame + i;
+		}
+		ofxTest(fixedStep, "elapsed time advances a fixed step per frame");
+		ofxTest(consecutive, "frame number advances once per frame");
+		ofxTest(realTime < numFrames / 25.f, "frames don't wait for the wall clock");
+		ofxTestEq(ofGetLastFrameTime(), 1 / 25., "last frame time is the step");
+
+		ofxTestEq(outputs.size(), numFrames, "every frame is output");
+		ofxTest(std::is_sorted(outputs.begin(), outputs.end()), "frames are output in order");
+		ofxTest(outputOverlapsDraw, "output runs while the next frame draws");
+
+		auto & timings = window->getFrameTimings();
+		ofxTestEq(timings.size(), numFrames, "timings recorded");
+		bool timingsOk = true;
+		for(size_t i = 0; i < timings.size(); i++){
+			timingsOk &= timings[i].frame == firstFrame + i;
+			timingsOk &= timings[i].drawMicros >= 5000;
+			timingsOk &= timings[i].outputMicros >= 5000;
+			timingsOk &= timings[i].outputStartMicros >= timings[i].startMicros + timings[i].eventsMicros + timings[i].updateMicros + timings[i].drawMicros;
+		}
+		ofxTest(timingsOk, "phase timings");
+
+		ofxTest(window->saveFrameTimings("trace.json"), "save chrome trace");
+		auto trace = ofBufferFromFile("trace.json").getText();
+		ofxTest(ofIsStringInString(trace, "\"name\":\"output\",\"ph\":\"X\",\"pid\":0,\"tid\":1"), "output in its own thread in the trace");
+		ofxTest(window->saveFrameTimings("timings.csv"), "save csv");
+		auto csv = ofSplitString(ofBufferFromFile("timings.csv").getText(), "\n", true, true);
+		ofxTestEq(csv.size(), numFrames + 1, "csv rows");
+
+		ofSetTimeModeSystem();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
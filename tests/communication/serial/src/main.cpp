@@ -0,0 +1,215 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+#if defined(TARGET_LINUX) || defined(TARGET_OSX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+// a pseudo terminal stands in for the device, what's written to the master
+// side arrives to the ofSerial opened on the slave side
+class PseudoTerminal{
+public:
+	PseudoTerminal(){
+		master = posix_openpt(O_RDWR | O_NOCTTY);
+		if(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0){
+			slave = ptsname(master);
+		}
+	}
+
+	~PseudoTerminal(){
+		if(master >= 0){
+			::close(master);
+		}
+	}
+
+	bool write(const std::vector<unsigned char> & data){
+		size_t written = 0;
+		while(written < data.size()){
+			auto n = ::write(master, data.data() + written, data.size() - written);
+			if(n <= 0){
+				return false;
+			}
+			written += n;
+		}
+		return true;
+	}
+
+	int master;
+	std::string slave;
+};
+#endif
+
+class ofApp: public ofxUnitTestsApp{
+	void run(){
+#if defined(TARGET_LINUX) || defined(TARGET_OSX)
+		testSerialReadThread();
+		testArduinoThreaded();
+#else
+		ofLogNotice() << "the serial tests need a pseudo terminal, skipping";
+#endif
+		testFirmataParser();
+	}
+
+#if defined(TARGET_LINUX) || defined(TARGET_OSX)
+	void testSerialReadThread(){
+		PseudoTerminal pty;
+		ofxTest(!pty.slave.empty(), "open pseudo terminal");
+		if(pty.slave.empty()){
+			return;
+		}
+
+		ofSerial serial;
+		ofxTest(serial.setup(pty.slave, 115200), "setup serial on pseudo terminal");
+		// a small ring buffer so the thread has to wait for the reader
+		ofxTest(serial.startReadThread(64), "start read thread");
+		ofxTest(serial.isReadThreadRunning(), "read thread running");
+		ofxTest(!serial.waitForData(10), "waitForData times out without data");
+		ofxTestEq(serial.readByte(), OF_SERIAL_NO_DATA, "readByte without data");
+
+		std::vector<unsigned char> sent(100000);
+		for(size_t i = 0; i < sent.size(); i++){
+			sent[i] = (i * 7) % 251;
+		}
+		std::thread writer([&]{
+			pty.write(sent);
+		});
+
+		std::vector<unsigned char> received;
+		unsigned char buffer[256];
+		auto start = ofGetElapsedTimeMillis();
+		while(received.size() < sent.size() && ofGetElapsedTimeMillis() - start < 10000){
+			if(!serial.waitForData(100)){
+				continue;
+			}
+			auto n = serial.readBytes(buffer, sizeof(buffer));
+			if(n > 0){
+				received.insert(received.end(), buffer, buffer + n);
+			}
+		}
+		writer.join();
+		ofxTestEq(received.size(), sent.size(), "received every byte");
+		ofxTest(received == sent, "bytes arrive in order");
+		ofxTest(serial.getLastReceiveTimeMicros() > 0, "receive time");
+
+		pty.write({'a', 'b', 'c'});
+		start = ofGetElapsedTimeMillis();
+		while(serial.available() < 3 && ofGetElapsedTimeMillis() - start < 1000){
+			serial.waitForData(100);
+		}
+		ofxTestEq(serial.available(), 3, "available from ring buffer");
+		ofxTestEq(serial.readByte(), int('a'), "readByte from ring buffer");
+		serial.flush(true, false);
+		ofxTestEq(serial.available(), 0, "flush clears ring buffer");
+
+		serial.stopReadThread();
+		ofxTest(!serial.isReadThreadRunning(), "stop read thread");
+		pty.write({'d'});
+		ofSleepMillis(50);
+		ofxTestEq(serial.readByte(), int('d'), "read without thread after stopping it");
+		serial.close();
+	}
+
+	void testArduinoThreaded(){
+		PseudoTerminal pty;
+		if(pty.slave.empty()){
+			return;
+		}
+
+		ofArduino arduino;
+		ofxTest(arduino.connect(pty.slave, 57600, true), "connect arduino threaded");
+		ofxTest(arduino.isThreaded(), "arduino is threaded");
+
+		int version = 0;
+		auto listener = arduino.EFirmwareVersionReceived.newListener([&](const int & major){
+			version = major;
+		});
+
+		// report version 2.5 and analog pin 3 = 1000
+		auto before = ofGetElapsedTimeMicros();
+		pty.write({REPORT_VERSION, 2, 5, ANALOG_MESSAGE | 3, 1000 & 0x7F, 1000 >> 7});
+
+		// the pin state is updated by the thread without calling update()
+		auto start = ofGetElapsedTimeMillis();
+		while(arduino.getPinState().analog[3] < 0 && ofGetElapsedTimeMillis() - start < 1000){
+			ofSleepMillis(1);
+		}
+		auto state = arduino.getPinState();
+		ofxTestEq(state.analog[3], 1000, "pin state updated from the thread");
+		ofxTest(state.analogTimeMicros[3] >= before, "pin state time");
+		ofxTestEq(version, 0, "events wait for update");
+
+		arduino.update();
+		ofxTestEq(version, 2, "version event from update");
+		ofxTestEq(arduino.getMinorFirmwareVersion(), 5, "minor version");
+
+		arduino.disconnect();
+		ofxTest(!arduino.isThreaded(), "disconnect stops the thread");
+	}
+#endif
+
+	void testFirmataParser(){
+		ofFirmataParser parser;
+		std::vector<ofFirmataParser::Message> messages;
+		std::vector<std::vector<unsigned char>> sysEx;
+		auto callback = [&](const ofFirmataParser::Message & message){
+			messages.push_back(message);
+			if(message.type == ofFirmataParser::Message::SysEx){
+				sysEx.emplace_back(message.data, message.data + message.size);
+			}
+		};
+
+		std::vector<unsigned char> data{
+			ANALOG_MESSAGE | 2, 0x7F, 0x03,
+			DIGITAL_MESSAGE | 1, 0x05, 0x00,
+			REPORT_VERSION, 2, 5,
+			START_SYSEX, 0x79, 1, 2, 3, END_SYSEX,
+			// a command in the middle of a message discards it
+			ANALOG_MESSAGE | 4, 0x10, ANALOG_MESSAGE | 5, 0x01, 0x00,
+		};
+
+		// split at every possible point, the result has to be the same
+		for(size_t split = 0; split <= data.size(); split++){
+			parser.reset();
+			messages.clear();
+			sysEx.clear();
+			parser.parse(data.data(), split, 10, callback);
+			parser.parse(data.data() + split, data.size() - split, 20, callback);
+
+			bool ok = messages.size() == 5;
+			ok &= ok && messages[0].type == ofFirmataParser::Message::Analog && messages[0].channel == 2 && messages[0].value == 0x7F + (0x03 << 7);
+			ok &= ok && messages[1].type == ofFirmataParser::Message::Digital && messages[1].channel == 1 && messages[1].value == 0x05;
+			ok &= ok && messages[2].type == ofFirmataParser::Message::Version && messages[2].value == 2 && messages[2].channel == 5;
+			ok &= ok && messages[3].type == ofFirmataParser::Message::SysEx && sysEx.size() == 1 && sysEx[0] == std::vector<unsigned char>{0x79, 1, 2, 3};
+			ok &= ok && messages[4].type == ofFirmataParser::Message::Analog && messages[4].channel == 5 && messages[4].value == 1;
+			ofxTest(ok, "parse split at " + ofToString(split));
+		}
+
+		parser.reset();
+		parser.parse(data.data(), data.size(), 30, callback);
+		auto & state = parser.getPinState();
+		ofxTestEq(state.analog[2], 0x7F + (0x03 << 7), "pin state analog");
+		ofxTestEq(state.analog[4], -1, "pin state discarded message");
+		ofxTestEq(state.analog[5], 1, "pin state analog 5");
+		ofxTestEq(state.analogTimeMicros[5], 30u, "pin state analog time");
+		ofxTestEq(state.getDigital(8), ARD_HIGH, "pin state digital 8");
+		ofxTestEq(state.getDigital(9), ARD_LOW, "pin state digital 9");
+		ofxTestEq(state.getDigital(10), ARD_HIGH, "pin state digital 10");
+		ofxTestEq(state.getDigital(0), -1, "pin state unreported port");
+		ofxTestEq(state.numMessages, 5u, "pin state messages");
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,171 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofCairoRenderer.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// what cairo expects for a pixel, computed without the conversion kernels
+	uint32_t expectedPixel(const ofPixels & pixels, size_t x, size_t y){
+		auto color = pixels.getColor(x, y);
+		uint32_t a = color.a;
+		auto premultiply = [&](uint32_t c){
+			return uint32_t(std::round(c * a / 255.f));
+		};
+		return (a << 24) | (premultiply(color.r) << 16) | (premultiply(color.g) << 8) | premultiply(color.b);
+	}
+
+	void testConversion(ofPixelFormat format){
+		// odd widths exercise the tails of the simd loops
+		ofPixels pixels;
+		pixels.allocate(37, 5, format);
+		for(size_t i = 0; i < pixels.size(); i++){
+			pixels[i] = (i * 97 + 13) % 256;
+		}
+
+		auto cairoFormat = ofCairoRenderer::getCairoFormat(format);
+		int stride = cairo_format_stride_for_width(cairoFormat, pixels.getWidth());
+		std::vector<unsigned char> converted(stride * pixels.getHeight());
+		ofxTest(ofCairoRenderer::toCairoPixels(pixels, converted.data(), stride), "converted " + ofToString(format));
+
+		bool same = true;
+		for(size_t y = 0; y < pixels.getHeight(); y++){
+			for(size_t x = 0; x < pixels.getWidth(); x++){
+				uint32_t pixel;
+				memcpy(&pixel, converted.data() + y * stride + x * 4, 4);
+				auto expected = expectedPixel(pixels, x, y);
+				if(cairoFormat == CAIRO_FORMAT_RGB24){
+					expected |= 0xff000000;
+				}
+				same &= pixel == expected;
+			}
+		}
+		ofxTest(same, "pixels of " + ofToString(format) + " match");
+	}
+
+	void drawSprites(ofCairoRenderer & renderer, const std::vector<ofImage> & sprites, int numDraws, int width, int height){
+		renderer.startRender();
+		renderer.background(ofFloatColor(1.f));
+		for(int i = 0; i < numDraws; i++){
+			auto & sprite = sprites[i % sprites.size()];
+			renderer.draw(sprite, (i * 37) % width, (i * 53) % height, 0, sprite.getWidth(), sprite.getHeight(), 0, 0, sprite.getWidth(), sprite.getHeight());
+		}
+		renderer.finishRender();
+	}
+
+	void run(){
+		testConversion(OF_PIXELS_RGB);
+		testConversion(OF_PIXELS_BGR);
+		testConversion(OF_PIXELS_RGBA);
+		testConversion(OF_PIXELS_BGRA);
+		testConversion(OF_PIXELS_GRAY);
+		testConversion(OF_PIXELS_GRAY_ALPHA);
+		ofPixels unsupported;
+		unsupported.allocate(4, 4, OF_PIXELS_NV12);
+		ofxTestEq(ofCairoRenderer::getCairoFormat(OF_PIXELS_NV12), CAIRO_FORMAT_INVALID, "nv12 can't be converted");
+		ofxTest(ofCairoRenderer::createCairoSurface(unsupported) == nullptr, "no surface for nv12");
+
+		ofPixels rgb;
+		rgb.allocate(3, 2, OF_PIXELS_RGB);
+		rgb.setColor(ofColor(255, 128, 0));
+		auto surface = ofCairoRenderer::createCairoSurface(rgb);
+		ofxTest(surface != nullptr, "created surface");
+		ofxTestEq(cairo_image_surface_get_width(surface), 3, "surface width");
+		ofxTestEq(cairo_image_surface_get_format(surface), CAIRO_FORMAT_RGB24, "surface format");
+		cairo_surface_destroy(surface);
+
+		std::vector<ofImage> sprites(4);
+		for(size_t i = 0; i < sprites.size(); i++){
+			sprites[i].setUseTexture(false);
+			sprites[i].allocate(16, 16, OF_IMAGE_COLOR_ALPHA);
+			sprites[i].setColor(ofColor::fromHsb(i * 60, 255, 255, 128));
+		}
+
+		ofCairoRenderer cached;
+		cached.setupMemoryOnly(ofCairoRenderer::IMAGE, false, false, ofRectangle(0, 0, 64, 64));
+		drawSprites(cached, sprites, 100, 64, 64);
+		auto stats = cached.getImageCacheStats();
+		ofxTestEq(stats.numMisses, size_t(4), "every sprite converted once");
+		ofxTestEq(stats.numHits, size_t(96), "the rest of the draws reuse the surface");
+		ofxTestEq(stats.numSurfaces, size_t(4), "one surface per sprite");
+
+		ofCairoRenderer uncached;
+		uncached.setImageCacheSize(0);
+		uncached.setupMemoryOnly(ofCairoRenderer::IMAGE, false, false, ofRectangle(0, 0, 64, 64));
+		drawSprites(uncached, sprites, 100, 64, 64);
+		ofxTestEq(uncached.getImageCacheStats().numSurfaces, size_t(0), "disabled cache keeps nothing");
+		ofxTest(cached.getImageSurfacePixels().getData() != nullptr && memcmp(cached.getImageSurfacePixels().getData(), uncached.getImageSurfacePixels().getData(), 64 * 64 * 4) == 0, "cached and uncached draws are the same");
+
+		// changing the pixels converts them again into the same surface
+		sprites[0].setColor(ofColor(0, 0, 255, 255));
+		drawSprites(cached, sprites, 1, 64, 64);
+		ofxTestEq(cached.getImageCacheStats().numMisses, size_t(5), "changed sprite converted again");
+		ofxTestEq(cached.getImageSurfacePixels().getColor(8, 8), ofColor(0, 0, 255, 255), "changed sprite drawn");
+
+		cached.setImageCacheSize(16 * 16 * 4 * 2);
+		stats = cached.getImageCacheStats();
+		ofxTestEq(stats.numSurfaces, size_t(2), "smaller cache evicts surfaces");
+		ofxTestEq(stats.numEvicted, size_t(2), "evicted count");
+
+		// a pdf embeds an image used as the source several times only once
+		ofCairoRenderer pdf;
+		pdf.setupMemoryOnly(ofCairoRenderer::PDF, false, false, ofRectangle(0, 0, 500, 500));
+		drawSprites(pdf, sprites, 200, 500, 500);
+		pdf.close();
+		ofCairoRenderer pdfUncached;
+		pdfUncached.setImageCacheSize(0);
+		pdfUncached.setupMemoryOnly(ofCairoRenderer::PDF, false, false, ofRectangle(0, 0, 500, 500));
+		drawSprites(pdfUncached, sprites, 200, 500, 500);
+		pdfUncached.close();
+		ofLogNotice() << "pdf with 200 sprite draws: " << pdf.getContentBuffer().size() << " bytes cached, " << pdfUncached.getContentBuffer().size() << " bytes uncached";
+		ofxTest(pdf.getContentBuffer().size() < pdfUncached.getContentBuffer().size(), "cached pdf is smaller");
+
+		// benchmark
+		{
+			std::vector<ofImage> bigSprites(8);
+			for(size_t i = 0; i < bigSprites.size(); i++){
+				bigSprites[i].setUseTexture(false);
+				bigSprites[i].allocate(128, 128, OF_IMAGE_COLOR_ALPHA);
+				bigSprites[i].setColor(ofColor::fromHsb(i * 30, 200, 255, 200));
+			}
+			int numDraws = 5000;
+			for(auto type: {ofCairoRenderer::IMAGE, ofCairoRenderer::PDF}){
+				float millis[2];
+				for(int useCache = 0; useCache < 2; useCache++){
+					ofCairoRenderer renderer;
+					renderer.setImageCacheSize(useCache ? 64 * 1024 * 1024 : 0);
+					renderer.setupMemoryOnly(type, false, false, ofRectangle(0, 0, 2048, 2048));
+					auto then = ofGetElapsedTimeMicros();
+					drawSprites(renderer, bigSprites, numDraws, 2048, 2048);
+					renderer.close();
+					millis[useCache] = (ofGetElapsedTimeMicros() - then) / 1000.f;
+				}
+				ofLogNotice() << numDraws << " sprite draws to " << (type == ofCairoRenderer::PDF ? "pdf" : "image") << ": " << millis[0] << "ms uncached, " << millis[1] << "ms cached";
+			}
+
+			ofPixels big;
+			big.allocate(4096, 4096, OF_PIXELS_RGBA);
+			big.set(100);
+			int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, big.getWidth());
+			std::vector<unsigned char> converted(stride * big.getHeight());
+			auto then = ofGetElapsedTimeMicros();
+			for(int i = 0; i < 10; i++){
+				ofCairoRenderer::toCairoPixels(big, converted.data(), stride);
+			}
+			auto seconds = (ofGetElapsedTimeMicros() - then) / 1000000.f;
+			ofLogNotice() << "rgba to cairo: " << big.size() * 10 / seconds / 1000000.f << "MB/s";
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
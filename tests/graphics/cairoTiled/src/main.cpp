@@ -0,0 +1,128 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofCairoRenderer.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void drawScene(ofCairoRenderer & renderer, int width, int height, int numShapes){
+		renderer.startRender();
+		renderer.background(ofFloatColor(0.1f, 0.1f, 0.2f, 1.f));
+		ofSeedRandom(7);
+		for(int i = 0; i < numShapes; i++){
+			renderer.setColor(ofFloatColor(ofRandomuf(), ofRandomuf(), ofRandomuf(), 0.7f));
+			float x = ofRandom(width);
+			float y = ofRandom(height);
+			float size = ofRandom(5, width / 10.f);
+			if(i % 2 == 0){
+				renderer.drawCircle(x, y, 0, size);
+			}else{
+				renderer.drawRectangle(x, y, 0, size, size * 0.5f);
+			}
+		}
+		renderer.finishRender();
+	}
+
+	int maxDifference(const ofPixels & a, const ofPixels & b){
+		if(a.size() != b.size()){
+			return 255;
+		}
+		int maxDiff = 0;
+		for(size_t i = 0; i < a.size(); i++){
+			maxDiff = std::max(maxDiff, std::abs(int(a[i]) - int(b[i])));
+		}
+		return maxDiff;
+	}
+
+	void run(){
+		int width = 1000;
+		int height = 700;
+		ofRectangle size(0, 0, width, height);
+
+		ofCairoRenderer single;
+		single.setupMemoryOnly(ofCairoRenderer::IMAGE, false, false, size);
+		drawScene(single, width, height, 200);
+		auto & singlePixels = single.getImageSurfacePixels();
+
+		// tiles that don't divide the image evenly
+		ofCairoRenderer::TileSettings settings;
+		settings.tileWidth = 256;
+		settings.tileHeight = 300;
+		settings.numThreads = 4;
+		ofCairoRenderer tiled;
+		tiled.setupTiled("", settings, size);
+		ofxTest(tiled.isTiled(), "renderer is tiled");
+		drawScene(tiled, width, height, 200);
+		auto & tiledPixels = tiled.getImageSurfacePixels();
+		ofxTestEq(tiledPixels.getWidth(), size_t(width), "tiled width");
+		ofxTestEq(tiledPixels.getHeight(), size_t(height), "tiled height");
+		// antialiasing can differ by a bit on the tile borders
+		ofxTest(maxDifference(singlePixels, tiledPixels) <= 2, "tiled image matches single surface");
+
+		// a second frame replaces the first one
+		drawScene(tiled, width, height, 10);
+		drawScene(single, width, height, 10);
+		ofxTest(maxDifference(single.getImageSurfacePixels(), tiled.getImageSurfacePixels()) <= 2, "second frame matches single surface");
+
+		// streamed to disk a row of tiles at a time
+		settings.streamToFile = true;
+		ofCairoRenderer streamed;
+		streamed.setupTiled("streamed.pam", settings, size);
+		drawScene(streamed, width, height, 10);
+		streamed.close();
+		auto buffer = ofBufferFromFile("streamed.pam");
+		std::string header = "P7\nWIDTH 1000\nHEIGHT 700\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+		ofxTestEq(buffer.size(), header.size() + width * height * 4, "streamed file size");
+		ofxTest(std::string(buffer.getData(), header.size()) == header, "streamed pam header");
+		bool samePixels = buffer.size() == header.size() + width * height * 4;
+		auto & expected = single.getImageSurfacePixels();
+		auto data = reinterpret_cast<const unsigned char *>(buffer.getData()) + header.size();
+		for(size_t i = 0; samePixels && i < size_t(width * height); i++){
+			// premultiplied bgra in the surface, straight rgba in the file,
+			// premultiplied again to compare without the rounding of low alphas
+			int alpha = data[i * 4 + 3];
+			for(int c = 0; c < 3; c++){
+				int premultiplied = (data[i * 4 + c] * alpha + 127) / 255;
+				samePixels &= std::abs(premultiplied - int(expected[i * 4 + 2 - c])) <= 2;
+			}
+			samePixels &= std::abs(alpha - int(expected[i * 4 + 3])) <= 2;
+		}
+		ofxTest(samePixels, "streamed pixels match single surface");
+
+		// benchmark
+		{
+			int bigWidth = 4096;
+			int bigHeight = 4096;
+			int numShapes = 5000;
+			ofRectangle bigSize(0, 0, bigWidth, bigHeight);
+
+			auto then = ofGetElapsedTimeMicros();
+			ofCairoRenderer bigSingle;
+			bigSingle.setupMemoryOnly(ofCairoRenderer::IMAGE, false, false, bigSize);
+			drawScene(bigSingle, bigWidth, bigHeight, numShapes);
+			bigSingle.getImageSurfacePixels();
+			auto singleMillis = (ofGetElapsedTimeMicros() - then) / 1000.f;
+
+			then = ofGetElapsedTimeMicros();
+			ofCairoRenderer bigTiled;
+			bigTiled.setupTiled("", ofCairoRenderer::TileSettings(), bigSize);
+			drawScene(bigTiled, bigWidth, bigHeight, numShapes);
+			bigTiled.getImageSurfacePixels();
+			auto tiledMillis = (ofGetElapsedTimeMicros() - then) / 1000.f;
+
+			ofLogNotice() << bigWidth << "x" << bigHeight << " " << numShapes << " shapes: single surface " << singleMillis << "ms, tiled with " << std::thread::hardware_concurrency() << " threads " << tiledMillis << "ms";
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,139 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// a gradient that changes with the frame number so every file is different
+	ofPixels makeFrame(size_t width, size_t height, size_t frame){
+		ofPixels pixels;
+		pixels.allocate(width, height, OF_PIXELS_RGB);
+		for(size_t y = 0; y < height; y++){
+			for(size_t x = 0; x < width; x++){
+				pixels.setColor(x, y, ofColor((x + frame) % 256, (y + frame * 3) % 256, frame % 256));
+			}
+		}
+		return pixels;
+	}
+
+	void run(){
+		{
+			ofImageSequenceRecorder recorder;
+			ofImageSequenceRecorder::Settings settings;
+			settings.folder = "sequence";
+			settings.numDigits = 4;
+			settings.firstFrame = 10;
+			ofxTest(recorder.setup(settings), "setup");
+
+			std::vector<ofPixels> frames;
+			for(size_t i = 0; i < 20; i++){
+				frames.push_back(makeFrame(64, 48, i));
+				auto pixels = frames.back();
+				ofxTest(recorder.add(std::move(pixels)), "add frame " + ofToString(i));
+				ofxTest(!pixels.isAllocated(), "pixels moved");
+			}
+			recorder.close();
+
+			auto stats = recorder.getStats();
+			ofxTestEq(stats.numFramesAdded, uint64_t(20), "frames added");
+			ofxTestEq(stats.numFramesWritten, uint64_t(20), "frames written");
+			ofxTestEq(stats.queueDepth, size_t(0), "queue empty after close");
+			ofxTest(stats.maxQueueDepth <= recorder.getSettings().maxQueuedFrames, "queue bounded");
+			ofxTestEq(recorder.getFramePath(10).filename().string(), std::string("frame_0010.png"), "numbering");
+
+			bool allMatch = true;
+			for(size_t i = 0; i < frames.size(); i++){
+				ofPixels loaded;
+				if(!ofLoadImage(loaded, recorder.getFramePath(10 + i)) || loaded.getData() == nullptr ||
+				   loaded.size() != frames[i].size() || !std::equal(loaded.begin(), loaded.end(), frames[i].begin())){
+					allMatch = false;
+				}
+			}
+			ofxTest(allMatch, "files contain the frames in order");
+			ofxTest(!ofFile::doesFileExist(recorder.getFramePath(30)), "no extra files");
+			ofDirectory::removeDirectory("sequence", true);
+		}
+
+		{
+			// one slow thread and a tiny queue, dropping keeps the numbering contiguous
+			ofImageSequenceRecorder recorder;
+			ofImageSequenceRecorder::Settings settings;
+			settings.folder = "dropped";
+			settings.numThreads = 1;
+			settings.maxQueuedFrames = 1;
+			settings.overflowPolicy = ofImageSequenceRecorder::Drop;
+			recorder.setup(settings);
+			auto frame = makeFrame(1024, 1024, 0);
+			size_t numAdded = 0;
+			for(size_t i = 0; i < 20; i++){
+				numAdded += recorder.add(frame);
+			}
+			recorder.close();
+			auto stats = recorder.getStats();
+			ofxTest(stats.numFramesDropped > 0, "frames dropped when the queue is full");
+			ofxTestEq(stats.numFramesAdded + stats.numFramesDropped, uint64_t(20), "every frame added or dropped");
+			ofxTestEq(stats.numFramesWritten, uint64_t(numAdded), "added frames written");
+			ofxTest(ofFile::doesFileExist(recorder.getFramePath(numAdded - 1)), "last frame written");
+			ofxTest(!ofFile::doesFileExist(recorder.getFramePath(numAdded)), "no gaps in the numbering");
+			ofDirectory::removeDirectory("dropped", true);
+		}
+
+		{
+			ofImageSequenceRecorder recorder;
+			ofImageSequenceRecorder::Settings settings;
+			settings.extension = "notanimage";
+			ofxTest(!recorder.setup(settings), "setup fails with an unknown extension");
+			ofxTest(!recorder.add(makeFrame(8, 8, 0)), "add fails if not setup");
+		}
+
+		// benchmark: 1000 full HD frames, blocking when the disk or the
+		// encoders can't keep up, compared with saving synchronously
+		const size_t width = 1920, height = 1080, numFrames = 1000, numSyncFrames = 50;
+		std::vector<ofPixels> source;
+		for(size_t i = 0; i < 8; i++){
+			source.push_back(makeFrame(width, height, i));
+		}
+
+		auto then = ofGetElapsedTimeMicros();
+		for(size_t i = 0; i < numSyncFrames; i++){
+			ofSaveImage(source[i % source.size()], "benchmark_sync/frame_" + ofToString(i, 5, '0') + ".png");
+		}
+		float syncMillis = (ofGetElapsedTimeMicros() - then) / 1000.f / numSyncFrames;
+		ofDirectory::removeDirectory("benchmark_sync", true);
+
+		ofImageSequenceRecorder recorder;
+		ofImageSequenceRecorder::Settings settings;
+		settings.folder = "benchmark";
+		recorder.setup(settings);
+		float maxAddMillis = 0;
+		then = ofGetElapsedTimeMicros();
+		for(size_t i = 0; i < numFrames; i++){
+			ofPixels pixels = source[i % source.size()];
+			auto addThen = ofGetElapsedTimeMicros();
+			recorder.add(std::move(pixels));
+			maxAddMillis = std::max(maxAddMillis, (ofGetElapsedTimeMicros() - addThen) / 1000.f);
+		}
+		float addMillis = (ofGetElapsedTimeMicros() - then) / 1000.f;
+		recorder.waitForAll();
+		float totalMillis = (ofGetElapsedTimeMicros() - then) / 1000.f;
+		auto stats = recorder.getStats();
+		recorder.close();
+		ofxTestEq(stats.numFramesWritten, uint64_t(numFrames), "benchmark frames written");
+		ofDirectory::removeDirectory("benchmark", true);
+
+		ofLogNotice() << "ofSaveImage: " << syncMillis << "ms per frame";
+		ofLogNotice() << "recorder with " << recorder.getSettings().numThreads << " threads: " << totalMillis / numFrames << "ms per frame, "
+			<< stats.framesPerSecond << " fps, " << stats.megabytesPerSecond << "MB/s";
+		ofLogNotice() << "add(): " << addMillis / numFrames << "ms average, " << maxAddMillis << "ms max, "
+			<< stats.blockedMillis << "ms blocked in total, max queue depth " << stats.maxQueueDepth
+			<< ", " << stats.averageEncodeMillis << "ms average encode";
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
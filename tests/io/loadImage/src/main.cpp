@@ -2,7 +2,126 @@
 #include "ofAppNoWindow.h"
 #include "ofxUnitTests.h"
 
+#ifdef TARGET_LINUX
+// peak resident memory of the process in KB
+static size_t peakMemoryKB(){
+	size_t peak = 0;
+	for(auto & line: ofSplitString(ofBufferFromFile("/proc/self/status").getText(), "\n")){
+		if(ofIsStringInString(line, "VmHWM:")){
+			peak = ofToInt(ofSplitString(line, ":", true, true)[1]);
+		}
+	}
+	return peak;
+}
+#endif
+
 class ofApp: public ofxUnitTestsApp{
+	// a gradient with a marker square so regions and flips can be checked
+	ofPixels makeImage(size_t width, size_t height){
+		ofPixels pixels;
+		pixels.allocate(width, height, OF_PIXELS_RGB);
+		for(size_t y = 0; y < height; y++){
+			for(size_t x = 0; x < width; x++){
+				pixels.setColor(x, y, ofColor(x * 255 / width, y * 255 / height, (x < 16 && y < 16) ? 255 : 0));
+			}
+		}
+		return pixels;
+	}
+
+	void testSettings(){
+		auto source = makeImage(320, 240);
+		ofxTest(ofSaveImage(source, "settings.png"), "save png");
+
+		ofImageLoadSettings settings;
+		settings.maxSize = 100;
+		ofPixels pixels;
+		ofxTest(ofLoadImage(pixels, "settings.png", settings), "load with max size");
+		ofxTestEq(pixels.getWidth(), size_t(100), "max size width");
+		ofxTestEq(pixels.getHeight(), size_t(75), "max size keeps the aspect ratio");
+
+		settings = ofImageLoadSettings();
+		settings.region.set(100, 50, 64, 32);
+		ofxTest(ofLoadImage(pixels, "settings.png", settings), "load region");
+		ofxTestEq(pixels.getWidth(), size_t(64), "region width");
+		ofxTestEq(pixels.getHeight(), size_t(32), "region height");
+		bool regionMatches = true;
+		for(size_t y = 0; y < 32; y++){
+			for(size_t x = 0; x < 64; x++){
+				regionMatches &= pixels.getColor(x, y) == source.getColor(100 + x, 50 + y);
+			}
+		}
+		ofxTest(regionMatches, "region contents");
+
+		settings.region.set(300, 200, 100, 100);
+		ofxTest(ofLoadImage(pixels, "settings.png", settings), "region clamped to the image");
+		ofxTestEq(pixels.getWidth(), size_t(20), "clamped region width");
+		settings.region.set(400, 300, 10, 10);
+		ofxTest(!ofLoadImage(pixels, "settings.png", settings), "region outside of the image fails");
+
+		settings = ofImageLoadSettings();
+		settings.flipVertical = false;
+		ofxTest(ofLoadImage(pixels, "settings.png", settings), "load without flip");
+		ofxTest(pixels.getColor(0, 239) == source.getColor(0, 0), "rows bottom up without flip");
+
+		ofBuffer buffer = ofBufferFromFile("settings.png");
+		settings = ofImageLoadSettings();
+		settings.maxSize = 50;
+		settings.region.set(0, 0, 160, 120);
+		ofxTest(ofLoadImage(pixels, buffer, settings), "region and max size from a buffer");
+		ofxTestEq(pixels.getWidth(), size_t(50), "region scaled to max size");
+		ofFile::removeFile("settings.png");
+	}
+
+	void benchmark(){
+		// a 40 megapixel jpeg, thumbnails with and without DCT scaling
+		const size_t width = 7744, height = 5184;
+		ofxTest(ofSaveImage(makeImage(width, height), "large.jpg", OF_IMAGE_QUALITY_HIGH), "save large jpeg");
+
+		auto measure = [&](const std::string & name, std::function<void(ofPixels &)> load){
+#ifdef TARGET_LINUX
+			size_t peakBefore = peakMemoryKB();
+#endif
+			ofPixels pixels;
+			auto then = ofGetElapsedTimeMicros();
+			load(pixels);
+			auto millis = (ofGetElapsedTimeMicros() - then) / 1000.f;
+			std::stringstream result;
+			result << name << ": " << millis << "ms, " << pixels.getWidth() << "x" << pixels.getHeight();
+#ifdef TARGET_LINUX
+			// the peak only grows so the cheapest loads have to run first
+			result << ", peak memory +" << (peakMemoryKB() - peakBefore) / 1024 << "MB";
+#endif
+			ofLogNotice() << result.str();
+			return pixels;
+		};
+
+		ofImageLoadSettings thumbnail;
+		thumbnail.maxSize = 256;
+		auto small = measure("maxSize 256", [&](ofPixels & pixels){
+			ofLoadImage(pixels, "large.jpg", thumbnail);
+		});
+		ofxTestEq(std::max(small.getWidth(), small.getHeight()), size_t(256), "thumbnail size");
+
+		ofImageLoadSettings crop;
+		crop.region.set(width / 2, height / 2, 1024, 1024);
+		auto region = measure("region 1024x1024", [&](ofPixels & pixels){
+			ofLoadImage(pixels, "large.jpg", crop);
+		});
+		ofxTestEq(region.getWidth(), size_t(1024), "region of the large image");
+
+		ofImageLoadSettings noFlip;
+		noFlip.flipVertical = false;
+		measure("full size, no flip", [&](ofPixels & pixels){
+			ofLoadImage(pixels, "large.jpg", noFlip);
+		});
+		auto resized = measure("full size and resize to 256", [&](ofPixels & pixels){
+			ofLoadImage(pixels, "large.jpg");
+			pixels.resize(256, 256 * height / width, OF_INTERPOLATE_BILINEAR);
+		});
+		ofxTestEq(resized.getWidth(), small.getWidth(), "same thumbnail size");
+		ofFile::removeFile("large.jpg");
+	}
+
 	void run(){
 		ofImage img;
 		img.setUseTexture(false);
@@ -10,6 +129,9 @@ class ofApp: public ofxUnitTestsApp{
 		ofxTest(img.load(ofToDataPath("indispensable.jpg", true)), "load from fs");
 		ofxTest(img.load("http://openframeworks.cc/about/0.jpg"), "load from http");
 		ofxTest(img.load("https://forum.openframeworks.cc/user_avatar/forum.openframeworks.cc/arturo/45/3965_1.png"), "load from https");
+
+		testSettings();
+		benchmark();
 	}
 };
 
@@ -39,6 +39,59 @@ bool aprox_eq(const glm::quat & v1, const glm::quat & v2) {
 }
 class ofApp: public ofxUnitTestsApp{
 public:
+	// every node gets the previous node at the same level as a sibling
+	// until there are childrenPerNode of them, deep is a single chain
+	// and wide is one root with every other node as a child
+	void benchmarkHierarchy(const std::string & name, size_t numNodes, size_t childrenPerNode){
+		std::vector<ofNode> nodes(numNodes);
+		for(size_t i = 1; i < numNodes; i++){
+			nodes[i].setParent(nodes[(i - 1) / childrenPerNode]);
+			nodes[i].setPosition({ 0.01f, 0.f, 0.f });
+		}
+		const int frames = 10;
+		glm::vec3 sum(0.f);
+
+		// move the root and read every global position once
+		auto start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			nodes[0].setPosition({ float(i), 0.f, 0.f });
+			for(auto & node: nodes){
+				sum += node.getGlobalPosition();
+			}
+		}
+		auto recursive = ofGetElapsedTimeMicros() - start;
+
+		ofNodeHierarchy hierarchy;
+		hierarchy.add(nodes[0]);
+		hierarchy.update();
+		uint64_t cached[2];
+		for(size_t threads: { 1, 4 }){
+			hierarchy.setNumThreads(threads);
+			start = ofGetElapsedTimeMicros();
+			for(int i = 0; i < frames; i++){
+				nodes[0].setPosition({ float(i), 0.f, 0.f });
+				hierarchy.update();
+				for(auto & node: nodes){
+					sum += node.getGlobalPosition();
+				}
+			}
+			cached[threads == 1 ? 0 : 1] = ofGetElapsedTimeMicros() - start;
+		}
+
+		// a single leaf moving only updates that node
+		start = ofGetElapsedTimeMicros();
+		for(int i = 0; i < frames; i++){
+			nodes.back().setPosition({ float(i), 0.f, 0.f });
+			hierarchy.update();
+			sum += nodes.back().getGlobalPosition();
+		}
+		auto leaf = ofGetElapsedTimeMicros() - start;
+
+		ofLogNotice() << name << " " << numNodes << " nodes, recursive: " << recursive / frames
+			<< "us, hierarchy: " << cached[0] / frames << "us, 4 threads: " << cached[1] / frames
+			<< "us, moving a leaf: " << leaf / frames << "us per frame (" << sum.x << ")";
+	}
+
     void run(){
 		{
 			ofLogNotice() << "start orbit test";
@@ -145,6 +198,82 @@ public:
 			ofLogNotice() << "end add / clear parent and keep global transform";
 		}
 
+		{
+			ofLogNotice() << "hierarchy start";
+			std::vector<ofNode> nodes(1000);
+			for(size_t i = 1; i < nodes.size(); i++){
+				nodes[i].setParent(nodes[(i - 1) / 3]);
+				nodes[i].setPosition({ 10.f, 0.f, float(i % 7) });
+				nodes[i].rotateDeg(i % 30, { 0.f, 1.f, 0.f });
+				nodes[i].setScale(1.01f);
+			}
+			std::vector<glm::mat4> expected;
+			for(auto & node: nodes){
+				expected.push_back(node.getGlobalTransformMatrix());
+			}
+
+			ofNodeHierarchy hierarchy;
+			hierarchy.add(nodes[0]);
+			ofxTestEq(hierarchy.size(), nodes.size(), "	descendants are added");
+			ofxTest(nodes.back().getHierarchy() == &hierarchy, "	nodes know their hierarchy");
+			auto zero = glm::vec4(0,0,0,1);
+			bool same = true;
+			for(size_t i = 0; i < nodes.size(); i++){
+				same &= aprox_eq(nodes[i].getGlobalTransformMatrix() * zero, expected[i] * zero);
+			}
+			ofxTest(same, "	same global transforms");
+
+			nodes[1].move({ 0.f, 5.f, 0.f });
+			ofxTest(aprox_eq(nodes[4].getGlobalPosition(), glm::vec3(expected[4][3]) + glm::vec3(0.f, 5.f, 0.f)), "	changes propagate to the children");
+
+			nodes[4].setParent(nodes[2], true);
+			auto position = nodes[4].getGlobalPosition();
+			nodes[2].move({ 1.f, 0.f, 0.f });
+			ofxTest(aprox_eq(nodes[4].getGlobalPosition(), position + glm::vec3(1.f, 0.f, 0.f)), "	reparenting");
+
+			// only the subtrees of the changed nodes are updated, every read
+			// after a change still has to see all the previous ones
+			same = true;
+			for(size_t i = 290; i < 330; i++){
+				nodes[i].setPosition({ 0.f, float(i), 0.f });
+				same &= aprox_eq(nodes[i].getGlobalTransformMatrix() * zero, nodes[i].getParent()->getGlobalTransformMatrix() * nodes[i].getLocalTransformMatrix() * zero);
+				same &= aprox_eq(nodes[i * 3 + 1].getGlobalTransformMatrix() * zero, nodes[i].getGlobalTransformMatrix() * nodes[i * 3 + 1].getLocalTransformMatrix() * zero);
+			}
+			ofxTest(same, "	interleaved changes and reads");
+
+			ofNode outside;
+			nodes[0].setParent(outside);
+			outside.setPosition({ 0.f, 0.f, 100.f });
+			ofxTest(aprox_eq(nodes[0].getGlobalPosition(), glm::vec3(0.f, 0.f, 100.f)), "	parent outside of the hierarchy");
+			ofNode outsideRoot;
+			outside.setParent(outsideRoot);
+			outsideRoot.setPosition({ 0.f, 50.f, 0.f });
+			ofxTest(aprox_eq(nodes[0].getGlobalPosition(), glm::vec3(0.f, 50.f, 100.f)), "	ancestors of a parent outside of the hierarchy");
+			ofxTest(aprox_eq(nodes[0].getGlobalPosition(), glm::vec3(0.f, 50.f, 100.f)), "	repeated reads without changes");
+			outside.clearParent();
+			nodes[0].clearParent();
+
+			{
+				ofNode temporary;
+				temporary.setParent(nodes[10]);
+				hierarchy.add(temporary);
+				ofxTestEq(hierarchy.size(), nodes.size() + 1, "	add a single node");
+			}
+			ofxTestEq(hierarchy.size(), nodes.size(), "	destroyed nodes are removed");
+
+			hierarchy.remove(nodes[3]);
+			ofxTest(nodes[3].getHierarchy() == nullptr, "	remove");
+			nodes[3].setPosition({ 0.f, 0.f, 0.f });
+			ofxTest(aprox_eq(nodes[3].getGlobalPosition(), nodes[0].getGlobalPosition()), "	removed nodes use their parent");
+
+			hierarchy.clear();
+			ofxTest(nodes[0].getHierarchy() == nullptr, "	clear");
+			ofLogNotice() << "hierarchy end";
+		}
+
+		benchmarkHierarchy("deep", 50000, 1);
+		benchmarkHierarchy("wide", 50000, 50000);
+		benchmarkHierarchy("balanced", 50000, 8);
 
     }
 };
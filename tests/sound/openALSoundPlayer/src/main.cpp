@@ -0,0 +1,134 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+#ifdef OF_SOUND_PLAYER_OPENAL
+#include "ofOpenALSoundPlayer.h"
+#include <sndfile.h>
+#include <cstdlib>
+
+class ofApp: public ofxUnitTestsApp{
+	// stereo sine wave, the right channel at half amplitude
+	bool writeSine(const std::string & path, float freq, float seconds, int samplerate = 44100){
+		SF_INFO info;
+		info.samplerate = samplerate;
+		info.channels = 2;
+		info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+		SNDFILE * f = sf_open(path.c_str(), SFM_WRITE, &info);
+		if(!f){
+			return false;
+		}
+		std::vector<short> samples(size_t(seconds * samplerate) * 2);
+		for(size_t i = 0; i < samples.size() / 2; i++){
+			float value = sin(glm::two_pi<float>() * freq * i / samplerate);
+			samples[i * 2] = value * 32000;
+			samples[i * 2 + 1] = value * 16000;
+		}
+		sf_writef_short(f, samples.data(), samples.size() / 2);
+		sf_close(f);
+		return true;
+	}
+
+	void run(){
+		auto path = ofToDataPath("sine.wav", true);
+		auto longPath = ofToDataPath("long.wav", true);
+		ofxTest(writeSine(path, 1000, 1), "test file written");
+		ofxTest(writeSine(longPath, 440, 60), "long test file written");
+
+		{
+			ofOpenALSoundPlayer player1, player2;
+			ofxTest(player1.load(path), "load");
+			ofxTestEq(player1.getDuration(), 1.f, "duration");
+			ofxTestEq(ofOpenALSoundPlayer::getNumCachedSounds(), 1, "decoded sound is cached");
+			ofxTest(player2.load(path), "load the same file again");
+			ofxTestEq(ofOpenALSoundPlayer::getNumCachedSounds(), 1, "players loading the same file share it");
+
+			player1.setLoop(true);
+			player1.play();
+			ofSleepMillis(100);
+			auto spectrum = player1.getSpectrum(257);
+			int peak = std::max_element(spectrum, spectrum + 257) - spectrum;
+			ofxTestEq(peak, int(round(1000.f / (44100.f / 512.f))), "spectrum peak at the sine frequency");
+			player1.stop();
+		}
+		ofxTestEq(ofOpenALSoundPlayer::getNumCachedSounds(), 0, "the cache is released with the players");
+
+		{
+			ofOpenALSoundPlayer player;
+			ofxTest(player.loadAsync(path), "load async");
+			player.setVolume(0.5);
+			player.play();
+			auto start = ofGetElapsedTimeMillis();
+			while(player.isLoading() && ofGetElapsedTimeMillis() - start < 5000){
+				ofSleepMillis(1);
+			}
+			ofxTest(player.isLoaded(), "async load finishes");
+			ofxTest(player.isPlaying(), "play while loading is applied once loaded");
+			ofxTestEq(player.getVolume(), 0.5f, "volume set while loading is kept");
+		}
+
+		{
+			ofOpenALSoundPlayer player;
+			ofxTest(player.load(longPath, true), "load stream");
+			ofxTestEq(round(player.getDuration()), 60.f, "stream duration");
+			player.play();
+			ofSleepMillis(200);
+			ofxTest(player.isPlaying(), "stream plays");
+			auto spectrum = player.getSpectrum(257);
+			ofSleepMillis(200);
+			spectrum = player.getSpectrum(257);
+			int peak = std::max_element(spectrum, spectrum + 257) - spectrum;
+			ofxTestEq(peak, int(round(440.f / (44100.f / 512.f))), "stream spectrum peak at the sine frequency");
+			player.stop();
+		}
+
+		// many players loading the same long sample
+		const int numPlayers = 16;
+		auto startSync = ofGetElapsedTimeMicros();
+		{
+			std::vector<ofOpenALSoundPlayer> players(numPlayers);
+			for(auto & player: players){
+				player.load(longPath);
+			}
+			ofLogNotice() << numPlayers << " players loading the same file: " << (ofGetElapsedTimeMicros() - startSync) / 1000.f << "ms";
+		}
+		auto startAsync = ofGetElapsedTimeMicros();
+		{
+			std::vector<ofOpenALSoundPlayer> players(numPlayers);
+			for(auto & player: players){
+				player.loadAsync(longPath);
+			}
+			ofLogNotice() << numPlayers << " players loading async, returned after: " << (ofGetElapsedTimeMicros() - startAsync) / 1000.f << "ms";
+			bool loading = true;
+			while(loading){
+				loading = false;
+				for(auto & player: players){
+					loading |= player.isLoading();
+				}
+				ofSleepMillis(1);
+			}
+			ofLogNotice() << numPlayers << " players loading async, loaded after: " << (ofGetElapsedTimeMicros() - startAsync) / 1000.f << "ms";
+			ofxTestEq(ofOpenALSoundPlayer::getNumCachedSounds(), 1, "concurrent async loads decode once");
+		}
+	}
+};
+#else
+class ofApp: public ofxUnitTestsApp{
+	void run(){
+		ofLogNotice() << "this platform doesn't use the OpenAL sound player";
+	}
+};
+#endif
+
+//========================================================================
+int main( ){
+#ifndef TARGET_WIN32
+	// OpenAL Soft's null backend mixes without an audio device so this runs headless
+	setenv("ALSOFT_DRIVERS", "null", 0);
+#endif
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -0,0 +1,130 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+#ifdef OF_SOUNDSTREAM_RTAUDIO
+#include "ofRtAudioSoundStream.h"
+
+// writes a sine without allocating
+class SineOutput: public ofBaseSoundOutput{
+public:
+	void audioOut(ofSoundBuffer & buffer){
+		for(size_t i = 0; i < buffer.getNumFrames(); i++){
+			float value = sin(phase) * 0.1;
+			phase += glm::two_pi<float>() * 440 / buffer.getSampleRate();
+			for(size_t c = 0; c < buffer.getNumChannels(); c++){
+				buffer[i * buffer.getNumChannels() + c] = value;
+			}
+		}
+		phase = fmod(phase, glm::two_pi<float>());
+	}
+	float phase = 0;
+};
+
+// allocates and locks on every callback, what the realtime check should flag
+class AllocatingOutput: public ofBaseSoundOutput{
+public:
+	void audioOut(ofSoundBuffer & buffer){
+		std::unique_lock<std::mutex> lock(mutex);
+		copies.emplace_back(buffer.getBuffer());
+	}
+	std::mutex mutex;
+	std::vector<std::vector<float>> copies;
+};
+
+// runs the callbacks RtAudio would run, RtAudio falls back to its dummy
+// api when it's compiled without any backend and that one never calls them
+class ofDrivenSoundStream: public ofRtAudioSoundStream{
+public:
+	void run(const ofSoundStreamSettings & settings, size_t numCallbacks){
+		this->settings = settings;
+		allocateBuffers(settings.bufferSize);
+		std::vector<float> output(settings.bufferSize * settings.numOutputChannels);
+		for(size_t i = 0; i < numCallbacks; i++){
+			rtAudioCallback(output.data(), nullptr, settings.bufferSize, 0, 0, this);
+		}
+	}
+};
+
+class ofApp: public ofxUnitTestsApp{
+	void testStats(const ofRtAudioSoundStream::CallbackStats & stats, const ofRtAudioSoundStream & stream){
+		uint64_t total = 0;
+		for(auto count: stats.histogram){
+			total += count;
+		}
+		ofxTestEq(total, stats.numCallbacks, "every callback in the histogram");
+		ofxTestEq(stats.numDeadlineMisses, stats.histogram.back(), "deadline misses are the last bin");
+		ofxTestEq(stats.numBufferResizes, uint64_t(0), "buffers allocated in setup");
+		ofxTest(std::abs(stats.deadlineMicros - stream.getBufferSize() * 1000000.f / stream.getSampleRate()) < 1, "deadline is the buffer duration");
+		ofxTest(stats.maxLoad >= stats.averageLoad, "max load is at least the average");
+		ofxTestEq(stats.numAllocations, uint64_t(0), "no allocations in the callback");
+		ofxTestEq(stats.numLocks, uint64_t(0), "no locks in the callback");
+	}
+
+	void run(){
+		// realtimeCheck.cpp installs itself when the program starts
+		ofxTest(ofRtAudioSoundStream::isRealtimeCheckEnabled(), "realtime check installed");
+
+		SineOutput sine;
+		ofSoundStreamSettings settings;
+		settings.numOutputChannels = 2;
+		settings.sampleRate = 44100;
+		settings.bufferSize = 256;
+		settings.setOutListener(&sine);
+
+		ofDrivenSoundStream driven;
+		ofxTestEq(driven.getCallbackStats().numCallbacks, uint64_t(0), "no callbacks before setup");
+		driven.run(settings, 100);
+		auto stats = driven.getCallbackStats();
+		ofxTestEq(stats.numCallbacks, uint64_t(100), "every callback counted");
+		testStats(stats, driven);
+
+		AllocatingOutput allocating;
+		settings.setOutListener(&allocating);
+		driven.run(settings, 100);
+		stats = driven.getCallbackStats();
+		ofxTest(stats.numAllocations >= stats.numCallbacks, "allocations in the listener detected");
+#ifdef TARGET_LINUX
+		ofxTest(stats.numLocks >= stats.numCallbacks, "locks in the listener detected");
+#endif
+
+		// the same with a real device, if there's one
+		settings.setOutListener(&sine);
+		ofRtAudioSoundStream stream;
+		if(!stream.setup(settings)){
+			ofLogNotice() << "no audio device available, skipping the device tests";
+			ofxTestEq(stream.getCallbackStats().numCallbacks, uint64_t(0), "no callbacks without a device");
+			return;
+		}
+		ofSleepMillis(500);
+		stream.stop();
+		stats = stream.getCallbackStats();
+		ofxTest(stats.numCallbacks > 0, "device callbacks ran");
+		testStats(stats, stream);
+
+		std::stringstream histogram;
+		for(size_t i = 0; i < stats.histogram.size(); i++){
+			histogram << (i < stats.histogram.size() - 1 ? ofToString(i * 10) + "%: " : "missed: ") << stats.histogram[i] << " ";
+		}
+		ofLogNotice() << stats.numCallbacks << " callbacks, average load " << stats.averageLoad * 100
+			<< "%, max " << stats.maxLoad * 100 << "% of " << stats.deadlineMicros << "us";
+		ofLogNotice() << histogram.str();
+		stream.close();
+	}
+};
+#else
+class ofApp: public ofxUnitTestsApp{
+	void run(){
+		ofLogNotice() << "this platform doesn't use the RtAudio sound stream";
+	}
+};
+#endif
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
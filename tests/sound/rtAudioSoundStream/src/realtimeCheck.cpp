@@ -0,0 +1,122 @@
+// counts the allocations and locks on the audio thread of an
+// ofRtAudioSoundStream. it replaces the global operator new and, on linux,
+// pthread_mutex_lock for the whole program so it's linked into this test
+// instead of openFrameworks, copy it into a debug build of an app to check
+// its listeners
+#include "ofConstants.h"
+
+#ifdef OF_SOUNDSTREAM_RTAUDIO
+#include "ofRtAudioSoundStream.h"
+#include <cstdlib>
+#include <new>
+#ifdef TARGET_LINUX
+#include <atomic>
+#include <cerrno>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#define OF_REALTIME_CHECK_LOCKS
+#endif
+
+namespace{
+	// thread local and trivially constructible so using it never allocates
+	// or locks
+	struct Counters{
+		bool active;
+		bool counting;
+		uint64_t allocations;
+		uint64_t locks;
+	};
+	thread_local Counters counters{false, false, 0, 0};
+
+	// counts the outermost call on the thread while it lasts, what it calls
+	// in turn, like an allocator that locks, isn't counted again
+	struct Count{
+		Count(uint64_t & counter)
+		:outermost(counters.active && !counters.counting){
+			if(outermost){
+				counters.counting = true;
+				counter++;
+			}
+		}
+		~Count(){
+			if(outermost){
+				counters.counting = false;
+			}
+		}
+		bool outermost;
+	};
+
+	void begin(){
+		counters.allocations = 0;
+		counters.locks = 0;
+		counters.active = true;
+	}
+
+	void end(uint64_t & numAllocations, uint64_t & numLocks){
+		counters.active = false;
+		numAllocations = counters.allocations;
+		numLocks = counters.locks;
+	}
+
+	const ofRtAudioSoundStream::RealtimeCheck check{begin, end};
+
+	struct Install{
+		Install(){
+			ofRtAudioSoundStream::setRealtimeCheck(&check);
+		}
+	} install;
+}
+
+void * operator new(std::size_t size){
+	Count allocation(counters.allocations);
+	if(size == 0){
+		size = 1;
+	}
+	while(true){
+		void * ptr = std::malloc(size);
+		if(ptr){
+			return ptr;
+		}
+		auto handler = std::get_new_handler();
+		if(!handler){
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+void operator delete(void * ptr) noexcept{
+	std::free(ptr);
+}
+
+#ifdef OF_REALTIME_CHECK_LOCKS
+namespace{
+	using LockFunction = int(*)(pthread_mutex_t *);
+	std::atomic<LockFunction> realLock(nullptr);
+	thread_local bool lookingUpLock = false;
+}
+
+// std::mutex and most other locks end up here, the real function is looked
+// up the first time. dlsym could lock too, until it returns those locks
+// retry instead of calling back into it
+extern "C" int pthread_mutex_lock(pthread_mutex_t * mutex) noexcept{
+	Count lock(counters.locks);
+	auto real = realLock.load();
+	if(!real && !lookingUpLock){
+		lookingUpLock = true;
+		real = (LockFunction)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+		realLock = real;
+		lookingUpLock = false;
+	}
+	if(real){
+		return real(mutex);
+	}
+	int result;
+	while((result = pthread_mutex_trylock(mutex)) == EBUSY){
+		sched_yield();
+	}
+	return result;
+}
+#endif
+#endif
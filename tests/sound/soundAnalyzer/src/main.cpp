@@ -0,0 +1,150 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// feeds the samples in buffers of the size a sound stream would use
+	void feed(ofSoundAnalyzer & analyzer, const std::vector<float> & samples, size_t numChannels, size_t bufferSize = 256){
+		size_t numFrames = samples.size() / numChannels;
+		for(size_t i = 0; i < numFrames; i += bufferSize){
+			analyzer.process(samples.data() + i * numChannels, std::min(bufferSize, numFrames - i), numChannels);
+		}
+	}
+
+	std::vector<float> sine(float freq, float amplitude, float seconds, size_t sampleRate){
+		std::vector<float> samples(seconds * sampleRate);
+		for(size_t i = 0; i < samples.size(); i++){
+			samples[i] = amplitude * sin(glm::two_pi<float>() * freq * i / sampleRate);
+		}
+		return samples;
+	}
+
+	void run(){
+		const size_t sampleRate = 44100;
+
+		{
+			ofSoundAnalyzer analyzer;
+			ofSoundAnalyzer::Settings settings;
+			settings.windowSize = 1000;
+			settings.hopSize = 0;
+			settings.threaded = false;
+			ofxTest(analyzer.setup(settings, sampleRate), "setup");
+			ofxTestEq(analyzer.getSettings().windowSize, size_t(1024), "window size rounded to a power of two");
+			ofxTestEq(analyzer.getSettings().hopSize, size_t(1), "hop size clamped");
+			ofxTestEq(analyzer.getSnapshot().spectrum.size(), size_t(513), "spectrum size");
+			ofxTestEq(analyzer.getSnapshot().bands.size(), size_t(32), "number of bands");
+			auto & frequencies = analyzer.getSnapshot().bandFrequencies;
+			ofxTest(std::is_sorted(frequencies.begin(), frequencies.end()), "band frequencies sorted");
+		}
+
+		{
+			// a stereo sine, the second channel silent so mixing halves the amplitude
+			ofSoundAnalyzer analyzer;
+			ofSoundAnalyzer::Settings settings;
+			settings.threaded = false;
+			analyzer.setup(settings, sampleRate);
+			auto mono = sine(1000, 0.5, 1, sampleRate);
+			std::vector<float> stereo(mono.size() * 2, 0);
+			for(size_t i = 0; i < mono.size(); i++){
+				stereo[i * 2] = mono[i];
+			}
+			feed(analyzer, stereo, 2);
+
+			auto & analysis = analyzer.getSnapshot();
+			ofxTestEq(analysis.frame + 1, uint64_t(mono.size() / settings.hopSize), "every hop analyzed");
+			ofxTestEq(analysis.position, uint64_t(mono.size() / settings.hopSize * settings.hopSize), "position");
+			auto peak = std::max_element(analysis.spectrum.begin(), analysis.spectrum.end()) - analysis.spectrum.begin();
+			ofxTest(std::abs(analyzer.getBinFrequency(peak) - 1000) < analyzer.getBinFrequency(1), "peak bin at 1KHz: " + ofToString(analyzer.getBinFrequency(peak)));
+			ofxTest(std::abs(analysis.rms - 0.25f / sqrt(2.f)) < 0.005f, "rms of the mixed sine: " + ofToString(analysis.rms));
+			ofxTest(std::abs(analysis.peak - 0.25f) < 0.005f, "peak of the mixed sine: " + ofToString(analysis.peak));
+			ofxTest(analysis.spectrum[peak] > 0.15f && analysis.spectrum[peak] < 0.3f, "peak magnitude: " + ofToString(analysis.spectrum[peak]));
+			ofxTestEq(analysis.numOnsets, uint64_t(1), "one onset for a steady tone");
+
+			settings.channel = 0;
+			analyzer.setup(settings, sampleRate);
+			feed(analyzer, stereo, 2);
+			ofxTest(std::abs(analyzer.getSnapshot().rms - 0.5f / sqrt(2.f)) < 0.01f, "rms of a single channel");
+		}
+
+		{
+			// tone bursts every half a second should give one onset each, they
+			// fade out so the end of a burst doesn't click
+			ofSoundAnalyzer::Settings settings;
+			settings.threaded = false;
+			ofSoundAnalyzer analyzer;
+			analyzer.setup(settings, sampleRate);
+			size_t numBursts = 10;
+			auto burst = sine(2000, 0.8, 0.1, sampleRate);
+			size_t attack = sampleRate / 500;
+			size_t release = sampleRate / 25;
+			for(size_t i = 0; i < burst.size(); i++){
+				burst[i] *= std::min({1.f, float(i) / attack, float(burst.size() - i) / release});
+			}
+			std::vector<float> samples(sampleRate * numBursts / 2, 0);
+			for(size_t i = 0; i < numBursts; i++){
+				std::copy(burst.begin(), burst.end(), samples.begin() + sampleRate / 8 + i * sampleRate / 2);
+			}
+			feed(analyzer, samples, 1);
+			ofxTestEq(analyzer.getSnapshot().numOnsets, uint64_t(numBursts), "one onset per burst");
+		}
+
+		{
+			// threaded results match the offline ones
+			ofSoundAnalyzer::Settings settings;
+			auto samples = sine(440, 0.5, 2, sampleRate);
+			ofSoundAnalyzer offline, threaded;
+			settings.threaded = false;
+			offline.setup(settings, sampleRate);
+			settings.threaded = true;
+			threaded.setup(settings, sampleRate);
+			feed(offline, samples, 1);
+			for(size_t i = 0; i < samples.size(); i += 256){
+				threaded.process(samples.data() + i, std::min(size_t(256), samples.size() - i), 1);
+				threaded.waitForAnalysis();
+			}
+			auto & a = offline.getSnapshot();
+			auto & b = threaded.getSnapshot();
+			ofxTestEq(a.frame, b.frame, "same number of frames analyzed");
+			ofxTest(a.spectrum == b.spectrum, "same spectrum");
+			ofxTestEq(threaded.getNumDroppedSamples(), uint64_t(0), "no samples dropped");
+		}
+
+		// benchmark over a minute of synthetic audio
+		auto samples = sine(440, 0.5, 60, sampleRate);
+		for(auto & s: samples){
+			s += ofRandom(-0.1, 0.1);
+		}
+		std::vector<std::pair<size_t, size_t>> sizes{{512, 128}, {1024, 256}, {2048, 512}, {4096, 1024}};
+		for(auto size: sizes){
+			for(auto threaded: {false, true}){
+				ofSoundAnalyzer::Settings settings;
+				settings.windowSize = size.first;
+				settings.hopSize = size.second;
+				settings.threaded = threaded;
+				ofSoundAnalyzer analyzer;
+				analyzer.setup(settings, sampleRate);
+				auto then = ofGetElapsedTimeMicros();
+				for(size_t i = 0; i < samples.size(); i += 256){
+					analyzer.process(samples.data() + i, std::min(size_t(256), samples.size() - i), 1);
+					if(threaded){
+						// the worker can't fall behind more than the ring buffer
+						analyzer.waitForAnalysis();
+					}
+				}
+				auto micros = std::max(ofGetElapsedTimeMicros() - then, uint64_t(1));
+				auto frames = analyzer.getSnapshot().frame + 1;
+				ofLogNotice() << "window " << size.first << " hop " << size.second << (threaded ? " threaded: " : " offline: ")
+					<< frames * 1000000 / micros << " frames/s, " << samples.size() / float(sampleRate) * 1000000 / micros << "x realtime";
+			}
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
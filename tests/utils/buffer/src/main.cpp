@@ -212,6 +212,97 @@ class ofApp: public ofxUnitTestsApp{
 			ofxTest(allLinesEqual, "all lines are correct");
 			ofxTestEq(numLines,lines.size(),"lines iterator correct numLines");
 		}
+
+		{
+			ofLogNotice() << "-------------------";
+			ofLogNotice() << "mapped file";
+			std::string text("first line\r\nsecond line\n\nlast line");
+			ofBufferToFile("mapped.txt", ofBuffer(text.c_str(), text.size()));
+
+			ofBuffer mapped;
+			ofxTest(mapped.mapFile("mapped.txt"), "mapFile");
+			ofxTest(mapped.isMapped(), "isMapped");
+			ofxTestEq(mapped.size(), text.size(), "mapped size");
+			ofxTestEq(mapped.getText(), text, "mapped contents");
+
+			std::vector<std::string> lines;
+			for(auto & line: mapped.getLines()){
+				lines.push_back(line);
+			}
+			std::vector<std::string> expected{"first line", "second line", "", "last line"};
+			ofxTest(lines == expected, "mapped lines");
+
+#if OF_HAS_STRING_VIEW
+			std::vector<std::string> views;
+			for(auto line: mapped.getLineViews()){
+				views.emplace_back(line);
+			}
+			ofxTest(views == expected, "line views");
+			ofxTestEq(std::string(mapped.getLines().begin().asStringView()), std::string("first line"), "Line::asStringView");
+#endif
+
+			mapped.getData()[0] = 'F';
+			ofxTestEq(ofBufferFromFile("mapped.txt").getText(), text, "writing to a mapped buffer doesn't modify the file");
+
+			ofBuffer copy = mapped;
+			ofxTest(!copy.isMapped(), "copies own their data");
+			ofxTestEq(copy.getText(), mapped.getText(), "copy contents");
+
+			ofBuffer moved = std::move(mapped);
+			ofxTest(moved.isMapped(), "moves keep the mapping");
+			ofxTestEq(mapped.size(), size_t(0), "moved from buffer is empty");
+
+			moved.append("\nappended");
+			ofxTest(!moved.isMapped(), "append copies the contents");
+			ofxTestEq(moved.getText(), "F" + text.substr(1) + "\nappended", "append to a mapped buffer");
+
+			ofxTest(!ofBuffer().mapFile("doesnotexist.txt"), "mapping a non existing file fails");
+			ofFile::removeFile("mapped.txt");
+		}
+
+		{
+			ofLogNotice() << "-------------------";
+			ofLogNotice() << "read throughput";
+			{
+				ofFile csv("big.csv", ofFile::WriteOnly);
+				for(int i = 0; i < 2000000; i++){
+					csv << i << "," << i * 2 << "," << i * 0.5f << "\n";
+				}
+			}
+
+			auto start = ofGetElapsedTimeMicros();
+			auto buffer = ofBufferFromFile("big.csv");
+			size_t numChars = 0, numLines = 0;
+			for(auto & line: buffer.getLines()){
+				numChars += line.size();
+				numLines++;
+			}
+			auto readMicros = ofGetElapsedTimeMicros() - start;
+
+			start = ofGetElapsedTimeMicros();
+			auto mapped = ofBufferFromMappedFile("big.csv");
+			size_t numMappedChars = 0, numMappedLines = 0;
+#if OF_HAS_STRING_VIEW
+			for(auto line: mapped.getLineViews()){
+				numMappedChars += line.size();
+				numMappedLines++;
+			}
+#else
+			for(auto & line: mapped.getLines()){
+				numMappedChars += line.size();
+				numMappedLines++;
+			}
+#endif
+			auto mappedMicros = ofGetElapsedTimeMicros() - start;
+
+			ofxTestEq(numMappedLines, numLines, "same number of lines");
+			ofxTestEq(numMappedChars, numChars, "same contents");
+			auto megabytes = buffer.size() / 1000000.f;
+			ofLogNotice() << megabytes << "MB, " << numLines << " lines";
+			ofLogNotice() << "ofBufferFromFile + getLines: " << readMicros / 1000.f << "ms, " << megabytes / (readMicros / 1000000.f) << "MB/s";
+			ofLogNotice() << "ofBufferFromMappedFile + getLineViews: " << mappedMicros / 1000.f << "ms, " << megabytes / (mappedMicros / 1000000.f) << "MB/s";
+			ofFile::removeFile("big.csv");
+		}
 	}
 };
 
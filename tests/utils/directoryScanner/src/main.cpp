@@ -0,0 +1,254 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void createFile(const of::filesystem::path & path, const std::string & contents = "test"){
+		ofFile file(path, ofFile::WriteOnly);
+		file << contents;
+	}
+
+	// waits for the watcher to report events and returns them
+	std::vector<ofDirectoryWatcher::Event> waitForEvents(ofDirectoryWatcher & watcher, std::vector<ofDirectoryWatcher::Event> & pending, size_t numExpected){
+		auto start = ofGetElapsedTimeMillis();
+		while(pending.size() < numExpected && ofGetElapsedTimeMillis() - start < 5000){
+			ofSleepMillis(10);
+			watcher.update();
+		}
+		ofSleepMillis(100);
+		watcher.update();
+		auto result = pending;
+		pending.clear();
+		return result;
+	}
+
+	bool contains(const std::vector<ofDirectoryWatcher::Event> & events, ofDirectoryWatcher::EventType type, const of::filesystem::path & path){
+		auto absolute = of::filesystem::path(ofToDataPath(path, true));
+		return std::any_of(events.begin(), events.end(), [&](const ofDirectoryWatcher::Event & event){
+			return event.type == type && event.path == absolute;
+		});
+	}
+
+	void received(const ofDirectoryWatcher::Event & event){
+		events.push_back(event);
+	}
+
+	void run(){
+		ofDirectory::removeDirectory("tree", true);
+
+		//========================================================================
+		ofLogNotice() << "testing natural sort";
+		{
+			std::vector<of::filesystem::path> names{"img10.png", "img2.png", "img1.png", "img02.png", "b", "a", "10", "9"};
+			std::sort(names.begin(), names.end(), ofDirectory::naturalLess);
+			std::vector<of::filesystem::path> expected{"9", "10", "a", "b", "img1.png", "img02.png", "img2.png", "img10.png"};
+			ofxTest(names == expected, "ofDirectory::naturalLess");
+
+			ofDirectory::createDirectory("tree/sort", true, true);
+			for(auto & name: {"frame10.png", "frame2.png", "frame1.png", "Frame3.png", ".hidden.png", "notes.TXT"}){
+				createFile(of::filesystem::path("tree/sort") / name);
+			}
+			ofDirectory dir("tree/sort");
+			dir.allowExt("png");
+			dir.allowExt("txt");
+			dir.listDir();
+			ofxTestEq(dir.size(), size_t(5), "listDir skips hidden files");
+			dir.sort();
+			std::vector<std::string> sorted;
+			for(auto & file: dir){
+				sorted.push_back(file.getFileName());
+			}
+			ofxTest(sorted == std::vector<std::string>({"Frame3.png", "frame1.png", "frame2.png", "frame10.png", "notes.TXT"}), "sort natural");
+			dir.sort(ofDirectory::SORT_FAST);
+			ofxTestEq(dir.getName(1), std::string("frame1.png"), "sort fast");
+			ofxTestEq(dir.getName(2), std::string("frame10.png"), "sort fast");
+
+			ofDirectory pngs;
+			pngs.allowExt("PNG");
+			pngs.listDir("tree/sort");
+			ofxTestEq(pngs.size(), size_t(4), "listDir extensions case insensitive");
+		}
+
+		//========================================================================
+		ofLogNotice() << "testing ofDirectoryScanner";
+		{
+			std::set<std::string> expected;
+			for(size_t d = 0; d < 4; d++){
+				for(size_t s = 0; s < 3; s++){
+					auto folder = of::filesystem::path("tree/scan") / ("dir" + ofToString(d)) / ("sub" + ofToString(s));
+					ofDirectory::createDirectory(folder, true, true);
+					for(size_t f = 0; f < 10; f++){
+						auto path = folder / ("file" + ofToString(f) + (f % 2 ? ".JPG" : ".txt"));
+						createFile(path);
+						if(f % 2){
+							expected.insert(ofToDataPath(path, true));
+						}
+					}
+				}
+			}
+			ofDirectory::createDirectory("tree/scan/.hidden", true, true);
+			createFile("tree/scan/.hidden/hidden.jpg");
+
+			ofDirectoryScanner::Settings settings;
+			settings.recursive = true;
+			settings.extensions = {"jpg"};
+			for(size_t numThreads: {1, 4}){
+				settings.numThreads = numThreads;
+				auto entries = ofDirectoryScanner::list("tree/scan", settings);
+				std::set<std::string> found;
+				for(auto & entry: entries){
+					found.insert(entry.path().string());
+				}
+				ofxTest(found == expected, "recursive scan with " + ofToString(numThreads) + " threads");
+				ofxTest(std::is_sorted(entries.begin(), entries.end(), [](const ofDirectoryEntry & a, const ofDirectoryEntry & b){
+					return ofDirectory::naturalLess(a.path(), b.path());
+				}), "list is sorted");
+			}
+
+			auto entry = ofDirectoryScanner::list("tree/scan", settings).front();
+			ofxTestEq(entry.getExtension(), std::string("jpg"), "lowercase extension");
+			ofxTestEq(entry.getDepth(), size_t(2), "depth");
+			ofxTestEq(entry.getSize(), uint64_t(4), "lazy size");
+			ofxTest(!entry.isDirectory(), "is a file");
+
+			settings.recursive = false;
+			settings.extensions.clear();
+			settings.includeDirectories = true;
+			ofxTestEq(ofDirectoryScanner::list("tree/scan", settings).size(), size_t(4), "non recursive with directories");
+			settings.showHidden = true;
+			ofxTestEq(ofDirectoryScanner::list("tree/scan", settings).size(), size_t(5), "show hidden");
+
+			size_t numStreamed = 0;
+			settings = ofDirectoryScanner::Settings();
+			settings.recursive = true;
+			auto numFound = ofDirectoryScanner::scan("tree/scan", settings, [&](const ofDirectoryEntry &){
+				numStreamed++;
+			});
+			ofxTestEq(numStreamed, size_t(120), "scan streams every file");
+			ofxTestEq(numFound, numStreamed, "scan returns the number of entries");
+			ofxTestEq(ofDirectoryScanner::scan("tree/nonexistent", settings, [](const ofDirectoryEntry &){}), size_t(0), "scan non existent directory");
+
+			settings.numThreads = 4;
+			bool thrown = false;
+			try{
+				ofDirectoryScanner::scan("tree/scan", settings, [](const ofDirectoryEntry &){
+					throw std::runtime_error("callback failed");
+				});
+			}catch(const std::runtime_error &){
+				thrown = true;
+			}
+			ofxTest(thrown, "exceptions from the callback stop the workers and reach the caller");
+		}
+
+		//========================================================================
+		ofLogNotice() << "testing ofDirectoryWatcher";
+		{
+			ofDirectory::createDirectory("tree/watch/sub", true, true);
+			createFile("tree/watch/existing.txt");
+
+			ofDirectoryWatcher watcher;
+			ofDirectoryWatcher::Settings settings;
+			settings.path = "tree/watch";
+			settings.extensions = {"txt"};
+			settings.notifyOnUpdate = false;
+			settings.pollIntervalMs = 100;
+			ofxTest(watcher.setup(settings), "watcher setup");
+			ofLogNotice() << "watching " << (watcher.isNative() ? "with system notifications" : "by polling");
+			ofAddListener(watcher.changed, this, &ofApp::received);
+
+			createFile("tree/watch/added.txt");
+			createFile("tree/watch/ignored.jpg");
+			createFile("tree/watch/sub/nested.txt");
+			auto received = waitForEvents(watcher, events, 2);
+			ofxTest(contains(received, ofDirectoryWatcher::Added, "tree/watch/added.txt"), "added file");
+			ofxTest(contains(received, ofDirectoryWatcher::Added, "tree/watch/sub/nested.txt"), "added file in subdirectory");
+			ofxTest(std::none_of(received.begin(), received.end(), [](const ofDirectoryWatcher::Event & event){
+				return event.path.extension() == ".jpg";
+			}), "extension filter");
+
+			// polling compares modification times, which can have a 1s resolution
+			ofSleepMillis(watcher.isNative() ? 0 : 1100);
+			createFile("tree/watch/existing.txt", "modified contents");
+			received = waitForEvents(watcher, events, 1);
+			ofxTest(contains(received, ofDirectoryWatcher::Modified, "tree/watch/existing.txt"), "modified file");
+
+			ofFile::removeFile("tree/watch/added.txt");
+			received = waitForEvents(watcher, events, 1);
+			ofxTest(contains(received, ofDirectoryWatcher::Removed, "tree/watch/added.txt"), "removed file");
+
+			// saving by writing a temporary file and renaming it over the
+			// original replaces the file instead of adding a new one
+			ofSleepMillis(watcher.isNative() ? 0 : 1100);
+			createFile("tree/watch/existing.tmp", "renamed over");
+			of::filesystem::rename(ofToDataPath("tree/watch/existing.tmp"), ofToDataPath("tree/watch/existing.txt"));
+			received = waitForEvents(watcher, events, 1);
+			ofxTest(contains(received, ofDirectoryWatcher::Modified, "tree/watch/existing.txt"), "file renamed over an existing one is modified");
+			ofxTest(!contains(received, ofDirectoryWatcher::Added, "tree/watch/existing.txt"), "file renamed over an existing one isn't added");
+
+			ofDirectory::createDirectory("tree/watch/new/deeper", true, true);
+			createFile("tree/watch/new/deeper/late.txt");
+			received = waitForEvents(watcher, events, 1);
+			ofxTest(contains(received, ofDirectoryWatcher::Added, "tree/watch/new/deeper/late.txt"), "file in new subdirectory");
+
+			watcher.close();
+			ofxTest(!watcher.isWatching(), "close");
+			ofRemoveListener(watcher.changed, this, &ofApp::received);
+		}
+
+		//========================================================================
+		ofLogNotice() << "benchmark";
+		{
+			const size_t numFolders = 40;
+			const size_t filesPerFolder = 500;
+			for(size_t d = 0; d < numFolders; d++){
+				auto folder = of::filesystem::path("tree/bench") / ("folder" + ofToString(d));
+				ofDirectory::createDirectory(folder, true, true);
+				for(size_t f = 0; f < filesPerFolder; f++){
+					createFile(folder / ("image_" + ofToString(f) + ".png"));
+				}
+			}
+			const size_t numFiles = numFolders * filesPerFolder;
+
+			auto start = ofGetElapsedTimeMicros();
+			size_t numListed = 0;
+			ofDirectory root("tree/bench");
+			for(auto & folder: root.getSorted()){
+				ofDirectory dir(folder.getAbsolutePath());
+				dir.allowExt("png");
+				dir.listDir();
+				dir.sort();
+				numListed += dir.size();
+			}
+			auto directoryMicros = ofGetElapsedTimeMicros() - start;
+			ofxTestEq(numListed, numFiles, "ofDirectory lists every file");
+
+			ofDirectoryScanner::Settings settings;
+			settings.recursive = true;
+			settings.extensions = {"png"};
+			std::vector<size_t> threadCounts{1, 0};
+			for(auto numThreads: threadCounts){
+				settings.numThreads = numThreads;
+				start = ofGetElapsedTimeMicros();
+				auto entries = ofDirectoryScanner::list("tree/bench", settings);
+				auto scannerMicros = ofGetElapsedTimeMicros() - start;
+				ofxTestEq(entries.size(), numFiles, "ofDirectoryScanner lists every file");
+				ofLogNotice() << numFiles << " files, ofDirectory listDir + sort " << directoryMicros / 1000.f << "ms, "
+					<< "ofDirectoryScanner " << (numThreads ? ofToString(numThreads) : std::string("one per core")) << " threads "
+					<< scannerMicros / 1000.f << "ms";
+			}
+		}
+
+		ofDirectory::removeDirectory("tree", true);
+	}
+
+	std::vector<ofDirectoryWatcher::Event> events;
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -34,6 +34,16 @@ public:
 	}
 };
 
+// counts how many times it's formatted
+struct ofFormatCounter{
+	int & count;
+};
+
+std::ostream & operator<<(std::ostream & os, const ofFormatCounter & counter){
+	counter.count++;
+	return os;
+}
+
 class ofApp: public ofxUnitTestsApp{
 	void run(){
 		auto testLogger = ofGetLoggerChannel();
@@ -45,6 +55,150 @@ class ofApp: public ofxUnitTestsApp{
 		ofSetLoggerChannel(testLogger);
 		ofxTestEq(stringLogger->getStdOut(),"[ notice ] logging: Hello World!\n","logging a notice message with printf syntax");
 		ofxTestEq(stringLogger->getStdErr(),"[  error ] logging: error 0 : error description\n","logging an error message with printf syntax");
+
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "disabled levels";
+		{
+			auto level = ofGetLogLevel();
+			stringLogger->reset();
+			ofSetLoggerChannel(stringLogger);
+			int count = 0;
+			ofSetLogLevel(OF_LOG_WARNING);
+			ofLogNotice("logging") << ofFormatCounter{count};
+			ofLogVerbose() << ofFormatCounter{count};
+			ofLogNotice("logging", "%d", count);
+			ofSetLogLevel("logging_verbose", OF_LOG_VERBOSE);
+			ofSetLogLevel("logging_silent", OF_LOG_SILENT);
+			ofLogNotice("logging_verbose") << ofFormatCounter{count};
+			ofLogFatalError("logging_silent") << ofFormatCounter{count};
+			ofLogError("logging") << ofFormatCounter{count};
+			ofSetLogLevel(level);
+			ofSetLoggerChannel(testLogger);
+			ofxTestEq(count, 2, "only enabled messages are formatted");
+			ofxTestEq(stringLogger->getStdOut(), "[ notice ] logging_verbose: \n", "module level lower than the global one");
+			ofxTestEq(stringLogger->getStdErr(), "[  error ] logging: \n", "module without level uses the global one");
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "async channel";
+		{
+			ofAsyncLoggerChannel::Settings settings;
+			settings.path = "async.log";
+			auto channel = std::make_shared<ofAsyncLoggerChannel>(settings);
+			ofSetLoggerChannel(channel);
+			std::vector<std::thread> threads;
+			for(int i = 0; i < 4; i++){
+				threads.emplace_back([i]{
+					for(int j = 0; j < 1000; j++){
+						ofLogWarning("thread" + ofToString(i)) << j;
+					}
+				});
+			}
+			for(auto & thread: threads){
+				thread.join();
+			}
+			channel->flush();
+			ofSetLoggerChannel(testLogger);
+
+			auto lines = ofSplitString(ofBufferFromFile("async.log").getText(), "\n", true);
+			// the file starts with the same timestamp header as ofFileLoggerChannel
+			ofxTestEq(lines.size(), size_t(4001), "every message from every thread is written");
+			ofxTestEq(lines.back().substr(0, 16), std::string("[warning] thread"), "text format");
+
+			settings.path = "async.jsonl";
+			settings.format = ofAsyncLoggerChannel::JsonLines;
+			channel->setup(settings);
+			channel->log(OF_LOG_ERROR, "module", "quote \" and\nnew line");
+			channel->close();
+			auto json = ofBufferFromFile("async.jsonl").getText();
+			ofxTest(ofIsStringInString(json, ",\"level\":\"error\",\"module\":\"module\",\"message\":\"quote \\\" and\\nnew line\"}\n"), "json lines format");
+
+			settings.path = "async.bin";
+			settings.format = ofAsyncLoggerChannel::Binary;
+			channel->setup(settings);
+			channel->log(OF_LOG_NOTICE, "module", "message");
+			channel->close();
+			auto binary = ofBufferFromFile("async.bin");
+			ofxTestEq(binary.size(), size_t(8 + 1 + 2 + 4 + 6 + 7), "binary record size");
+			ofxTestEq(int(binary.getData()[8]), int(OF_LOG_NOTICE), "binary record level");
+			ofxTestEq(std::string(binary.getData() + 15, 13), std::string("modulemessage"), "binary record strings");
+
+			settings.path = "async_drop.log";
+			settings.format = ofAsyncLoggerChannel::Text;
+			settings.queueSize = 2;
+			settings.overflowPolicy = ofAsyncLoggerChannel::Drop;
+			channel->setup(settings);
+			for(int i = 0; i < 10000; i++){
+				channel->log(OF_LOG_NOTICE, "", "message");
+			}
+			channel->close();
+			auto dropped = ofBufferFromFile("async_drop.log").getText();
+			ofxTest(channel->getNumDropped() == 0 || ofIsStringInString(dropped, "messages, the queue was full"), "dropped messages are reported");
+
+			// threads keep logging, some of them waiting for a slot, while
+			// the channel is set up again and closed
+			settings.path = "async_close.log";
+			settings.queueSize = 2;
+			settings.overflowPolicy = ofAsyncLoggerChannel::Block;
+			channel->setup(settings);
+			std::atomic<bool> logging(true);
+			std::atomic<size_t> numLogged(0);
+			threads.clear();
+			for(int i = 0; i < 4; i++){
+				threads.emplace_back([&]{
+					while(logging){
+						channel->log(OF_LOG_VERBOSE, "close", "message");
+						if(++numLogged % 100 == 0){
+							channel->flush();
+						}
+					}
+				});
+			}
+			ofSleepMillis(10);
+			channel->setup(settings);
+			ofSleepMillis(10);
+			channel->close();
+			logging = false;
+			for(auto & thread: threads){
+				thread.join();
+			}
+			ofxTest(numLogged > 0, "logging while the channel closes doesn't crash or block");
+		}
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "benchmark";
+		{
+			auto level = ofGetLogLevel();
+			const int numMessages = 100000;
+			auto time = [&]{
+				auto then = ofGetElapsedTimeMicros();
+				for(int i = 0; i < numMessages; i++){
+					ofLogNotice("benchmark") << "message " << i << " " << 0.5f;
+				}
+				return (ofGetElapsedTimeMicros() - then) * 1000.f / numMessages;
+			};
+
+			ofSetLogLevel(OF_LOG_WARNING);
+			auto disabled = time();
+			ofSetLogLevel(OF_LOG_NOTICE);
+
+			ofSetLoggerChannel(std::make_shared<ofFileLoggerChannel>("benchmark_sync.log", false));
+			auto sync = time();
+
+			ofAsyncLoggerChannel::Settings settings;
+			settings.path = "benchmark_async.log";
+			auto async = std::make_shared<ofAsyncLoggerChannel>(settings);
+			ofSetLoggerChannel(async);
+			auto queued = time();
+			async->flush();
+
+			ofSetLoggerChannel(testLogger);
+			ofSetLogLevel(level);
+			ofLogNotice() << "disabled: " << disabled << "ns per message";
+			ofLogNotice() << "ofFileLoggerChannel: " << sync << "ns per message";
+			ofLogNotice() << "ofAsyncLoggerChannel: " << queued << "ns per message";
+		}
 	}
 	std::shared_ptr<ofStringLoggerChannel> stringLogger{new ofStringLoggerChannel};
 };
@@ -0,0 +1,131 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ProfiledThread: public ofThread{
+	void threadedFunction(){
+		for(int i = 0; i < 10; i++){
+			OF_PROFILE_ZONE("thread work");
+			ofSleepMillis(1);
+		}
+	}
+};
+
+class ofApp: public ofxUnitTestsApp{
+	size_t countZones(const std::vector<ofProfiler::Zone> & zones, const std::string & name){
+		return std::count_if(zones.begin(), zones.end(), [&](const ofProfiler::Zone & zone){
+			return name == zone.name;
+		});
+	}
+
+	void run(){
+		ofProfiler::setEnabled(false);
+		ofProfiler::clear();
+		{
+			OF_PROFILE_ZONE("disabled");
+		}
+		ofxTestEq(ofProfiler::getZones().size(), size_t(0), "nothing recorded while disabled");
+
+		ofProfiler::setEnabled(true);
+		{
+			OF_PROFILE_ZONE("outer");
+			ofSleepMillis(2);
+			{
+				OF_PROFILE_ZONE("inner");
+				ofSleepMillis(1);
+			}
+		}
+		auto zones = ofProfiler::getZones();
+		ofxTestEq(zones.size(), size_t(2), "recorded nested zones");
+		ofxTestEq(std::string(zones[0].name), std::string("outer"), "sorted by start");
+		ofxTest(zones[0].startNanos <= zones[1].startNanos && zones[0].endNanos >= zones[1].endNanos, "inner zone inside outer");
+		ofxTest(zones[1].endNanos - zones[1].startNanos >= 1000000, "zone duration");
+		ofxTestEq(ofProfiler::getThreadNames()[zones[0].thread], std::string("main"), "main thread name");
+
+		auto summary = ofProfiler::getSummary();
+		ofxTestEq(summary.size(), size_t(2), "summary groups by name");
+		ofxTestEq(std::string(summary[0].name), std::string("outer"), "summary sorted by total time");
+		ofxTestEq(summary[0].count, size_t(1), "summary count");
+
+		// zones in ofThread are recorded with the thread name, ofThread
+		// itself doesn't add one
+		ProfiledThread thread;
+		thread.setThreadName("profiled");
+		thread.startThread();
+		thread.waitForThread(false);
+		zones = ofProfiler::getZones();
+		auto names = ofProfiler::getThreadNames();
+		ofxTestEq(countZones(zones, "thread work"), size_t(10), "zones from another thread");
+		ofxTestEq(countZones(zones, "ofThread::threadedFunction"), size_t(0), "no zone around the whole thread");
+		bool namedThread = false;
+		for(auto & zone: zones){
+			if(std::string(zone.name) == "thread work"){
+				namedThread = names[zone.thread] == "profiled";
+			}
+		}
+		ofxTest(namedThread, "thread named after the ofThread");
+
+		// core zones
+		ofProfiler::clear();
+		for(int i = 0; i < 3; i++){
+			ofGetMainLoop()->loopOnce();
+		}
+		zones = ofProfiler::getZones();
+		ofxTestEq(countZones(zones, "ofMainLoop::loopOnce"), size_t(3), "main loop zones");
+		ofxTestEq(countZones(zones, "update"), size_t(3), "update zones");
+		ofxTestEq(countZones(zones, "draw"), size_t(3), "draw zones");
+
+		ofxTest(ofProfiler::saveChromeTrace("trace.json"), "saved trace");
+		auto trace = ofLoadJson("trace.json");
+		ofxTest(trace["traceEvents"].is_array(), "trace is valid json");
+		size_t numComplete = 0;
+		for(auto & event: trace["traceEvents"]){
+			numComplete += event["ph"] == "X";
+		}
+		ofxTestEq(numComplete, zones.size(), "every zone in the trace");
+
+		// the oldest zones are overwritten when the buffer is full
+		ofProfiler::setBufferSize(16);
+		std::thread([]{
+			for(int i = 0; i < 100; i++){
+				OF_PROFILE_ZONE("ring");
+			}
+		}).join();
+		ofxTestEq(countZones(ofProfiler::getZones(), "ring"), size_t(16), "ring keeps the last zones");
+		ofProfiler::setBufferSize(65536);
+
+		// benchmark
+		{
+			int numZones = 1000000;
+			ofProfiler::setEnabled(false);
+			auto then = ofGetElapsedTimeMicros();
+			for(int i = 0; i < numZones; i++){
+				OF_PROFILE_ZONE("benchmark");
+			}
+			auto disabledNanos = (ofGetElapsedTimeMicros() - then) * 1000.f / numZones;
+
+			ofProfiler::setEnabled(true);
+			then = ofGetElapsedTimeMicros();
+			for(int i = 0; i < numZones; i++){
+				OF_PROFILE_ZONE("benchmark");
+			}
+			auto enabledNanos = (ofGetElapsedTimeMicros() - then) * 1000.f / numZones;
+			ofLogNotice() << "zone overhead: " << disabledNanos << "ns disabled, " << enabledNanos << "ns enabled";
+		}
+		ofProfiler::setEnabled(false);
+		ofProfiler::clear();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -73,6 +73,122 @@ class ofApp: public ofxUnitTestsApp{
 		ofxTestEq(ofVAArgsToString("Hello %s !","world"),"Hello world !","ofVAArgsToString");
 		setlocale (LC_ALL,"C"); //To make sure decimal separator is a '.'
 		ofxTestEq(ofVAArgsToString("writing some floats %+4.2f %g %E !",1.2345, -10., 1526.4),"writing some floats +1.23 -10 1.526400E+03 !","ofVAArgsToString");
+
+
+		ofxTestEq(ofToString(1.5f),"1.5","ofToString float");
+		ofxTestEq(ofToString(1234567.0),"1.23457e+06","ofToString double keeps 6 significant digits");
+		ofxTestEq(ofToString(-42),"-42","ofToString int");
+		ofxTestEq(ofToString('a'),"a","ofToString char");
+		ofxTestEq(ofToString(3.14159,2),"3.14","ofToString precision");
+		ofxTestEq(ofToString(7,3,'0'),"007","ofToString width and fill");
+		ofxTestEq(ofToString(2.5,1,6,' '),"   2.5","ofToString precision, width and fill");
+		ofxTestEq(ofToString(std::vector<float>{1.5f,2.f}),"{1.5, 2}","ofToString vector");
+		std::string appended = "fps: ";
+		ofAppendToString(appended, 59.94f, 1);
+		ofxTestEq(appended,"fps: 59.9","ofAppendToString");
+
+		ofxTestEq(ofToInt(" 42"),42,"ofToInt leading whitespace");
+		ofxTestEq(ofToInt("+7"),7,"ofToInt plus sign");
+		ofxTestEq(ofToInt("12abc"),12,"ofToInt stops at the first invalid character");
+		ofxTestEq(ofToInt("abc"),0,"ofToInt invalid");
+		ofxTestEq(ofToFloat("3.5e2"),350.f,"ofToFloat");
+		ofxTestEq(ofToDouble("-0.25"),-0.25,"ofToDouble");
+		ofxTestEq(ofToInt64("9223372036854775807"),int64_t(9223372036854775807LL),"ofToInt64");
+		int parsed = 5;
+		ofxTest(!ofParseNumber("x", parsed) && parsed == 5,"ofParseNumber leaves the value unchanged on failure");
+
+		std::vector<std::string_view> views;
+		ofSplitString(" a , b,,c ", ",", views, true, true);
+		ofxTestEq(views.size(),3u,"split views size");
+		ofxTest(views[0] == "a" && views[1] == "b" && views[2] == "c","split views trimmed");
+		float x = 0;
+		ofxTest(ofParseNumber(ofSplitStringViews("1,2.5,3", ",")[1], x) && x == 2.5f,"ofParseNumber from a view");
+
+		std::vector<std::string> reused;
+		ofSplitString("hi this is a split test", " ", reused);
+		ofSplitString("a;b", ";", reused);
+		ofxTestEq(reused.size(),2u,"split reusing the vector size");
+		ofxTestEq(reused[1],"b","split reusing the vector");
+
+		std::string_view remaining = "1 2 3";
+		std::string_view token;
+		std::string tokens;
+		while(ofNextToken(remaining, " ", token)){
+			tokens += std::string(token) + ";";
+		}
+		ofxTestEq(tokens,"1;2;3;","ofNextToken");
+		ofxTestEq(std::string(ofTrimView("  trim this  ")),"trim this","ofTrimView");
+
+		ofLogNotice() << "-------------------";
+		ofLogNotice() << "benchmark";
+		{
+			const int n = 200000;
+			auto time = [&](std::function<void()> f){
+				auto then = ofGetElapsedTimeMicros();
+				f();
+				return (ofGetElapsedTimeMicros() - then) * 1000.f / n;
+			};
+			size_t total = 0;
+
+			auto stream = time([&]{
+				for(int i = 0; i < n; i++){
+					std::ostringstream out;
+					out << i * 0.37f;
+					total += out.str().size();
+				}
+			});
+			auto toString = time([&]{
+				for(int i = 0; i < n; i++){
+					total += ofToString(i * 0.37f).size();
+				}
+			});
+			std::string buffer;
+			auto append = time([&]{
+				for(int i = 0; i < n; i++){
+					buffer.clear();
+					ofAppendToString(buffer, i * 0.37f);
+					total += buffer.size();
+				}
+			});
+			ofLogNotice() << "float to string: stream " << stream << "ns, ofToString " << toString << "ns, ofAppendToString " << append << "ns";
+
+			std::vector<std::string> numbers;
+			for(int i = 0; i < 1000; i++){
+				numbers.push_back(ofToString(i * 0.37f));
+			}
+			float sum = 0;
+			auto fromStream = time([&]{
+				for(int i = 0; i < n; i++){
+					sum += ofTo<float>(numbers[i % numbers.size()]);
+				}
+			});
+			auto toFloat = time([&]{
+				for(int i = 0; i < n; i++){
+					sum += ofToFloat(numbers[i % numbers.size()]);
+				}
+			});
+			ofLogNotice() << "string to float: stream " << fromStream << "ns, ofToFloat " << toFloat << "ns";
+
+			std::string row = "1.5, 2.25, 3, 4.125, 5, 6.5, 7, 8.75";
+			auto split = time([&]{
+				for(int i = 0; i < n; i++){
+					for(auto & column: ofSplitString(row, ",", false, true)){
+						sum += ofToFloat(column);
+					}
+				}
+			});
+			auto splitViews = time([&]{
+				for(int i = 0; i < n; i++){
+					ofSplitString(row, ",", views, false, true);
+					for(auto column: views){
+						ofParseNumber(column, x);
+						sum += x;
+					}
+				}
+			});
+			ofLogNotice() << "csv row: ofSplitString + ofToFloat " << split << "ns, string views + ofParseNumber " << splitViews << "ns";
+			ofLogNotice() << total << " " << sum;
+		}
 	}
 };
 
@@ -0,0 +1,171 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void run(){
+		ofTaskScheduler scheduler(4);
+		ofxTestEq(scheduler.getNumWorkers(), size_t(4), "number of workers");
+
+		auto doubled = scheduler.async([]{ return 21; }).then([](const int & value){ return value * 2; });
+		ofxTestEq(doubled.get(), 42, "async and then");
+
+		auto failed = scheduler.async([]() -> int{ throw std::runtime_error("failed"); });
+		auto afterFailed = failed.then([](const int & value){ return value; });
+		bool thrown = false;
+		try{
+			afterFailed.get();
+		}catch(const std::runtime_error &){
+			thrown = true;
+		}
+		ofxTest(thrown, "exceptions reach the continuations");
+
+		auto mainThreadId = std::this_thread::get_id();
+		std::thread::id continuationId;
+		auto onMain = scheduler.async([]{ return 1; }).thenOnMainThread([&](const int & value){
+			continuationId = std::this_thread::get_id();
+			return value + 1;
+		});
+		ofxTestEq(onMain.get(), 2, "thenOnMainThread result");
+		ofxTest(continuationId == mainThreadId, "thenOnMainThread runs in the main thread");
+
+		auto fromWorker = scheduler.async([&]{
+			return scheduler.runOnMainThread([]{ return 3; }).get();
+		});
+		ofxTestEq(fromWorker.get(), 3, "a task can wait for the main thread while the main thread waits for it");
+
+		// with every worker busy the main thread has to run the queued tasks
+		// itself instead of spinning until a worker is free
+		std::vector<ofTask<std::thread::id>> busy;
+		for(size_t i = 0; i < scheduler.getNumWorkers() * 4; i++){
+			busy.push_back(scheduler.async([]{
+				ofSleepMillis(5);
+				return std::this_thread::get_id();
+			}));
+		}
+		bool ranOnMain = false;
+		for(auto & task: busy){
+			ranOnMain |= task.get() == mainThreadId;
+		}
+		ofxTest(ranOnMain, "get() from the main thread runs tasks queued from outside the workers");
+
+		auto pending = scheduler.runOnMainThread([]{ return 4; });
+		ofxTest(!pending.isReady(), "main thread tasks wait for the update");
+		ofEventArgs args;
+		ofNotifyEvent(ofEvents().update, args);
+		ofxTest(pending.isReady(), "main thread tasks run on update");
+
+		std::vector<int> values(100000, 0);
+		scheduler.parallelFor(0, values.size(), [&](size_t i){
+			values[i] += i % 7;
+		});
+		bool allSet = true;
+		for(size_t i = 0; i < values.size(); i++){
+			allSet &= values[i] == int(i % 7);
+		}
+		ofxTest(allSet, "parallelFor visits every index once");
+
+		std::atomic<size_t> count(0);
+		scheduler.parallelFor(0, 64, [&](size_t){
+			scheduler.parallelFor(0, 1000, [&](size_t){
+				count++;
+			}, 10);
+		}, 1);
+		ofxTestEq(count.load(), size_t(64000), "nested parallelFor");
+
+		scheduler.setNumWorkers(2);
+		ofxTestEq(scheduler.getNumWorkers(), size_t(2), "setNumWorkers");
+		ofxTestEq(scheduler.async([]{ return 5; }).get(), 5, "tasks run after changing the workers");
+
+		// the worker is busy until the destructor has stopped it so the
+		// other tasks are still queued when it's destroyed
+		std::unique_ptr<ofTaskScheduler> destroyed(new ofTaskScheduler(1));
+		std::atomic<bool> release(false);
+		auto blocking = destroyed->async([&]{
+			while(!release){
+				ofSleepMillis(1);
+			}
+			return 6;
+		});
+		ofSleepMillis(20);
+		auto queued = destroyed->async([]{ return 7; });
+		auto continuation = queued.then([](const int & value){ return value + 1; });
+		auto onMainThread = destroyed->runOnMainThread([]{ return 8; });
+		std::thread releaser([&]{
+			ofSleepMillis(100);
+			release = true;
+		});
+		destroyed.reset();
+		releaser.join();
+		ofxTestEq(blocking.get(), 6, "running tasks finish when the scheduler is destroyed");
+		size_t numFailed = 0;
+		for(auto task: {queued, continuation, onMainThread}){
+			try{
+				task.get();
+			}catch(const std::runtime_error &){
+				numFailed++;
+			}
+		}
+		ofxTestEq(numFailed, size_t(3), "queued tasks fail when the scheduler is destroyed");
+
+		benchmark();
+	}
+
+	// times the loop serially and split by schedulers with a growing number of workers
+	template<typename F>
+	void timeWorkers(const std::string & name, size_t count, F f){
+		auto then = ofGetElapsedTimeMicros();
+		for(int i = 0; i < 10; i++){
+			f(0, count);
+		}
+		ofLogNotice() << name << ", serial: " << (ofGetElapsedTimeMicros() - then) / 10000.f << "ms";
+
+		auto maxWorkers = std::max(std::thread::hardware_concurrency(), 2u);
+		for(size_t numWorkers = 1; numWorkers <= maxWorkers; numWorkers *= 2){
+			ofTaskScheduler scheduler(numWorkers);
+			then = ofGetElapsedTimeMicros();
+			for(int i = 0; i < 10; i++){
+				scheduler.parallelForRange(0, count, f);
+			}
+			ofLogNotice() << name << ", " << numWorkers << " workers: " << (ofGetElapsedTimeMicros() - then) / 10000.f << "ms";
+		}
+	}
+
+	void benchmark(){
+		ofPixels pixels;
+		pixels.allocate(3840, 2160, OF_PIXELS_RGBA);
+		pixels.set(128);
+		timeWorkers("brightness of a 4k image", pixels.getHeight(), [&](size_t begin, size_t end){
+			for(size_t y = begin; y < end; y++){
+				auto line = pixels.getLine(y).begin();
+				for(size_t x = 0; x < pixels.getWidth() * 4; x += 4){
+					for(size_t c = 0; c < 3; c++){
+						line[x + c] = std::min(line[x + c] * 5 / 4, 255);
+					}
+				}
+			}
+		});
+
+		std::vector<glm::vec3> vertices(1000000, glm::vec3(1, 2, 3));
+		std::vector<glm::vec3> transformed(vertices.size());
+		auto matrix = glm::rotate(glm::mat4(1.f), 0.1f, glm::vec3(0, 1, 0));
+		timeWorkers("transform of 1M vertices", vertices.size(), [&](size_t begin, size_t end){
+			for(size_t i = begin; i < end; i++){
+				transformed[i] = glm::vec3(matrix * glm::vec4(vertices[i], 1.f));
+			}
+		});
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,443 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxNetwork.h"
+
+// a minimal HTTP/1.1 server standing in for a remote one. /<kind>/<size>
+// answers size generated bytes after a fixed latency, etag/ responses have
+// to be revalidated, fresh/ ones can be cached for an hour, nostore/ ones
+// can't be cached and vary/ ones change with the Accept header. range/
+// responses can be requested from an offset and drop/ ones close the
+// connection in the middle of the body
+class TestServer{
+public:
+	~TestServer(){
+		running = false;
+		// wakes up the blocking accept
+		ofxTCPManager wakeUp;
+		wakeUp.Create();
+		wakeUp.Connect("127.0.0.1", port);
+		acceptThread.join();
+		for(auto & thread: connectionThreads){
+			thread.join();
+		}
+	}
+
+	bool setup(int port, int latencyMillis){
+		this->port = port;
+		this->latencyMillis = latencyMillis;
+		if(!listener.Create() || !listener.Bind(port, true) || !listener.Listen(64)){
+			return false;
+		}
+		running = true;
+		acceptThread = std::thread([this]{
+			while(running){
+				auto connection = std::make_shared<ofxTCPManager>();
+				if(listener.Accept(*connection) && running){
+					numConnections++;
+					connectionThreads.emplace_back([this, connection]{
+						serve(*connection);
+					});
+				}
+			}
+			listener.Close();
+		});
+		return true;
+	}
+
+	std::atomic<int> numConnections{0};
+	std::atomic<int> numRequests{0};
+	std::atomic<int> numNotModified{0};
+
+private:
+	void serve(ofxTCPManager & connection){
+		connection.SetTimeoutReceive(1);
+		std::string received;
+		char buffer[4096];
+		while(running){
+			auto headersEnd = received.find("\r\n\r\n");
+			if(headersEnd == std::string::npos){
+				int size = connection.Receive(buffer, sizeof(buffer));
+				if(size > 0){
+					received.append(buffer, size);
+				}else if(size != SOCKET_TIMEOUT){
+					break;
+				}
+				continue;
+			}
+			auto request = received.substr(0, headersEnd);
+			received.erase(0, headersEnd + 4);
+			if(!respond(connection, request)){
+				break;
+			}
+		}
+		connection.Close();
+	}
+
+	bool respond(ofxTCPManager & connection, const std::string & request){
+		numRequests++;
+		// GET /<kind>/<size> HTTP/1.1
+		auto requestLine = ofSplitString(request.substr(0, request.find("\r\n")), " ");
+		auto path = ofSplitString(requestLine.size() > 1 ? requestLine[1] : "", "/", true);
+		std::string kind = path.size() > 0 ? path[0] : "";
+		uint64_t size = path.size() > 1 ? ofToInt64(path[1]) : 0;
+		auto lowercaseRequest = ofToLower(request);
+		ofSleepMillis(latencyMillis);
+
+		std::string etag = "\"" + ofToString(size) + "\"";
+		std::string response;
+		uint64_t begin = 0;
+		uint64_t end = size;
+		auto range = lowercaseRequest.find("range: bytes=");
+		if(kind == "etag" && ofIsStringInString(lowercaseRequest, "if-none-match: " + etag)){
+			numNotModified++;
+			response = "HTTP/1.1 304 Not Modified\r\n";
+			end = 0;
+		}else if((kind == "range" || kind == "drop") && range != std::string::npos){
+			begin = ofToInt64(lowercaseRequest.substr(range + 13));
+			if(begin >= size){
+				response = "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" + ofToString(size) + "\r\nContent-Length: 0\r\n";
+				begin = end = 0;
+			}else{
+				response = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + ofToString(begin) + "-" + ofToString(size - 1) + "/" + ofToString(size) + "\r\n";
+				response += "Content-Length: " + ofToString(size - begin) + "\r\n";
+			}
+		}else{
+			response = "HTTP/1.1 200 OK\r\nContent-Length: " + ofToString(size) + "\r\n";
+		}
+		if(kind == "etag"){
+			response += "ETag: " + etag + "\r\nCache-Control: no-cache\r\n";
+		}else if(kind == "fresh"){
+			response += "Cache-Control: max-age=3600\r\n";
+		}else if(kind == "nostore"){
+			response += "ETag: " + etag + "\r\nCache-Control: no-store\r\n";
+		}else if(kind == "vary"){
+			response += "Cache-Control: max-age=3600\r\nVary: Accept\r\n";
+		}
+		response += "\r\n";
+
+		if(kind == "drop"){
+			end = begin + (end - begin) / 2;
+		}
+		// the body is generated and sent in chunks so big files don't need
+		// the memory, small ones go with the headers so the body doesn't
+		// wait for the ack of the headers
+		response.reserve(65536);
+		for(auto offset = begin; offset < end; offset++){
+			response += char(offset % 251);
+			if(response.size() == 65536){
+				if(connection.SendAll(response.data(), response.size()) != int(response.size())){
+					return false;
+				}
+				response.clear();
+			}
+		}
+		if(!response.empty() && connection.SendAll(response.data(), response.size()) != int(response.size())){
+			return false;
+		}
+		return kind != "drop";
+	}
+
+	ofxTCPManager listener;
+	int port = 0;
+	int latencyMillis = 0;
+	std::atomic<bool> running{false};
+	std::thread acceptThread;
+	std::vector<std::thread> connectionThreads;
+};
+
+class ofApp: public ofxUnitTestsApp{
+	// the responses are notified in the update event
+	void waitForResponses(const std::vector<int> & finished, size_t count){
+		auto start = ofGetElapsedTimeMillis();
+		while(finished.size() < count && ofGetElapsedTimeMillis() - start < 10000){
+			ofEventArgs args;
+			ofNotifyEvent(ofEvents().update, args);
+			ofSleepMillis(1);
+		}
+	}
+
+	void testCache(ofURLFileLoader & loader, TestServer & server, const std::string & url){
+		loader.setCacheDirectory("urlCache");
+		loader.clearCache();
+
+		auto first = loader.get(url + "etag/5000");
+		auto second = loader.get(url + "etag/5000");
+		ofxTest(!first.fromCache, "first response from the server");
+		ofxTest(second.fromCache, "not modified response from the cache");
+		ofxTestEq(second.status, 200, "not modified response status");
+		ofxTestEq(server.numNotModified.load(), 1, "revalidated with the etag");
+		ofxTest(first.data.getText() == second.data.getText(), "same data from the cache");
+
+		loader.get(url + "fresh/300");
+		auto numRequests = server.numRequests.load();
+		auto fresh = loader.get(url + "fresh/300");
+		ofxTest(fresh.fromCache && fresh.data.size() == 300, "fresh response from the cache");
+		ofxTestEq(server.numRequests.load(), numRequests, "fresh response without a request");
+
+		loader.get(url + "nostore/300");
+		ofxTest(!loader.get(url + "nostore/300").fromCache, "no-store responses aren't cached");
+
+		loader.get(url + "vary/300");
+		ofxTest(!loader.get(url + "vary/300").fromCache, "responses that vary with the request headers aren't cached");
+
+		ofHttpRequest authorized(url + "fresh/400", "authorized");
+		authorized.headers["Authorization"] = "Bearer token";
+		loader.handleRequest(authorized);
+		ofxTest(!loader.handleRequest(authorized).fromCache, "requests with their own headers aren't cached");
+		ofxTest(!loader.get(url + "fresh/400").fromCache, "responses to requests with their own headers aren't stored");
+
+		loader.clearCache();
+		ofxTest(!loader.get(url + "fresh/300").fromCache, "clearCache");
+		loader.setCacheDirectory("");
+		ofDirectory::removeDirectory("urlCache", true);
+	}
+
+	void testAsync(ofURLFileLoader & loader, const std::string & url){
+		loader.setMaxConcurrentRequests(1);
+		std::vector<int> finished;
+		std::vector<int> ids;
+		for(int i = 0; i < 5; i++){
+			ofHttpRequest request(url + "data/100", "request " + ofToString(i));
+			request.priority = i == 3 ? 1 : 0;
+			request.done = [&finished, i](const ofHttpResponse &){
+				finished.push_back(i);
+			};
+			ids.push_back(loader.handleRequestAsync(request));
+		}
+		waitForResponses(finished, 5);
+		ofxTestEq(finished.size(), size_t(5), "async responses");
+		// the first one could have started before the rest were queued
+		auto position = std::find(finished.begin(), finished.end(), 3) - finished.begin();
+		ofxTest(position <= 1, "higher priority requests start first");
+
+		finished.clear();
+		ids.clear();
+		for(int i = 0; i < 4; i++){
+			ofHttpRequest request(url + "data/100", "request " + ofToString(i));
+			request.done = [&finished, i](const ofHttpResponse &){
+				finished.push_back(i);
+			};
+			ids.push_back(loader.handleRequestAsync(request));
+		}
+		// the first is probably running already, the third is still queued
+		loader.remove(ids[0]);
+		loader.remove(ids[2]);
+		waitForResponses(finished, 2);
+		ofSleepMillis(100);
+		waitForResponses(finished, 3);
+		ofxTest(finished == std::vector<int>({1, 3}), "removed requests don't respond");
+
+		// failed requests are retried until they are removed, even when
+		// the removal comes while one of the attempts is failing
+		finished.clear();
+		ofHttpRequest failing("http://127.0.0.1:1/refused", "failing");
+		failing.done = [&finished](const ofHttpResponse &){
+			finished.push_back(-1);
+		};
+		auto failingId = loader.handleRequestAsync(failing);
+		waitForResponses(finished, 10);
+		loader.remove(failingId);
+		auto pump = [](){
+			auto start = ofGetElapsedTimeMillis();
+			while(ofGetElapsedTimeMillis() - start < 300){
+				ofEventArgs args;
+				ofNotifyEvent(ofEvents().update, args);
+				ofSleepMillis(1);
+			}
+		};
+		pump();
+		auto numFailed = finished.size();
+		pump();
+		ofxTestEq(finished.size(), numFailed, "removed failing requests aren't retried");
+	}
+
+	// the stand-in server generates the byte at each offset of a body
+	static bool isGenerated(const char * data, size_t size, uint64_t offset){
+		for(size_t i = 0; i < size; i++){
+			if(data[i] != char((offset + i) % 251)){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void testStreaming(ofURLFileLoader & loader, const std::string & url){
+		uint64_t size = 64 * 1024 * 1024;
+		uint64_t received = 0;
+		size_t biggestChunk = 0;
+		bool generated = true;
+		ofHttpProgress lastProgress;
+		ofHttpRequest request(url + "range/" + ofToString(size), "stream");
+		request.receive = [&](const char * data, size_t chunkSize){
+			generated &= isGenerated(data, chunkSize, received);
+			received += chunkSize;
+			biggestChunk = std::max(biggestChunk, chunkSize);
+			return true;
+		};
+		request.progress = [&](const ofHttpProgress & progress){
+			lastProgress = progress;
+		};
+		auto start = ofGetElapsedTimeMicros();
+		auto response = loader.handleRequest(request);
+		ofLogNotice() << "streamed " << size / 1024 / 1024 << "MB to a callback at "
+			<< size / ((ofGetElapsedTimeMicros() - start) / 1000000.) / 1000000. << "MB/s";
+		ofxTestEq(response.status, 200, "streamed response status");
+		ofxTestEq(received, size, "streamed the whole body");
+		ofxTest(generated, "streamed data");
+		ofxTestEq(response.data.size(), size_t(0), "streamed responses don't keep the body");
+		ofxTest(biggestChunk <= 1024 * 1024, "streamed in chunks");
+		ofxTestEq(lastProgress.bytesReceived, size, "progress received bytes");
+		ofxTestEq(lastProgress.totalBytes, size, "progress total bytes");
+
+		ofHttpRequest cancelled(url + "range/" + ofToString(size), "cancelled");
+		uint64_t cancelledReceived = 0;
+		cancelled.receive = [&](const char *, size_t chunkSize){
+			cancelledReceived += chunkSize;
+			return cancelledReceived < 1024 * 1024;
+		};
+		ofxTestEq(loader.handleRequest(cancelled).status, -1, "receive returning false cancels the request");
+		ofxTest(cancelledReceived < size, "cancelled before the end");
+
+		std::string path = "download.bin";
+		size = 16 * 1024 * 1024;
+		ofFile::removeFile(path);
+		ofxTestEq(loader.saveTo(url + "drop/" + ofToString(size), path).status, -1, "interrupted download");
+		auto partialSize = ofBufferFromFile(path).size();
+		ofxTest(partialSize > 0 && partialSize < size, "partial file");
+
+		ofHttpRequest resume(url + "range/" + ofToString(size), path, true);
+		resume.resume = true;
+		uint64_t firstProgress = 0;
+		resume.progress = [&](const ofHttpProgress & progress){
+			if(firstProgress == 0){
+				firstProgress = progress.bytesReceived;
+			}
+		};
+		ofxTestEq(loader.handleRequest(resume).status, 206, "resumed download status");
+		ofxTest(firstProgress >= partialSize, "progress counts the resumed bytes");
+		auto file = ofBufferFromFile(path);
+		ofxTestEq(file.size(), size, "resumed file size");
+		ofxTest(isGenerated(file.getData(), file.size(), 0), "resumed file data");
+		ofxTestEq(loader.handleRequest(resume).status, 416, "resuming a complete file");
+		ofxTestEq(ofBufferFromFile(path).size(), size, "complete file untouched");
+
+		// a server that ignores the range sends the whole body
+		std::string partial(1000, 0);
+		ofBufferToFile(path, ofBuffer(partial.data(), partial.size()));
+		resume.url = url + "data/5000";
+		ofxTestEq(loader.handleRequest(resume).status, 200, "resuming without range support");
+		file = ofBufferFromFile(path);
+		ofxTest(file.size() == 5000 && isGenerated(file.getData(), file.size(), 0), "overwritten without range support");
+
+		std::vector<int> finished;
+		ofHttpRequest async(url + "range/" + ofToString(size), path, true);
+		async.done = [&](const ofHttpResponse &){
+			finished.push_back(0);
+		};
+		size_t numEvents = 0;
+		ofHttpProgress lastEvent;
+		auto id = async.getId();
+		ofEventListener progressListener;
+		progressListener = ofURLProgressEvent().newListener([&numEvents, &lastEvent, id](const ofHttpProgress & progress){
+			if(progress.requestId == id){
+				numEvents++;
+				lastEvent = progress;
+			}
+		});
+		loader.handleRequestAsync(async);
+		waitForResponses(finished, 1);
+		ofxTest(numEvents > 0, "progress events");
+		ofxTestEq(lastEvent.bytesReceived, size, "progress event before done");
+		ofxTestEq(ofBufferFromFile(path).size(), size, "asynchronous download");
+		ofFile::removeFile(path);
+
+		// a folder can't be opened as a file, the request fails once
+		ofDirectory::createDirectory(path);
+		finished.clear();
+		ofHttpResponse unwritable;
+		ofHttpRequest toFolder(url + "data/100", path, true);
+		toFolder.done = [&](const ofHttpResponse & response){
+			unwritable = response;
+			finished.push_back(0);
+		};
+		loader.handleRequestAsync(toFolder);
+		waitForResponses(finished, 1);
+		ofSleepMillis(200);
+		waitForResponses(finished, 2);
+		ofxTestEq(finished.size(), size_t(1), "write errors aren't retried");
+		ofxTestEq(unwritable.status, -1, "write error status");
+		ofDirectory::removeDirectory(path, true);
+	}
+
+	void benchmark(ofURLFileLoader & loader, TestServer & server, const std::string & url){
+		size_t numRequests = 200;
+		size_t size = 16384;
+		for(size_t concurrency: {1, 4, 16}){
+			loader.setMaxConcurrentRequests(concurrency);
+			std::vector<int> finished;
+			auto numConnections = server.numConnections.load();
+			auto start = ofGetElapsedTimeMicros();
+			for(size_t i = 0; i < numRequests; i++){
+				ofHttpRequest request(url + "data/" + ofToString(size), "benchmark");
+				request.done = [&finished](const ofHttpResponse &){
+					finished.push_back(0);
+				};
+				loader.handleRequestAsync(request);
+			}
+			waitForResponses(finished, numRequests);
+			auto seconds = (ofGetElapsedTimeMicros() - start) / 1000000.;
+			ofLogNotice() << numRequests << " requests of " << size << " bytes with 10ms latency, "
+				<< concurrency << " concurrent: " << numRequests / seconds << " requests/s, "
+				<< numRequests * size / seconds / 1000000. << "MB/s, "
+				<< server.numConnections.load() - numConnections << " new connections";
+		}
+
+		loader.setCacheDirectory("urlCache");
+		loader.get(url + "fresh/" + ofToString(size));
+		auto start = ofGetElapsedTimeMicros();
+		for(size_t i = 0; i < numRequests; i++){
+			loader.get(url + "fresh/" + ofToString(size));
+		}
+		ofLogNotice() << numRequests << " requests of " << size << " bytes from the disk cache: "
+			<< numRequests / ((ofGetElapsedTimeMicros() - start) / 1000000.) << " requests/s";
+		loader.clearCache();
+		loader.setCacheDirectory("");
+		ofDirectory::removeDirectory("urlCache", true);
+	}
+
+	void run(){
+		int port = ofRandom(15000, 65535);
+		TestServer server;
+		ofxTest(server.setup(port, 10), "stand-in server");
+		std::string url = "http://127.0.0.1:" + ofToString(port) + "/";
+
+		ofURLFileLoader loader;
+		auto response = loader.get(url + "data/1000");
+		ofxTestEq(response.status, 200, "get status");
+		ofxTestEq(response.data.size(), size_t(1000), "get size");
+		ofxTestEq(response.headers["content-length"], std::string("1000"), "response headers");
+		for(int i = 0; i < 9; i++){
+			loader.get(url + "data/1000");
+		}
+		ofxTestEq(server.numConnections.load(), 1, "consecutive requests reuse the connection");
+
+		testCache(loader, server, url);
+		testAsync(loader, url);
+		testStreaming(loader, url);
+		benchmark(loader, server, url);
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -1,4 +1,5 @@
 #include "utils/ofXml.h"
+#include "utils/ofJson.h"
 #include "ofxUnitTests.h"
 #include <locale>
 
@@ -179,7 +180,197 @@ class ofApp: public ofxUnitTestsApp{
 			current_locale.global( saved_loc );
 		}
 		ofLogNotice()<<"\n";
+
+		ofLogNotice() << "Testing SAX parsing";
+		{
+			std::istringstream stream("<?xml version='1.0'?><!-- comment --><a x='1 &gt; 0'><b/>text &amp; more<![CDATA[<raw>]]></a>");
+			EventRecorder recorder;
+			ofxTest(ofXmlSaxParse(stream, recorder, 1), "\tparsing a well formed document succeeds");
+			ofxTestEq(recorder.events, "<a x=1 > 0><b></b>[text & more][<raw>]</a>", "\tevents are reported in document order with entities decoded");
+
+			std::istringstream bom("\xEF\xBB\xBF<a>text</a>");
+			EventRecorder bomRecorder;
+			ofxTest(ofXmlSaxParse(bom, bomRecorder, 1), "\ta UTF-8 byte order mark is skipped");
+			ofxTestEq(bomRecorder.events, "<a>[text]</a>", "\tthe byte order mark isn't reported as text");
+
+			std::istringstream references("<a>&#65;&#x42;&#x1F600;&#; &#x; &# 65; &#+65; &#-65; &#x110000; &#xD800; &#0;</a>");
+			EventRecorder referencesRecorder;
+			ofxTest(ofXmlSaxParse(references, referencesRecorder), "\tparsing numeric character references succeeds");
+			ofxTestEq(referencesRecorder.events, "<a>[AB\xF0\x9F\x98\x80&#; &#x; &# 65; &#+65; &#-65; &#x110000; &#xD800; &#0;]</a>", "\tinvalid numeric character references are copied verbatim");
+
+			std::istringstream broken("<a><b></a>");
+			EventRecorder brokenRecorder;
+			ofxTest(!ofXmlSaxParse(broken, brokenRecorder), "\tmismatched end tags are reported as an error");
+			ofxTest(brokenRecorder.errors == 1, "\tthe handler is notified of the error");
+		}
+		ofLogNotice()<<"\n";
+
+		ofLogNotice() << "Benchmarking large documents";
+		{
+			const size_t numElements = 200000;
+			{
+				ofFile file("large.xml", ofFile::WriteOnly);
+				file << "<scene>\n";
+				for(size_t i = 0; i < numElements; i++){
+					file << "\t<node id=\"" << i << "\" x=\"" << i * 0.5 << "\" y=\"" << i * 0.25 << "\">name" << i << "</node>\n";
+				}
+				file << "</scene>\n";
+			}
+			ofLogNotice() << "\tgenerated large.xml, " << ofFile("large.xml").getSize() / 1024 / 1024 << "MB";
+
+			auto start = ofGetElapsedTimeMicros();
+			ofXml dom;
+			ofxTest(dom.load("large.xml"), "\tload() parses the generated file");
+			size_t domCount = 0;
+			for(auto & node: dom.getChild("scene").getChildren("node")){
+				domCount += node ? 1 : 0;
+			}
+			auto domTime = ofGetElapsedTimeMicros() - start;
+
+			start = ofGetElapsedTimeMicros();
+			ofXml mapped;
+			ofxTest(mapped.loadMapped("large.xml"), "\tloadMapped() parses the generated file");
+			size_t mappedCount = 0;
+			for(auto & node: mapped.getChild("scene").getChildren("node")){
+				mappedCount += node ? 1 : 0;
+			}
+			auto mappedTime = ofGetElapsedTimeMicros() - start;
+			ofxTestEq(mapped.getChild("scene").getLastChild().getAttribute("id").getIntValue(), int(numElements - 1), "\tmapped document reads attributes in place");
+
+			start = ofGetElapsedTimeMicros();
+			ElementCounter counter;
+			ofxTest(ofXmlSaxParse("large.xml", counter), "\tofXmlSaxParse() parses the generated file");
+			auto saxTime = ofGetElapsedTimeMicros() - start;
+
+			ofxTestEq(domCount, numElements, "\tDOM finds every node");
+			ofxTestEq(mappedCount, numElements, "\tmapped DOM finds every node");
+			ofxTestEq(counter.count, numElements, "\tSAX reports every node");
+			ofLogNotice() << "\tload: " << domTime / 1000 << "ms, loadMapped: " << mappedTime / 1000 << "ms, SAX: " << saxTime / 1000 << "ms";
+
+			{
+				ofFile file("large.json", ofFile::WriteOnly);
+				file << "[\n";
+				for(size_t i = 0; i < numElements; i++){
+					file << "{\"id\":" << i << ",\"position\":[" << i * 0.5 << "," << i * 0.25 << "],\"name\":\"name" << i << "\"}" << (i + 1 < numElements ? ",\n" : "\n");
+				}
+				file << "]\n";
+			}
+
+			start = ofGetElapsedTimeMicros();
+			auto json = ofLoadJson("large.json");
+			auto jsonTime = ofGetElapsedTimeMicros() - start;
+
+			start = ofGetElapsedTimeMicros();
+			size_t streamed = 0;
+			int64_t lastId = -1;
+			ofxTest(ofLoadJsonElements("large.json", [&](const std::string &, ofJson & element){
+				streamed++;
+				lastId = element["id"];
+				return true;
+			}), "\tofLoadJsonElements() parses the generated file");
+			auto streamTime = ofGetElapsedTimeMicros() - start;
+
+			ofxTestEq(json.size(), numElements, "\tofLoadJson loads every element");
+			ofxTestEq(streamed, numElements, "\tofLoadJsonElements streams every element");
+			ofxTestEq(lastId, int64_t(numElements - 1), "\telements are streamed in order");
+			ofLogNotice() << "\tofLoadJson: " << jsonTime / 1000 << "ms, ofLoadJsonElements: " << streamTime / 1000 << "ms";
+
+			ofFile::removeFile("large.xml");
+			ofFile::removeFile("large.json");
+		}
+		ofLogNotice() << "Testing compiled queries";
+		{
+			ofXml config;
+			auto root = config.appendChild("config");
+			const int numItems = 2000;
+			for(int i = 0; i < numItems; i++){
+				auto item = root.appendChild("item");
+				item.setAttribute("id", i);
+				item.appendChild("settings").appendChild("value").set(i);
+			}
+
+			ofXml::Query childPath("item/settings/value");
+			ofXml::Query xpath("item[@id>=0]/settings/value");
+			ofxTest(childPath.isChildPath(), "\tplain child paths skip XPath");
+			ofxTest(!xpath.isChildPath() && xpath, "\tother expressions are compiled as XPath");
+			ofxTestEq(root.find(childPath).size(), size_t(numItems), "\tchild path finds every node");
+			ofxTestEq(root.find(xpath).size(), size_t(numItems), "\tcompiled XPath finds every node");
+			ofxTestEq(root.findFirst(childPath).getIntValue(), 0, "\tchild path finds the first node in document order");
+			ofxTestEq(root.getChildByPath("item/settings/value").getIntValue(), 0, "\tgetChildByPath walks element names");
+			ofxTest(!ofXml::Query("item["), "\tinvalid expressions are reported");
+
+			const int iterations = 20;
+			auto start = ofGetElapsedTimeMicros();
+			size_t found = 0;
+			for(int i = 0; i < iterations; i++){
+				for(auto & item: root.getChildren("item")){
+					found += item.find("./settings/value").size();
+				}
+			}
+			auto stringTime = ofGetElapsedTimeMicros() - start;
+
+			ofXml::Query relative("settings/value");
+			ofXml::Query relativeXPath("./settings/value");
+			start = ofGetElapsedTimeMicros();
+			size_t foundCompiled = 0;
+			for(int i = 0; i < iterations; i++){
+				for(auto & item: root.getChildren("item")){
+					foundCompiled += item.find(relativeXPath).size();
+				}
+			}
+			auto compiledTime = ofGetElapsedTimeMicros() - start;
+
+			start = ofGetElapsedTimeMicros();
+			size_t foundChildPath = 0;
+			for(int i = 0; i < iterations; i++){
+				for(auto & item: root.getChildren("item")){
+					foundChildPath += item.find(relative).size();
+				}
+			}
+			auto childPathTime = ofGetElapsedTimeMicros() - start;
+
+			ofxTestEq(found, foundCompiled, "\tcompiled queries find the same nodes as strings");
+			ofxTestEq(found, foundChildPath, "\tchild paths find the same nodes as strings");
+			ofLogNotice() << "\t" << iterations * numItems << " finds, string: " << stringTime / 1000 << "ms, compiled XPath: " << compiledTime / 1000 << "ms, child path: " << childPathTime / 1000 << "ms";
+		}
+		ofLogNotice()<<"\n";
 	}
+
+	class EventRecorder: public ofXmlSaxHandler{
+	public:
+		bool startElement(const std::string & name, const ofXmlSaxAttributes & attributes){
+			events += "<" + name;
+			for(auto & attr: attributes){
+				events += " " + attr.first + "=" + attr.second;
+			}
+			events += ">";
+			return true;
+		}
+		bool endElement(const std::string & name){
+			events += "</" + name + ">";
+			return true;
+		}
+		bool text(const std::string & text){
+			events += "[" + text + "]";
+			return true;
+		}
+		void error(const std::string &, size_t){
+			errors++;
+		}
+		std::string events;
+		int errors = 0;
+	};
+
+	class ElementCounter: public ofXmlSaxHandler{
+	public:
+		bool startElement(const std::string & name, const ofXmlSaxAttributes &){
+			if(name == "node"){
+				count++;
+			}
+			return true;
+		}
+		size_t count = 0;
+	};
 };
 
 
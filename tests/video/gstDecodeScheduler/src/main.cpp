@@ -0,0 +1,108 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofGstVideoPlayer.h"
+
+class ofApp: public ofxUnitTestsApp{
+	bool writeVideo(const std::string & path, int numFrames){
+		ofGstUtils writer;
+		writer.setPipelineWithSink("videotestsrc num-buffers=" + ofToString(numFrames) + " ! video/x-raw,format=I420,width=320,height=240,framerate=30/1 ! x264enc ! matroskamux ! filesink name=sink location=\"" + path + "\"", "sink", false);
+		writer.startPipeline();
+		writer.play();
+		auto start = ofGetElapsedTimeMillis();
+		while(!writer.getIsMovieDone() && ofGetElapsedTimeMillis() - start < 10000){
+			ofSleepMillis(10);
+		}
+		writer.close();
+		return ofFile(path).exists();
+	}
+
+	void run(){
+		auto path = ofToDataPath("scheduler.mkv", true);
+		ofxTest(writeVideo(path, 300), "test file written");
+
+		auto scheduler = std::make_shared<ofGstDecodeScheduler>();
+		scheduler->setMaxDecoderThreads(12);
+		scheduler->setMaxConcurrentPrerolls(2);
+
+		const size_t numPlayers = 8;
+		std::vector<std::shared_ptr<ofGstVideoPlayer>> players;
+		for(size_t i = 0; i < numPlayers; i++){
+			auto player = std::make_shared<ofGstVideoPlayer>();
+			player->setDecodeScheduler(scheduler);
+			// the second half starts hidden, they should preroll last and never decode
+			player->setVisible(i < numPlayers / 2);
+			player->loadAsync(path);
+			player->play();
+			players.push_back(player);
+		}
+		ofxTestEq(scheduler->getNumPlayers(), numPlayers, "players are registered");
+		ofxTest(scheduler->getNumPrerolling() <= 2, "only 2 players preroll at once");
+		ofxTest(scheduler->getNumPendingLoads() >= numPlayers - 2, "the rest wait");
+		ofxTest(players[0]->isPlaying() && !players[0]->isPaused(), "play is remembered while the load is pending");
+		ofxTestEq(scheduler->getDecoderThreadsFor(*players[0]), 2, "visible players split what the hidden ones leave");
+		ofxTestEq(scheduler->getDecoderThreadsFor(*players.back()), 1, "hidden players get one thread");
+		size_t numThreads = 0;
+		for(auto & player: players){
+			numThreads += scheduler->getDecoderThreadsFor(*player);
+		}
+		ofxTestEq(numThreads, scheduler->getMaxDecoderThreads(), "the players stay within the budget");
+
+		size_t maxPrerolling = 0;
+		bool visibleFirst = true;
+		auto start = ofGetElapsedTimeMillis();
+		while(ofGetElapsedTimeMillis() - start < 3000){
+			for(auto & player: players){
+				player->update();
+			}
+			maxPrerolling = std::max(maxPrerolling, scheduler->getNumPrerolling());
+			for(size_t i = numPlayers / 2; i < numPlayers; i++){
+				visibleFirst &= players[i]->isLoadPending() || !players[numPlayers / 2 - 1]->isLoadPending();
+			}
+			ofSleepMillis(5);
+		}
+		ofxTest(maxPrerolling <= 2, "prerolls are staggered");
+		ofxTest(visibleFirst, "visible players are loaded first");
+		ofxTestEq(scheduler->getNumPendingLoads(), 0, "all the loads started");
+
+		for(size_t i = 0; i < numPlayers; i++){
+			auto & player = players[i];
+			ofLogNotice() << "player " << i << (player->isVisible() ? " visible" : " hidden")
+				<< ": " << player->getNumFramesDecoded() << " frames, "
+				<< player->getNumFramesDropped() << " dropped, "
+				<< player->getDecodeLatencyMicros() << "us latency, "
+				<< player->getMaxDecodeLatencyMicros() << "us max latency";
+		}
+		ofxTest(players[0]->getNumFramesDecoded() > 30, "visible players decode");
+		ofxTest(players.back()->isPlaying(), "hidden players still report playing");
+		ofxTest(players.back()->getGstVideoUtils()->isPaused(), "hidden players don't decode");
+		ofxTest(players.back()->getNumFramesDecoded() <= 1, "hidden players only decode the preroll frame");
+
+		players.back()->setVisible(true);
+		ofxTest(!players.back()->getGstVideoUtils()->isPaused(), "showing a player resumes it");
+		players[0]->setVisible(false);
+		ofxTest(players[0]->getGstVideoUtils()->isPaused(), "hiding a player pauses it");
+		auto decoded = players[0]->getNumFramesDecoded();
+		start = ofGetElapsedTimeMillis();
+		while(ofGetElapsedTimeMillis() - start < 500){
+			for(auto & player: players){
+				player->update();
+			}
+			ofSleepMillis(5);
+		}
+		ofxTest(players[0]->getNumFramesDecoded() <= decoded + 1, "hidden player stopped decoding");
+		ofxTest(players.back()->getNumFramesDecoded() > 1, "shown player decodes");
+
+		players.clear();
+		ofxTestEq(scheduler->getNumPlayers(), 0, "players unregister when destroyed");
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}
@@ -0,0 +1,167 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofGstUtils.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// runs the pipeline as fast as possible, calling update like the
+	// player would and popping the queued frames into frames
+	bool play(ofGstVideoUtils & video, const std::string & pipeline, ofPixelFormat format, int w, int h, std::vector<std::shared_ptr<ofGstVideoFrame>> & frames){
+		if(!video.setPipeline(pipeline, format, false, w, h)){
+			return false;
+		}
+		g_object_set(G_OBJECT(video.getSink()), "sync", FALSE, nullptr);
+		if(!video.startPipeline()){
+			return false;
+		}
+		video.play();
+		numPopped = 0;
+		auto start = ofGetElapsedTimeMillis();
+		while(!video.getIsMovieDone() && ofGetElapsedTimeMillis() - start < 10000){
+			video.update();
+			numPopped += video.popFrames(frames);
+			// release frames early like an app would so the pipeline can reuse the buffers
+			if(frames.size() > 16){
+				frames.erase(frames.begin(), frames.end() - 1);
+			}
+			ofSleepMillis(1);
+		}
+		video.update();
+		numPopped += video.popFrames(frames);
+		return video.getIsMovieDone();
+	}
+
+	size_t numPopped = 0;
+
+	void testQueue(){
+		ofGstVideoUtils video;
+		video.setFrameQueueSize(64);
+		std::vector<std::shared_ptr<ofGstVideoFrame>> frames;
+		std::vector<std::shared_ptr<ofGstVideoFrame>> allFrames;
+		ofxTest(play(video, "videotestsrc num-buffers=30 ! video/x-raw,framerate=30/1 ! videoconvert", OF_PIXELS_RGBA, 320, 240, allFrames), "pipeline runs to the end");
+		ofxTestEq(video.getNumFramesReceived(), 30, "all the frames arrive");
+
+		// the last frames popped are still alive
+		auto & lastFrame = allFrames.back();
+		ofxTest(lastFrame->isMapped(), "frames stay mapped while referenced");
+		ofxTestEq(lastFrame->getWidth(), 320, "frame width");
+		ofxTestEq(lastFrame->getHeight(), 240, "frame height");
+		ofxTestEq(lastFrame->getPixelFormat(), OF_PIXELS_RGBA, "frame format");
+		ofxTest(!lastFrame->hasPaddedRows(), "rgba rows are never padded");
+		ofxTest(lastFrame->getPixels().getData() == lastFrame->getPlaneData(0), "pixels point to the gstreamer buffer");
+		ofxTestEq(lastFrame->getTimestampNanos(), int64_t(29) * GST_SECOND / 30, "timestamp of the last frame");
+		ofxTestEq(video.getNumFramesCopied(), 0, "no copies when rows aren't padded");
+		lastFrame->release();
+		ofxTest(!lastFrame->isMapped(), "release unmaps the frame");
+
+		bool increasing = true;
+		for(size_t i = 1; i < allFrames.size(); i++){
+			increasing &= allFrames[i]->getFrameNumber() > allFrames[i - 1]->getFrameNumber();
+			increasing &= allFrames[i]->getTimestampNanos() > allFrames[i - 1]->getTimestampNanos();
+		}
+		ofxTest(increasing, "frames are popped in order");
+		video.close();
+
+		// odd widths have padded rows in rgb and planar formats
+		for(auto format: {OF_PIXELS_RGB, OF_PIXELS_I420}){
+			ofGstVideoUtils padded;
+			padded.setFrameQueueSize(4);
+			frames.clear();
+			play(padded, "videotestsrc num-buffers=10 ! video/x-raw,framerate=30/1 ! videoconvert", format, 321, 241, frames);
+			ofxTest(!frames.empty() && frames.back()->hasPaddedRows(), "odd widths are padded in " + ofToString(format));
+			if(!frames.empty()){
+				auto copies = ofGstVideoFrame::getNumPixelCopies();
+				auto & pixels = frames.back()->getPixels();
+				ofxTestEq(pixels.getWidth(), 321, "padded pixels width");
+				ofxTestEq(pixels.getPixelFormat(), format, "padded pixels format");
+				ofxTest(pixels.getData() != frames.back()->getPlaneData(0), "padded pixels are copied");
+				frames.back()->getPixels();
+				ofxTestEq(ofGstVideoFrame::getNumPixelCopies(), copies + 1, "padded pixels are only copied once");
+
+				std::vector<std::thread> threads;
+				std::vector<const unsigned char*> data(4);
+				for(size_t i = 0; i < data.size(); i++){
+					threads.emplace_back([&, i]{
+						data[i] = frames.front()->getPixels().getData();
+					});
+				}
+				for(auto & thread: threads){
+					thread.join();
+				}
+				ofxTestEq(ofGstVideoFrame::getNumPixelCopies(), copies + 2, "padded pixels are copied once from several threads");
+				ofxTest(std::count(data.begin(), data.end(), data[0]) == 4, "every thread gets the same copy");
+			}
+			ofxTestEq(padded.getNumQueuedFrames(), 0, "queue is empty after popping");
+		}
+
+		// the preroll event gets the padded frames too, without the padding
+		ofGstVideoUtils preroll;
+		preroll.setFrameQueueSize(4);
+		std::atomic<int> numPrerolled(0);
+		std::atomic<bool> prerollWidth(true);
+		auto listener = preroll.prerollEvent.newListener([&](ofPixels & pixels){
+			numPrerolled++;
+			prerollWidth = prerollWidth && pixels.getWidth() == 321;
+		});
+		frames.clear();
+		play(preroll, "videotestsrc num-buffers=10 ! video/x-raw,framerate=30/1 ! videoconvert", OF_PIXELS_RGB, 321, 241, frames);
+		ofxTest(numPrerolled >= 10, "preroll event for every padded frame");
+		ofxTest(prerollWidth, "preroll event pixels have the frame width");
+	}
+
+	void testFile(){
+		auto path = ofToDataPath("framepool.mkv", true);
+		ofGstUtils writer;
+		writer.setPipelineWithSink("videotestsrc num-buffers=60 ! video/x-raw,format=I420,width=640,height=360,framerate=30/1 ! matroskamux ! filesink name=sink location=\"" + path + "\"", "sink", false);
+		writer.startPipeline();
+		writer.play();
+		auto start = ofGetElapsedTimeMillis();
+		while(!writer.getIsMovieDone() && ofGetElapsedTimeMillis() - start < 10000){
+			ofSleepMillis(10);
+		}
+		writer.close();
+		ofxTest(ofFile(path).exists(), "test file written");
+
+		ofGstVideoUtils video;
+		video.setFrameQueueSize(8);
+		std::vector<std::shared_ptr<ofGstVideoFrame>> frames;
+		ofxTest(play(video, "filesrc location=\"" + path + "\" ! decodebin ! videoconvert", OF_PIXELS_I420, 640, 360, frames), "file pipeline runs to the end");
+		ofxTestEq(video.getNumFramesReceived(), 60, "all the frames in the file arrive");
+		ofxTestEq(video.getNumFramesReceived(), numPopped + video.getNumFramesDropped(), "every frame is either popped or dropped");
+		ofxTestEq(video.getNumFramesCopied(), 0, "no copies for unpadded I420");
+	}
+
+	void benchmark(){
+		for(auto size: {glm::ivec2(1920, 1080), glm::ivec2(1917, 1080)}){
+			for(size_t queueSize: {size_t(0), size_t(8)}){
+				ofGstVideoUtils video;
+				video.setFrameQueueSize(queueSize);
+				std::vector<std::shared_ptr<ofGstVideoFrame>> frames;
+				auto start = ofGetElapsedTimeMicros();
+				play(video, "videotestsrc num-buffers=300 pattern=black ! video/x-raw,framerate=60/1 ! videoconvert", OF_PIXELS_RGB, size.x, size.y, frames);
+				auto time = ofGetElapsedTimeMicros() - start;
+				auto received = std::max(video.getNumFramesReceived(), uint64_t(1));
+				ofLogNotice() << size.x << "x" << size.y << (queueSize ? " frame queue: " : " swap buffers: ")
+					<< received * 1000000. / time << "fps, "
+					<< float(video.getNumFramesCopied()) / received << " copies per frame, "
+					<< video.getNumFramesDropped() << " dropped";
+			}
+		}
+	}
+
+	void run(){
+		ofGstUtils::startGstMainLoop();
+		testQueue();
+		testFile();
+		benchmark();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = std::make_shared<ofAppNoWindow>();
+	auto app = std::make_shared<ofApp>();
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+}